@@ -117,6 +117,7 @@ enum XRequestTypes {
    kXR_truncate,// 3028
    kXR_sigver,  // 3029
    kXR_decrypt, // 3030
+   kXR_fetch,   // 3031
    kXR_REQFENCE // Always last valid request code +1
 };
 
@@ -220,6 +221,7 @@ enum XQueryType {
    kXR_Qckscan= 6,
    kXR_Qconfig= 7,
    kXR_Qvisa  = 8,
+   kXR_Qlocfd = 9,
    kXR_Qopaque=16,
    kXR_Qopaquf=32,
    kXR_Qopaqug=64
@@ -398,6 +400,13 @@ struct ClientEndsessRequest {
    kXR_char  sessid[16];
    kXR_int32  dlen;
 };
+struct ClientFetchRequest {
+   kXR_char  streamid[2];
+   kXR_unt16 requestid;
+   kXR_int32 rlen;      // Maximum bytes to return per file (0 -> server max)
+   kXR_char  reserved[12];
+   kXR_int32 dlen;      // Newline separated list of paths follows
+};
 struct ClientGetfileRequest {
    kXR_char  streamid[2];
    kXR_unt16 requestid;
@@ -593,6 +602,7 @@ typedef union {
    struct ClientDecryptRequest decrypt;
    struct ClientDirlistRequest dirlist;
    struct ClientEndsessRequest endsess;
+   struct ClientFetchRequest fetch;
    struct ClientGetfileRequest getfile;
    struct ClientLocateRequest locate;
    struct ClientLoginRequest login;
@@ -664,6 +674,16 @@ struct ServerResponseBody_Open {
    kXR_char cptype[4]; // kXR_retstat is specified
 }; // info will follow if kXR_retstat is specified
 
+// The kXR_fetch response is a sequence of these, one per requested path and in
+// request order. Each is followed by dlen bytes of file data when errnum is
+// zero or by a null terminated error message otherwise. The response may be
+// split across several kXR_oksofar responses but never within an item.
+struct ServerResponseBody_Fetch {
+   kXR_int64 fsize;    // Size of the whole file (0 upon error)
+   kXR_int32 errnum;   // Zero or the kXR error code for this file
+   kXR_int32 dlen;     // Length of the data or error message that follows
+};
+
 // The following information is returned in the response body when kXR_secreqs
 // is set in ClientProtocolRequest::flags. Note that the size of secvec is
 // defined by secvsz and will not be present when secvsz == 0.
@@ -88,6 +88,7 @@ enum CmsReqCode            // Request Codes
      kYR_update  = 25,
      kYR_usage   = 26,
      kYR_xauth   = 27,
+     kYR_summary = 28,
      kYR_MaxReq            // Count of request numbers (highest + 1)
 };
 
@@ -272,6 +273,7 @@ struct CmsLoginData
                   kYR_suspend =   0x00000100,   // Suspended login
                   kYR_nostage =   0x00000200,   // Staging unavailable
                   kYR_trying  =   0x00000400,   // Extensive login retries
+                  kYR_nssum   =   0x00000800,   // Accepts namespace summaries
                   kYR_debug   =   0x80000000,
                   kYR_share   =   0x7f000000,   // Mask to isolate share
                   kYR_shift   =   24,           // Share shift position
@@ -568,6 +570,37 @@ enum  {kYR_Stage  = 0x01, kYR_noStage = 0x02,  // Modifier
       };
 };
 
+/******************************************************************************/
+/*                       s u m m a r y   R e q u e s t                        */
+/******************************************************************************/
+  
+// Request: summary <sumdata> <bits>
+// Respond: n/a
+//
+// A summary is a Bloom filter of the server's exported name space. It is sent
+// unmarshalled (kYR_raw) in fragments of at most maxFrag bytes. All fields of
+// CmsSummaryData are in network byte order. A filter only becomes usable once
+// the fragment flagged kYR_last has been received in sequence.
+//
+struct CmsSummaryData
+{      kXR_unt32     Gen;    // Generation number of this summary
+       kXR_unt32     Bits;   // Number of bits in the whole filter
+       kXR_unt32     Offset; // Byte offset of this fragment
+       kXR_unt16     nHash;  // Number of hash functions used
+       kXR_unt16     Flags;  // See below
+};
+
+struct CmsSummaryRequest
+{      CmsRRHdr       Hdr;
+       CmsSummaryData Data;
+//     kXR_char       Bits[Hdr.datalen-sizeof(CmsSummaryData)];
+
+enum  {kYR_last = 0x0001     // Flags: last fragment of the filter
+      };
+
+static const int maxFrag = 8192;
+};
+
 /******************************************************************************/
 /*                         t r u n c   R e q u e s t                          */
 /******************************************************************************/
@@ -54,6 +54,7 @@
 #include "Xrd/XrdStats.hh"
 
 #include "XrdNet/XrdNetAddr.hh"
+#include "XrdNet/XrdNetCache.hh"
 #include "XrdNet/XrdNetIF.hh"
 #include "XrdNet/XrdNetSecurity.hh"
 #include "XrdNet/XrdNetUtils.hh"
@@ -1219,6 +1220,7 @@ int XrdConfig::xbuf(XrdSysError *eDest, XrdOucStream &Config)
 
    Purpose:  To parse directive: network [wan] [[no]keepalive] [buffsz <blen>]
                                          [kaparms parms] [cache <ct>] [[no]dnr]
+                                         [negcache <nct>]
                                          [routes <rtype> [use <ifn1>,<ifn2>]]
                                          [[no]rpipa]
 
@@ -1229,6 +1231,7 @@ int XrdConfig::xbuf(XrdSysError *eDest, XrdOucStream &Config)
              kaparms   keepalive paramters as specfied by parms.
              <blen>    is the socket's send/rcv buffer size.
              <ct>      Seconds to cache address to name resolutions.
+             <nct>     Seconds to cache addresses that could not be resolved.
              [no]dnr   do [not] perform a reverse DNS lookup if not needed.
              routes    specifies the network configuration (see reference)
              [no]rpipa do [not] resolve private IP addresses.
@@ -1240,7 +1243,7 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
 {
     char *val;
     int  i, n, V_keep = -1, V_nodnr = 0, V_iswan = 0, V_blen = -1, V_ct = -1, V_assumev4;
-    int  v_rpip = -1;
+    int  v_rpip = -1, V_nct = -1;
     long long llp;
     struct netopts {const char *opname; int hasarg; int opval;
                            int *oploc;  const char *etxt;}
@@ -1252,6 +1255,7 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
         {"kaparms",    4, 0, &V_keep,   "option"},
         {"buffsz",     1, 0, &V_blen,   "network buffsz"},
         {"cache",      2, 0, &V_ct,     "cache time"},
+        {"negcache",   2, 0, &V_nct,    "negative cache time"},
         {"dnr",        0, 0, &V_nodnr,  "option"},
         {"nodnr",      0, 1, &V_nodnr,  "option"},
         {"routes",     3, 1, 0,         "routes"},
@@ -1327,6 +1331,7 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
          Net_Opts |= (V_nodnr ? XRDNET_NORLKUP   : 0);
         }
 
+     if (V_nct >= 0) XrdNetCache::SetNKT(V_nct);
      if (V_ct >= 0) XrdNetAddr::SetCache(V_ct);
      if (v_rpip >= 0) XrdInet::netIF.SetRPIPA(v_rpip != 0);
      if (V_assumev4 >= 0) XrdInet::SetAssumeV4(true);
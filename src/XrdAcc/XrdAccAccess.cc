@@ -29,6 +29,7 @@
 /******************************************************************************/
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <time.h>
 #include <sys/param.h>
 
@@ -89,6 +90,10 @@ XrdAccAccess::XrdAccAccess(XrdSysError *erp)
 // Get the audit option that we should use
 //
    Auditor = XrdAccAuditObject(erp);
+
+// The decision cache is established during configuration
+//
+   dCache = 0; dcMask = 0; dcLife = 0; dcGen = 0;
 }
 
 /******************************************************************************/
@@ -102,16 +107,17 @@ XrdAccPrivs XrdAccAccess::Access(const XrdSecEntity    *Entity,
 {
    XrdAccPrivs myprivs;
    char *gname;
-   int accok;
    XrdAccGroupList *glp;
    XrdAccPrivCaps caps;
    XrdAccCapability *cp;
    const int plen  = strlen(path);
    const long phash = XrdOucHashVal2(path, plen);
-   XrdAccAudit_Options audits = (XrdAccAudit_Options)Auditor->Auditing();
    const char *id   = (Entity->name ? (const char *)Entity->name : "*");
    const char *host;
    int isuser = (*id && (*id != '*' || id[1]));
+   char dcKey[2048+MAXPATHLEN];
+   unsigned long dcHash = 0;
+   bool hostUsed;
 
 // Get a shared context for these potentially long running routines
 //
@@ -119,10 +125,26 @@ XrdAccPrivs XrdAccAccess::Access(const XrdSecEntity    *Entity,
 
 // Check if we really need to resolve the host name
 //
-   if (Atab.D_List || Atab.H_Hash || Atab.N_Hash)
+   if ((hostUsed = (Atab.D_List || Atab.H_Hash || Atab.N_Hash)))
       host = Entity->addrInfo->Name("?");
       else host = (Entity->host ? (const char *)Entity->host : "?");
 
+// See if we recently made this decision. The decision depends on the id, the
+// host (when any host based entries exist), the groups and the path.
+//
+   if (dCache)
+      {int klen = snprintf(dcKey, sizeof(dcKey), "%s\n%s\n%s\n%s", id,
+                           (hostUsed && host ? host : ""),
+                           (Entity->grps ? Entity->grps : ""), path);
+       if (klen >= (int)sizeof(dcKey)) *dcKey = 0;
+          else {dcHash = XrdOucHashVal2(dcKey, klen);
+                if (CacheFind(dcKey, dcHash, myprivs))
+                   {Access_Context.UnLock(xs_Shared);
+                    return Decide(myprivs, Entity, path, oper);
+                   }
+               }
+      }
+
 // Establish default privileges
 //
    if (Atab.Z_List) Atab.Z_List->Privs(caps, path, plen, phash);
@@ -177,25 +199,18 @@ XrdAccPrivs XrdAccAccess::Access(const XrdSecEntity    *Entity,
        delete glp;
       }
 
-// We are now done with looking at changeable data
-//
-   Access_Context.UnLock(xs_Shared);
-
-
-// Compute composite privileges and see if privs need to be returned
+// Compute composite privileges and remember them for next time
 //
    myprivs = (XrdAccPrivs)(caps.pprivs & ~caps.nprivs);
-   if (!oper) return (XrdAccPrivs)myprivs;
+   if (dCache && *dcKey) CacheSave(dcKey, dcHash, myprivs);
 
-// Check if auditing is enabled or whether we can do a fastaroo test
+// We are now done with looking at changeable data
 //
-   if (!audits) return (XrdAccPrivs)Test(myprivs, oper);
-   if ((accok = Test(myprivs, oper)) && !(audits & audit_grant))
-      return (XrdAccPrivs)accok;
+   Access_Context.UnLock(xs_Shared);
 
-// Call the auditing routine and exit
+// Return the privileges or the result of checking them
 //
-   return (XrdAccPrivs)Audit(accok, Entity, path, oper);
+   return Decide(myprivs, Entity, path, oper);
 }
   
 /******************************************************************************/
@@ -305,6 +320,94 @@ int XrdAccAccess::Audit(const int              accok,
    return accok;
 }
 
+/******************************************************************************/
+/* Private:                    C a c h e F i n d                              */
+/******************************************************************************/
+
+// Must be called with a shared Access_Context lock held
+
+bool XrdAccAccess::CacheFind(const char *key, unsigned long hval,
+                             XrdAccPrivs &privs)
+{
+   int slot = (int)(hval & dcMask);
+   XrdSysMutexHelper dcLock(dcMutex[slot % dcLocks]);
+   DecEnt *dP = &dCache[slot];
+
+   if (!dP->key || dP->hval != hval || dP->gen != dcGen
+   ||  dP->expires < time(0) || strcmp(dP->key, key)) return false;
+   privs = dP->privs;
+   return true;
+}
+
+/******************************************************************************/
+/* Private:                    C a c h e S a v e                              */
+/******************************************************************************/
+
+// Must be called with a shared Access_Context lock held
+
+void XrdAccAccess::CacheSave(const char *key, unsigned long hval,
+                             XrdAccPrivs privs)
+{
+   int slot = (int)(hval & dcMask);
+   char *newKey = strdup(key), *oldKey;
+   DecEnt *dP = &dCache[slot];
+
+   dcMutex[slot % dcLocks].Lock();
+   oldKey      = dP->key;
+   dP->key     = newKey;
+   dP->hval    = hval;
+   dP->expires = time(0) + dcLife;
+   dP->gen     = dcGen;
+   dP->privs   = privs;
+   dcMutex[slot % dcLocks].UnLock();
+   if (oldKey) free(oldKey);
+}
+
+/******************************************************************************/
+/* Private:                       D e c i d e                                 */
+/******************************************************************************/
+
+XrdAccPrivs XrdAccAccess::Decide(XrdAccPrivs myprivs, const XrdSecEntity *Entity,
+                                 const char *path, const Access_Operation oper)
+{
+   XrdAccAudit_Options audits = (XrdAccAudit_Options)Auditor->Auditing();
+   int accok;
+
+// See if privs need to be returned
+//
+   if (!oper) return (XrdAccPrivs)myprivs;
+
+// Check if auditing is enabled or whether we can do a fastaroo test
+//
+   if (!audits) return (XrdAccPrivs)Test(myprivs, oper);
+   if ((accok = Test(myprivs, oper)) && !(audits & audit_grant))
+      return (XrdAccPrivs)accok;
+
+// Call the auditing routine and exit
+//
+   return (XrdAccPrivs)Audit(accok, Entity, path, oper);
+}
+
+/******************************************************************************/
+/*                              S e t C a c h e                               */
+/******************************************************************************/
+
+void XrdAccAccess::SetCache(int entries, int lifetime)
+{
+   int n = 1;
+
+// The cache is only sized once during configuration
+//
+   if (dCache || entries <= 0) return;
+
+// Round the number of entries up to a power of two
+//
+   while(n < entries && n < 0x40000000) n <<= 1;
+   dCache = (DecEnt *)calloc(n, sizeof(DecEnt));
+   dcMask = n - 1;
+   dcLife = lifetime;
+}
+
 /******************************************************************************/
 /*                              S w a p T a b s                               */
 /******************************************************************************/
@@ -337,6 +440,10 @@ void XrdAccAccess::SwapTabs(struct XrdAccAccess_Tables &newtab)
 //
    XrdAccConfiguration.GroupMaster.PurgeCache();
 
+// Likewise, previously made access decisions no longer apply
+//
+   dcGen++;
+
 // We can now let loose new table searchers
 //
    Access_Context.UnLock(xs_Exclusive);
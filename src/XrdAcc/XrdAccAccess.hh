@@ -35,6 +35,7 @@
 #include "XrdAcc/XrdAccCapability.hh"
 #include "XrdSec/XrdSecEntity.hh"
 #include "XrdOuc/XrdOucHash.hh"
+#include "XrdSys/XrdSysPthread.hh"
 #include "XrdSys/XrdSysXSLock.hh"
 #include "XrdSys/XrdSysPlatform.hh"
 
@@ -112,6 +113,11 @@ friend class XrdAccConfig;
 //
 void              SwapTabs(struct XrdAccAccess_Tables &newtab);
 
+// SetCache() sizes the cache of recent access decisions (0 disables it) and
+// sets the number of seconds a decision may be reused.
+//
+void              SetCache(int entries, int lifetime);
+
       int Test(const XrdAccPrivs priv, const Access_Operation oper);
 
       XrdAccAccess(XrdSysError *erp);
@@ -123,10 +129,34 @@ private:
 XrdAccPrivs Access(const char *id, const Access_ID_Type idtype,
                    const char *path, const Access_Operation oper);
 
+bool        CacheFind(const char *key, unsigned long hval, XrdAccPrivs &privs);
+void        CacheSave(const char *key, unsigned long hval, XrdAccPrivs  privs);
+XrdAccPrivs Decide(XrdAccPrivs myprivs, const XrdSecEntity *Entity,
+                   const char *path, const Access_Operation oper);
+
 struct XrdAccAccess_Tables Atab;
 
 XrdSysXSLock Access_Context;
 
+// The decision cache is direct mapped and protected by a set of mutexes, each
+// covering every dcLocks'th entry. Entries from before the last table swap
+// are recognized by their generation number and ignored.
+//
+struct DecEnt {char         *key;
+               unsigned long hval;
+               time_t        expires;
+               unsigned int  gen;
+               XrdAccPrivs   privs;
+              };
+
+static const int dcLocks = 64;
+
+DecEnt      *dCache;
+int          dcMask;
+int          dcLife;
+unsigned int dcGen;
+XrdSysMutex  dcMutex[dcLocks];
+
 XrdAccAudit *Auditor;
 };
 #endif
@@ -46,7 +46,7 @@ XrdAccCapability::XrdAccCapability(char *pathval, XrdAccPrivCaps &privval)
 
 // Do common initialization
 //
-   next = 0; ctmp = 0;
+   next = 0; ctmp = 0; trie = 0;
    priv.pprivs = privval.pprivs; priv.nprivs = privval.nprivs;
    plen = strlen(pathval); pins = 0; prem = 0;
    pkey = XrdOucHashVal2((const char *)pathval, plen);
@@ -59,6 +59,24 @@ XrdAccCapability::XrdAccCapability(char *pathval, XrdAccPrivCaps &privval)
           {pins = i; prem = plen - i - 2; break;}
 }
 
+/******************************************************************************/
+/*                               C o m p i l e                                */
+/******************************************************************************/
+
+void XrdAccCapability::Compile()
+{
+   static const int trieMin = 8;
+
+// Lists with only a few paths are scanned faster than a trie can be walked
+//
+   if (trie || Flatten(0, 0) < trieMin) return;
+
+// Record every path, including those in referenced templates, in list order
+//
+   trie = new XrdAccCapTrie;
+   Flatten(trie, 0);
+}
+
 /******************************************************************************/
 /*                            D e s t r u c t o r                             */
 /******************************************************************************/
@@ -71,10 +89,30 @@ XrdAccCapability::~XrdAccCapability()
      XrdAccCapability *cp, *np = next;
 
      if (path) {free(path); path = 0;}
+     if (trie) {delete trie; trie = 0;}
 
      while(np) {cp = np; np = np->next; cp->next = 0; delete cp;}
      next = 0;
 }
+/******************************************************************************/
+/* Private:                      F l a t t e n                                */
+/******************************************************************************/
+
+// Add each path in the list to the trie, expanding templates in place, and
+// return the next order number. When the trie is nil the paths are just counted.
+
+int XrdAccCapability::Flatten(XrdAccCapTrie *tP, int order)
+{
+   XrdAccCapability *cp = this;
+
+   do {if (cp->ctmp) order = cp->ctmp->Flatten(tP, order);
+          else {if (tP) tP->Add(cp->path, cp->plen, order, cp->priv);
+                order++;
+               }
+      } while((cp = cp->next));
+   return order;
+}
+
 /******************************************************************************/
 /*                                 P r i v s                                  */
 /******************************************************************************/
@@ -87,6 +125,8 @@ int XrdAccCapability::Privs(      XrdAccPrivCaps &pathpriv,
 {XrdAccCapability *cp=this;
  const int psl = (pathsub ? strlen(pathsub) : 0);
 
+ if (trie && !pathsub) return trie->Find(pathpriv, pathname, pathlen);
+
  do {if (cp->ctmp)
        {if (cp->ctmp->Privs(pathpriv,pathname,pathlen,pathhash,pathsub))
            return 1;
@@ -131,6 +171,148 @@ int XrdAccCapability::Subcomp(const char *pathname, const int pathlen,
    return 1;
 }
 
+/******************************************************************************/
+/*                         X r d A c c C a p T r i e                          */
+/******************************************************************************/
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdAccCapTrie::XrdAccCapTrie()
+{
+   root = Alloc("", 0);
+}
+
+/******************************************************************************/
+/*                                   A d d                                    */
+/******************************************************************************/
+
+void XrdAccCapTrie::Add(const char *path, int plen, int order,
+                        XrdAccPrivCaps &privs)
+{
+   Node *np = root, *kp, *mp, **kids;
+   int i, n, slot, pos = 0;
+
+// Descend the trie splitting any edge that only partially matches the path
+//
+   while(pos < plen)
+        {if ((i = Kid(np, path[pos], slot)) < 0)
+            {kp = Alloc(path+pos, plen-pos);
+             kids = (Node **)malloc((np->knum+1)*sizeof(Node *));
+             if (np->knum)
+                {memcpy(kids, np->kids, slot*sizeof(Node *));
+                 memcpy(kids+slot+1, np->kids+slot,
+                        (np->knum-slot)*sizeof(Node *));
+                 free(np->kids);
+                }
+             kids[slot] = kp; np->kids = kids; np->knum++;
+             np = kp; pos = plen;
+             break;
+            }
+         kp = np->kids[i];
+         for (n = 1; n < kp->llen && pos+n < plen
+                  && kp->label[n] == path[pos+n]; n++) {}
+         if (n < kp->llen)
+            {char *rest = strdup(kp->label+n);
+             mp = Alloc(kp->label, n);
+             mp->kids = (Node **)malloc(sizeof(Node *));
+             mp->kids[0] = kp; mp->knum = 1;
+             free(kp->label); kp->label = rest; kp->llen -= n;
+             np->kids[i] = mp; kp = mp;
+            }
+         np = kp; pos += n;
+        }
+
+// An earlier capability for the same path always takes precedence
+//
+   if (np->order < 0)
+      {np->order = order;
+       np->priv.pprivs = privs.pprivs; np->priv.nprivs = privs.nprivs;
+      }
+}
+
+/******************************************************************************/
+/* Private:                        A l l o c                                  */
+/******************************************************************************/
+
+XrdAccCapTrie::Node *XrdAccCapTrie::Alloc(const char *label, int llen)
+{
+   Node *np = new Node;
+
+   np->kids  = 0;
+   np->label = strndup(label, llen);
+   np->llen  = llen;
+   np->knum  = 0;
+   np->order = -1;
+   return np;
+}
+
+/******************************************************************************/
+/*                                  F i n d                                   */
+/******************************************************************************/
+
+int XrdAccCapTrie::Find(XrdAccPrivCaps &pathpriv,
+                        const char *pathname, const int pathlen)
+{
+   Node *np = root, *kp, *best = 0;
+   int i, slot, pos = 0;
+
+// Walk down the trie. Every node with a path along the way is a prefix of
+// pathname and the one that came first in the list is the one that applies.
+//
+   if (root->order >= 0) best = root;
+   while(pos < pathlen && (i = Kid(np, pathname[pos], slot)) >= 0)
+        {kp = np->kids[i];
+         if (kp->llen > pathlen - pos
+         ||  memcmp(kp->label, pathname+pos, kp->llen)) break;
+         pos += kp->llen; np = kp;
+         if (np->order >= 0 && (!best || np->order < best->order)) best = np;
+        }
+
+// Return the privileges, if any
+//
+   if (!best) return 0;
+   pathpriv.pprivs = (XrdAccPrivs)(pathpriv.pprivs | best->priv.pprivs);
+   pathpriv.nprivs = (XrdAccPrivs)(pathpriv.nprivs | best->priv.nprivs);
+   return 1;
+}
+
+/******************************************************************************/
+/* Private:                         F r e e                                   */
+/******************************************************************************/
+
+void XrdAccCapTrie::Free(Node *np)
+{
+   for (int i = 0; i < np->knum; i++) Free(np->kids[i]);
+   if (np->kids) free(np->kids);
+   free(np->label);
+   delete np;
+}
+
+/******************************************************************************/
+/* Private:                          K i d                                    */
+/******************************************************************************/
+
+// Children are kept sorted by the first byte of their label, which is unique
+// among them. Return the index of the child starting with lead or -1 and set
+// slot to where such a child would be inserted.
+
+int XrdAccCapTrie::Kid(Node *np, char lead, int &slot)
+{
+   int lo = 0, hi = np->knum - 1, mid;
+   unsigned char c = (unsigned char)lead, k;
+
+   while(lo <= hi)
+        {mid = (lo + hi) / 2;
+         k = (unsigned char)np->kids[mid]->label[0];
+         if (k == c) return mid;
+         if (k < c) lo = mid + 1;
+            else    hi = mid - 1;
+        }
+   slot = lo;
+   return -1;
+}
+
 /******************************************************************************/
 /*                         X r d A c c C a p N a m e                          */
 /******************************************************************************/
@@ -36,6 +36,43 @@
 
 #include "XrdAcc/XrdAccPrivs.hh"
 
+/******************************************************************************/
+/*                         X r d A c c C a p T r i e                          */
+/******************************************************************************/
+
+// This is a compressed byte-level prefix trie of the paths in a capability
+// list. Each path is recorded with its position in the list so that Find()
+// returns the same capability that a sequential scan of the list would.
+
+class XrdAccCapTrie
+{
+public:
+
+void                Add(const char *path, int plen, int order,
+                        XrdAccPrivCaps &privs);
+
+int                 Find(XrdAccPrivCaps &pathpriv,
+                         const char *pathname, const int pathlen);
+
+                    XrdAccCapTrie();
+                   ~XrdAccCapTrie() {Free(root);}
+private:
+
+struct Node {Node          **kids;
+             char           *label;
+             int             llen;
+             int             knum;
+             int             order;
+             XrdAccPrivCaps  priv;
+            };
+
+Node               *Alloc(const char *label, int llen);
+void                Free(Node *np);
+int                 Kid(Node *np, char lead, int &slot);
+
+Node               *root;
+};
+
 /******************************************************************************/
 /*                      X r d A c c C a p a b i l i t y                       */
 /******************************************************************************/
@@ -45,6 +82,12 @@ class XrdAccCapability
 public:
 void                Add(XrdAccCapability *newcap) {next = newcap;}
 
+// Compile() builds a prefix trie of the list headed by this capability so that
+// Privs() need not scan the list. It must be called on the head of the list
+// once the list is complete. Short lists are left as they are.
+//
+void                Compile();
+
 XrdAccCapability   *Next() {return next;}
 
 // Privs() searches the associated capability for a prefix matching path. If one
@@ -79,14 +122,17 @@ int                 Subcomp(const char *pathname, const int pathlen,
                   XrdAccCapability(char *pathval, XrdAccPrivCaps &privval);
 
                   XrdAccCapability(XrdAccCapability *taddr)
-                        {next = 0; ctmp = taddr;
+                        {next = 0; ctmp = taddr; trie = 0;
                          pkey = 0; path = 0; plen = 0; pins = 0; prem = 0;
                         }
 
                  ~XrdAccCapability();
 private:
+int               Flatten(XrdAccCapTrie *tP, int order);
+
 XrdAccCapability *next;      // -> Next capability
 XrdAccCapability *ctmp;      // -> Capability template
+XrdAccCapTrie    *trie;      // -> Compiled list (head of list only)
 
 /*----------- The below fields are valid when template is zero -----------*/
 
@@ -285,6 +285,7 @@ int XrdAccConfig::ConfigFile(XrdSysError &Eroute, const char *ConfigFN) {
 // Set external options, as needed
 //
    if (options & ACC_PGO) GroupMaster.SetOptions(Primary_Only);
+   Authorization->SetCache(dcSize, GroupMaster.Lifetime());
 
 // All done
 //
@@ -299,6 +300,7 @@ void XrdAccConfig::ConfigDefaults()
 {
    AuthRT   = 60*60*12;
    options  = 0;
+   dcSize   = 4096;
 }
   
 /******************************************************************************/
@@ -313,6 +315,7 @@ int XrdAccConfig::ConfigXeq(char *var, XrdOucStream &Config, XrdSysError &Eroute
    TS_Xeq("audit",         xaud);
    TS_Xeq("authdb",        xdbp);
    TS_Xeq("authrefresh",   xart);
+   TS_Xeq("cache",         xcac);
    TS_Xeq("gidlifetime",   xglt);
    TS_Xeq("gidretran",     xgrt);
    TS_Xeq("nisdomain",     xnis);
@@ -398,6 +401,38 @@ int XrdAccConfig::xart(XrdOucStream &Config, XrdSysError &Eroute)
       return 0;
 }
 
+/******************************************************************************/
+/*                                  x c a c                                   */
+/******************************************************************************/
+
+/* Function: xcac
+
+   Purpose:  To parse the directive: cache {off | <entries>}
+
+             off       do not cache access decisions.
+             <entries> the number of recent access decisions to cache. Cached
+                       decisions are discarded whenever the authdb is refreshed
+                       and once they are gidlifetime seconds old. The default
+                       is 4096.
+
+   Output: 0 upon success or !0 upon failure.
+*/
+
+int XrdAccConfig::xcac(XrdOucStream &Config, XrdSysError &Eroute)
+{
+    char *val;
+    int csz;
+
+      val = Config.GetWord();
+      if (!val || !val[0])
+         {Eroute.Emsg("Config","cache value not specified");return 1;}
+      if (!strcmp(val, "off")) csz = 0;
+         else if (XrdOuca2x::a2i(Eroute,"cache entries",val,&csz,1,1<<24))
+                 return 1;
+      dcSize = csz;
+      return 0;
+}
+
 /******************************************************************************/
 /*                                  x d b p                                   */
 /******************************************************************************/
@@ -621,6 +656,10 @@ int XrdAccConfig::ConfigDBrec(XrdSysError &Eroute,
        return -1;
       }
 
+   // Compile long lists so that look-ups need not scan them
+   //
+   mycap.Next()->Compile();
+
    // Insert the capability into the appropriate table/list
    //
         if (domname)
@@ -95,6 +95,7 @@ int                 ConfigXeq(char *, XrdOucStream &, XrdSysError &);
 int                 PrivsConvert(char *privs, XrdAccPrivCaps &ctab);
 int                 xaud(XrdOucStream &Config, XrdSysError &Eroute);
 int                 xart(XrdOucStream &Config, XrdSysError &Eroute);
+int                 xcac(XrdOucStream &Config, XrdSysError &Eroute);
 int                 xdbp(XrdOucStream &Config, XrdSysError &Eroute);
 int                 xglt(XrdOucStream &Config, XrdSysError &Eroute);
 int                 xgrt(XrdOucStream &Config, XrdSysError &Eroute);
@@ -107,5 +108,6 @@ XrdSysMutex          Config_Context;
 XrdSysThread         Config_Refresh;
 
 int                  options;
+int                  dcSize;
 };
 #endif
@@ -140,6 +140,10 @@ void             SetDomain(const char *dname) {domain = dname;}
 //
 void             SetLifetime(const int seconds) {LifeTime = (int)seconds;}
 
+// Returns the cache lifetime in seconds.
+//
+int              Lifetime() {return (int)LifeTime;}
+
 // Used by the configuration object to set various options
 //
 void             SetOptions(XrdAccGroups_Options opts) {options = opts;}
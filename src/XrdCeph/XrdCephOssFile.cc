@@ -71,6 +71,10 @@ int XrdCephOssFile::Read(XrdSfsAio *aiop) {
   return ceph_aio_read(m_fd, aiop, aioReadCallback);
 }
 
+ssize_t XrdCephOssFile::ReadV(XrdOucIOVec *readV, int n) {
+  return ceph_posix_readv(m_fd, readV, n);
+}
+
 ssize_t XrdCephOssFile::ReadRaw(void *buff, off_t offset, size_t blen) {
   return Read(buff, offset, blen);
 }
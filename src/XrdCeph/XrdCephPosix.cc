@@ -34,14 +34,18 @@
 #include <stdlib.h>
 #include <stdarg.h>
 #include <radosstriper/libradosstriper.hpp>
+#include <algorithm>
+#include <atomic>
 #include <map>
 #include <stdexcept>
 #include <string>
 #include <sstream>
+#include <vector>
 #include <sys/xattr.h>
 #include <time.h>
 #include <limits>
 #include <pthread.h>
+#include <sched.h>
 #include "XrdSfs/XrdSfsAio.hh"
 #include "XrdSys/XrdSysPthread.hh"
 
@@ -61,6 +65,8 @@ struct CephFileRef : CephFile {
   int flags;
   mode_t mode;
   unsigned long long offset;
+  /// striper resolved at open time, if any
+  libradosstriper::RadosStriper *striper;
 };
 
 /// small struct for directory listing
@@ -87,10 +93,11 @@ std::vector<StriperDict> g_radosStripers;
 typedef std::map<std::string, librados::IoCtx*> IOCtxDict;
 std::vector<IOCtxDict> g_ioCtx;
 std::vector<librados::Rados*> g_cluster;
-/// mutex protecting the striper and ioctx maps
-XrdSysMutex g_striper_mutex;
+/// lock protecting the striper and ioctx maps
+/// lookups of existing stripers only take it in read mode
+XrdSysRWLock g_striper_rwlock;
 /// index of current Striper/IoCtx to be used
-unsigned int g_cephPoolIdx = 0;
+std::atomic<unsigned int> g_cephPoolIdx(0);
 /// size of the Striper/IoCtx pool, defaults to 1
 /// may be overwritten in the configuration file
 /// (See XrdCephOss::configure)
@@ -98,32 +105,42 @@ unsigned int g_maxCephPoolIdx = 1;
 
 /// global variable holding a list of files currently opened for write
 std::multiset<std::string> g_filesOpenForWrite;
-/// global variable holding a map of file descriptor to file reference
-std::map<unsigned int, CephFileRef> g_fds;
-/// global variable remembering the next available file descriptor
+
+/// entry of the table of file descriptors
+/// refs counts the calls currently using the file reference
+struct CephFdEntry {
+  std::atomic<CephFileRef*> fr;
+  std::atomic<int> refs;
+};
+/// global table of file descriptors. It is made of chunks that are allocated
+/// on demand and never freed so that looking up a file descriptor takes no lock
+static const unsigned int g_fdChunkBits = 10;
+static const unsigned int g_fdChunkSize = 1 << g_fdChunkBits;
+static const unsigned int g_fdMaxChunks = 1024;
+std::atomic<CephFdEntry*> g_fdChunks[g_fdMaxChunks];
+/// global variable remembering the next never used file descriptor
 unsigned int g_nextCephFd = 0;
-/// mutex protecting the map of file descriptors and the openForWrite multiset
+/// file descriptors that were closed and can be reused
+std::vector<int> g_freeCephFds;
+/// mutex protecting the allocation of file descriptors and the openForWrite multiset
 XrdSysMutex g_fd_mutex;
 
-/// Accessor to next ceph pool index
-/// Note that this is not thread safe, but we do not care
-/// as we only want a rough load balancing
-unsigned int getCephPoolIdxAndIncrease() {
+/// allocates the stripers/ioCtxs/cluster vectors, to be called with the
+/// striper lock held in write mode
+void initCephPools() {
   if (g_radosStripers.size() == 0) {
-    // initialization phase : allocate corresponding places in the vectors
     for (unsigned int i = 0; i < g_maxCephPoolIdx; i++) {
       g_radosStripers.push_back(StriperDict());
       g_ioCtx.push_back(IOCtxDict());
       g_cluster.push_back(0);
     }
   }
-  unsigned int res = g_cephPoolIdx;
-  unsigned nextValue = g_cephPoolIdx+1;
-  if (nextValue >= g_maxCephPoolIdx) {
-    nextValue = 0;
-  }
-  g_cephPoolIdx = nextValue;
-  return res;
+}
+
+/// Accessor to next ceph pool index
+/// Note that the pool vectors must have been initialized
+unsigned int getCephPoolIdxAndIncrease() {
+  return g_cephPoolIdx++ % g_maxCephPoolIdx;
 }
 
 /// check whether a file is open for write
@@ -144,35 +161,80 @@ void deleteOpenForWrite(std::string& name) {
   g_filesOpenForWrite.erase(g_filesOpenForWrite.find(name));
 }
 
-/// look for a FileRef from its file descriptor
-CephFileRef* getFileRef(int fd) {
-  XrdSysMutexHelper lock(g_fd_mutex);
-  std::map<unsigned int, CephFileRef>::iterator it = g_fds.find(fd);
-  if (it != g_fds.end()) {
-    return &(it->second);
-  } else {
+/// look for the entry of a file descriptor in the global table
+static CephFdEntry* getFdEntry(int fd) {
+  if (fd < 0 || (unsigned int)fd >= g_fdMaxChunks * g_fdChunkSize) {
     return 0;
   }
+  CephFdEntry *chunk = g_fdChunks[fd >> g_fdChunkBits].load(std::memory_order_acquire);
+  return chunk ? &chunk[fd & (g_fdChunkSize-1)] : 0;
 }
 
-/// deletes a FileRef from the global table of file descriptors
-void deleteFileRef(int fd) {
+/// look for a FileRef from its file descriptor and take a reference on it
+/// the reference must be dropped with putFileRef
+CephFileRef* getFileRef(int fd) {
+  CephFdEntry *entry = getFdEntry(fd);
+  if (0 == entry) return 0;
+  entry->refs++;
+  CephFileRef *fr = entry->fr.load();
+  if (0 == fr) entry->refs--;
+  return fr;
+}
+
+/// drops a reference taken by getFileRef
+void putFileRef(int fd) {
+  getFdEntry(fd)->refs--;
+}
+
+/// holds a reference on the FileRef of a file descriptor for the scope of a call
+class CephFileRefGuard {
+public:
+  CephFileRefGuard(int fd) : m_fd(fd), m_fr(getFileRef(fd)) {}
+  ~CephFileRefGuard() { if (m_fr) putFileRef(m_fd); }
+  operator CephFileRef*() const { return m_fr; }
+  CephFileRef* operator->() const { return m_fr; }
+private:
+  int m_fd;
+  CephFileRef *m_fr;
+};
+
+/**
+ * removes a FileRef from the global table of file descriptors and returns it
+ * once no other call is using it. The caller is responsible for deleting it
+ */
+CephFileRef* detachFileRef(int fd) {
+  CephFdEntry *entry = getFdEntry(fd);
+  if (0 == entry) return 0;
+  CephFileRef *fr = entry->fr.exchange(0);
+  if (0 == fr) return 0;
+  while (entry->refs.load() > 0) sched_yield();
   XrdSysMutexHelper lock(g_fd_mutex);
-  std::map<unsigned int, CephFileRef>::iterator it = g_fds.find(fd);
-  if (it != g_fds.end()) {
-    g_fds.erase(it);
-  }
+  g_freeCephFds.push_back(fd);
+  return fr;
 }
 
 /**
  * inserts a new FileRef into the global table of file descriptors
- * and return the associated file descriptor
+ * and return the associated file descriptor or -EMFILE if the table is full
  */
 int insertFileRef(CephFileRef &fr) {
   XrdSysMutexHelper lock(g_fd_mutex);
-  g_fds[g_nextCephFd] = fr;
-  g_nextCephFd++;
-  return g_nextCephFd-1;
+  int fd;
+  if (!g_freeCephFds.empty()) {
+    fd = g_freeCephFds.back();
+    g_freeCephFds.pop_back();
+  } else {
+    if (g_nextCephFd >= g_fdMaxChunks * g_fdChunkSize) {
+      return -EMFILE;
+    }
+    fd = g_nextCephFd++;
+    std::atomic<CephFdEntry*> &chunk = g_fdChunks[fd >> g_fdChunkBits];
+    if (0 == chunk.load(std::memory_order_relaxed)) {
+      chunk.store(new CephFdEntry[g_fdChunkSize](), std::memory_order_release);
+    }
+  }
+  getFdEntry(fd)->fr.store(new CephFileRef(fr));
+  return fd;
 }
 
 /// global variable containing defaults for CephFiles
@@ -398,6 +460,7 @@ static CephFileRef getCephFileRef(const char *path, XrdOucEnv *env, int flags,
   fr.flags = flags;
   fr.mode = mode;
   fr.offset = 0;
+  fr.striper = 0;
   return fr;
 }
 
@@ -506,34 +569,65 @@ int checkAndCreateStriper(unsigned int cephPoolIdx, std::string &userAtPool, con
   return 1;
 } 
 
-static libradosstriper::RadosStriper* getRadosStriper(const CephFile& file) {
-  XrdSysMutexHelper lock(g_striper_mutex);
+/// looks up the striper and ioctx to be used for a file, creating them if needed
+/// returns 0 if they could not be created
+static int getCephPoolObjects(const CephFile& file,
+                              libradosstriper::RadosStriper **striper,
+                              librados::IoCtx **ioctx) {
   std::stringstream ss;
   ss << file.userId << '@' << file.pool << ',' << file.nbStripes << ','
      << file.stripeUnit << ',' << file.objectSize;
   std::string userAtPool = ss.str();
+  // the common case of an existing striper only needs a read lock
+  {
+    XrdSysRWLockHelper lock(g_striper_rwlock, true);
+    if (g_radosStripers.size() > 0) {
+      unsigned int cephPoolIdx = getCephPoolIdxAndIncrease();
+      StriperDict::iterator it = g_radosStripers[cephPoolIdx].find(userAtPool);
+      if (it != g_radosStripers[cephPoolIdx].end()) {
+        *striper = it->second;
+        *ioctx = g_ioCtx[cephPoolIdx].find(userAtPool)->second;
+        return 1;
+      }
+    }
+  }
+  XrdSysRWLockHelper lock(g_striper_rwlock, false);
+  initCephPools();
   unsigned int cephPoolIdx = getCephPoolIdxAndIncrease();
   if (checkAndCreateStriper(cephPoolIdx, userAtPool, file) == 0) {
     return 0;
   }
-  return g_radosStripers[cephPoolIdx][userAtPool];
+  *striper = g_radosStripers[cephPoolIdx][userAtPool];
+  *ioctx = g_ioCtx[cephPoolIdx][userAtPool];
+  return 1;
+}
+
+static libradosstriper::RadosStriper* getRadosStriper(const CephFile& file) {
+  libradosstriper::RadosStriper *striper;
+  librados::IoCtx *ioctx;
+  if (getCephPoolObjects(file, &striper, &ioctx) == 0) {
+    return 0;
+  }
+  return striper;
+}
+
+/// same as above for an opened file, using the striper resolved at open time
+static libradosstriper::RadosStriper* getRadosStriper(const CephFileRef& fr) {
+  if (fr.striper) return fr.striper;
+  return getRadosStriper((const CephFile&)fr);
 }
 
 static librados::IoCtx* getIoCtx(const CephFile& file) {
-  XrdSysMutexHelper lock(g_striper_mutex);
-  std::stringstream ss;
-  ss << file.userId << '@' << file.pool << ',' << file.nbStripes << ','
-     << file.stripeUnit << ',' << file.objectSize;
-  std::string userAtPool = ss.str();
-  unsigned int cephPoolIdx = getCephPoolIdxAndIncrease();
-  if (checkAndCreateStriper(cephPoolIdx, userAtPool, file) == 0) {
+  libradosstriper::RadosStriper *striper;
+  librados::IoCtx *ioctx;
+  if (getCephPoolObjects(file, &striper, &ioctx) == 0) {
     return 0;
   }
-  return g_ioCtx[cephPoolIdx][userAtPool];
+  return ioctx;
 }
 
 void ceph_posix_disconnect_all() {
-  XrdSysMutexHelper lock(g_striper_mutex);
+  XrdSysRWLockHelper lock(g_striper_rwlock, false);
   for (unsigned int i= 0; i < g_maxCephPoolIdx; i++) {
     for (StriperDict::iterator it2 = g_radosStripers[i].begin();
          it2 != g_radosStripers[i].end();
@@ -558,15 +652,10 @@ void ceph_posix_set_logfunc(void (*logfunc) (char *, va_list argp)) {
 
 static int ceph_posix_internal_truncate(const CephFile &file, unsigned long long size);
 
-int ceph_posix_open(XrdOucEnv* env, const char *pathname, int flags, mode_t mode) {
-  CephFileRef fr = getCephFileRef(pathname, env, flags, mode, 0);
-  int fd = insertFileRef(fr);
-  logwrapper((char*)"ceph_open : fd %d associated to %s", fd, pathname);
-  if (flags & (O_WRONLY|O_RDWR)) {
-    insertOpenForWrite(fr.name);
-  }
+/// checks done when opening a file, returns 0 or -errno
+static int ceph_posix_internal_open(CephFileRef &fr) {
   // in case of O_CREAT and O_EXCL, we should complain if the file exists
-  if ((flags & O_CREAT) && (flags & O_EXCL)) {
+  if ((fr.flags & O_CREAT) && (fr.flags & O_EXCL)) {
     libradosstriper::RadosStriper *striper = getRadosStriper(fr);
     if (0 == striper) return -EINVAL;
     struct stat buf;
@@ -577,22 +666,41 @@ int ceph_posix_open(XrdOucEnv* env, const char *pathname, int flags, mode_t mode
     }
   }
   // in case of O_TRUNC, we should truncate the file
-  if (flags & O_TRUNC) {
+  if (fr.flags & O_TRUNC) {
     int rc = ceph_posix_internal_truncate(fr, 0);
     // fail only if file exists and cannot be truncated
     if (rc < 0 && rc != -ENOENT) return rc;
   }
+  return 0;
+}
+
+int ceph_posix_open(XrdOucEnv* env, const char *pathname, int flags, mode_t mode) {
+  CephFileRef fr = getCephFileRef(pathname, env, flags, mode, 0);
+  // resolve the striper once so that I/O on the file does not look it up
+  fr.striper = getRadosStriper(fr);
+  if (flags & (O_WRONLY|O_RDWR)) {
+    insertOpenForWrite(fr.name);
+  }
+  int rc = ceph_posix_internal_open(fr);
+  int fd = (rc < 0 ? rc : insertFileRef(fr));
+  if (fd < 0) {
+    if (flags & (O_WRONLY|O_RDWR)) {
+      deleteOpenForWrite(fr.name);
+    }
+    return fd;
+  }
+  logwrapper((char*)"ceph_open : fd %d associated to %s", fd, pathname);
   return fd;
 }
 
 int ceph_posix_close(int fd) {
-  CephFileRef* fr = getFileRef(fd);
+  CephFileRef* fr = detachFileRef(fd);
   if (fr) {
     logwrapper((char*)"ceph_close: closed fd %d", fd);
     if (fr->flags & (O_WRONLY|O_RDWR)) {
       deleteOpenForWrite(fr->name);
     }
-    deleteFileRef(fd);
+    delete fr;
     return 0;
   } else {
     return -EBADF;
@@ -614,7 +722,7 @@ static off64_t lseek_compute_offset(CephFileRef &fr, off64_t offset, int whence)
 }
 
 off_t ceph_posix_lseek(int fd, off_t offset, int whence) {
-  CephFileRef* fr = getFileRef(fd);
+  CephFileRefGuard fr(fd);
   if (fr) {
     logwrapper((char*)"ceph_lseek: for fd %d, offset=%lld, whence=%d", fd, offset, whence);
     return (off_t)lseek_compute_offset(*fr, offset, whence);
@@ -624,7 +732,7 @@ off_t ceph_posix_lseek(int fd, off_t offset, int whence) {
 }
 
 off64_t ceph_posix_lseek64(int fd, off64_t offset, int whence) {
-  CephFileRef* fr = getFileRef(fd);
+  CephFileRefGuard fr(fd);
   if (fr) {
     logwrapper((char*)"ceph_lseek64: for fd %d, offset=%lld, whence=%d", fd, offset, whence);
     return lseek_compute_offset(*fr, offset, whence);
@@ -634,7 +742,7 @@ off64_t ceph_posix_lseek64(int fd, off64_t offset, int whence) {
 }
 
 ssize_t ceph_posix_write(int fd, const void *buf, size_t count) {
-  CephFileRef* fr = getFileRef(fd);
+  CephFileRefGuard fr(fd);
   if (fr) {
     logwrapper((char*)"ceph_write: for fd %d, count=%d", fd, count);
     if ((fr->flags & (O_WRONLY|O_RDWR)) == 0) {
@@ -656,7 +764,7 @@ ssize_t ceph_posix_write(int fd, const void *buf, size_t count) {
 }
 
 ssize_t ceph_posix_pwrite(int fd, const void *buf, size_t count, off64_t offset) {
-  CephFileRef* fr = getFileRef(fd);
+  CephFileRefGuard fr(fd);
   if (fr) {
     logwrapper((char*)"ceph_write: for fd %d, count=%d", fd, count);
     if ((fr->flags & (O_WRONLY|O_RDWR)) == 0) {
@@ -684,7 +792,7 @@ static void ceph_aio_write_complete(rados_completion_t c, void *arg) {
 }
 
 ssize_t ceph_aio_write(int fd, XrdSfsAio *aiop, AioCB *cb) {
-  CephFileRef* fr = getFileRef(fd);
+  CephFileRefGuard fr(fd);
   if (fr) {
     // get the parameters from the Xroot aio object
     size_t count = aiop->sfsAio.aio_nbytes;
@@ -715,7 +823,7 @@ ssize_t ceph_aio_write(int fd, XrdSfsAio *aiop, AioCB *cb) {
 }
 
 ssize_t ceph_posix_read(int fd, void *buf, size_t count) {
-  CephFileRef* fr = getFileRef(fd);
+  CephFileRefGuard fr(fd);
   if (fr) {
     logwrapper((char*)"ceph_read: for fd %d, count=%d", fd, count);
     if ((fr->flags & (O_WRONLY|O_RDWR)) != 0) {
@@ -737,7 +845,7 @@ ssize_t ceph_posix_read(int fd, void *buf, size_t count) {
 }
 
 ssize_t ceph_posix_pread(int fd, void *buf, size_t count, off64_t offset) {
-  CephFileRef* fr = getFileRef(fd);
+  CephFileRefGuard fr(fd);
   if (fr) {
     logwrapper((char*)"ceph_read: for fd %d, count=%d", fd, count);
     if ((fr->flags & (O_WRONLY|O_RDWR)) != 0) {
@@ -772,7 +880,7 @@ static void ceph_aio_read_complete(rados_completion_t c, void *arg) {
 }
 
 ssize_t ceph_aio_read(int fd, XrdSfsAio *aiop, AioCB *cb) {
-  CephFileRef* fr = getFileRef(fd);
+  CephFileRefGuard fr(fd);
   if (fr) {
     // get the parameters from the Xroot aio object
     size_t count = aiop->sfsAio.aio_nbytes;
@@ -800,8 +908,152 @@ ssize_t ceph_aio_read(int fd, XrdSfsAio *aiop, AioCB *cb) {
   }
 }
 
+/// implementation of CephAioReader on top of a rados striper
+class RadosAioReader : public CephAioReader {
+public:
+  RadosAioReader(libradosstriper::RadosStriper *striper, const std::string &name) :
+    m_striper(striper), m_name(name) {}
+  virtual ~RadosAioReader() {
+    for (unsigned int i = 0; i < m_completions.size(); i++) {
+      m_completions[i]->wait_for_complete();
+      m_completions[i]->release();
+      delete m_bls[i];
+    }
+  }
+  virtual int start(size_t count, off64_t offset) {
+    ceph::bufferlist *bl = new ceph::bufferlist();
+    librados::AioCompletion *completion = librados::Rados::aio_create_completion();
+    int rc = m_striper->aio_read(m_name, completion, bl, count, offset);
+    if (rc < 0) {
+      completion->release();
+      delete bl;
+      return rc;
+    }
+    m_completions.push_back(completion);
+    m_bls.push_back(bl);
+    return 0;
+  }
+  virtual ssize_t wait(unsigned int idx) {
+    m_completions[idx]->wait_for_complete();
+    int rc = m_completions[idx]->get_return_value();
+    // some versions of the striper return 0 rather than the number of bytes
+    return rc < 0 ? rc : m_bls[idx]->length();
+  }
+  virtual void copy(unsigned int idx, size_t pos, size_t len, char *buf) {
+    m_bls[idx]->copy(pos, len, buf);
+  }
+private:
+  libradosstriper::RadosStriper *m_striper;
+  std::string m_name;
+  std::vector<librados::AioCompletion*> m_completions;
+  std::vector<ceph::bufferlist*> m_bls;
+};
+
+/// maximum number of unrequested bytes read to merge two segments of a readv
+static const unsigned long long g_readvMaxGap = 512 * 1024;
+
+/// small struct describing the range of the file covered by one read of a readv
+struct ReadVRange {
+  unsigned long long offset;
+  unsigned long long end;
+};
+
+/// orders the segments of a readv by offset
+struct ReadVOrder {
+  ReadVOrder(XrdOucIOVec *v) : readV(v) {}
+  bool operator()(int a, int b) const { return readV[a].offset < readV[b].offset; }
+  XrdOucIOVec *readV;
+};
+
+/// returns the index of the part of the file holding the given offset that
+/// is stored contiguously in a single rados object
+static unsigned long long objectExtent(const CephFile &file, unsigned long long offset) {
+  if (file.nbStripes <= 1) {
+    return file.objectSize ? offset / file.objectSize : 0;
+  }
+  return file.stripeUnit ? offset / file.stripeUnit : 0;
+}
+
+/// performs a vector read of the given file using the given reader
+/// Segments stored close to each other in the same rados object are read
+/// together and all reads are started before waiting for any of them, so
+/// the whole vector costs a single round trip to the object store
+ssize_t ceph_posix_internal_readv(CephAioReader &reader, const CephFile &file,
+                                  XrdOucIOVec *readV, int n) {
+  // sort the non empty segments by offset
+  std::vector<int> order;
+  for (int i = 0; i < n; i++) {
+    if (readV[i].size < 0 || readV[i].offset < 0) return -EINVAL;
+    if (readV[i].size > 0) order.push_back(i);
+  }
+  std::sort(order.begin(), order.end(), ReadVOrder(readV));
+  // coalesce them into one read per rados object
+  std::vector<ReadVRange> ranges;
+  std::vector<unsigned int> segRange(n, 0);
+  for (std::vector<int>::const_iterator it = order.begin(); it != order.end(); it++) {
+    unsigned long long beg = readV[*it].offset;
+    unsigned long long end = beg + readV[*it].size;
+    if (!ranges.empty()) {
+      ReadVRange &last = ranges.back();
+      unsigned long long newEnd = std::max(last.end, end);
+      if (beg <= last.end + g_readvMaxGap &&
+          objectExtent(file, last.offset) == objectExtent(file, newEnd-1)) {
+        last.end = newEnd;
+        segRange[*it] = ranges.size()-1;
+        continue;
+      }
+    }
+    ReadVRange range = {beg, end};
+    ranges.push_back(range);
+    segRange[*it] = ranges.size()-1;
+  }
+  // start all reads and only then wait for them
+  int rc = 0;
+  unsigned int nbStarted = 0;
+  for (; nbStarted < ranges.size(); nbStarted++) {
+    rc = reader.start(ranges[nbStarted].end - ranges[nbStarted].offset,
+                      ranges[nbStarted].offset);
+    if (rc < 0) break;
+  }
+  std::vector<ssize_t> results(nbStarted);
+  for (unsigned int i = 0; i < nbStarted; i++) {
+    results[i] = reader.wait(i);
+  }
+  if (rc < 0) return rc;
+  // dispatch the data, a short read is an error as for any other readv
+  ssize_t nbBytes = 0;
+  for (int i = 0; i < n; i++) {
+    if (0 == readV[i].size) continue;
+    unsigned int r = segRange[i];
+    if (results[r] < 0) return results[r];
+    unsigned long long pos = readV[i].offset - ranges[r].offset;
+    if ((unsigned long long)results[r] < pos + readV[i].size) return -ESPIPE;
+    reader.copy(r, pos, readV[i].size, readV[i].data);
+    nbBytes += readV[i].size;
+  }
+  return nbBytes;
+}
+
+ssize_t ceph_posix_readv(int fd, XrdOucIOVec *readV, int n) {
+  CephFileRefGuard fr(fd);
+  if (fr) {
+    logwrapper((char*)"ceph_readv: for fd %d, n=%d", fd, n);
+    if ((fr->flags & (O_WRONLY|O_RDWR)) != 0) {
+      return -EBADF;
+    }
+    libradosstriper::RadosStriper *striper = getRadosStriper(*fr);
+    if (0 == striper) {
+      return -EINVAL;
+    }
+    RadosAioReader reader(striper, fr->name);
+    return ceph_posix_internal_readv(reader, *fr, readV, n);
+  } else {
+    return -EBADF;
+  }
+}
+
 int ceph_posix_fstat(int fd, struct stat *buf) {
-  CephFileRef* fr = getFileRef(fd);
+  CephFileRefGuard fr(fd);
   if (fr) {
     logwrapper((char*)"ceph_stat: fd %d", fd);
     // minimal stat : only size and times are filled
@@ -854,7 +1106,7 @@ int ceph_posix_stat(XrdOucEnv* env, const char *pathname, struct stat *buf) {
 }
 
 int ceph_posix_fsync(int fd) {
-  CephFileRef* fr = getFileRef(fd);
+  CephFileRefGuard fr(fd);
   if (fr) {
     logwrapper((char*)"ceph_sync: fd %d", fd);
     return 0;
@@ -864,7 +1116,7 @@ int ceph_posix_fsync(int fd) {
 }
 
 int ceph_posix_fcntl(int fd, int cmd, ... /* arg */ ) {
-  CephFileRef* fr = getFileRef(fd);
+  CephFileRefGuard fr(fd);
   if (fr) {
     logwrapper((char*)"ceph_fcntl: fd %d cmd=%d", fd, cmd);
     // minimal implementation
@@ -902,7 +1154,7 @@ ssize_t ceph_posix_getxattr(XrdOucEnv* env, const char* path,
 
 ssize_t ceph_posix_fgetxattr(int fd, const char* name,
                              void* value, size_t size) {
-  CephFileRef* fr = getFileRef(fd);
+  CephFileRefGuard fr(fd);
   if (fr) {
     logwrapper((char*)"ceph_fgetxattr: fd %d name=%s", fd, name);
     return ceph_posix_internal_getxattr(*fr, name, value, size);
@@ -936,7 +1188,7 @@ ssize_t ceph_posix_setxattr(XrdOucEnv* env, const char* path,
 int ceph_posix_fsetxattr(int fd,
                          const char* name, const void* value,
                          size_t size, int flags)  {
-  CephFileRef* fr = getFileRef(fd);
+  CephFileRefGuard fr(fd);
   if (fr) {
     logwrapper((char*)"ceph_fsetxattr: fd %d name=%s value=%s", fd, name, value);
     return ceph_posix_internal_setxattr(*fr, name, value, size, flags);
@@ -964,7 +1216,7 @@ int ceph_posix_removexattr(XrdOucEnv* env, const char* path,
 }
 
 int ceph_posix_fremovexattr(int fd, const char* name) {
-  CephFileRef* fr = getFileRef(fd);
+  CephFileRefGuard fr(fd);
   if (fr) {
     logwrapper((char*)"ceph_fremovexattr: fd %d name=%s", fd, name);
     return ceph_posix_internal_removexattr(*fr, name);
@@ -1013,7 +1265,7 @@ int ceph_posix_listxattrs(XrdOucEnv* env, const char* path, XrdSysXAttr::AList *
 }
 
 int ceph_posix_flistxattrs(int fd, XrdSysXAttr::AList **aPL, int getSz) {
-  CephFileRef* fr = getFileRef(fd);
+  CephFileRefGuard fr(fd);
   if (fr) {
     logwrapper((char*)"ceph_flistxattrs: fd %d", fd);
     return ceph_posix_internal_listxattrs(*fr, aPL, getSz);
@@ -1051,7 +1303,7 @@ static int ceph_posix_internal_truncate(const CephFile &file, unsigned long long
 }
 
 int ceph_posix_ftruncate(int fd, unsigned long long size) {
-  CephFileRef* fr = getFileRef(fd);
+  CephFileRefGuard fr(fd);
   if (fr) {
     logwrapper((char*)"ceph_posix_ftruncate: fd %d, size %d", fd, size);
     return ceph_posix_internal_truncate(*fr, size);
@@ -33,11 +33,25 @@
 #include <stdarg.h>
 #include <dirent.h>
 #include <XrdOuc/XrdOucEnv.hh>
+#include <XrdOuc/XrdOucIOVec.hh>
 #include <XrdSys/XrdSysXAttr.hh>
 
 class XrdSfsAio;
 typedef void(AioCB)(XrdSfsAio*, size_t);
 
+/// interface to the asynchronous object store reads issued by ceph_posix_readv
+/// reads are identified by the order in which they were started, starting at 0
+class CephAioReader {
+public:
+  virtual ~CephAioReader() {}
+  /// starts reading count bytes at the given offset, returns 0 or -errno
+  virtual int start(size_t count, off64_t offset) = 0;
+  /// waits for the given read to complete, returns bytes read or -errno
+  virtual ssize_t wait(unsigned int idx) = 0;
+  /// copies len bytes found at pos in the data of the given read into buf
+  virtual void copy(unsigned int idx, size_t pos, size_t len, char *buf) = 0;
+};
+
 void ceph_posix_set_defaults(const char* value);
 void ceph_posix_disconnect_all();
 void ceph_posix_set_logfunc(void (*logfunc) (char *, va_list argp));
@@ -51,6 +65,7 @@ ssize_t ceph_aio_write(int fd, XrdSfsAio *aiop, AioCB *cb);
 ssize_t ceph_posix_read(int fd, void *buf, size_t count);
 ssize_t ceph_posix_pread(int fd, void *buf, size_t count, off64_t offset);
 ssize_t ceph_aio_read(int fd, XrdSfsAio *aiop, AioCB *cb);
+ssize_t ceph_posix_readv(int fd, XrdOucIOVec *readV, int n);
 int ceph_posix_fstat(int fd, struct stat *buf);
 int ceph_posix_stat(XrdOucEnv* env, const char *pathname, struct stat *buf);
 int ceph_posix_fsync(int fd);
@@ -0,0 +1,150 @@
+/******************************************************************************/
+/*                                                                            */
+/*                    X r d C k s C a l c M u l t i . c c                     */
+/*                                                                            */
+/* (c) 2018 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include "XrdCks/XrdCksCalcMulti.hh"
+
+/******************************************************************************/
+/*                         L o c a l   D e f i n e s                          */
+/******************************************************************************/
+
+// Segments smaller than this are not worth handing to other threads
+//
+#define XRDCKS_MINPAR 1048576
+
+/******************************************************************************/
+/*                            D e s t r u c t o r                             */
+/******************************************************************************/
+
+XrdCksCalcMulti::~XrdCksCalcMulti()
+{
+   int i;
+
+// Stop all of the threads
+//
+   isEnding = true;
+   for (i = 1; i < csNum; i++)
+       if (csWork[i].isThread) csWork[i].goSem.Post();
+   for (i = 1; i < csNum; i++)
+       if (csWork[i].isThread) XrdSysThread::Join(csWork[i].tid, 0);
+
+// Recycle the checksum objects
+//
+   for (i = 0; i < csNum; i++) csWork[i].Obj->Recycle();
+}
+
+/******************************************************************************/
+/*                                   A d d                                    */
+/******************************************************************************/
+  
+bool XrdCksCalcMulti::Add(XrdCksCalc *csP)
+{
+   if (csNum >= csMax || isRunning) return false;
+   csWork[csNum].Parent = this;
+   csWork[csNum].Obj    = csP;
+   csNum++;
+   return true;
+}
+
+/******************************************************************************/
+/*                                  I n i t                                   */
+/******************************************************************************/
+  
+void XrdCksCalcMulti::Init()
+{
+   for (int i = 0; i < csNum; i++) csWork[i].Obj->Init();
+}
+
+/******************************************************************************/
+/*                                  T y p e                                   */
+/******************************************************************************/
+  
+const char *XrdCksCalcMulti::Type(int &csSize)
+{
+   if (csNum) return csWork[0].Obj->Type(csSize);
+   csSize = 0;
+   return "";
+}
+
+/******************************************************************************/
+/*                                U p d a t e                                 */
+/******************************************************************************/
+  
+void XrdCksCalcMulti::Update(const char *Buff, int BLen)
+{
+   int i, numWait = 0;
+
+// Small segments or a single algorithm are simply done inline
+//
+   if (csNum < 2 || BLen < XRDCKS_MINPAR)
+      {for (i = 0; i < csNum; i++) csWork[i].Obj->Update(Buff, BLen);
+       return;
+      }
+
+// Start the helper threads the first time around. Should we fail to start a
+// thread, that algorithm will be computed inline.
+//
+   if (!isRunning)
+      {isRunning = true;
+       for (i = 1; i < csNum; i++)
+           csWork[i].isThread = !XrdSysThread::Run(&csWork[i].tid,
+                                 XrdCksCalcMulti::Work, (void *)&csWork[i],
+                                 XRDSYSTHREAD_HOLD, "cks calc");
+      }
+
+// Hand the segment to each thread and do the rest ourselves
+//
+   uBuff = Buff; uLen = BLen;
+   for (i = 1; i < csNum; i++)
+       if (csWork[i].isThread) {csWork[i].goSem.Post(); numWait++;}
+   for (i = 0; i < csNum; i++)
+       if (!csWork[i].isThread) csWork[i].Obj->Update(Buff, BLen);
+
+// Wait for all of the threads to finish with the segment
+//
+   while(numWait--) doneSem.Wait();
+}
+
+/******************************************************************************/
+/* Private:                         W o r k                                   */
+/******************************************************************************/
+  
+void *XrdCksCalcMulti::Work(void *wP)
+{
+   Worker *myWork = (Worker *)wP;
+   XrdCksCalcMulti *Parent = myWork->Parent;
+
+   while(1)
+        {myWork->goSem.Wait();
+         if (Parent->isEnding) break;
+         myWork->Obj->Update(Parent->uBuff, Parent->uLen);
+         Parent->doneSem.Post();
+        }
+   return 0;
+}
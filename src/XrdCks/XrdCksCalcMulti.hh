@@ -0,0 +1,93 @@
+#ifndef __XRDCKSCALCMULTI_HH__
+#define __XRDCKSCALCMULTI_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                    X r d C k s C a l c M u l t i . h h                     */
+/*                                                                            */
+/* (c) 2018 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include "XrdCks/XrdCksCalc.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+/* This class computes several checksums over the same data. It is handed to
+   code that expects a single XrdCksCalc object. Large segments are handed to
+   one thread per additional algorithm so that all of them are computed in the
+   time it takes to compute the slowest one. Final() and Type() refer to the
+   first object; use Object() to get at the others.
+*/
+  
+class XrdCksCalcMulti : public XrdCksCalc
+{
+public:
+
+bool        Add(XrdCksCalc *csP);
+
+int         Count() {return csNum;}
+
+char       *Final() {return (csNum ? csWork[0].Obj->Final() : 0);}
+
+void        Init();
+
+XrdCksCalc *New() {return 0;}
+
+XrdCksCalc *Object(int i) {return (i >= 0 && i < csNum ? csWork[i].Obj : 0);}
+
+void        Recycle() {}
+
+const char *Type(int &csSize);
+
+void        Update(const char *Buff, int BLen);
+
+            XrdCksCalcMulti() : doneSem(0), uBuff(0), uLen(0), csNum(0),
+                                isRunning(false), isEnding(false) {}
+virtual    ~XrdCksCalcMulti();
+
+static const int csMax = 8;
+
+private:
+
+struct Worker
+      {XrdCksCalcMulti *Parent;
+       XrdCksCalc      *Obj;
+       XrdSysSemaphore  goSem;
+       pthread_t        tid;
+       bool             isThread;
+                        Worker() : Parent(0), Obj(0), goSem(0),
+                                   isThread(false) {}
+      };
+
+static void     *Work(void *wP);
+
+XrdSysSemaphore  doneSem;
+const char      *uBuff;
+int              uLen;
+int              csNum;
+bool             isRunning;
+bool             isEnding;
+Worker           csWork[csMax];
+};
+#endif
@@ -162,6 +162,25 @@ int XrdCksManOss::Calc(const char *Pfn, time_t &MTime, XrdCksCalc *csP)
    return (rc < 0 ? rc : 0);
 }
 
+/******************************************************************************/
+/*                              C a l c M a n y                               */
+/******************************************************************************/
+  
+int XrdCksManOss::CalcMany(const char *Lfn, XrdCksData *Cks, int csNum,
+                           int doSet)
+{
+   int rc;
+   LfnPfn Xfn(Lfn, rc);
+
+// If lfn conversion failed, bail out
+//
+   if (rc) return rc;
+
+// Return the result
+//
+   return XrdCksManager::CalcMany(Xfn.Pfn, Cks, csNum, doSet);
+}
+
 /******************************************************************************/
 /*                                   D e l                                    */
 /******************************************************************************/
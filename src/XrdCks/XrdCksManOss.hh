@@ -45,6 +45,9 @@ class XrdCksManOss : public XrdCksManager
 public:
 virtual int         Calc(const char *Lfn, XrdCksData &Cks, int doSet=1);
 
+virtual int         CalcMany(const char *Lfn, XrdCksData *Cks, int csNum,
+                             int doSet=1);
+
 virtual int         Del( const char *Lfn, XrdCksData &Cks);
 
 virtual int         Get( const char *Lfn, XrdCksData &Cks);
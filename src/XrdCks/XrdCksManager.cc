@@ -42,6 +42,7 @@
 #include "XrdCks/XrdCksCalcadler32.hh"
 #include "XrdCks/XrdCksCalccrc32.hh"
 #include "XrdCks/XrdCksCalcmd5.hh"
+#include "XrdCks/XrdCksCalcMulti.hh"
 #include "XrdCks/XrdCksLoader.hh"
 #include "XrdCks/XrdCksManager.hh"
 #include "XrdCks/XrdCksXAttr.hh"
@@ -96,6 +97,48 @@ XrdCksManager::~XrdCksManager()
    if (cksLoader) delete cksLoader;
 }
 
+/******************************************************************************/
+/*                          c s B a t c h I n f o                             */
+/******************************************************************************/
+
+struct XrdCksManager::csBatchInfo
+      {XrdCksManager *Mgr;
+       csBatch       *Batch;
+       XrdSysMutex    bMutex;
+       int            bNum;
+       int            bNext;
+       int            numBad;
+       int            doSet;
+      };
+
+/******************************************************************************/
+/* Private:                    B a t c h W o r k                              */
+/******************************************************************************/
+
+// Each batch thread takes the next file to be checksummed until none are left
+  
+void *XrdCksManager::BatchWork(void *bP)
+{
+   csBatchInfo *bInfo = (csBatchInfo *)bP;
+   csBatch *bItem;
+   int bNum, rc;
+
+   while(1)
+        {bInfo->bMutex.Lock();
+         if ((bNum = bInfo->bNext) >= bInfo->bNum)
+            {bInfo->bMutex.UnLock(); break;}
+         bInfo->bNext++;
+         bInfo->bMutex.UnLock();
+
+         bItem = &(bInfo->Batch[bNum]);
+         rc = bInfo->Mgr->CalcMany(bItem->Pfn, bItem->Cks, bItem->csNum,
+                                   bInfo->doSet);
+         bItem->Result = rc;
+         if (rc) {bInfo->bMutex.Lock(); bInfo->numBad++; bInfo->bMutex.UnLock();}
+        }
+   return 0;
+}
+
 /******************************************************************************/
 /*                                  C a l c                                   */
 /******************************************************************************/
@@ -167,7 +210,8 @@ int XrdCksManager::Calc(const char *Pfn, time_t &MTime, XrdCksCalc *csP)
    calcSize = fileSize = Stat.st_size;
    MTime = Stat.st_mtime;
 
-// We now compute checksum 64MB at a time using mmap I/O
+// We now compute checksum 64MB at a time using mmap I/O. We ask that the next
+// segment be read in while we are computing the checksum of the current one.
 //
    ioSize = (fileSize < (off_t)segSize ? fileSize : segSize); rc = 0;
    while(calcSize)
@@ -175,6 +219,10 @@ int XrdCksManager::Calc(const char *Pfn, time_t &MTime, XrdCksCalc *csP)
                        MAP_NORESERVE|MAP_PRIVATE, In.FD, Offset)) == MAP_FAILED)
             {rc = errno; eDest->Emsg("Cks", rc, "memory map", Pfn); break;}
          madvise(inBuff, ioSize, MADV_SEQUENTIAL);
+#ifdef POSIX_FADV_WILLNEED
+         if (calcSize > ioSize)
+            posix_fadvise(In.FD, Offset+ioSize, segSize, POSIX_FADV_WILLNEED);
+#endif
          csP->Update(inBuff, ioSize);
          calcSize -= ioSize; Offset += ioSize;
          if (munmap(inBuff, ioSize) < 0)
@@ -188,6 +236,97 @@ int XrdCksManager::Calc(const char *Pfn, time_t &MTime, XrdCksCalc *csP)
    return 0;
 }
 
+/******************************************************************************/
+/*                             C a l c B a t c h                              */
+/******************************************************************************/
+  
+int XrdCksManager::CalcBatch(csBatch *Batch, int bNum, int maxIO, int doSet)
+{
+   static const int maxThreads = 64;
+   csBatchInfo bInfo;
+   pthread_t tid[maxThreads];
+   int i, numThreads = 0;
+
+// Set up the batch
+//
+   bInfo.Mgr    = this;
+   bInfo.Batch  = Batch;
+   bInfo.bNum   = bNum;
+   bInfo.bNext  = 0;
+   bInfo.numBad = 0;
+   bInfo.doSet  = doSet;
+
+// Determine how many files we will read at once. We are one of the readers.
+//
+   if (maxIO <= 0) maxIO = 4;
+      else if (maxIO > maxThreads) maxIO = maxThreads;
+   if (maxIO > bNum) maxIO = bNum;
+
+// Start the additional readers. If we can't start any, we do it all ourselves.
+//
+   for (i = 1; i < maxIO; i++)
+       {if (XrdSysThread::Run(&tid[numThreads], XrdCksManager::BatchWork,
+                              (void *)&bInfo, XRDSYSTHREAD_HOLD, "cks batch"))
+           {eDest->Emsg("Cks", errno, "start checksum batch thread"); break;}
+        numThreads++;
+       }
+   BatchWork((void *)&bInfo);
+
+// Wait for all of the readers to finish
+//
+   for (i = 0; i < numThreads; i++) XrdSysThread::Join(tid[i], 0);
+   return bInfo.numBad;
+}
+
+/******************************************************************************/
+/*                              C a l c M a n y                               */
+/******************************************************************************/
+  
+int XrdCksManager::CalcMany(const char *Pfn, XrdCksData *Cks, int csNum,
+                            int doSet)
+{
+   XrdCksCalcMulti csMulti;
+   XrdCksCalc *csP;
+   csInfo *csIP;
+   time_t MTime;
+   int i, rc;
+
+// Determine which checksums to compute and get an object for each
+//
+   if (csLast < 0) return -ENOTSUP;
+   if (csNum <= 0 || csNum > XrdCksCalcMulti::csMax) return -EINVAL;
+   for (i = 0; i < csNum; i++)
+       {csIP = &csTab[0];
+        if (!(*Cks[i].Name)) Cks[i].Set(csIP->Name);
+           else if (!(csIP = Find(Cks[i].Name))) return -ENOTSUP;
+        if (!(csP = csIP->Obj->New())) return -ENOMEM;
+        csMulti.Add(csP);
+       }
+
+// Compute all of the checksums reading the file once
+//
+   if ((rc = Calc(Pfn, MTime, &csMulti))) return rc;
+
+// Return the results and set them if so wanted
+//
+   for (i = 0; i < csNum; i++)
+       {csP = csMulti.Object(i);
+        Cks[i].Length = static_cast<char>(Size(Cks[i].Name));
+        memcpy(Cks[i].Value, csP->Final(), Cks[i].Length);
+        Cks[i].fmTime = static_cast<long long>(MTime);
+        Cks[i].csTime = static_cast<int>(time(0) - MTime);
+        if (doSet)
+           {XrdOucXAttr<XrdCksXAttr> xCS;
+            memcpy(&xCS.Attr.Cks, &Cks[i], sizeof(xCS.Attr.Cks));
+            if ((rc = xCS.Set(Pfn))) return -rc;
+           }
+       }
+
+// All done
+//
+   return 0;
+}
+
 /******************************************************************************/
 /*                                C o n f i g                                 */
 /******************************************************************************/
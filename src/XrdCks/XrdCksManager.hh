@@ -50,6 +50,31 @@ class XrdCksManager : public XrdCks
 public:
 virtual int         Calc( const char *Pfn, XrdCksData &Cks, int doSet=1);
 
+/* CalcMany() calculates several checksums of a physical file while reading
+              the file only once. Cks is an array of csNum (at most 8) objects
+              naming the algorithms; upon success, each holds its checksum.
+              When doSet is true, each checksum is recorded in the file's
+              extended attributes. Returns 0 upon success or -errno. As
+              with Calc(), the oss based manager takes a logical file name.
+*/
+virtual int         CalcMany(const char *Pfn, XrdCksData *Cks, int csNum,
+                             int doSet=1);
+
+/* CalcBatch() calculates checksums for many files with up to maxIO files
+               being read at the same time (the default is 4). Each element
+               of Batch is handled as by CalcMany() and its Result is set to
+               its return value. Returns the number of elements that failed.
+*/
+struct csBatch
+      {const char *Pfn;     // In:  Physical file name
+       XrdCksData *Cks;     // I/O: Checksums to calculate
+       int         csNum;   // In:  Number of elements in Cks
+       int         Result;  // Out: 0 or -errno
+      };
+
+        int         CalcBatch(csBatch *Batch, int bNum, int maxIO=0,
+                              int doSet=1);
+
 virtual int         Config(const char *Token, char *Line);
 
 virtual int         Del(  const char *Pfn, XrdCksData &Cks);
@@ -103,6 +128,10 @@ struct csInfo
                                 {memset(Name, 0, sizeof(Name));}
       };
 
+struct  csBatchInfo;
+
+static
+void   *BatchWork(void *bP);
 int     Config(const char *cFN, csInfo &Info);
 csInfo *Find(const char *Name);
 
@@ -52,6 +52,8 @@ namespace XrdCl
   const int DefaultRunForkHandler       = 0;
   const int DefaultRedirectLimit        = 16;
   const int DefaultWorkerThreads        = 3;
+  const int DefaultMaxWorkerThreads     = 16;
+  const int DefaultWorkerLatency        = 1000;
   const int DefaultCPChunkSize          = 16777216;
   const int DefaultCPParallelChunks     = 4;
   const int DefaultDataServerTTL        = 300;
@@ -66,6 +68,7 @@ namespace XrdCl
   const int DefaultParallelEvtLoop      = 1;
   const int DefaultMetalinkProcessing   = 1;
   const int DefaultLocalMetalinkFile    = 1;
+  const int DefaultLocalFdRead          = 1;
 
   const char * const DefaultPollerPreference   = "built-in";
   const char * const DefaultNetworkStack       = "IPAuto";
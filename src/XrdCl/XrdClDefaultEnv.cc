@@ -272,6 +272,8 @@ namespace XrdCl
     REGISTER_VAR_INT( varsInt, "RunForkHandler",       DefaultRunForkHandler       );
     REGISTER_VAR_INT( varsInt, "RedirectLimit",        DefaultRedirectLimit        );
     REGISTER_VAR_INT( varsInt, "WorkerThreads",        DefaultWorkerThreads        );
+    REGISTER_VAR_INT( varsInt, "MaxWorkerThreads",     DefaultMaxWorkerThreads     );
+    REGISTER_VAR_INT( varsInt, "WorkerLatency",        DefaultWorkerLatency        );
     REGISTER_VAR_INT( varsInt, "CPChunkSize",          DefaultCPChunkSize          );
     REGISTER_VAR_INT( varsInt, "CPParallelChunks",     DefaultCPParallelChunks     );
     REGISTER_VAR_INT( varsInt, "DataServerTTL",        DefaultDataServerTTL        );
@@ -286,6 +288,7 @@ namespace XrdCl
     REGISTER_VAR_INT( varsInt, "ParallelEvtLoop",      DefaultParallelEvtLoop      );
     REGISTER_VAR_INT( varsInt, "MetalinkProcessing",   DefaultMetalinkProcessing   );
     REGISTER_VAR_INT( varsInt, "LocalMetalinkFile",    DefaultLocalMetalinkFile    );
+    REGISTER_VAR_INT( varsInt, "LocalFdRead",          DefaultLocalFdRead          );
 
     REGISTER_VAR_STR( varsStr, "PollerPreference",     DefaultPollerPreference     );
     REGISTER_VAR_STR( varsStr, "ClientMonitor",        DefaultClientMonitor        );
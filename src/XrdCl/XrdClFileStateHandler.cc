@@ -30,6 +30,7 @@
 #include "XrdCl/XrdClForkHandler.hh"
 #include "XrdCl/XrdClConstants.hh"
 #include "XrdCl/XrdClMessageUtils.hh"
+#include "XrdCl/XrdClPostMaster.hh"
 #include "XrdCl/XrdClXRootDTransport.hh"
 #include "XrdCl/XrdClXRootDResponses.hh"
 #include "XrdCl/XrdClMonitor.hh"
@@ -37,14 +38,145 @@
 #include "XrdCl/XrdClResponseJob.hh"
 #include "XrdCl/XrdClJobManager.hh"
 #include "XrdCl/XrdClUglyHacks.hh"
+#include "XrdCl/XrdClUtils.hh"
 #include "XrdClRedirectorRegistry.hh"
+#include "XrdNet/XrdNetAddr.hh"
+#include "XrdNet/XrdNetUtils.hh"
 
 #include <sstream>
 #include <memory>
 #include <sys/time.h>
+#include <sys/types.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
 
 namespace
 {
+  //----------------------------------------------------------------------------
+  // Check if the url refers to a server running on this host
+  //----------------------------------------------------------------------------
+  bool IsLocalHost( const XrdCl::URL &url )
+  {
+    static char *myName = XrdNetUtils::MyHostName( 0 );
+    XrdNetAddr   addr;
+
+    if( !addr.Set( url.GetHostName().c_str(), url.GetPort() ) &&
+        addr.isLoopback() )
+      return true;
+
+    return myName && url.GetHostName() == myName;
+  }
+
+  //----------------------------------------------------------------------------
+  // Milliseconds we are willing to wait for the server to pass the descriptor
+  //----------------------------------------------------------------------------
+  const int LocalFdTimeout = 500;
+
+  //----------------------------------------------------------------------------
+  // Job picking up the local descriptor offered by the server and notifying
+  // the user about the open, the pick up involves waiting for the server so
+  // it is not done in the response handler
+  //----------------------------------------------------------------------------
+  class LocalFdJob: public XrdCl::Job
+  {
+    public:
+      //------------------------------------------------------------------------
+      // Constructor
+      //------------------------------------------------------------------------
+      LocalFdJob( XrdCl::FileStateHandler *stateHandler,
+                  const std::string       &offer,
+                  XrdCl::ResponseHandler  *userHandler,
+                  XrdCl::XRootDStatus     *openStatus,
+                  XrdCl::HostList         *hostList ):
+        pStateHandler( stateHandler ),
+        pOffer( offer ),
+        pUserHandler( userHandler ),
+        pOpenStatus( openStatus ),
+        pHostList( hostList )
+      {
+      }
+
+      //------------------------------------------------------------------------
+      // Fetch the descriptor and call the user handler
+      //------------------------------------------------------------------------
+      virtual void Run( void *arg )
+      {
+        pStateHandler->OnLocalFd( pOffer );
+        pUserHandler->HandleResponseWithHosts( pOpenStatus, 0, pHostList );
+        delete this;
+      }
+
+    private:
+      XrdCl::FileStateHandler *pStateHandler;
+      std::string              pOffer;
+      XrdCl::ResponseHandler  *pUserHandler;
+      XrdCl::XRootDStatus     *pOpenStatus;
+      XrdCl::HostList         *pHostList;
+  };
+
+  //----------------------------------------------------------------------------
+  // Object that receives the local descriptor offer for a freshly opened file
+  // and then notifies the user about the open
+  //----------------------------------------------------------------------------
+  class LocalFdHandler: public XrdCl::ResponseHandler
+  {
+    public:
+      //------------------------------------------------------------------------
+      // Constructor
+      //------------------------------------------------------------------------
+      LocalFdHandler( XrdCl::FileStateHandler *stateHandler,
+                      XrdCl::ResponseHandler  *userHandler,
+                      XrdCl::XRootDStatus     *openStatus,
+                      XrdCl::HostList         *hostList ):
+        pStateHandler( stateHandler ),
+        pUserHandler( userHandler ),
+        pOpenStatus( openStatus ),
+        pHostList( hostList )
+      {
+      }
+
+      //------------------------------------------------------------------------
+      // Handle the response
+      //------------------------------------------------------------------------
+      virtual void HandleResponse( XrdCl::XRootDStatus *status,
+                                   XrdCl::AnyObject    *response )
+      {
+        using namespace XrdCl;
+
+        //----------------------------------------------------------------------
+        // Servers not willing to pass the descriptor are simply used as usual
+        //----------------------------------------------------------------------
+        Buffer *buffer = 0;
+        if( status->IsOK() && response )
+          response->Get( buffer );
+
+        if( buffer )
+        {
+          JobManager *jobMan = DefaultEnv::GetPostMaster()->GetJobManager();
+          jobMan->QueueJob( new LocalFdJob( pStateHandler, buffer->ToString(),
+                                            pUserHandler, pOpenStatus,
+                                            pHostList ) );
+        }
+        else
+        {
+          Log *log = DefaultEnv::GetLog();
+          log->Debug( FileMsg, "[0x%x] No local descriptor: %s", pStateHandler,
+                      status->ToStr().c_str() );
+          pUserHandler->HandleResponseWithHosts( pOpenStatus, 0, pHostList );
+        }
+        delete status;
+        delete response;
+        delete this;
+      }
+
+    private:
+      XrdCl::FileStateHandler *pStateHandler;
+      XrdCl::ResponseHandler  *pUserHandler;
+      XrdCl::XRootDStatus     *pOpenStatus;
+      XrdCl::HostList         *pHostList;
+  };
+
   //----------------------------------------------------------------------------
   // Object that does things to the FileStateHandler when kXR_open returns
   // and then calls the user handler
@@ -83,6 +215,24 @@ namespace
         //----------------------------------------------------------------------
         pStateHandler->OnOpen( status, openInfo, hostList );
         delete response;
+
+        //----------------------------------------------------------------------
+        // If the server is on this host it may give us the descriptor of the
+        // file, the user is notified once we know
+        //----------------------------------------------------------------------
+        if( pUserHandler && status->IsOK() )
+        {
+          LocalFdHandler *fdHandler = new LocalFdHandler( pStateHandler,
+                                                          pUserHandler,
+                                                          status, hostList );
+          if( pStateHandler->RequestLocalFd( fdHandler ).IsOK() )
+          {
+            delete this;
+            return;
+          }
+          delete fdHandler;
+        }
+
         if( pUserHandler )
           pUserHandler->HandleResponseWithHosts( status, 0, hostList );
         else
@@ -322,6 +472,8 @@ namespace XrdCl
     pStatInfo( 0 ),
     pFileUrl( 0 ),
     pDataServer( 0 ),
+    pDataServerChannel( 0 ),
+    pDataServerChannelGen( 0 ),
     pLoadBalancer( 0 ),
     pStateRedirect( 0 ),
     pFileHandle( 0 ),
@@ -332,6 +484,8 @@ namespace XrdCl
     pDoRecoverWrite( true ),
     pFollowRedirects( true ),
     pUseVirtRedirector( true ),
+    pLocalFd( -1 ),
+    pLocalReads( 0 ),
     pReOpenHandler( 0 )
   {
     pFileHandle = new uint8_t[4];
@@ -351,6 +505,8 @@ namespace XrdCl
     pStatInfo( 0 ),
     pFileUrl( 0 ),
     pDataServer( 0 ),
+    pDataServerChannel( 0 ),
+    pDataServerChannelGen( 0 ),
     pLoadBalancer( 0 ),
     pStateRedirect( 0 ),
     pFileHandle( 0 ),
@@ -361,6 +517,8 @@ namespace XrdCl
     pDoRecoverWrite( true ),
     pFollowRedirects( true ),
     pUseVirtRedirector( useVirtRedirector ),
+    pLocalFd( -1 ),
+    pLocalReads( 0 ),
     pReOpenHandler( 0 )
   {
     pFileHandle = new uint8_t[4];
@@ -398,6 +556,9 @@ namespace XrdCl
       registry.Release( *pFileUrl );
     }
 
+    if( pLocalFd >= 0 )
+      close( pLocalFd );
+
     delete pStatInfo;
     delete pFileUrl;
     delete pDataServer;
@@ -549,11 +710,17 @@ namespace XrdCl
       return XRootDStatus( stError, errInProgress );
 
     if( pFileState == OpenInProgress || pFileState == Closed ||
-        pFileState == Recovering || !pInTheFly.empty() )
+        pFileState == Recovering || !pInTheFly.empty() || pLocalReads )
       return XRootDStatus( stError, errInvalidOp );
 
     pFileState = CloseInProgress;
 
+    if( pLocalFd >= 0 )
+    {
+      close( pLocalFd );
+      pLocalFd = -1;
+    }
+
     Log *log = DefaultEnv::GetLog();
     log->Debug( FileMsg, "[0x%x@%s] Sending a close command for handle 0x%x to "
                 "%s", this, pFileUrl->GetURL().c_str(),
@@ -663,6 +830,14 @@ namespace XrdCl
     if( pFileState != Opened && pFileState != Recovering )
       return XRootDStatus( stError, errInvalidOp );
 
+    if( pLocalFd >= 0 )
+    {
+      int fd = pLocalFd;
+      ++pLocalReads;
+      scopedLock.UnLock();
+      return ReadLocal( fd, offset, size, buffer, handler );
+    }
+
     Log *log = DefaultEnv::GetLog();
     log->Debug( FileMsg, "[0x%x@%s] Sending a read command for handle 0x%x to "
                 "%s", this, pFileUrl->GetURL().c_str(),
@@ -822,6 +997,14 @@ namespace XrdCl
     if( pFileState != Opened && pFileState != Recovering )
       return XRootDStatus( stError, errInvalidOp );
 
+    if( pLocalFd >= 0 )
+    {
+      int fd = pLocalFd;
+      ++pLocalReads;
+      scopedLock.UnLock();
+      return VectorReadLocal( fd, chunks, buffer, handler );
+    }
+
     Log *log = DefaultEnv::GetLog();
     log->Debug( FileMsg, "[0x%x@%s] Sending a vector read command for handle "
                 "0x%x to %s", this, pFileUrl->GetURL().c_str(),
@@ -1044,7 +1227,8 @@ namespace XrdCl
     {
       delete pDataServer;
       delete pLoadBalancer;
-      pLoadBalancer = 0;
+      pLoadBalancer      = 0;
+      pDataServerChannel = 0;
 
       pDataServer = new URL( hostList->back().url );
       pDataServer->SetParams( pFileUrl->GetParams() );
@@ -1141,6 +1325,72 @@ namespace XrdCl
     }
   }
 
+  //----------------------------------------------------------------------------
+  // Ask the data server for the descriptor of the file
+  //----------------------------------------------------------------------------
+  XRootDStatus FileStateHandler::RequestLocalFd( ResponseHandler *handler )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+
+    int localFdRead = DefaultLocalFdRead;
+    DefaultEnv::GetEnv()->GetInt( "LocalFdRead", localFdRead );
+
+    if( !localFdRead || pFileState != Opened || pLocalFd >= 0 ||
+        !IsReadOnly() || !pDataServer || !IsLocalHost( *pDataServer ) )
+      return XRootDStatus( stError, errNotSupported );
+
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( FileMsg, "[0x%x@%s] Asking %s for the local descriptor of "
+                "handle 0x%x", this, pFileUrl->GetURL().c_str(),
+                pDataServer->GetHostId().c_str(), *((uint32_t*)pFileHandle) );
+
+    Message            *msg;
+    ClientQueryRequest *req;
+    MessageUtils::CreateRequest( msg, req );
+
+    req->requestid = kXR_query;
+    req->infotype  = kXR_Qlocfd;
+    memcpy( req->fhandle, pFileHandle, 4 );
+
+    MessageSendParams params;
+    params.followRedirects = false;
+    MessageUtils::ProcessSendParams( params );
+
+    XRootDTransport::SetDescription( msg );
+    Status st = MessageUtils::SendMessage( *pDataServer, msg, handler, params );
+    if( !st.IsOK() )
+      delete msg;
+    return st;
+  }
+
+  //----------------------------------------------------------------------------
+  // Pick up the descriptor offered by the data server
+  //----------------------------------------------------------------------------
+  void FileStateHandler::OnLocalFd( const std::string &offer )
+  {
+    Log *log = DefaultEnv::GetLog();
+    int  fd  = Utils::FetchLocalFd( offer, LocalFdTimeout );
+
+    XrdSysMutexHelper scopedLock( pMutex );
+
+    if( fd < 0 )
+    {
+      log->Debug( FileMsg, "[0x%x@%s] Unable to get the local descriptor: %s",
+                  this, pFileUrl->GetURL().c_str(), strerror( -fd ) );
+      return;
+    }
+
+    if( pFileState != Opened || pLocalFd >= 0 )
+    {
+      close( fd );
+      return;
+    }
+
+    log->Debug( FileMsg, "[0x%x@%s] Reading through local descriptor %d",
+                this, pFileUrl->GetURL().c_str(), fd );
+    pLocalFd = fd;
+  }
+
   //----------------------------------------------------------------------------
   // Process the results of the closing operation
   //----------------------------------------------------------------------------
@@ -1430,8 +1680,25 @@ namespace XrdCl
     //--------------------------------------------------------------------------
     if( pFileState == Opened )
     {
+      //------------------------------------------------------------------------
+      // Look up the data server's channel only once, unless the post master
+      // deleted the channels since (e.g. in the child after a fork)
+      //------------------------------------------------------------------------
+      PostMaster *postMaster = DefaultEnv::GetPostMaster();
+      if( postMaster )
+      {
+        uint64_t gen = postMaster->GetGeneration();
+        if( !pDataServerChannel || pDataServerChannelGen != gen )
+        {
+          pDataServerChannel    = postMaster->GetChannel( *pDataServer );
+          pDataServerChannelGen = gen;
+        }
+      }
+      else pDataServerChannel = 0;
+
       msg->SetSessionId( pSessionId );
-      Status st = MessageUtils::SendMessage( *pDataServer, msg, handler, sendParams );
+      Status st = MessageUtils::SendMessage( *pDataServer, msg, handler,
+                                             sendParams, pDataServerChannel );
 
       //------------------------------------------------------------------------
       // Invalid session id means that the connection has been broken while we
@@ -1565,6 +1832,112 @@ namespace XrdCl
     return MessageUtils::SendMessage( *pDataServer, msg, handler, params );
   }
 
+  //----------------------------------------------------------------------------
+  // Read from the local descriptor and call the handler
+  //----------------------------------------------------------------------------
+  XRootDStatus FileStateHandler::ReadLocal( int              fd,
+                                            uint64_t         offset,
+                                            uint32_t         size,
+                                            void            *buffer,
+                                            ResponseHandler *handler )
+  {
+    uint32_t done = 0;
+    ssize_t  rc   = 0;
+    while( done < size )
+    {
+      rc = pread( fd, (char*)buffer + done, size - done, offset + done );
+      if( rc < 0 && errno == EINTR ) continue;
+      if( rc <= 0 ) break;
+      done += rc;
+    }
+    int err = ( rc < 0 ? errno : 0 );
+
+    XrdSysMutexHelper scopedLock( pMutex );
+    --pLocalReads;
+    if( err )
+      return XRootDStatus( stError, errOSError, err );
+    ++pRCount;
+    pRBytes += done;
+    scopedLock.UnLock();
+
+    AnyObject *obj = new AnyObject();
+    obj->Set( new ChunkInfo( offset, done, buffer ) );
+    handler->HandleResponseWithHosts( new XRootDStatus(), obj,
+                                      new HostList() );
+    return XRootDStatus();
+  }
+
+  //----------------------------------------------------------------------------
+  // Vector read from the local descriptor and call the handler
+  //----------------------------------------------------------------------------
+  XRootDStatus FileStateHandler::VectorReadLocal( int              fd,
+                                                  const ChunkList &chunks,
+                                                  void            *buffer,
+                                                  ResponseHandler *handler )
+  {
+    XRDCL_SMART_PTR_T<VectorReadInfo> info( new VectorReadInfo() );
+    char     *cursor = (char*)buffer;
+    uint32_t  total  = 0;
+    int       err    = 0;
+
+    for( size_t i = 0; i < chunks.size() && !err; ++i )
+    {
+      char *chunkBuffer;
+      if( cursor )
+      {
+        chunkBuffer  = cursor;
+        cursor      += chunks[i].length;
+      }
+      else
+        chunkBuffer = (char*)chunks[i].buffer;
+
+      uint32_t done = 0;
+      while( done < chunks[i].length )
+      {
+        ssize_t rc = pread( fd, chunkBuffer + done, chunks[i].length - done,
+                            chunks[i].offset + done );
+        if( rc < 0 && errno == EINTR ) continue;
+        if( rc < 0 ) err = errno;
+        if( rc <= 0 ) break;
+        done += rc;
+      }
+
+      //------------------------------------------------------------------------
+      // A chunk running past the end of file fails the whole request, the
+      // same way the server fails such a readv
+      //------------------------------------------------------------------------
+      if( !err && done < chunks[i].length ) err = ENODATA;
+      info->GetChunks().push_back( ChunkInfo( chunks[i].offset, done,
+                                              chunkBuffer ) );
+      total += done;
+    }
+    info->SetSize( total );
+
+    XrdSysMutexHelper scopedLock( pMutex );
+    --pLocalReads;
+    if( err && err != ENODATA )
+      return XRootDStatus( stError, errOSError, err );
+    if( err )
+    {
+      scopedLock.UnLock();
+      handler->HandleResponseWithHosts( new XRootDStatus( stError,
+                                          errErrorResponse, kXR_FSError,
+                                          "readv past EOF" ), 0,
+                                        new HostList() );
+      return XRootDStatus();
+    }
+    ++pVCount;
+    pVBytes += total;
+    pVSegs  += chunks.size();
+    scopedLock.UnLock();
+
+    AnyObject *obj = new AnyObject();
+    obj->Set( info.release() );
+    handler->HandleResponseWithHosts( new XRootDStatus(), obj,
+                                      new HostList() );
+    return XRootDStatus();
+  }
+
   //----------------------------------------------------------------------------
   // Re-open the current file at a given server
   //----------------------------------------------------------------------------
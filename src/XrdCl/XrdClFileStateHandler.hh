@@ -234,6 +234,22 @@ namespace XrdCl
                    const OpenInfo     *openInfo,
                    const HostList     *hostList );
 
+      //------------------------------------------------------------------------
+      //! Ask the data server for the descriptor of the file if it runs on
+      //! this host and the file is open for reading
+      //!
+      //! @param handler handler to be notified when the response arrives
+      //! @return        status of the operation, an error if the descriptor
+      //!                should not be asked for
+      //------------------------------------------------------------------------
+      XRootDStatus RequestLocalFd( ResponseHandler *handler );
+
+      //------------------------------------------------------------------------
+      //! Pick up the descriptor offered by the data server, the reads are
+      //! then done directly on it
+      //------------------------------------------------------------------------
+      void OnLocalFd( const std::string &offer );
+
       //------------------------------------------------------------------------
       //! Process the results of the closing operation
       //------------------------------------------------------------------------
@@ -366,6 +382,23 @@ namespace XrdCl
       //------------------------------------------------------------------------
       bool IsReadOnly() const;
 
+      //------------------------------------------------------------------------
+      //! Read from the local descriptor and call the handler
+      //------------------------------------------------------------------------
+      XRootDStatus ReadLocal( int              fd,
+                              uint64_t         offset,
+                              uint32_t         size,
+                              void            *buffer,
+                              ResponseHandler *handler );
+
+      //------------------------------------------------------------------------
+      //! Vector read from the local descriptor and call the handler
+      //------------------------------------------------------------------------
+      XRootDStatus VectorReadLocal( int              fd,
+                                    const ChunkList &chunks,
+                                    void            *buffer,
+                                    ResponseHandler *handler );
+
       //------------------------------------------------------------------------
       //! Re-open the current file at a given server
       //------------------------------------------------------------------------
@@ -418,6 +451,8 @@ namespace XrdCl
       StatInfo               *pStatInfo;
       URL                    *pFileUrl;
       URL                    *pDataServer;
+      Channel                *pDataServerChannel;
+      uint64_t                pDataServerChannelGen;
       URL                    *pLoadBalancer;
       URL                    *pStateRedirect;
       uint8_t                *pFileHandle;
@@ -431,6 +466,8 @@ namespace XrdCl
       bool                    pFollowRedirects;
       bool                    pDoneInitOpen;
       bool                    pUseVirtRedirector;
+      int                     pLocalFd;
+      uint32_t                pLocalReads;
 
       //------------------------------------------------------------------------
       // Monitoring variables
@@ -34,6 +34,7 @@
 #include "XrdCl/XrdClForkHandler.hh"
 #include "XrdCl/XrdClPlugInInterface.hh"
 #include "XrdCl/XrdClPlugInManager.hh"
+#include "XrdCl/XrdClPostMaster.hh"
 #include "XrdSys/XrdSysPthread.hh"
 
 #include <memory>
@@ -344,6 +345,8 @@ namespace XrdCl
   FileSystem::FileSystem( const URL &url, bool enablePlugIns ):
     pLoadBalancerLookupDone( false ),
     pFollowRedirects( true ),
+    pChannel( 0 ),
+    pChannelGen( 0 ),
     pPlugIn(0)
   {
     pUrl = new URL( url.GetURL() );
@@ -1149,6 +1152,62 @@ namespace XrdCl
     return MessageUtils::WaitForResponse( &handler, response );
   }
 
+  //----------------------------------------------------------------------------
+  // Fetch the leading bytes of several files - async
+  //----------------------------------------------------------------------------
+  XRootDStatus FileSystem::Fetch( const std::vector<std::string> &fileList,
+                                  uint32_t                        size,
+                                  ResponseHandler                *handler,
+                                  uint16_t                        timeout )
+  {
+    if( pPlugIn )
+      return XRootDStatus( stError, errNotSupported );
+
+    if( fileList.empty() )
+      return XRootDStatus( stError, errInvalidArgs );
+
+    std::vector<std::string>::const_iterator it;
+    std::string                              list;
+    for( it = fileList.begin(); it != fileList.end(); ++it )
+    {
+      list += *it;
+      list += "\n";
+    }
+    list.erase( list.length()-1, 1 );
+
+    Message            *msg;
+    ClientFetchRequest *req;
+    MessageUtils::CreateRequest( msg, req, list.length() );
+
+    req->requestid = kXR_fetch;
+    req->rlen      = size;
+    req->dlen      = list.length();
+
+    msg->Append( list.c_str(), list.length(), 24 );
+
+    MessageSendParams params; params.timeout = timeout;
+    MessageUtils::ProcessSendParams( params );
+    XRootDTransport::SetDescription( msg );
+
+    return Send( msg, handler, params );
+  }
+
+  //----------------------------------------------------------------------------
+  // Fetch the leading bytes of several files - sync
+  //----------------------------------------------------------------------------
+  XRootDStatus FileSystem::Fetch( const std::vector<std::string>  &fileList,
+                                  uint32_t                         size,
+                                  FetchInfo                      *&response,
+                                  uint16_t                         timeout )
+  {
+    SyncResponseHandler handler;
+    Status st = Fetch( fileList, size, &handler, timeout );
+    if( !st.IsOK() )
+      return st;
+
+    return MessageUtils::WaitForResponse( &handler, response );
+  }
+
   //----------------------------------------------------------------------------
   // Set file property
   //----------------------------------------------------------------------------
@@ -1201,6 +1260,7 @@ namespace XrdCl
 
     delete pUrl;
     pUrl = new URL( url );
+    pChannel = 0;
     pLoadBalancerLookupDone = true;
   }
 
@@ -1222,6 +1282,22 @@ namespace XrdCl
 
     params.followRedirects = pFollowRedirects;
 
-    return MessageUtils::SendMessage( *pUrl, msg, handler, params );
+    //--------------------------------------------------------------------------
+    // Look up the channel only once, unless the post master deleted the
+    // channels since (e.g. in the child after a fork). We hold pMutex.
+    //--------------------------------------------------------------------------
+    PostMaster *postMaster = DefaultEnv::GetPostMaster();
+    if( postMaster )
+    {
+      uint64_t gen = postMaster->GetGeneration();
+      if( !pChannel || pChannelGen != gen )
+      {
+        pChannel    = postMaster->GetChannel( *pUrl );
+        pChannelGen = gen;
+      }
+    }
+    else pChannel = 0;
+
+    return MessageUtils::SendMessage( *pUrl, msg, handler, params, pChannel );
   }
 }
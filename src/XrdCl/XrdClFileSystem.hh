@@ -39,6 +39,7 @@ namespace XrdCl
 {
   class PostMaster;
   class Message;
+  class Channel;
   class FileSystemPlugIn;
   struct MessageSendParams;
 
@@ -692,6 +693,49 @@ namespace XrdCl
                             uint16_t                         timeout = 0 )
                             XRD_WARN_UNUSED_RESULT;
 
+      //------------------------------------------------------------------------
+      //! Open, read the leading bytes of and close several files using a
+      //! single request - async
+      //!
+      //! Meant for workloads reading many small files. Files the server
+      //! cannot serve this way (e.g. because they need a redirect) are
+      //! reported with a kXR_Unsupported error and need to be opened
+      //! individually. Not supported by file system plug-ins.
+      //!
+      //! @param fileList  list of files to be fetched
+      //! @param size      maximum number of bytes to read from each file,
+      //!                  0 for the maximum the server allows
+      //! @param handler   handler to be notified when the response arrives,
+      //!                  the response parameter will hold a FetchInfo object
+      //!                  if the procedure is successful
+      //! @param timeout   timeout value, if 0 the environment default will
+      //!                  be used
+      //! @return          status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus Fetch( const std::vector<std::string> &fileList,
+                          uint32_t                        size,
+                          ResponseHandler                *handler,
+                          uint16_t                        timeout = 0 )
+                          XRD_WARN_UNUSED_RESULT;
+
+      //------------------------------------------------------------------------
+      //! Open, read the leading bytes of and close several files using a
+      //! single request - sync
+      //!
+      //! @param fileList  list of files to be fetched
+      //! @param size      maximum number of bytes to read from each file,
+      //!                  0 for the maximum the server allows
+      //! @param response  the response (to be deleted by the user)
+      //! @param timeout   timeout value, if 0 the environment default will
+      //!                  be used
+      //! @return          status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus Fetch( const std::vector<std::string>  &fileList,
+                          uint32_t                         size,
+                          FetchInfo                      *&response,
+                          uint16_t                         timeout = 0 )
+                          XRD_WARN_UNUSED_RESULT;
+
       //------------------------------------------------------------------------
       //! Set filesystem property
       //!
@@ -743,6 +787,8 @@ namespace XrdCl
       bool              pLoadBalancerLookupDone;
       bool              pFollowRedirects;
       URL              *pUrl;
+      Channel          *pChannel;
+      uint64_t          pChannelGen;
       FileSystemPlugIn *pPlugIn;
   };
 }
@@ -20,6 +20,20 @@
 #include "XrdCl/XrdClLog.hh"
 #include "XrdCl/XrdClDefaultEnv.hh"
 #include "XrdCl/XrdClConstants.hh"
+#include <sys/time.h>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Size of the per-worker queue, jobs that do not fit go to the overflow
+  //----------------------------------------------------------------------------
+  const uint32_t JobQueueSize = 1024;
+
+  //----------------------------------------------------------------------------
+  // Minimum time (in microseconds) between spawning two extra workers
+  //----------------------------------------------------------------------------
+  const uint64_t GrowthInterval = 100000;
+}
 
 //------------------------------------------------------------------------------
 // The thread
@@ -28,15 +42,143 @@ extern "C"
 {
   static void *RunRunnerThread( void *arg )
   {
-    using namespace XrdCl;
-    JobManager *mgr = (JobManager*)arg;
-    mgr->RunJobs();
+    XrdCl::JobManager::RunWorker( arg );
     return 0;
   }
 }
 
 namespace XrdCl
 {
+  //----------------------------------------------------------------------------
+  // Create the queue
+  //----------------------------------------------------------------------------
+  JobManager::JobQueue::JobQueue( uint32_t size )
+  {
+    pCells = new Cell[size];
+    pMask  = size-1;
+    for( uint32_t i = 0; i < size; ++i )
+      pCells[i].seq = i;
+    pPutPos = 0;
+    pGetPos = 0;
+  }
+
+  //----------------------------------------------------------------------------
+  // Delete the queue
+  //----------------------------------------------------------------------------
+  JobManager::JobQueue::~JobQueue()
+  {
+    delete [] pCells;
+  }
+
+  //----------------------------------------------------------------------------
+  // Put a job in the queue, fail if the queue is full
+  //----------------------------------------------------------------------------
+  bool JobManager::JobQueue::Put( const JobHelper &job )
+  {
+#ifdef HAVE_ATOMICS
+    Cell     *cell;
+    uint64_t  pos = AtomicGet( pPutPos );
+    for( ;; )
+    {
+      cell = &pCells[pos & pMask];
+      int64_t dif = (int64_t)AtomicGet( cell->seq ) - (int64_t)pos;
+      if( dif == 0 )
+      {
+        if( AtomicCAS( pPutPos, pos, pos+1 ) )
+          break;
+      }
+      else if( dif < 0 )
+        return false;
+      pos = AtomicGet( pPutPos );
+    }
+
+    //--------------------------------------------------------------------------
+    // The cell is ours, fill it and hand it over to the consumers
+    //--------------------------------------------------------------------------
+    cell->data = job;
+    AtomicInc( cell->seq );
+    return true;
+#else
+    XrdSysMutexHelper scopedLock( pMutex );
+    Cell *cell = &pCells[pPutPos & pMask];
+    if( cell->seq != pPutPos )
+      return false;
+    cell->data = job;
+    cell->seq  = ++pPutPos;
+    return true;
+#endif
+  }
+
+  //----------------------------------------------------------------------------
+  // Get a job from the queue, fail if the queue is empty
+  //----------------------------------------------------------------------------
+  bool JobManager::JobQueue::Get( JobHelper &job )
+  {
+#ifdef HAVE_ATOMICS
+    Cell     *cell;
+    uint64_t  pos = AtomicGet( pGetPos );
+    for( ;; )
+    {
+      cell = &pCells[pos & pMask];
+      int64_t dif = (int64_t)AtomicGet( cell->seq ) - (int64_t)(pos+1);
+      if( dif == 0 )
+      {
+        if( AtomicCAS( pGetPos, pos, pos+1 ) )
+          break;
+      }
+      else if( dif < 0 )
+        return false;
+      pos = AtomicGet( pGetPos );
+    }
+
+    //--------------------------------------------------------------------------
+    // Take the job and make the cell writable for the next round
+    //--------------------------------------------------------------------------
+    job = cell->data;
+    AtomicAdd( cell->seq, pMask );
+    return true;
+#else
+    XrdSysMutexHelper scopedLock( pMutex );
+    Cell *cell = &pCells[pGetPos & pMask];
+    if( cell->seq != pGetPos+1 )
+      return false;
+    job = cell->data;
+    cell->seq = ++pGetPos + pMask;
+    return true;
+#endif
+  }
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  JobManager::JobManager( uint32_t workers, uint32_t maxWorkers,
+                          uint32_t maxLatency )
+  {
+    if( workers == 0 )
+      workers = 1;
+    if( maxWorkers < workers )
+      maxWorkers = workers;
+
+    pRunning        = false;
+    pMaxLatency     = maxWorkers > workers ? maxLatency : 0;
+    pNextGrowth     = 0;
+    pIdleCount      = 0;
+    pOverflowCount  = 0;
+    pNumWorkers     = workers;
+    pWorkers.resize( maxWorkers, 0 );
+    for( uint32_t i = 0; i < workers; ++i )
+      pWorkers[i] = new Worker( this, i, JobQueueSize );
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  JobManager::~JobManager()
+  {
+    for( uint32_t i = 0; i < pWorkers.size(); ++i )
+      delete pWorkers[i];
+  }
+
   //----------------------------------------------------------------------------
   // Initialize the job manager
   //----------------------------------------------------------------------------
@@ -50,7 +192,14 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   bool JobManager::Finalize()
   {
-    pJobs.Clear();
+    JobHelper h;
+    uint32_t  n = AtomicGet( pNumWorkers );
+    for( uint32_t i = 0; i < n; ++i )
+      while( pWorkers[i]->queue.Get( h ) ) {}
+
+    XrdSysMutexHelper scopedLock( pOverflowMutex );
+    pOverflow.clear();
+    AtomicZAP( pOverflowCount );
     return true;
   }
 
@@ -69,20 +218,18 @@ namespace XrdCl
       return false;
     }
 
-    for( uint32_t i = 0; i < pWorkers.size(); ++i )
+    for( uint32_t i = 0; i < pNumWorkers; ++i )
     {
-      int ret = ::pthread_create( &pWorkers[i], 0, ::RunRunnerThread, this );
-      if( ret != 0 )
+      if( !SpawnWorker( i ) )
       {
-        log->Error( JobMgrMsg, "Unable to spawn a job worker thread: %s",
-                    strerror( errno ) );
         if( i > 0 )
           StopWorkers( i-1 );
         return false;
       }
     }
     pRunning = true;
-    log->Debug( JobMgrMsg, "Job manager started, %d workers", pWorkers.size() );
+    log->Debug( JobMgrMsg, "Job manager started, %d workers (up to %d)",
+                pNumWorkers, pWorkers.size() );
     return true;
   }
 
@@ -100,13 +247,53 @@ namespace XrdCl
       return false;
     }
 
-    StopWorkers( pWorkers.size()-1 );
+    StopWorkers( pNumWorkers-1 );
 
     pRunning = false;
     log->Debug( JobMgrMsg, "Job manager stopped" );
     return true;
   }
 
+  //----------------------------------------------------------------------------
+  // Add a job to be run
+  //----------------------------------------------------------------------------
+  void JobManager::QueueJob( Job *job, void *arg )
+  {
+    JobHelper h( job, arg, pMaxLatency ? Now() : 0 );
+
+    //--------------------------------------------------------------------------
+    // A given thread always feeds the same worker
+    //--------------------------------------------------------------------------
+    unsigned long id = (unsigned long)pthread_self();
+    uint32_t      n  = AtomicGet( pNumWorkers );
+    Worker       *w  = pWorkers[((id * 2654435761UL) >> 16) % n];
+
+    if( !w->queue.Put( h ) )
+    {
+      XrdSysMutexHelper scopedLock( pOverflowMutex );
+      pOverflow.push_back( h );
+      AtomicInc( pOverflowCount );
+    }
+
+    //--------------------------------------------------------------------------
+    // The job has been published, so if the worker is not idle it will see
+    // it before going to sleep. If it is busy let an idle one steal the job.
+    //--------------------------------------------------------------------------
+    if( AtomicGet( w->idle ) )
+      w->sem.Post();
+    else if( AtomicGet( pIdleCount ) )
+      WakeIdle();
+  }
+
+  //----------------------------------------------------------------------------
+  // Worker thread body
+  //----------------------------------------------------------------------------
+  void JobManager::RunWorker( void *arg )
+  {
+    Worker *w = (Worker*)arg;
+    w->mgr->RunJobs( w->index );
+  }
+
   //----------------------------------------------------------------------------
   // Stop all workers up to n'th
   //----------------------------------------------------------------------------
@@ -117,36 +304,179 @@ namespace XrdCl
     {
       void *threadRet;
       log->Dump( JobMgrMsg, "Stopping worker #%d...", i );
-      if( pthread_cancel( pWorkers[i] ) != 0 )
+      if( pthread_cancel( pWorkers[i]->thread ) != 0 )
       {
         log->Error( TaskMgrMsg, "Unable to cancel worker #%d: %s", i,
                     strerror( errno ) );
         abort();
       }
-      
-      if( pthread_join( pWorkers[i], (void**)&threadRet ) != 0 )
+
+      if( pthread_join( pWorkers[i]->thread, (void**)&threadRet ) != 0 )
       {
         log->Error( TaskMgrMsg, "Unable to join worker #%d: %s", i,
                     strerror( errno ) );
         abort();
       }
 
+      //------------------------------------------------------------------------
+      // The worker may have been cancelled while waiting
+      //------------------------------------------------------------------------
+      if( pWorkers[i]->idle )
+        SetIdle( pWorkers[i], false );
       log->Dump( JobMgrMsg, "Worker #%d stopped", i );
     }
   }
 
   //----------------------------------------------------------------------------
-  // Initialize the job manager
+  // Spawn a worker in the slot n
   //----------------------------------------------------------------------------
-  void JobManager::RunJobs()
+  bool JobManager::SpawnWorker( uint32_t n )
   {
+    int ret = ::pthread_create( &pWorkers[n]->thread, 0, ::RunRunnerThread,
+                                pWorkers[n] );
+    if( ret != 0 )
+    {
+      Log *log = DefaultEnv::GetLog();
+      log->Error( JobMgrMsg, "Unable to spawn a job worker thread: %s",
+                  strerror( ret ) );
+      return false;
+    }
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Run the jobs queued for the given worker
+  //----------------------------------------------------------------------------
+  void JobManager::RunJobs( uint32_t worker )
+  {
+    Worker    *me = pWorkers[worker];
+    JobHelper  h;
+
     pthread_setcanceltype( PTHREAD_CANCEL_DEFERRED, 0 );
     for( ;; )
     {
-      JobHelper h = pJobs.Get();
+      if( !GetJob( worker, h ) )
+      {
+        //----------------------------------------------------------------------
+        // Announce that we are idle and look once more, a producer either
+        // sees us idle and wakes us up or we see its job here
+        //----------------------------------------------------------------------
+        SetIdle( me, true );
+        if( !GetJob( worker, h ) )
+        {
+          me->sem.Wait();
+          SetIdle( me, false );
+          continue;
+        }
+        SetIdle( me, false );
+      }
+
       pthread_setcancelstate( PTHREAD_CANCEL_DISABLE, 0 );
+      if( pMaxLatency )
+        CheckLatency( h );
       h.job->Run( h.arg );
       pthread_setcancelstate( PTHREAD_CANCEL_ENABLE, 0 );
     }
   }
+
+  //----------------------------------------------------------------------------
+  // Mark the worker as idle or busy
+  //----------------------------------------------------------------------------
+  void JobManager::SetIdle( Worker *worker, bool idle )
+  {
+#ifndef HAVE_ATOMICS
+    XrdSysMutexHelper scopedLock( pIdleMutex );
+#endif
+    if( idle )
+    {
+      AtomicInc( worker->idle );
+      AtomicInc( pIdleCount );
+    }
+    else
+    {
+      AtomicDec( worker->idle );
+      AtomicDec( pIdleCount );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Take a job from own queue, steal one or take one from the overflow
+  //----------------------------------------------------------------------------
+  bool JobManager::GetJob( uint32_t worker, JobHelper &job )
+  {
+    if( pWorkers[worker]->queue.Get( job ) )
+      return true;
+
+    uint32_t n = AtomicGet( pNumWorkers );
+    for( uint32_t i = 1; i < n; ++i )
+      if( pWorkers[(worker+i) % n]->queue.Get( job ) )
+        return true;
+
+    if( !AtomicGet( pOverflowCount ) )
+      return false;
+
+    XrdSysMutexHelper scopedLock( pOverflowMutex );
+    if( pOverflow.empty() )
+      return false;
+    job = pOverflow.front();
+    pOverflow.pop_front();
+    AtomicDec( pOverflowCount );
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Spawn another worker if the job has been waiting for too long
+  //----------------------------------------------------------------------------
+  void JobManager::CheckLatency( const JobHelper &job )
+  {
+    uint64_t now = Now();
+    if( now < job.stamp + pMaxLatency || AtomicGet( pIdleCount ) ||
+        AtomicGet( pNumWorkers ) >= pWorkers.size() )
+      return;
+
+    if( !pMutex.CondLock() )
+      return;
+
+    uint32_t n = pNumWorkers;
+    if( pRunning && n < pWorkers.size() && now >= pNextGrowth )
+    {
+      pNextGrowth = now + GrowthInterval;
+      if( !pWorkers[n] )
+        pWorkers[n] = new Worker( this, n, JobQueueSize );
+      if( SpawnWorker( n ) )
+      {
+        AtomicInc( pNumWorkers );
+        Log *log = DefaultEnv::GetLog();
+        log->Debug( JobMgrMsg, "Jobs waited %llu us to run, added worker "
+                    "#%d", (unsigned long long)(now - job.stamp), n );
+      }
+    }
+    pMutex.UnLock();
+  }
+
+  //----------------------------------------------------------------------------
+  // Wake one of the idle workers
+  //----------------------------------------------------------------------------
+  void JobManager::WakeIdle()
+  {
+    uint32_t n = AtomicGet( pNumWorkers );
+    for( uint32_t i = 0; i < n; ++i )
+    {
+      if( AtomicGet( pWorkers[i]->idle ) )
+      {
+        pWorkers[i]->sem.Post();
+        return;
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Current time in microseconds
+  //----------------------------------------------------------------------------
+  uint64_t JobManager::Now()
+  {
+    struct timeval tv;
+    gettimeofday( &tv, 0 );
+    return (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+  }
 }
@@ -21,8 +21,11 @@
 
 #include <stdint.h>
 #include <vector>
+#include <deque>
 #include <pthread.h>
-#include "XrdCl/XrdClSyncQueue.hh"
+#include "XrdSys/XrdSysPthread.hh"
+#include "XrdSys/XrdSysAtomics.hh"
+#include "XrdCl/XrdClUglyHacks.hh"
 
 namespace XrdCl
 {
@@ -44,26 +47,32 @@ namespace XrdCl
   };
 
   //----------------------------------------------------------------------------
-  //! A synchronized queue
+  //! Runs jobs in a pool of worker threads
+  //!
+  //! Every worker owns a bounded lock-free queue. A thread queueing jobs
+  //! always feeds the same worker, so the callbacks of one poller stay on
+  //! one worker, and idle workers steal from the busy ones. If the jobs wait
+  //! too long to be picked up the pool grows, up to a limit.
   //----------------------------------------------------------------------------
   class JobManager
   {
     public:
       //------------------------------------------------------------------------
       //! Constructor
+      //!
+      //! @param workers    number of workers started initially
+      //! @param maxWorkers maximum number of workers, the pool does not grow
+      //!                   if this is not greater than workers
+      //! @param maxLatency queueing latency (in microseconds) above which
+      //!                   a new worker is spawned, 0 disables the growth
       //------------------------------------------------------------------------
-      JobManager( uint32_t workers )
-      {
-        pRunning = false;
-        pWorkers.resize( workers );
-      }
+      JobManager( uint32_t workers, uint32_t maxWorkers = 0,
+                  uint32_t maxLatency = 0 );
 
       //------------------------------------------------------------------------
       //! Destructor
       //------------------------------------------------------------------------
-      ~JobManager()
-      {
-      }
+      ~JobManager();
 
       //------------------------------------------------------------------------
       //! Initialize the job manager
@@ -88,34 +97,129 @@ namespace XrdCl
       //------------------------------------------------------------------------
       //! Add a job to be run
       //------------------------------------------------------------------------
-      void QueueJob( Job *job, void *arg = 0 )
+      void QueueJob( Job *job, void *arg = 0 );
+
+      //------------------------------------------------------------------------
+      //! Worker thread body, arg is the worker slot
+      //------------------------------------------------------------------------
+      static void RunWorker( void *arg );
+
+      //------------------------------------------------------------------------
+      //! Get the number of workers currently running
+      //------------------------------------------------------------------------
+      uint32_t GetNumWorkers()
       {
-        pJobs.Put( JobHelper( job, arg ) );
+        return AtomicGet( pNumWorkers );
       }
 
+    private:
+      struct JobHelper
+      {
+        JobHelper( Job *j = 0, void *a = 0, uint64_t s = 0 ):
+          job(j), arg(a), stamp(s) {}
+        Job      *job;
+        void     *arg;
+        uint64_t  stamp;
+      };
+
       //------------------------------------------------------------------------
-      //! Run the jobs
+      // Bounded multi-producer multi-consumer queue. Each cell carries
+      // a sequence number telling whether it is ready to be written (seq ==
+      // pos) or read (seq == pos+1), so producers and consumers only ever
+      // contend on a single compare-and-swap.
       //------------------------------------------------------------------------
-      void RunJobs();
+      class JobQueue
+      {
+        public:
+          JobQueue( uint32_t size );
+          ~JobQueue();
+          bool Put( const JobHelper &job );
+          bool Get( JobHelper &job );
+
+        private:
+          struct Cell
+          {
+            uint64_t  seq;
+            JobHelper data;
+          };
+
+          Cell       *pCells;
+          uint64_t    pMask;
+          char        pPad1[64];
+          uint64_t    pPutPos;
+          char        pPad2[64];
+          uint64_t    pGetPos;
+#ifndef HAVE_ATOMICS
+          XrdSysMutex pMutex;
+#endif
+      };
+
+      struct Worker
+      {
+        Worker( JobManager *m, uint32_t i, uint32_t size ):
+          mgr(m), index(i), queue(size), sem(0), idle(0) {}
+        JobManager      *mgr;
+        uint32_t         index;
+        pthread_t        thread;
+        JobQueue         queue;
+        Semaphore        sem;
+        int              idle;
+      };
+
+      //------------------------------------------------------------------------
+      //! Run the jobs queued for the given worker
+      //------------------------------------------------------------------------
+      void RunJobs( uint32_t worker );
+
+      //------------------------------------------------------------------------
+      //! Mark the worker as idle or busy
+      //------------------------------------------------------------------------
+      void SetIdle( Worker *worker, bool idle );
 
-    private:
       //------------------------------------------------------------------------
       //! Stop all workers up to n'th
       //------------------------------------------------------------------------
       void StopWorkers( uint32_t n );
 
-      struct JobHelper
-      {
-        JobHelper( Job *j = 0, void *a = 0 ): job(j), arg(a) {}
-        Job  *job;
-        void *arg;
-      };
+      //------------------------------------------------------------------------
+      //! Spawn a worker in the slot n
+      //------------------------------------------------------------------------
+      bool SpawnWorker( uint32_t n );
+
+      //------------------------------------------------------------------------
+      //! Take a job from own queue, steal one or take one from the overflow
+      //------------------------------------------------------------------------
+      bool GetJob( uint32_t worker, JobHelper &job );
+
+      //------------------------------------------------------------------------
+      //! Spawn another worker if the job has been waiting for too long
+      //------------------------------------------------------------------------
+      void CheckLatency( const JobHelper &job );
+
+      //------------------------------------------------------------------------
+      //! Wake one of the idle workers
+      //------------------------------------------------------------------------
+      void WakeIdle();
+
+      //------------------------------------------------------------------------
+      //! Current time in microseconds
+      //------------------------------------------------------------------------
+      static uint64_t Now();
 
-      std::vector<pthread_t> pWorkers;
-      SyncQueue<JobHelper>   pJobs;
-      XrdSysMutex            pMutex;
-      bool                   pRunning;
+      std::vector<Worker*>  pWorkers;
+      uint32_t              pNumWorkers;
+      uint32_t              pMaxLatency;
+      uint64_t              pNextGrowth;
+      int                   pIdleCount;
+      int                   pOverflowCount;
+      std::deque<JobHelper> pOverflow;
+      XrdSysMutex           pOverflowMutex;
+      XrdSysMutex           pMutex;
+#ifndef HAVE_ATOMICS
+      XrdSysMutex           pIdleMutex;
+#endif
+      bool                  pRunning;
   };
 }
 
-#endif // __XRD_CL_ANY_OBJECT_HH__
+#endif // __XRD_CL_JOB_MANAGER_HH__
@@ -40,7 +40,8 @@ namespace XrdCl
   Status MessageUtils::SendMessage( const URL               &url,
                                     Message                 *msg,
                                     ResponseHandler         *handler,
-                                    const MessageSendParams &sendParams )
+                                    const MessageSendParams &sendParams,
+                                    Channel                 *channel )
   {
     //--------------------------------------------------------------------------
     // Get the stuff needed to send the message
@@ -56,9 +57,12 @@ namespace XrdCl
                url.GetHostId().c_str(), msg->GetDescription().c_str() );
 
 
+    if( !channel )
+      channel = postMaster->GetChannel( url );
+
     AnyObject   sidMgrObj;
     SIDManager *sidMgr    = 0;
-    st = postMaster->QueryTransport( url, XRootDQuery::SIDManager,
+    st = postMaster->QueryTransport( channel, XRootDQuery::SIDManager,
                                      sidMgrObj );
 
     if( !st.IsOK() )
@@ -111,7 +115,7 @@ namespace XrdCl
     //--------------------------------------------------------------------------
     // Send the message
     //--------------------------------------------------------------------------
-    st = postMaster->Send( url, msg, msgHandler, sendParams.stateful,
+    st = postMaster->Send( channel, url, msg, msgHandler, sendParams.stateful,
                            sendParams.expires );
     if( !st.IsOK() )
     {
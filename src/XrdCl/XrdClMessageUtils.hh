@@ -35,6 +35,8 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   //! Synchronize the response
   //----------------------------------------------------------------------------
+  class Channel;
+
   class SyncResponseHandler: public ResponseHandler
   {
     public:
@@ -205,11 +207,15 @@ namespace XrdCl
 
       //------------------------------------------------------------------------
       //! Send message
+      //!
+      //! @param channel the post master channel for url if already known,
+      //!                otherwise it is looked up
       //------------------------------------------------------------------------
       static Status SendMessage( const URL               &url,
                                  Message                 *msg,
                                  ResponseHandler         *handler,
-                                 const MessageSendParams &sendParams );
+                                 const MessageSendParams &sendParams,
+                                 Channel                 *channel = 0 );
 
       //------------------------------------------------------------------------
       //! Process sending params
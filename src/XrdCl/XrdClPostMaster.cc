@@ -37,14 +37,22 @@ namespace XrdCl
   // Constructor
   //----------------------------------------------------------------------------
   PostMaster::PostMaster():
-    pPoller( 0 ), pInitialized( false )
+    pPoller( 0 ), pGeneration( 0 ), pInitialized( false )
   {
     Env *env = DefaultEnv::GetEnv();
-    int workerThreads = DefaultWorkerThreads;
-    env->GetInt( "WorkerThreads", workerThreads );
+    int workerThreads    = DefaultWorkerThreads;
+    int maxWorkerThreads = DefaultMaxWorkerThreads;
+    int workerLatency    = DefaultWorkerLatency;
+    env->GetInt( "WorkerThreads",    workerThreads );
+    env->GetInt( "MaxWorkerThreads", maxWorkerThreads );
+    env->GetInt( "WorkerLatency",    workerLatency );
+    if( workerThreads < 1 )    workerThreads    = 1;
+    if( maxWorkerThreads < 1 ) maxWorkerThreads = 1;
+    if( workerLatency < 0 )    workerLatency    = 0;
 
     pTaskManager = new TaskManager();
-    pJobManager  = new JobManager(workerThreads);
+    pJobManager  = new JobManager( workerThreads, maxWorkerThreads,
+                                   workerLatency );
   }
 
   //----------------------------------------------------------------------------
@@ -99,10 +107,13 @@ namespace XrdCl
     pJobManager->Finalize();
     ChannelMap::iterator it;
 
+    pChannelMapMutex.WriteLock();
     for( it = pChannelMap.begin(); it != pChannelMap.end(); ++it )
       delete it->second;
 
     pChannelMap.clear();
+    ++pGeneration;
+    pChannelMapMutex.UnLock();
     return pPoller->Finalize();
   }
 
@@ -183,8 +194,19 @@ namespace XrdCl
                            bool                  stateful,
                            time_t                expires )
   {
-    Channel *channel = GetChannel( url );
+    return Send( GetChannel( url ), url, msg, handler, stateful, expires );
+  }
 
+  //----------------------------------------------------------------------------
+  // Send the message asynchronously through a known channel
+  //----------------------------------------------------------------------------
+  Status PostMaster::Send( Channel              *channel,
+                           const URL            &url,
+                           Message              *msg,
+                           OutgoingMsgHandler   *handler,
+                           bool                  stateful,
+                           time_t                expires )
+  {
     if( !channel )
       return Status( stError, errNotSupported );
 
@@ -236,8 +258,16 @@ namespace XrdCl
                                      uint16_t   query,
                                      AnyObject &result )
   {
-    Channel *channel = GetChannel( url );
+    return QueryTransport( GetChannel( url ), query, result );
+  }
 
+  //----------------------------------------------------------------------------
+  // Query the transport handler of a known channel
+  //----------------------------------------------------------------------------
+  Status PostMaster::QueryTransport( Channel   *channel,
+                                     uint16_t   query,
+                                     AnyObject &result )
+  {
     if( !channel )
       return Status( stError, errNotSupported );
 
@@ -279,9 +309,24 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   Channel *PostMaster::GetChannel( const URL &url )
   {
-    XrdSysMutexHelper scopedLock( pChannelMapMutex );
+    //--------------------------------------------------------------------------
+    // Channels are created once per host and only removed on finalization,
+    // so look them up with the read lock and take the write lock only to add
+    //--------------------------------------------------------------------------
+    std::string hostId = url.GetHostId();
+    pChannelMapMutex.ReadLock();
+    ChannelMap::iterator it = pChannelMap.find( hostId );
+    if( it != pChannelMap.end() )
+    {
+      Channel *channel = it->second;
+      pChannelMapMutex.UnLock();
+      return channel;
+    }
+    pChannelMapMutex.UnLock();
+
+    XrdSysRWLockHelper scopedLock( pChannelMapMutex, false );
     Channel *channel = 0;
-    ChannelMap::iterator it = pChannelMap.find( url.GetHostId() );
+    it = pChannelMap.find( hostId );
 
     if( it == pChannelMap.end() )
     {
@@ -297,7 +342,7 @@ namespace XrdCl
       }
 
       channel = new Channel( url, pPoller, trHandler, pTaskManager, pJobManager );
-      pChannelMap[url.GetHostId()] = channel;
+      pChannelMap[hostId] = channel;
     }
     else
       channel = it->second;
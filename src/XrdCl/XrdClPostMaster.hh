@@ -120,6 +120,19 @@ namespace XrdCl
                    bool                  stateful,
                    time_t                expires );
 
+      //------------------------------------------------------------------------
+      //! Send the message asynchronously through a channel obtained earlier
+      //! with GetChannel, see above for the description of the parameters.
+      //!
+      //! @param channel the channel for the url
+      //------------------------------------------------------------------------
+      Status Send( Channel              *channel,
+                   const URL            &url,
+                   Message              *msg,
+                   OutgoingMsgHandler   *handler,
+                   bool                  stateful,
+                   time_t                expires );
+
       //------------------------------------------------------------------------
       //! Synchronously receive a message - blocks until a message matching
       //! a filter is found in the incoming queue or the timeout passes
@@ -163,6 +176,36 @@ namespace XrdCl
                              uint16_t   query,
                              AnyObject &result );
 
+      //------------------------------------------------------------------------
+      //! Query the transport handler of a channel obtained earlier with
+      //! GetChannel
+      //------------------------------------------------------------------------
+      Status QueryTransport( Channel   *channel,
+                             uint16_t   query,
+                             AnyObject &result );
+
+      //------------------------------------------------------------------------
+      //! Get the channel for a given URL, create it if it does not exist yet.
+      //! Channels are deleted when the post master is finalized (i.e. also
+      //! in the child after a fork). A caller keeping the returned pointer
+      //! must record GetGeneration() before calling this and look the channel
+      //! up again when the generation has changed.
+      //!
+      //! @param url the channel to be looked up
+      //! @return    the channel or 0 if the protocol is not supported
+      //------------------------------------------------------------------------
+      Channel *GetChannel( const URL &url );
+
+      //------------------------------------------------------------------------
+      //! Get the channel generation, it changes whenever the channels are
+      //! deleted
+      //------------------------------------------------------------------------
+      uint64_t GetGeneration()
+      {
+        XrdSysRWLockHelper scopedLock( pChannelMapMutex );
+        return pGeneration;
+      }
+
       //------------------------------------------------------------------------
       //! Register channel event handler
       //------------------------------------------------------------------------
@@ -192,13 +235,12 @@ namespace XrdCl
       }
 
     private:
-      Channel *GetChannel( const URL &url );
-
       typedef std::map<std::string, Channel*> ChannelMap;
       Poller           *pPoller;
       TaskManager      *pTaskManager;
       ChannelMap        pChannelMap;
-      XrdSysMutex       pChannelMapMutex;
+      XrdSysRWLock      pChannelMapMutex;
+      uint64_t          pGeneration;
       bool              pInitialized;
       JobManager       *pJobManager;
   };
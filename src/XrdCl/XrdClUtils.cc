@@ -22,6 +22,7 @@
 #include "XrdCl/XrdClConstants.hh"
 #include "XrdCl/XrdClCheckSumManager.hh"
 #include "XrdNet/XrdNetAddr.hh"
+#include "XrdSys/XrdSysFD.hh"
 
 #include <algorithm>
 #include <iomanip>
@@ -34,7 +35,14 @@
 #include <string>
 
 #include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 #include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
 
 namespace
 {
@@ -489,4 +497,87 @@ namespace XrdCl
     }
     return checksum;
   }
+
+  //----------------------------------------------------------------------------
+  // Pick up a file descriptor passed by a server running on this host
+  //----------------------------------------------------------------------------
+  int Utils::FetchLocalFd( const std::string &offer, int timeout )
+  {
+    size_t pos = offer.find( ' ' );
+    if( pos == std::string::npos || pos == 0 || pos+1 >= offer.length() )
+      return -EINVAL;
+
+    std::string path  = offer.substr( 0, pos );
+    std::string token = offer.substr( pos+1 );
+
+    struct sockaddr_un sun;
+    if( path.length() >= sizeof( sun.sun_path ) )
+      return -ENAMETOOLONG;
+    memset( &sun, 0, sizeof( sun ) );
+    sun.sun_family = AF_UNIX;
+    strcpy( sun.sun_path, path.c_str() );
+
+    //--------------------------------------------------------------------------
+    // Connect and hand over the token, the socket does not block so that a
+    // server with a full listen queue fails the request instead of stalling us
+    //--------------------------------------------------------------------------
+    int sock = XrdSysFD_Socket( AF_UNIX, SOCK_STREAM, 0 );
+    if( sock < 0 )
+      return -errno;
+
+    if( fcntl( sock, F_SETFL, fcntl( sock, F_GETFL ) | O_NONBLOCK ) ||
+        connect( sock, (struct sockaddr*)&sun, sizeof( sun ) ) ||
+        write( sock, token.c_str(), token.length() ) != (ssize_t)token.length() )
+    {
+      int rc = errno;
+      close( sock );
+      return -rc;
+    }
+
+    //--------------------------------------------------------------------------
+    // Wait for the answer, the descriptor comes as ancillary data
+    //--------------------------------------------------------------------------
+    struct pollfd pfd;
+    pfd.fd = sock; pfd.events = POLLIN;
+    int rc;
+    do { rc = poll( &pfd, 1, timeout ); } while( rc < 0 && errno == EINTR );
+    if( rc <= 0 )
+    {
+      rc = ( rc ? errno : ETIMEDOUT );
+      close( sock );
+      return -rc;
+    }
+
+    union { struct cmsghdr hdr;
+            char           buff[CMSG_SPACE(sizeof(int))]; } cmsg;
+    struct msghdr msg;
+    struct iovec  iov;
+    char          ok = 0;
+    memset( &msg, 0, sizeof( msg ) );
+    iov.iov_base = &ok; iov.iov_len = 1;
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = cmsg.buff;
+    msg.msg_controllen = sizeof( cmsg.buff );
+
+#ifdef MSG_CMSG_CLOEXEC
+    do { rc = recvmsg( sock, &msg, MSG_CMSG_CLOEXEC ); }
+#else
+    do { rc = recvmsg( sock, &msg, 0 ); }
+#endif
+    while( rc < 0 && errno == EINTR );
+    int err = ( rc < 0 ? errno : EPROTO );
+    close( sock );
+
+    int fd = -1;
+    struct cmsghdr *cP = ( rc > 0 ? CMSG_FIRSTHDR( &msg ) : 0 );
+    if( cP && cP->cmsg_level == SOL_SOCKET && cP->cmsg_type == SCM_RIGHTS )
+      memcpy( &fd, CMSG_DATA( cP ), sizeof( int ) );
+    if( fd < 0 )
+      return ( ok == 'n' ? -ENOENT : -err );
+#ifndef MSG_CMSG_CLOEXEC
+    fcntl( fd, F_SETFD, FD_CLOEXEC );
+#endif
+    return fd;
+  }
 }
@@ -189,6 +189,15 @@ namespace XrdCl
       //------------------------------------------------------------------------
       static std::string NormalizeChecksum( const std::string &name,
                                             const std::string &checksum );
+
+      //------------------------------------------------------------------------
+      //! Pick up a file descriptor passed by a server running on this host
+      //!
+      //! @param offer   the "<socket path> <token>" answer to kXR_Qlocfd
+      //! @param timeout milliseconds to wait for the server to pass it
+      //! @return        the descriptor or -errno on failure
+      //------------------------------------------------------------------------
+      static int FetchLocalFd( const std::string &offer, int timeout );
   };
 
   //----------------------------------------------------------------------------
@@ -271,6 +271,7 @@ namespace XrdCl
                  pRequest->GetDescription().c_str() );
       Message *embededMsg = new Message( rsp->hdr.dlen-8 );
       embededMsg->Append( msg->GetBuffer( 16 ), rsp->hdr.dlen-8 );
+      embededMsg->SetSessionId( msg->GetSessionId() );
       XRDCL_SMART_PTR_T<Message> msgPtr( msg );
       pResponse = embededMsg; // this can never happen for oksofars
 
@@ -1264,6 +1265,37 @@ namespace XrdCl
         return Status();
       }
 
+      //------------------------------------------------------------------------
+      // kXR_fetch
+      //------------------------------------------------------------------------
+      case kXR_fetch:
+      {
+        AnyObject *obj = new AnyObject();
+
+        uint32_t  pathLen = req->fetch.dlen;
+        char     *paths   = new char[pathLen+1];
+        paths[pathLen] = 0;
+        memcpy( paths, pRequest->GetBuffer( 24 ), pathLen );
+
+        log->Dump( XRootDMsg, "[%s] Parsing the response to %s as "
+                   "FetchInfo", pUrl.GetHostId().c_str(),
+                   pRequest->GetDescription().c_str() );
+        FetchInfo *data = new FetchInfo();
+
+        if( data->ParseServerResponse( paths, buffer, length ) == false )
+        {
+          delete obj;
+          delete data;
+          delete [] paths;
+          return Status( stError, errInvalidResponse );
+        }
+        delete [] paths;
+
+        obj->Set( data );
+        response = obj;
+        return Status();
+      }
+
       //------------------------------------------------------------------------
       // kXR_stat
       //------------------------------------------------------------------------
@@ -21,7 +21,10 @@
 #include "XrdCl/XrdClDefaultEnv.hh"
 #include "XrdCl/XrdClConstants.hh"
 #include "XrdCl/XrdClUtils.hh"
+#include "XrdSys/XrdSysPlatform.hh"
+#include <arpa/inet.h>
 #include <cstdlib>
+#include <cstring>
 
 namespace XrdCl
 {
@@ -296,4 +299,55 @@ namespace XrdCl
     }
     return true;
   }
+
+  //----------------------------------------------------------------------------
+  // Parse the fetch response
+  //----------------------------------------------------------------------------
+  bool FetchInfo::ParseServerResponse( const char *paths,
+                                       const char *data,
+                                       uint32_t    length )
+  {
+    if( !paths || ( !data && length ) )
+      return false;
+
+    std::vector<std::string>           pathList;
+    std::vector<std::string>::iterator it;
+    Utils::splitString( pathList, paths, "\n" );
+
+    const uint32_t hdrSize = sizeof( ServerResponseBody_Fetch );
+    uint32_t       offset  = 0;
+
+    for( it = pathList.begin(); it != pathList.end(); ++it )
+    {
+      if( it->empty() )
+        continue;
+
+      //------------------------------------------------------------------------
+      // The header may not be aligned so we copy it out
+      //------------------------------------------------------------------------
+      ServerResponseBody_Fetch hdr;
+      if( length - offset < hdrSize )
+        return false;
+      memcpy( &hdr, data+offset, hdrSize );
+      offset += hdrSize;
+
+      uint64_t size   = ntohll( hdr.fsize );
+      uint32_t errnum = ntohl( hdr.errnum );
+      uint32_t dlen   = ntohl( hdr.dlen );
+      if( length - offset < dlen )
+        return false;
+
+      if( errnum )
+      {
+        std::string msg( data+offset, dlen ? strnlen( data+offset, dlen ) : 0 );
+        Add( FetchEntry( *it, size, XRootDStatus( stError, errErrorResponse,
+                                                  errnum, msg ), "" ) );
+      }
+      else
+        Add( FetchEntry( *it, size, XRootDStatus(),
+                         std::string( data+offset, dlen ) ) );
+      offset += dlen;
+    }
+    return offset == length;
+  }
 }
@@ -810,6 +810,165 @@ namespace XrdCl
       uint32_t  pSize;
   };
 
+  //----------------------------------------------------------------------------
+  //! Result of a multi-file fetch
+  //----------------------------------------------------------------------------
+  class FetchInfo
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! The leading bytes of a single file or the reason they could not
+      //! be obtained
+      //------------------------------------------------------------------------
+      class FetchEntry
+      {
+        public:
+          //--------------------------------------------------------------------
+          //! Constructor
+          //--------------------------------------------------------------------
+          FetchEntry( const std::string  &path,
+                      uint64_t            size,
+                      const XRootDStatus &status,
+                      const std::string  &data ):
+            pPath( path ),
+            pSize( size ),
+            pStatus( status ),
+            pData( data ) {}
+
+          //--------------------------------------------------------------------
+          //! Get the path
+          //--------------------------------------------------------------------
+          const std::string &GetPath() const
+          {
+            return pPath;
+          }
+
+          //--------------------------------------------------------------------
+          //! Get the size of the whole file
+          //--------------------------------------------------------------------
+          uint64_t GetSize() const
+          {
+            return pSize;
+          }
+
+          //--------------------------------------------------------------------
+          //! Get the status, the file must be accessed individually when
+          //! the error code is kXR_Unsupported
+          //--------------------------------------------------------------------
+          const XRootDStatus &GetStatus() const
+          {
+            return pStatus;
+          }
+
+          //--------------------------------------------------------------------
+          //! Get the data read from the beginning of the file
+          //--------------------------------------------------------------------
+          const std::string &GetData() const
+          {
+            return pData;
+          }
+
+          //--------------------------------------------------------------------
+          //! Check whether the data holds the whole file
+          //--------------------------------------------------------------------
+          bool IsComplete() const
+          {
+            return pStatus.IsOK() && pData.size() == pSize;
+          }
+
+        private:
+          std::string  pPath;
+          uint64_t     pSize;
+          XRootDStatus pStatus;
+          std::string  pData;
+      };
+
+      //------------------------------------------------------------------------
+      //! List of entries
+      //------------------------------------------------------------------------
+      typedef std::vector<FetchEntry>    EntryList;
+
+      //------------------------------------------------------------------------
+      //! Iterator over entries
+      //------------------------------------------------------------------------
+      typedef EntryList::iterator        Iterator;
+
+      //------------------------------------------------------------------------
+      //! Iterator over entries
+      //------------------------------------------------------------------------
+      typedef EntryList::const_iterator  ConstIterator;
+
+      //------------------------------------------------------------------------
+      //! Get number of entries
+      //------------------------------------------------------------------------
+      uint32_t GetSize() const
+      {
+        return pEntries.size();
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the entry at index
+      //------------------------------------------------------------------------
+      FetchEntry &At( uint32_t index )
+      {
+        return pEntries[index];
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the begin iterator
+      //------------------------------------------------------------------------
+      Iterator Begin()
+      {
+        return pEntries.begin();
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the begin iterator
+      //------------------------------------------------------------------------
+      ConstIterator Begin() const
+      {
+        return pEntries.begin();
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the end iterator
+      //------------------------------------------------------------------------
+      Iterator End()
+      {
+        return pEntries.end();
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the end iterator
+      //------------------------------------------------------------------------
+      ConstIterator End() const
+      {
+        return pEntries.end();
+      }
+
+      //------------------------------------------------------------------------
+      //! Add an entry
+      //------------------------------------------------------------------------
+      void Add( const FetchEntry &entry )
+      {
+        pEntries.push_back( entry );
+      }
+
+      //------------------------------------------------------------------------
+      //! Parse server response and fill up the object
+      //!
+      //! @param paths  newline separated list of the requested paths
+      //! @param data   the response body
+      //! @param length length of the response body
+      //------------------------------------------------------------------------
+      bool ParseServerResponse( const char *paths,
+                                const char *data,
+                                uint32_t    length );
+
+    private:
+      EntryList pEntries;
+  };
+
   //----------------------------------------------------------------------------
   // List of URLs
   //----------------------------------------------------------------------------
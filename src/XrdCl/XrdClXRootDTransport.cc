@@ -803,6 +803,13 @@ namespace XrdCl
         req->query.infotype = htons( req->query.infotype );
         break;
 
+      //------------------------------------------------------------------------
+      // kXR_fetch
+      //------------------------------------------------------------------------
+      case kXR_fetch:
+        req->fetch.rlen = htonl( req->fetch.rlen );
+        break;
+
       //------------------------------------------------------------------------
       // kXR_truncate
       //------------------------------------------------------------------------
@@ -2271,6 +2278,7 @@ namespace XrdCl
           case kXR_Qconfig: o << "kXR_Qconfig"; break;
           case kXR_Qckscan: o << "kXR_Qckscan"; break;
           case kXR_Qcksum:  o << "kXR_Qcksum"; break;
+          case kXR_Qlocfd:  o << "kXR_Qlocfd"; break;
           case kXR_Qopaque: o << "kXR_Qopaque"; break;
           case kXR_Qopaquf: o << "kXR_Qopaquf"; break;
           case kXR_Qopaqug: o << "kXR_Qopaqug"; break;
@@ -2283,7 +2291,8 @@ namespace XrdCl
         }
         o << ", ";          
 
-        if( sreq->infotype == kXR_Qopaqug || sreq->infotype == kXR_Qvisa )
+        if( sreq->infotype == kXR_Qopaqug || sreq->infotype == kXR_Qvisa ||
+            sreq->infotype == kXR_Qlocfd )
         {
           o << "handle: " << FileHandleToStr( sreq->fhandle );
           o << ", ";
@@ -2399,6 +2408,25 @@ namespace XrdCl
         break;
       }
 
+      //------------------------------------------------------------------------
+      // kXR_fetch
+      //------------------------------------------------------------------------
+      case kXR_fetch:
+      {
+        ClientFetchRequest *sreq = (ClientFetchRequest *)msg->GetBuffer();
+        o << "kXR_fetch (";
+        o << "size: " << sreq->rlen << ", ";
+
+        char *fn = GetDataAsString( msg );
+        char *cursor;
+        for( cursor = fn; *cursor; ++cursor )
+          if( *cursor == '\n' ) *cursor = ' ';
+
+        o << "paths: " << fn << ")";
+        delete [] fn;
+        break;
+      }
+
       //------------------------------------------------------------------------
       // kXR_prepare
       //------------------------------------------------------------------------
@@ -44,6 +44,8 @@
 
 #include "XrdOss/XrdOss.hh"
 
+#include "XrdOuc/XrdOucEnv.hh"
+
 #include "XrdSfs/XrdSfsFlags.hh"
 
 #include "XrdSys/XrdSysError.hh"
@@ -108,6 +110,25 @@ int XrdCmsBaseFS::Bypass()
    return 0;
 }
   
+/******************************************************************************/
+/* Private:                       D i r L e n                                 */
+/******************************************************************************/
+
+// Return the length of the directory component of the request's path or zero
+// if the request should not be batched with others for the same directory.
+  
+int XrdCmsBaseFS::DirLen(XrdCmsBaseFR *rP)
+{
+   int n;
+
+   if (rP->PDirLen > 0) return rP->PDirLen;
+
+   n = strlen(rP->Path) - 1;
+   if (n <= 0 || rP->Path[n] == '/') return 0;
+   while(n >= 0 && rP->Path[n] != '/') n--;
+   return (n > 0 ? n : 0);
+}
+
 /******************************************************************************/
 /* Public:                        E x i s t s                                 */
 /******************************************************************************/
@@ -264,6 +285,7 @@ do{theQ.pqAvail.Wait();
    theQ.Mutex.Lock(); inQ = 1;
    while((rP = theQ.pqFirst))
         {if (!(theQ.pqFirst = rP->Next)) {theQ.pqLast = 0; inQ = 0;}
+         rP->Next = 0;
          theQ.Mutex.UnLock();
          if (rP->PDirLen > 0 && !hasDir(rP->Path, rP->PDirLen))
             {delete rP; continue;}
@@ -331,25 +353,89 @@ void XrdCmsBaseFS::Queue(XrdCmsRRData &Arg, XrdCmsPInfo &Who,
   
 void XrdCmsBaseFS::Runner()
 {
-   XrdCmsBaseFR *rP;
-   int inQ;
+   XrdCmsBaseFR *rP, *pP, *xP;
+   int dLen, rNum;
 
-// Process requests at the given rate
+// Process requests as they arrive. When we are doing local lookups, queued
+// requests for the same directory are taken together and resolved as a batch.
+// With more than one runner, any remaining requests are left to the others.
 //
 do{theQ.rqAvail.Wait();
-   theQ.Mutex.Lock(); inQ = 1;
+   theQ.Mutex.Lock();
    while((rP = theQ.rqFirst))
-        {if (!(theQ.rqFirst = rP->Next)) {theQ.rqLast = 0; inQ = 0;}
-         theQ.qNum--;
+        {theQ.rqFirst = rP->Next; rP->Next = 0; rNum = 1;
+         if (lclStat && theQ.rqFirst && (dLen = DirLen(rP)))
+            {XrdCmsBaseFR *lP = rP;
+             pP = 0; xP = theQ.rqFirst;
+             while(xP && rNum < maxBatch)
+                  {if (DirLen(xP) == dLen && !strncmp(xP->Path,rP->Path,dLen))
+                      {if (pP) pP->Next = xP->Next;
+                          else theQ.rqFirst = xP->Next;
+                       lP->Next = xP; lP = xP; xP = xP->Next; lP->Next = 0;
+                       rNum++;
+                      } else {pP = xP; xP = xP->Next;}
+                  }
+             if ((theQ.rqLast = theQ.rqFirst))
+                while(theQ.rqLast->Next) theQ.rqLast = theQ.rqLast->Next;
+            } else dLen = 0;
+         if (!theQ.rqFirst) theQ.rqLast = 0;
+            else if (numRunners > 1) theQ.rqAvail.Post();
+         theQ.qNum -= rNum;
          theQ.Mutex.UnLock();
-         Xeq(rP); delete rP;
-         if (!inQ) break;
+         if (rNum > 1) XeqBatch(rP, rNum, dLen);
+            else {Xeq(rP); delete rP;}
          theQ.Mutex.Lock();
         }
-   if (inQ) theQ.Mutex.UnLock();
+   theQ.Mutex.UnLock();
   } while(1);
 }
 
+/******************************************************************************/
+/* Private:                         S c a n                                   */
+/******************************************************************************/
+
+// Read the directory common to all of the requests and note which of the files
+// actually exist. We return false if the directory listing can't be trusted.
+  
+bool XrdCmsBaseFS::Scan(XrdCmsBaseFR *rP, int rNum, int dLen, char *Found)
+{
+   XrdOucEnv     myEnv;
+   XrdOssDF     *dP;
+   const char   *fName[maxBatch];
+   char          dPath[XrdCmsMAX_PATH_LEN], eName[XrdCmsMAX_PATH_LEN];
+   bool          upDir = false;
+   int           i, rc, nLeft = rNum;
+
+// Construct the directory path and the list of file names we are looking for
+//
+   if (dLen >= (int)sizeof(dPath)) return false;
+   strncpy(dPath, rP->Path, dLen); dPath[dLen] = '\0';
+   for (i = 0; i < rNum && rP; i++, rP = rP->Next) fName[i] = rP->Path+dLen+1;
+   memset(Found, 0, rNum);
+
+// Open the directory
+//
+   if (!(dP = Config.ossFS->newDir("cmsd"))) return false;
+   if (dP->Opendir(dPath, myEnv)) {delete dP; return false;}
+
+// Read every entry. A real directory always lists its parent which we use to
+// weed out simulated listings that only contain a placeholder. The same file
+// may be looked up more than once (e.g. by redundant managers), so mark every
+// request for it.
+//
+   while(!(rc = dP->Readdir(eName, sizeof(eName))) && *eName && nLeft)
+        {if (!upDir && !strcmp(eName, "..")) {upDir = true; continue;}
+         for (i = 0; i < rNum; i++)
+             if (!Found[i] && !strcmp(eName, fName[i]))
+                {Found[i] = 1; nLeft--;}
+        }
+   dP->Close(); delete dP;
+
+// If all files were found, the outcome is the same as not having scanned
+//
+   return !nLeft || (!rc && upDir);
+}
+
 /******************************************************************************/
 /*                                 S t a r t                                  */
 /******************************************************************************/
@@ -365,7 +451,7 @@ void XrdCmsBaseFS::Start()
    DEBUG("Srv=" <<int(Server) <<" dfs=" <<int(dfsSys) <<" lcl=" <<int(lclStat)
          <<" Pre=" <<int(preSel) <<" dmLife=" <<dmLife <<' ' <<dpLife);
    DEBUG("Lim=" <<theQ.rLimit <<' ' <<theQ.rAgain <<" fix=" <<int(Fixed)
-         <<" Qmax=" <<theQ.qMax);
+         <<" Qmax=" <<theQ.qMax <<" Runners=" <<numRunners <<" Scan=" <<scanMin);
 
 // Set the passthru option if we can't do this locally and have no limit
 //
@@ -379,6 +465,14 @@ void XrdCmsBaseFS::Start()
        ||  XrdSysThread::Run(&tid, XrdCmsBaseRunner, Me, 0, "fsQ runner"))
           {Say.Emsg("cmsd", errno, "start baseFS queue handler");
            theQ.rLimit = 0;
+          } else {
+           for (int i = 1; i < numRunners; i++)
+               if (XrdSysThread::Run(&tid, XrdCmsBaseRunner, Me, 0,
+                                     "fsQ runner"))
+                  {Say.Emsg("cmsd", errno, "start baseFS queue runner");
+                   numRunners = i;
+                   break;
+                  }
           }
       }
 }
@@ -418,3 +512,31 @@ void XrdCmsBaseFS::Xeq(XrdCmsBaseFR *rP)
    rc = Exists(rP->Path, rP->PDirLen);
    if (cBack) (*cBack)(rP, rc);
 }
+
+/******************************************************************************/
+/* Private:                     X e q B a t c h                               */
+/******************************************************************************/
+
+void XrdCmsBaseFS::XeqBatch(XrdCmsBaseFR *rP, int rNum, int dLen)
+{
+   XrdCmsBaseFR *nP;
+   char Found[maxBatch];
+   bool Scanned;
+   int i;
+
+// If there are enough requests for the same directory, read the directory to
+// eliminate files that don't exist. Those are answered without a stat().
+//
+   Scanned = scanMin && rNum >= scanMin && Scan(rP, rNum, dLen, Found);
+
+// Resolve each request
+//
+   for (i = 0; rP; rP = nP, i++)
+       {nP = rP->Next; rP->Next = 0;
+        if (Scanned && !Found[i]
+        &&  !(Config.DiskSS && PrepQ.Exists(rP->Path)))
+           {if (cBack) (*cBack)(rP, -1);}
+           else Xeq(rP);
+        delete rP;
+       }
+}
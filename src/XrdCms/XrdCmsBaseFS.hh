@@ -88,6 +88,15 @@ class XrdCmsBaseFS
 {
 public:
 
+// Batch() sets the number of threads resolving queued requests and the number
+//         of queued requests for the same directory that warrants reading the
+//         directory instead of checking each file (0 -> never).
+//
+       void             Batch(int nRun, int nScan)
+                             {numRunners = (nRun  > 0 ? nRun  : 1);
+                              scanMin    = (nScan > 1 ? nScan : 0);
+                             }
+
        int              dfsTries() {return dfsMaxTries;}
 
 // Exists() returns a tri-logic state:
@@ -149,7 +158,8 @@ inline int              Traverse() {return Punt;}
        XrdCmsBaseFS(void (*theCB)(XrdCmsBaseFR *, int))
                    : cBack(theCB), dfsMaxTries(dfltDfsTries),
                                    stgMaxTries(dfltStgTries),
-                     dmLife(0), dpLife(0), lclStat(0), preSel(1),
+                     dmLife(0), dpLife(0), numRunners(1), scanMin(0),
+                     lclStat(0), preSel(1),
                      dfsSys(0), Server(0), Fixed(0), Punt(0) {}
       ~XrdCmsBaseFS() {}
 
@@ -157,12 +167,17 @@ private:
 
 struct dMoP {int        Present;};
 
+static const int        maxBatch = 64;
+
        int              Bypass();
+static int              DirLen(XrdCmsBaseFR *rP);
        int              FStat( char *Path, int fnPos, int upat=0);
        int              hasDir(char *Path, int fnPos);
        void             Queue(XrdCmsRRData &Arg, XrdCmsPInfo &Who,
                               int dln, int Frc=0);
+       bool             Scan(XrdCmsBaseFR *rP, int rNum, int dLen, char *Found);
        void             Xeq(XrdCmsBaseFR *rP);
+       void             XeqBatch(XrdCmsBaseFR *rP, int rNum, int dLen);
 
        XrdSysMutex      fsMutex;
        XrdOucHash<dMoP> fsDirMP;
@@ -193,6 +208,8 @@ struct RequestQ
        int              stgMaxTries;
        int              dmLife;
        int              dpLife;
+       int              numRunners; // Threads resolving queued requests
+       int              scanMin;    // Min requests per directory for a scan
        char             lclStat;  // 1-> Local stat() calls wanted
        char             preSel;   // 1-> Preselect before redirect
        char             dfsSys;   // 1-> Distributed Filesystem
@@ -271,6 +271,51 @@ int  XrdCmsCache::GetFile(XrdCmsSelect &Sel, SMask_t mask)
    return retc;
 }
 
+/******************************************************************************/
+/* Public                        N i l F i l e                                */
+/******************************************************************************/
+
+// This method is used when the file is known not to exist anywhere (e.g. all
+// of the name space summaries say so). The entry is created or reset as if all
+// nodes had been queried and none responded, so that the client need not wait.
+  
+int XrdCmsCache::NilFile(XrdCmsSelect &Sel)
+{
+   XrdCmsKeyItem *iP;
+
+// Serialize processing
+//
+   myMutex.Lock();
+
+// Find or add the entry
+//
+   if (  !(iP = Sel.Path.TODRef) || !(iP->Key.Equiv(Sel.Path)))
+      if (!(iP = CTable.Find(Sel.Path)))
+         {Sel.Path.TOD = Tock;
+          iP = CTable.Add(Sel.Path);
+         }
+
+// Mark the entry as resolved with no locations
+//
+   if (iP)
+      {iP->Loc.hfvec    = 0;
+       iP->Loc.pfvec    = 0;
+       iP->Loc.qfvec    = 0;
+       iP->Loc.deadline = 0;
+       iP->Loc.lifeline = nilTMO + time(0);
+       iP->Loc.TOD_B    = BClock;
+       iP->Key.TOD      = Tock;
+       Sel.Path.Ref     = iP->Key.Ref;
+      }
+   Sel.Path.TODRef = iP;
+
+// All done
+//
+   myMutex.UnLock();
+   Sel.Vec.hf = Sel.Vec.pf = Sel.Vec.bf = 0;
+   return (iP ? 1 : 0);
+}
+
 /******************************************************************************/
 /* Public                        U n k F i l e                                */
 /******************************************************************************/
@@ -516,7 +561,7 @@ SMask_t XrdCmsCache::getBVec(unsigned int TODa, unsigned int &TODb)
 // Calculate the new vector
 //
    for (i = 0; i <= vecHi; i++)
-       if (TODb < Bounced[i]) BVec |= 1ULL << i;
+       if (TODb < Bounced[i]) BVec |= SMaskBit(i);
 
    Bhistory[TODa].Vec   = BVec;
    Bhistory[TODa].Start = TODb;
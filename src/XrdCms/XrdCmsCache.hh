@@ -61,6 +61,11 @@ int         DelFile(XrdCmsSelect &Sel, SMask_t mask);
 //
 int         GetFile(XrdCmsSelect &Sel, SMask_t mask);
 
+// NilFile() records that no node has the file without querying any of them.
+//           It returns 1 upon success and 0 otherwise.
+//
+int         NilFile(XrdCmsSelect &Sel);
+
 // UnkFile() updates the unqueried vector and returns 1 upon success, 0 o/w.
 //
 int         UnkFile(XrdCmsSelect &Sel, SMask_t mask);
@@ -80,13 +85,11 @@ void       *TickTock();
 
 static const int min_nxTime = 60;
 
-            XrdCmsCache() : okVec(0), Tick(8*60*60), Tock(0), BClock(0), 
-                            nilTMO(0),
+            XrdCmsCache() : Bhistory(), Bounced(), okVec(0), Tick(8*60*60),
+                            Tock(0), BClock(0), nilTMO(0),
                             DLTime(5), QDelay(5), Bhits(0), Bmiss(0), vecHi(-1),
                             isDFS(0)
-                          {memset(Bounced,  0, sizeof(Bounced));
-                           memset(Bhistory, 0, sizeof(Bhistory));
-                          }
+                          {}
            ~XrdCmsCache() {}   // Never gets deleted
 
 private:
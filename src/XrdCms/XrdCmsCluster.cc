@@ -53,6 +53,7 @@
 #include "XrdCms/XrdCmsRRQ.hh"
 #include "XrdCms/XrdCmsState.hh"
 #include "XrdCms/XrdCmsSelect.hh"
+#include "XrdCms/XrdCmsSummary.hh"
 #include "XrdCms/XrdCmsTrace.hh"
 #include "XrdCms/XrdCmsTypes.hh"
 
@@ -600,7 +601,7 @@ int XrdCmsCluster::Locate(XrdCmsSelect &Sel)
 //
    if (*Sel.Path.Val != '*') Path = Sel.Path.Val;
       else {if (*(Sel.Path.Val+1) == '\0')
-               {Sel.Vec.hf = ~0LL; Sel.Vec.pf = Sel.Vec.wf = 0;
+               {Sel.Vec.hf = FULLMASK; Sel.Vec.pf = Sel.Vec.wf = 0;
                 return 0;
                }
             Path = Sel.Path.Val+1;
@@ -646,12 +647,16 @@ int XrdCmsCluster::Locate(XrdCmsSelect &Sel)
 // First check if we have seen this file before. If so, get nodes that have it.
 // A Refresh request kills this because it's as if we hadn't seen it before.
 // If the file was found but either a query is in progress or we have a server
-// bounce; the client must wait.
+// bounce; the client must wait. Otherwise, only nodes whose name space summary
+// admits the file are asked. If there are none, the file does not exist.
 //
    if (Sel.Opts & XrdCmsSelect::Refresh 
    || !(retc = Cache.GetFile(Sel, pinfo.rovec)))
-      {Cache.AddFile(Sel, 0);
-       qfVec = pinfo.rovec; Sel.Vec.hf = 0;
+      {qfVec = (Sel.Opts & XrdCmsSelect::Refresh ? pinfo.rovec
+             :  Summary.Maybe(Sel.Path.Val, pinfo.rovec));
+       if (qfVec) Cache.AddFile(Sel, 0);
+          else    retc = Cache.NilFile(Sel);
+       Sel.Vec.hf = 0;
       } else qfVec = Sel.Vec.bf;
 
 // Compute the delay, if any
@@ -920,7 +925,7 @@ int XrdCmsCluster::Select(XrdCmsSelect &Sel)
    XrdCmsPInfo  pinfo;
    const char  *Amode;
    int dowt = 0, retc = 0, isRW, fRD, noSel = (Sel.Opts & XrdCmsSelect::Defer);
-   SMask_t amask, smask, pmask;
+   SMask_t amask, smask, pmask, qmask;
 
 // Establish some local options
 //
@@ -969,15 +974,20 @@ int XrdCmsCluster::Select(XrdCmsSelect &Sel)
       }
 
 // If either a refresh is wanted or we didn't find the file, re-prime the cache
-// which will force the client to wait. Otherwise, compute the primary and
+// which will force the client to wait unless the name space summaries show
+// that no node has the file. In that case, we proceed as if all nodes had been
+// queried and said they don't have it. Otherwise, compute the primary and
 // secondary selections. If there are none, the client may have to wait if we
 // have servers that we can query regarding the file. Note that for files being
 // opened in write mode, only one writable copy may exist unless this is a
 // meta-operation (e.g., remove) in which case the file itself remain unmodified
 // or a replica request, in which case we select a new target server.
 //
+   qmask = pinfo.rovec;
    if (!(Sel.Opts & XrdCmsSelect::Refresh)
-   &&   (retc = Cache.GetFile(Sel, pinfo.rovec)))
+   &&   ((retc = Cache.GetFile(Sel, pinfo.rovec))
+   ||    (!(qmask = Summary.Maybe(Sel.Path.Val, pinfo.rovec))
+   &&      (retc = Cache.NilFile(Sel)))))
       {if (isRW)
           {     if (retc<0) return Config.LUPDelay;
               else if (Sel.Opts & XrdCmsSelect::Replica)
@@ -1008,7 +1018,7 @@ int XrdCmsCluster::Select(XrdCmsSelect &Sel)
        if (Sel.Vec.hf & Sel.nmask) Cache.UnkFile(Sel, Sel.nmask);
       } else {
        Cache.AddFile(Sel, 0); 
-       Sel.Vec.bf = pinfo.rovec; 
+       Sel.Vec.bf = qmask; 
        Sel.Vec.hf = Sel.Vec.pf = pmask = smask = 0;
        retc = 0;
       }
@@ -1071,11 +1081,9 @@ int XrdCmsCluster::Select(XrdCmsSelect &Sel)
 int XrdCmsCluster::Select(SMask_t pmask, int &port, char *hbuff, int &hlen,
                           int isrw, int isMulti, int ifWant)
 {
-   static const SMask_t smLow(255);
    XrdCmsSelector selR;
    XrdCmsNode *nP = 0;
-   SMask_t tmask;
-   int Snum = 0;
+   int Snum;
    XrdNetIF::ifType nType = static_cast<XrdNetIF::ifType>(ifWant);
 
 // If there is nothing to select from, return failure
@@ -1107,9 +1115,7 @@ int XrdCmsCluster::Select(SMask_t pmask, int &port, char *hbuff, int &hlen,
 // In shared-nothing systems the incomming mask will only have a single node.
 // Compute the a single node number that is contained in the mask.
 //
-   do {if (!(tmask = pmask & smLow)) Snum += 8;
-         else {while((tmask = tmask>>1)) Snum++; break;}
-      } while((pmask = pmask >> 8));
+   Snum = SMaskFirst(pmask);
 
 // See if the node passes muster
 //
@@ -1465,30 +1471,7 @@ int XrdCmsCluster::Drop(int sent, int sinst, XrdCmsDrop *djp)
 
 int XrdCmsCluster::Multiple(SMask_t mVec)
 {
-   static const unsigned long long Left32  = 0xffffffff00000000LL;
-   static const unsigned long long Right32 = 0x00000000ffffffffLL;
-   static const unsigned long long Left16  = 0x00000000ffff0000LL;
-   static const unsigned long long Right16 = 0x000000000000ffffLL;
-   static const unsigned long long Left08  = 0x000000000000ff00LL;
-   static const unsigned long long Right08 = 0x00000000000000ffLL;
-   static const unsigned long long Left04  = 0x00000000000000f0LL;
-   static const unsigned long long Right04 = 0x000000000000000fLL;
-//                                0 1 2 3 4 5 6 7 8 9 A B C D E F
-   static const int isMult[16] = {0,0,0,1,0,1,1,1,0,1,1,1,1,1,1,1};
-
-   if (mVec & Left32) {if (mVec & Right32) return 1;
-                          else mVec = mVec >> 32LL;
-                      }
-   if (mVec & Left16) {if (mVec & Right16) return 1;
-                          else mVec = mVec >> 16LL;
-                      }
-   if (mVec & Left08) {if (mVec & Right08) return 1;
-                          else mVec = mVec >>  8LL;
-                      }
-   if (mVec & Left04) {if (mVec & Right04) return 1;
-                          else mVec = mVec >>  4LL;
-                      }
-   return isMult[mVec];
+   return SMaskCount(mVec) > 1;
 }
   
 /******************************************************************************/
@@ -1497,19 +1480,7 @@ int XrdCmsCluster::Multiple(SMask_t mVec)
   
 bool XrdCmsCluster::maxBits(SMask_t mVec, int mbits)
 {
-   int count = 0;
-
-// Count bits. This is the fastest way assuming few bits are set
-//
-   while(mVec)
-        {mVec &= (mVec - 1);
-         count++;
-         if (count >= mbits) return true;
-        }
-
-// Indicate we have not reached the maximum bits set
-//
-   return false;
+   return SMaskCount(mVec) >= mbits;
 }
 
 /******************************************************************************/
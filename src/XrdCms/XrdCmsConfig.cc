@@ -62,6 +62,7 @@
 #include "XrdCms/XrdCmsRRQ.hh"
 #include "XrdCms/XrdCmsSecurity.hh"
 #include "XrdCms/XrdCmsState.hh"
+#include "XrdCms/XrdCmsSummary.hh"
 #include "XrdCms/XrdCmsSupervisor.hh"
 #include "XrdCms/XrdCmsTrace.hh"
 #include "XrdCms/XrdCmsUtils.hh"
@@ -136,6 +137,8 @@ void *XrdCmsStartMonRefs(void *carg) { return Cluster.MonRefs(); }
 
 void *XrdCmsStartMonStat(void *carg) { return CmsState.Monitor(); }
 
+void *XrdCmsStartSummary(void *carg) { return Summary.Publish(); }
+
 void *XrdCmsStartAdmin(void *carg)
       {return XrdCms::Admin.Start((XrdNetSocket *)carg);
       }
@@ -419,6 +422,21 @@ int XrdCmsConfig::Configure2()
   if (!NoGo && isManager)              NoGo = setupManager();
   if (!NoGo && (isServer || ManList))  NoGo = setupServer();
 
+// Enable name space summaries if so wanted. A manager only relies on a
+// summary while it is younger than the fxhold noloc time, so without it the
+// summaries would be collected but never used.
+//
+  if (!NoGo && SumTime && isManager)
+     {if (!emptylife)
+         {Say.Emsg("Config", "summary requires fxhold noloc to be specified.");
+          NoGo = 1;
+         }
+      else if (SumTime > emptylife)
+         Say.Say("Config warning: summary interval exceeds fxhold noloc; "
+                 "summaries will often be too old to be used!");
+     }
+  if (!NoGo && SumTime) Summary.Init(SumTime, SumSize, SumHash, emptylife);
+
 // If we are a solo peer then we have no servers and a lot of space and
 // connections don't matter. Only one connection matters for a meta-manager.
 // Servers, supervisors, and managers who have a meta manager must wait for
@@ -501,6 +519,7 @@ int XrdCmsConfig::ConfigXeq(char *var, XrdOucStream &CFile, XrdSysError *eDest)
    TS_Xeq("role",          xrole);   // Server,  non-dynamic
    TS_Xeq("seclib",        xsecl);   // Server,  non-dynamic
    TS_Xeq("subcluster",    xsubc);   // Manager, non-dynamic
+   TS_Xeq("summary",       xsumry);  // Any,     non-dynamic
    TS_Set("wait",          doWait);  // Server,  non-dynamic (backward compat)
    TS_unSet("nowait",      doWait);  // Server,  non-dynamic
    TS_Xer("whitelist",     xblk,true);//Manager, non-dynamic
@@ -578,6 +597,17 @@ void XrdCmsConfig::DoIt()
 //
    if (isManager || isServer || isPeer) XrdCmsManager::Start(ManList);
 
+// Start publishing name space summaries if we are a data server that exports
+// a local name space. Staging servers don't as their summary would only list
+// files on disk while any file in the mass storage system may be staged.
+//
+   if (SumTime && isServer && !isManager && !isProxy && !DiskSS
+   &&  !baseFS.isDFS())
+      {if (XrdSysThread::Run(&tid, XrdCmsStartSummary, (void *)0,
+                             0, "Summary publisher"))
+          Say.Emsg("cmsd", errno, "start summary publisher");
+      }
+
 // Start state monitoring thread
 //
    if (XrdSysThread::Run(&tid, XrdCmsStartMonStat, (void *)0,
@@ -664,6 +694,9 @@ void XrdCmsConfig::ConfigDefaults(void)
    DoHnTry  = 1;
    MaxDelay = -1;
    LogPerf  = 10;         // Every 10 usage requests
+   SumTime  = 0;          // No name space summaries
+   SumSize  = 1024*1024;  // 8M bits
+   SumHash  = 7;
    DiskMin  = 10240;      // 10GB*1024 (Min partition space) in MB
    DiskHWM  = 11264;      // 11GB*1024 (High Water Mark SUO) in MB
    DiskMinP = 2;
@@ -1561,7 +1594,12 @@ int XrdCmsConfig::xdefs(XrdSysError *eDest, XrdOucStream &CFile)
 
    Purpose:  To parse the directive: dfs <opts>
 
-   <opts>:   limit [central] [=]<n>
+   <opts>:   batch <n>         - number of threads that resolve queued lookups.
+                                 Queued lookups for the same directory are
+                                 resolved together by one thread. The default
+                                 is 1. Only meaningful when a limit is set.
+
+             limit [central] [=]<n>
                        central - apply limit on manager node. Otherwise, limit
                                  is applied where lookups occur.
                        [=]<n>  - the limit value as transactions per second. If
@@ -1591,6 +1629,11 @@ int XrdCmsConfig::xdefs(XrdSysError *eDest, XrdOucStream &CFile)
 
              retries <n>         Maximum number of select retries.
 
+             scan <n>          - when at least n queued lookups refer to the
+                                 same directory, read the directory once and
+                                 only stat() the files that are listed. Zero
+                                 (default) turns this off.
+
    Type: Any, non-dynamic.
 
    Output: 0 upon success or !0 upon failure.
@@ -1601,6 +1644,7 @@ int XrdCmsConfig::xdfs(XrdSysError *eDest, XrdOucStream &CFile)
     int Opts = XrdCmsBaseFS::DFSys | (isProxy ? XrdCmsBaseFS::Immed : 0)
              | (!isManager && isServer ? XrdCmsBaseFS::Servr: 0);
     int Hold = 0, limCent = 0, limFix = 0, limV = 0, qMax = 0, rTry = 0;
+    int nBat = 1, nScan = 0;
     char *val;
 
 // If we are a meta-manager or a peer, ignore this option
@@ -1614,7 +1658,12 @@ int XrdCmsConfig::xdfs(XrdSysError *eDest, XrdOucStream &CFile)
 
 // Now parse each option
 //
-do{     if (!strcmp("mdhold",  val))
+do{     if (!strcmp("batch",   val))
+           {if (!(val = CFile.GetWord()))
+               {eDest->Emsg("Config","batch value not specified.");   return 1;}
+            if (XrdOuca2x::a2i(*eDest,"batch value",val,&nBat,1,64))  return 1;
+           }
+   else if (!strcmp("mdhold",  val))
            {if (!(val = CFile.GetWord()))
                {eDest->Emsg("Config","mdhold value not specified.");  return 1;}
             if (XrdOuca2x::a2tm(*eDest, "hold value", val, &Hold, 0)) return 1;
@@ -1655,6 +1704,11 @@ do{     if (!strcmp("mdhold",  val))
                {eDest->Emsg("Config","retries value not specified.");    return 1;}
             if (XrdOuca2x::a2i(*eDest, "retries value", val, &rTry, 1))  return 1;
            }
+   else if (!strcmp("scan",    val))
+           {if (!(val = CFile.GetWord()))
+               {eDest->Emsg("Config","scan value not specified.");    return 1;}
+            if (XrdOuca2x::a2i(*eDest,"scan value",val,&nScan,0,64))  return 1;
+           }
    else {eDest->Emsg("Config", "invalid dfs option '",val,"'."); return 1;}
   } while((val = CFile.GetWord()));
 
@@ -1682,6 +1736,7 @@ do{     if (!strcmp("mdhold",  val))
 //
    baseFS.SetTries(true, rTry);
    baseFS.Limit(limV, qMax);
+   baseFS.Batch(nBat, nScan);
    baseFS.Init(Opts, Hold, Hold*10);
    return 0;
 }
@@ -2864,6 +2919,81 @@ int XrdCmsConfig::xsubc(XrdSysError *eDest, XrdOucStream &CFile)
    return (XrdCmsUtils::ParseMan(eDest, &SanList, hSpec, hPort) ? 0 : 1);
 }
   
+/******************************************************************************/
+/*                                x s u m r y                                 */
+/******************************************************************************/
+
+/* Function: xsumry
+
+   Purpose:  To parse the directive: summary [interval <sec>] [size <bytes>]
+                                             [hashes <num>]
+
+             <sec>     Time (seconds, M, H. etc) between full name space
+                       summaries published by a data server. The default is
+                       30 minutes.
+             <bytes>   The size of the summary (K, M, etc). The default is 1M
+                       which comfortably describes about 800,000 names.
+             <num>     The number of hash functions per name. The default is 7.
+
+   Notes: Managers that specify this directive ask their data servers for name
+          space summaries and only query the servers whose summary admits a
+          file. Data servers that specify it publish a summary to every manager
+          that asks for one. Only data servers use the options. Files that
+          are placed in the name space other than via the data server only
+          appear in the next summary. Hence, a manager relies on a summary only
+          while it is younger than the time non-existence may be cached (i.e.
+          fxhold noloc). Hence, a manager refuses to start when summary is
+          specified without fxhold noloc and warns when the interval is
+          longer than the noloc time as most summaries would then be too old
+          to be used. Staging servers never publish a summary.
+
+   Type: Any, non-dynamic.
+
+   Output: 0 upon success or !0 upon failure.
+*/
+
+int XrdCmsConfig::xsumry(XrdSysError *eDest, XrdOucStream &CFile)
+{
+    long long ssz = SumSize;
+    int sht = SumHash, stm = (SumTime ? SumTime : 30*60);
+    char *val;
+
+    while((val = CFile.GetWord()))
+        {     if (!strcmp("interval", val))
+                 {if (!(val = CFile.GetWord()))
+                     {eDest->Emsg("Config", "summary interval not specified");
+                      return 1;
+                     }
+                  if (XrdOuca2x::a2tm(*eDest,"summary interval",val,&stm,60))
+                     return 1;
+                 }
+         else if (!strcmp("size", val))
+                 {if (!(val = CFile.GetWord()))
+                     {eDest->Emsg("Config", "summary size not specified");
+                      return 1;
+                     }
+                  if (XrdOuca2x::a2sz(*eDest,"summary size",val,&ssz,
+                                      XrdCmsSummary::minSize,
+                                      XrdCmsSummary::maxSize)) return 1;
+                 }
+         else if (!strcmp("hashes", val))
+                 {if (!(val = CFile.GetWord()))
+                     {eDest->Emsg("Config", "summary hashes not specified");
+                      return 1;
+                     }
+                  if (XrdOuca2x::a2i(*eDest,"summary hashes",val,&sht,1,
+                                     XrdCmsSummary::maxHash)) return 1;
+                 }
+         else {eDest->Emsg("Config", "invalid summary option -", val);
+               return 1;
+              }
+        }
+    SumTime = stm;
+    SumSize = static_cast<int>(ssz);
+    SumHash = sht;
+    return 0;
+}
+
 /******************************************************************************/
 /*                                x t r a c e                                 */
 /******************************************************************************/
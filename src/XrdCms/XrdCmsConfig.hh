@@ -89,6 +89,9 @@ int         AskPerf;      // Seconds between perf queries
 int         AskPing;      // Number of ping requests per AskPerf window
 int         PingTick;     // Ping clock value
 int         LogPerf;      // AskPerf intervals before logging perf
+int         SumTime;      // Seconds between name space summaries (0 -> none)
+int         SumSize;      // Bytes in a name space summary
+int         SumHash;      // Hash functions per name space summary entry
 
 int         PortTCP;      // TCP Port to  listen on
 XrdInet    *NetTCP;       // -> Network Object
@@ -225,6 +228,7 @@ int  xschedm(char *val, XrdSysError *eDest, XrdOucStream &CFile);
 int  xsecl(XrdSysError *edest, XrdOucStream &CFile);
 int  xspace(XrdSysError *edest, XrdOucStream &CFile);
 int  xsubc(XrdSysError *edest, XrdOucStream &CFile);
+int  xsumry(XrdSysError *edest, XrdOucStream &CFile);
 int  xtrace(XrdSysError *edest, XrdOucStream &CFile);
 
 XrdInet          *NetTCPr;     // Network for supervisors
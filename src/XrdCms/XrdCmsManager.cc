@@ -576,6 +576,37 @@ bool XrdCmsManager::Start(const XrdOucTList *mL)
    return xnum == mtot;
 }
 
+/******************************************************************************/
+/*                             S u m m a r i z e                              */
+/******************************************************************************/
+
+// Send a name space summary fragment to each manager that asked for summaries.
+// We return the number of managers the fragment was sent to.
+//
+int XrdCmsManager::Summarize(struct iovec *vP, int vN, int vT)
+{
+   XrdCmsNode *nP;
+   int i, numSent = 0;
+
+// Obtain a lock on the table
+//
+   MTMutex.Lock();
+
+// Run through the table looking for managers that want the summary
+//
+   for (i = 0; i <= MTHi; i++)
+       {if ((nP=MastTab[i]) && !nP->isOffline && nP->isSumry)
+           {nP->Lock(true);
+            MTMutex.UnLock();
+            if (nP->Send(vP, vN, vT) >= 0) numSent++;
+            nP->UnLock();
+            MTMutex.Lock();
+           }
+       }
+   MTMutex.UnLock();
+   return numSent;
+}
+
 /******************************************************************************/
 /*                                V e r i f y                                 */
 /******************************************************************************/
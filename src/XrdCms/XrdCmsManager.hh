@@ -83,6 +83,8 @@ static void Reset();
 
 static bool Start(const XrdOucTList *mL);
 
+static int  Summarize(struct iovec *vP, int vN, int vT);
+
        bool Verify(XrdLink *lP, const char *sid, const char *sname);
 
             XrdCmsManager(XrdOucTList *mlP, int snum);
@@ -55,6 +55,7 @@
 #include "XrdCms/XrdCmsNode.hh"
 #include "XrdCms/XrdCmsSelect.hh"
 #include "XrdCms/XrdCmsState.hh"
+#include "XrdCms/XrdCmsSummary.hh"
 #include "XrdCms/XrdCmsTrace.hh"
 
 #include "XrdOss/XrdOss.hh"
@@ -92,11 +93,10 @@ XrdCmsNode::XrdCmsNode(XrdLink *lnkp, const char *theIF, const char *nid,
                        int port, int lvl, int id) : nodeMutex(0, "nodeCV")
 {
     static XrdSysMutex   iMutex;
-    static const SMask_t smask_1(1);
     static int           iNum = 1;
 
     Link     =  lnkp;
-    NodeMask =  (id < 0 ? 0 : smask_1 << id);
+    NodeMask =  (id < 0 ? SMask_t(0) : SMaskBit(id));
     NodeID   = id;
     cidP     =  0;
     hasNet   =  0;
@@ -110,6 +110,7 @@ XrdCmsNode::XrdCmsNode(XrdLink *lnkp, const char *theIF, const char *nid,
     isMan    =  0;
     isKnown  =  0;
     isPeer   =  0;
+    isSumry  =  0;
     incUL    =  0;
     myCost   =  0;
     myLoad   =  0;
@@ -476,7 +477,10 @@ const char *XrdCmsNode::do_Have(XrdCmsRRData &Arg)
             if (baseFS.isDFS())
                {Sel.Vec.hf = pinfo.rovec; Sel.Vec.wf = pinfo.rwvec;
                 isnew       = Cache.AddFile(Sel, allNodes);
-               } else isnew = Cache.AddFile(Sel, NodeMask);
+               } else {
+                isnew       = Cache.AddFile(Sel, NodeMask);
+                Summary.Have(NodeID, Arg.Path);
+               }
            }
 
 // Return if we have no managers or we already informed the managers
@@ -1618,6 +1622,23 @@ const char *XrdCmsNode::do_Status(XrdCmsRRData &Arg)
    return 0;
 }
 
+/******************************************************************************/
+/*                            d o _ S u m m a r y                             */
+/******************************************************************************/
+  
+// Summaries are sent by data servers to managers that asked for them at login.
+// Each request carries one fragment of the server's name space summary.
+//
+const char *XrdCmsNode::do_Summary(XrdCmsRRData &Arg)
+{
+
+// Process: summary <sumdata> <bits>
+// Respond: n/a
+//
+   if (Config.asManager()) Summary.Update(NodeID, Arg.Buff, Arg.Dlen);
+   return 0;
+}
+
 /******************************************************************************/
 /*                              d o _ T r u n c                               */
 /******************************************************************************/
@@ -73,6 +73,7 @@ public:
        char   RoleID;       //5 The converted XrdCmsRole::RoleID
        char   TimeZone;     //6 Time zone in +UTC-
        char   TZValid;      //7 Time zone has been set
+       char   isSumry;      //0 Set when manager accepts name space summaries
 
 static const char isBlisted  = 0x01; // in isBad -> Node is black listed
 static const char isDisabled = 0x02; // in isBad -> Node is disable (internal)
@@ -117,6 +118,7 @@ static void   do_StateDFS(XrdCmsBaseFR *rP, int rc);
 const  char  *do_StatFS(XrdCmsRRData &Arg);
 const  char  *do_Stats(XrdCmsRRData &Arg);
 const  char  *do_Status(XrdCmsRRData &Arg);
+const  char  *do_Summary(XrdCmsRRData &Arg);
 const  char  *do_Trunc(XrdCmsRRData &Arg);
 const  char  *do_Try(XrdCmsRRData &Arg);
 const  char  *do_Update(XrdCmsRRData &Arg);
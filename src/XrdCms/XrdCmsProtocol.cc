@@ -60,6 +60,7 @@
 #include "XrdCms/XrdCmsRouting.hh"
 #include "XrdCms/XrdCmsRTable.hh"
 #include "XrdCms/XrdCmsState.hh"
+#include "XrdCms/XrdCmsSummary.hh"
 #include "XrdCms/XrdCmsTrace.hh"
 
 #include "XrdOuc/XrdOucCRC.hh"
@@ -396,6 +397,8 @@ void XrdCmsProtocol::Pander(const char *manager, int mport)
                    Say.Emsg("Protocol", "Logged into", sname, Link->Name());
                    if (Data.SID)
                       Manager->Verify(Link, (const char *)Data.SID, sname);
+                   if (Data.Mode & CmsLoginData::kYR_nssum)
+                      {myNode->isSumry = 1; Summary.Kick();}
                    Reason = Dispatch(isUp, TimeOut, 2);
                    rc = 0;
                    loginData.fSpace= Meter.FreeSpace(fsUtil);
@@ -569,6 +572,7 @@ XrdCmsRouting *XrdCmsProtocol::Admit()
    SMask_t      newmask, servset(0);
    int addedp = 0, Status = 0, isPeer = 0, isProxy = 0;
    int isMan, isServ, isSubm, wasSuspended = 0, Share = 100, tZone = 0;
+   int iNum;
 
 // Construct environment data
 //
@@ -584,6 +588,7 @@ XrdCmsRouting *XrdCmsProtocol::Admit()
    if (CmsState.Suspended)      {Data.Mode |= CmsLoginData::kYR_suspend;
                                  wasSuspended = 1;
                                 }
+   if (Summary.isOn())           Data.Mode |= CmsLoginData::kYR_nssum;
    Data.HoldTime = Config.LUPHold;
 
 // Do the login and get the data
@@ -727,6 +732,11 @@ XrdCmsRouting *XrdCmsProtocol::Admit()
 //
    Cluster.ResetRef(servset);
    if (Config.asManager()) {Manager->Reset(); myNode->SyncSpace();}
+
+// Any name space summary we have for this node is stale. The node will send a
+// new one if it publishes summaries at all.
+//
+   Summary.Reset(myNode->ID(iNum));
    myNode->isBad &= ~XrdCmsNode::isDisabled;
 
 // Document the login
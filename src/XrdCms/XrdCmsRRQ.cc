@@ -38,6 +38,7 @@
 #include "XrdCms/XrdCmsRRQ.hh"
 #include "XrdCms/XrdCmsRTable.hh"
 #include "XrdCms/XrdCmsTrace.hh"
+#include "XrdSys/XrdSysAtomics.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysTimer.hh"
 #include <stdio.h>
@@ -54,10 +55,6 @@ using namespace XrdCms;
   
 XrdCmsRRQ             XrdCms::RRQ;
 
-XrdSysMutex           XrdCmsRRQSlot::myMutex;
-XrdCmsRRQSlot        *XrdCmsRRQSlot::freeSlot = 0;
-short                 XrdCmsRRQSlot::initSlot = 0;
-
 /******************************************************************************/
 /*                    E x t e r n a l   F u n c t i o n s                     */
 /******************************************************************************/
@@ -69,6 +66,19 @@ void *XrdCmsRRQ_StartRespond(void *parg) {return RRQ.Respond();}
 /******************************************************************************/
 /*               X r d C m s R R Q   C l a s s   M e t h o d s                */
 /******************************************************************************/
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdCmsRRQ::XrdCmsRRQ() : slabNum(0),   allocNext(0), numWaiting(0),
+                         isWaiting(0), isReady(0),
+                         luFast(0),    luSlow(0),  rdFast(0), rdSlow(0),
+                         Tslice(178),  Tdelay(5),  myClock(0)
+{
+   memset(slabTab, 0, sizeof(slabTab));
+   Grow();
+}
+
 /******************************************************************************/
 /*                                   A d d                                    */
 /******************************************************************************/
@@ -76,39 +86,83 @@ void *XrdCmsRRQ_StartRespond(void *parg) {return RRQ.Respond();}
 short XrdCmsRRQ::Add(short Snum, XrdCmsRRQInfo *Info)
 {
 // EPNAME("RRQ Add");
-   XrdCmsRRQSlot *sp;
+   XrdCmsRRQSlot *sp, *pp;
+   Shard *shP;
 
-// Obtain a slot and fill it in
+// If a slot number given, check if it's the right slot and it is still queued.
+// If so, piggy-back this request to existing one and make a fast exit. We
+// need a slot for this as well, so get it first.
 //
-   if (!(sp = XrdCmsRRQSlot::Alloc(Info))) return 0;
+   if (!(sp = Alloc(Info))) return 0;
 // DEBUG("adding slot " <<sp->slotNum);
 
-// If a slot number given, check if it's the right slot and it is still queued.
-// If so, piggy-back this request to existing one and make a fast exit
-//
-   myMutex.Lock(); Stats.Add2Q++;
-   if (Snum && Slot[Snum].Info.Key == Info->Key && Slot[Snum].Expire)
-      {if (Info->isLU)
-          {sp->LkUp = Slot[Snum].LkUp;
-           Slot[Snum].LkUp = sp;
-          } else {
-           sp->Cont = Slot[Snum].Cont;
-           Slot[Snum].Cont = sp;
+   if (Snum > 0 && Snum < AtomicGet(slabNum)*slabSize)
+      {pp = Slot(Snum); shP = &Shards[Snum % numShards];
+       shP->myMutex.Lock();
+       if (pp->Info.Key == Info->Key && pp->Expire)
+          {if (Info->isLU)
+              {sp->LkUp = pp->LkUp;
+               pp->LkUp = sp;
+              } else {
+               sp->Cont = pp->Cont;
+               pp->Cont = sp;
+              }
+           shP->Add2Q++; shP->PBack++;
+           shP->myMutex.UnLock();
+           return Snum;
           }
-       Stats.PBack++;
-       myMutex.UnLock();
-       return Snum;
+       shP->myMutex.UnLock();
       }
 
-// Queue this slot to the pending response queue and tell the timeout scheduler
+// Queue this slot to its shard's pending response queue and tell the timeout
+// scheduler if it has nothing to do right now.
 //
-   sp->Expire = myClock+1;
-   if (waitQ.Singleton()) isWaiting.Post();
-   waitQ.Prev()->Insert(&sp->Link);
-   myMutex.UnLock();
+   shP = &Shards[sp->slotNum % numShards];
+   shP->myMutex.Lock();
+   shP->Add2Q++;
+   sp->Expire = AtomicGet(myClock)+1;
+   shP->waitQ.Prev()->Insert(&sp->Link);
+   shP->myMutex.UnLock();
+   if (!AtomicInc(numWaiting)) isWaiting.Post();
    return sp->slotNum;
 }
 
+/******************************************************************************/
+/*                                 A l l o c                                  */
+/******************************************************************************/
+  
+XrdCmsRRQSlot *XrdCmsRRQ::Alloc(XrdCmsRRQInfo *theInfo)
+{
+   XrdCmsRRQSlot *sp = 0;
+   Shard *shP;
+   unsigned int n;
+   int i;
+
+// Take a slot from the first shard that has a free one, starting with a
+// different shard each time to spread requests. If none are free, grow.
+//
+   do {AtomicFAdd(n, allocNext, 1);
+       for (i = 0; i < numShards && !sp; i++)
+           {shP = &Shards[(n+i) % numShards];
+            shP->myMutex.Lock();
+            if ((sp = shP->freeSlot)) shP->freeSlot = sp->Cont;
+            shP->myMutex.UnLock();
+           }
+      } while(!sp && Grow());
+
+// Fill out the slot, if we have one
+//
+   if (sp)
+      {sp->Info     = *theInfo;
+       sp->Cont     = 0;
+       sp->LkUp     = 0;
+       sp->Arg1     = 0;
+       sp->Arg2     = 0;
+       sp->onReadyQ = false;
+      }
+   return sp;
+}
+
 /******************************************************************************/
 /*                                   D e l                                    */
 /******************************************************************************/
@@ -118,6 +172,48 @@ void XrdCmsRRQ::Del(short Snum, const void *Key)
      Ready(Snum, Key, 0, 0);
 }
 
+/******************************************************************************/
+/*                                  G r o w                                   */
+/******************************************************************************/
+  
+bool XrdCmsRRQ::Grow()
+{
+   XrdCmsRRQSlot *sp;
+   Shard *shP;
+   char buff[32];
+   int i, n, snum;
+
+// Add another slab of slots unless we reached the maximum
+//
+   slabMutex.Lock();
+   if ((n = slabNum) >= numSlabs) {slabMutex.UnLock(); return false;}
+   sp = slabTab[n] = new XrdCmsRRQSlot[slabSize];
+
+// Number the slots and hand them out to the shards. Slot number zero is never
+// used as it means "no slot".
+//
+   for (i = 0; i < slabSize; i++)
+       {snum = n*slabSize + i;
+        sp[i].slotNum = snum;
+        if (!snum) continue;
+        shP = &Shards[snum % numShards];
+        shP->myMutex.Lock();
+        sp[i].Cont = shP->freeSlot;
+        shP->freeSlot = &sp[i];
+        shP->myMutex.UnLock();
+       }
+   AtomicInc(slabNum);
+   slabMutex.UnLock();
+
+// Tell everyone when we go beyond the initial allocation
+//
+   if (n)
+      {sprintf(buff, "%d", (n+1)*slabSize);
+       Say.Emsg("RRQ", "Request queue expanded to", buff, "slots.");
+      }
+   return true;
+}
+
 /******************************************************************************/
 /*                                  I n i t                                   */
 /******************************************************************************/
@@ -131,7 +227,7 @@ int XrdCmsRRQ::Init(int Tint, int Tdly)
 //
    if (Tint) Tslice = Tint;
    if (Tdly) Tdelay = Tdly;
-   memset(&Stats, 0, sizeof(Stats));
+   Stats = Info();
 
 // Fill out the response structure
 //
@@ -198,13 +294,15 @@ int XrdCmsRRQ::Ready(int Snum, const void *Key, SMask_t mask1, SMask_t mask2)
 {
 // EPNAME("RRQ Ready");
    XrdCmsRRQSlot *sp;
+   Shard *shP;
 
 // Check if it's the right slot and it is still queued.
 //
-   myMutex.Lock();
-   sp = &Slot[Snum];
+   if (Snum <= 0 || Snum >= AtomicGet(slabNum)*slabSize) return 1;
+   sp = Slot(Snum); shP = &Shards[Snum % numShards];
+   shP->myMutex.Lock();
    if (sp->Info.Key != Key || !sp->Expire)
-      {myMutex.UnLock();
+      {shP->myMutex.UnLock();
 //     DEBUG("slot " <<Snum <<" no longer valid");
        return 1;
       }
@@ -213,25 +311,80 @@ int XrdCmsRRQ::Ready(int Snum, const void *Key, SMask_t mask1, SMask_t mask2)
 // a fixed differentiation mask. Accumulate the 1st but replace the 2nd.
 //
    sp->Arg1 |= mask1; sp->Arg2 = mask2;
-   Stats.Resp++;
+   shP->Resp++;
+
+// If the slot is already waiting for the responder we are done
+//
+   if (sp->onReadyQ) {shP->myMutex.UnLock(); return 1;}
 
 // Check if we should still hold on to this slot because the number of actual
 // responders is less than the number needed.
 //
    if (sp->Info.actR < sp->Info.minR)
-      {sp->Info.actR++; Stats.Multi++;
-       myMutex.UnLock();
+      {sp->Info.actR++; shP->Multi++;
+       shP->myMutex.UnLock();
        return 0;
       }
 
 // Move the element from the waiting queue to the ready queue
 //
    sp->Link.Remove();
+   AtomicDec(numWaiting);
+   Ready2Q(sp);
+   shP->myMutex.UnLock();
+// DEBUG("readied slot " <<Snum <<" mask " <<mask);
+   return 1;
+}
+
+/******************************************************************************/
+/*                               R e a d y 2 Q                                */
+/******************************************************************************/
+
+// Called with the slot's shard locked
+//
+void XrdCmsRRQ::Ready2Q(XrdCmsRRQSlot *sp)
+{
+   sp->onReadyQ = true;
+   myMutex.Lock();
    if (readyQ.Singleton()) isReady.Post();
    readyQ.Prev()->Insert(&sp->Link);
    myMutex.UnLock();
-// DEBUG("readied slot " <<Snum <<" mask " <<mask);
-   return 1;
+}
+
+/******************************************************************************/
+/*                               R e c y c l e                                */
+/******************************************************************************/
+  
+void XrdCmsRRQ::Recycle(XrdCmsRRQSlot *rp)
+{
+   XrdCmsRRQSlot *sp, *np;
+   Shard *shP;
+
+// Return the slots in the lookup chain first, then the ones in the select
+// chain, and finally this slot. Each goes back to the shard it belongs to.
+//
+   np = rp->LkUp;
+   while((sp = np))
+        {np = sp->LkUp;
+         shP = &Shards[sp->slotNum % numShards];
+         shP->myMutex.Lock();
+         sp->Info.Key = 0; sp->Cont = shP->freeSlot; shP->freeSlot = sp;
+         shP->myMutex.UnLock();
+        }
+
+   np = rp->Cont;
+   while((sp = np))
+        {np = sp->Cont;
+         shP = &Shards[sp->slotNum % numShards];
+         shP->myMutex.Lock();
+         sp->Info.Key = 0; sp->Cont = shP->freeSlot; shP->freeSlot = sp;
+         shP->myMutex.UnLock();
+        }
+
+   shP = &Shards[rp->slotNum % numShards];
+   shP->myMutex.Lock();
+   rp->Info.Key = 0; rp->Cont = shP->freeSlot; shP->freeSlot = rp;
+   shP->myMutex.UnLock();
 }
 
 /******************************************************************************/
@@ -242,6 +395,7 @@ void *XrdCmsRRQ::Respond()
 {
 // EPNAME("RRQ Respond");
    XrdCmsRRQSlot *sp;
+   Shard *shP;
 
 // In an endless loop, process all ready elements
 //
@@ -250,9 +404,15 @@ void *XrdCmsRRQ::Respond()
        Stats.rdFast += rdFast; Stats.rdSlow += rdSlow;
        Stats.luFast += luFast; Stats.luSlow += luSlow;
        if (readyQ.Singleton()) {myMutex.UnLock(); break;}
-       sp = readyQ.Next()->Item(); sp->Link.Remove(); sp->Expire = 0;
+       sp = readyQ.Next()->Item(); sp->Link.Remove();
        myMutex.UnLock();
 
+    // Once the slot is no longer marked as queued nothing else may be
+    // piggy-backed onto it and we can safely walk its chains.
+    //
+       shP = &Shards[sp->slotNum % numShards];
+       shP->myMutex.Lock(); sp->Expire = 0; shP->myMutex.UnLock();
+
     // A locate request can be pggy-backed on a select request and vice-versa
     // We separate the two queues here as each has a different response.
     //
@@ -269,7 +429,7 @@ void *XrdCmsRRQ::Respond()
               }
            sendRedResp(sp);
           }
-       sp->Recycle();
+       Recycle(sp);
       } while(1);
       } while(1);
 
@@ -399,6 +559,9 @@ void *XrdCmsRRQ::TimeOut()
 {
 // EPNAME("RRQ TimeOut");
    XrdCmsRRQSlot *sp;
+   Shard *shP;
+   unsigned int theClock;
+   int i;
 
 // We measure millisecond intervals to timeout waiting requests. We used to zero
 // out arg1/2 to force expiration, but they would be zero anyway if no responses
@@ -407,22 +570,21 @@ void *XrdCmsRRQ::TimeOut()
 //
    while(1)
         {isWaiting.Wait();
-         myMutex.Lock();
-         while(1)
-              {myClock++;
-               myMutex.UnLock();
-               XrdSysTimer::Wait(Tslice);
-               myMutex.Lock();
-               while((sp=waitQ.Next()->Item()) && sp->Expire < myClock)
-                    {sp->Link.Remove();
-                     if (readyQ.Singleton()) isReady.Post();
-//                   sp->Arg1 = 0; sp->Arg2 = 0;
-//                   DEBUG("expired slot " <<sp->slotNum);
-                     readyQ.Prev()->Insert(&sp->Link);
-                    }
-               if (waitQ.Singleton()) break;
-              }
-         myMutex.UnLock();
+         do {theClock = AtomicInc(myClock) + 1;
+             XrdSysTimer::Wait(Tslice);
+             for (i = 0; i < numShards; i++)
+                 {shP = &Shards[i];
+                  shP->myMutex.Lock();
+                  while((sp=shP->waitQ.Next()->Item()) && sp->Expire < theClock)
+                       {sp->Link.Remove();
+                        AtomicDec(numWaiting);
+//                      sp->Arg1 = 0; sp->Arg2 = 0;
+//                      DEBUG("expired slot " <<sp->slotNum);
+                        Ready2Q(sp);
+                       }
+                  shP->myMutex.UnLock();
+                 }
+            } while(AtomicGet(numWaiting));
         }
 
 // Keep the compiler happy
@@ -431,80 +593,21 @@ void *XrdCmsRRQ::TimeOut()
 }
 
 /******************************************************************************/
-/*           X r d C m s R R Q S l o t   C l a s s   M e t h o d s            */
-/******************************************************************************/
-/******************************************************************************/
-/*                           C o n s t r u c t o r                            */
+/*                            S t a t i s t i c s                             */
 /******************************************************************************/
 
-XrdCmsRRQSlot::XrdCmsRRQSlot() : Link(this)
+void XrdCmsRRQ::Statistics(Info &Data)
 {
-
-   slotNum  = initSlot++;
-   if (slotNum)
-      {Cont     = freeSlot;
-       freeSlot = this;
-      } else Cont = 0;
-   Arg1 = Arg2 = 0;
-   Info.Key = 0;
-}
-
-/******************************************************************************/
-/*                                 A l l o c                                  */
-/******************************************************************************/
-  
-XrdCmsRRQSlot *XrdCmsRRQSlot::Alloc(XrdCmsRRQInfo *theInfo)
-{
-   XrdCmsRRQSlot *sp;
-
-   myMutex.Lock();
-   if ((sp = freeSlot))
-      {sp->Info = *theInfo;
-       freeSlot = sp->Cont;
-       sp->Cont = 0;
-       sp->LkUp = 0;
-       sp->Arg1 = 0;
-       sp->Arg2 = 0;
-      }
-   myMutex.UnLock();
-   return sp;
-}
-
-/******************************************************************************/
-/*                               R e c y c l e                                */
-/******************************************************************************/
-  
-void XrdCmsRRQSlot::Recycle()
-{
-   XrdCmsRRQSlot *sp, *np;
-
-   myMutex.Lock();
-   if (!Link.Singleton()) Link.Remove();
-
-// Remove items in the lookup chain first
-//
-   np = LkUp;
-   while((sp = np))
-        {np           = sp->LkUp;
-         sp->Cont     = freeSlot;
-         freeSlot     = sp;
-         sp->Info.Key = 0;
-        }
-
-// Now remove items in the select chain
-//
-   np = Cont;
-   while((sp = np))
-        {np           = sp->Cont;
-         sp->Cont     = freeSlot;
-         freeSlot     = sp;
-         sp->Info.Key = 0;
-        }
-
-// Now put this item in the free chain
-//
-   Info.Key = 0;
-   Cont     = freeSlot;
-   freeSlot = this;
-   myMutex.UnLock();
+   int i;
+
+   myMutex.Lock(); Data = Stats; myMutex.UnLock();
+
+   for (i = 0; i < numShards; i++)
+       {Shards[i].myMutex.Lock();
+        Data.Add2Q += Shards[i].Add2Q;
+        Data.PBack += Shards[i].PBack;
+        Data.Resp  += Shards[i].Resp;
+        Data.Multi += Shards[i].Multi;
+        Shards[i].myMutex.UnLock();
+       }
 }
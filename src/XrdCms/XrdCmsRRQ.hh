@@ -74,19 +74,12 @@ class XrdCmsRRQSlot
 {
 friend class XrdCmsRRQ;
 
-static XrdCmsRRQSlot *Alloc(XrdCmsRRQInfo *Info);
-
-       void           Recycle();
-
-       XrdCmsRRQSlot();
+       XrdCmsRRQSlot() : Link(this), Cont(0), LkUp(0), Arg1(0), Arg2(0),
+                         Expire(0), slotNum(0), onReadyQ(false) {}
       ~XrdCmsRRQSlot() {}
 
 private:
 
-static   XrdSysMutex                 myMutex;
-static   XrdCmsRRQSlot              *freeSlot;
-static   short                       initSlot;
-
          XrdOucDLlist<XrdCmsRRQSlot> Link;
          XrdCmsRRQSlot              *Cont;
          XrdCmsRRQSlot              *LkUp;
@@ -95,12 +88,18 @@ static   short                       initSlot;
          SMask_t                     Arg2;
 unsigned int                         Expire;
          int                         slotNum;
+         bool                        onReadyQ;
 };
 
 /******************************************************************************/
 /*                             X r d C m s R R Q                              */
 /******************************************************************************/
-  
+
+// Slots are allocated in slabs as needed, up to the number a short slot number
+// can address. Each slot belongs to one of several shards, each with its own
+// lock, free list and wait queue, so that concurrent lookups only contend when
+// they hash to the same shard. A slot number indexes its slot directly.
+//
 class XrdCmsRRQ
 {
 public:
@@ -129,27 +128,52 @@ struct Info
        long long rdSlow;   // Slow redirects
       };
 
-void  Statistics(Info &Data) {myMutex.Lock(); Data = Stats; myMutex.UnLock();}
+void  Statistics(Info &Data);
 
 void *TimeOut();
 
-      XrdCmsRRQ() : isWaiting(0), isReady(0),
-                    luFast(0),    luSlow(0),  rdFast(0), rdSlow(0),
-                    Tslice(178),  Tdelay(5),  myClock(0) {}
+      XrdCmsRRQ();
      ~XrdCmsRRQ() {}
 
 private:
 
+XrdCmsRRQSlot *Alloc(XrdCmsRRQInfo *Info);
+bool           Grow();
+void           Recycle(XrdCmsRRQSlot *sp);
+void           Ready2Q(XrdCmsRRQSlot *sp);
 void sendLocResp(XrdCmsRRQSlot *lP);
 void sendLwtResp(XrdCmsRRQSlot *rP);
 void sendRedResp(XrdCmsRRQSlot *rP);
-static const int numSlots = 1024;
 
-         XrdSysMutex                   myMutex;
+inline XrdCmsRRQSlot *Slot(int Snum)
+                            {return &slabTab[Snum/slabSize][Snum%slabSize];}
+
+static const int slabSize  = 1024;
+static const int numSlabs  = 32;   // Slot numbers must fit in a short
+static const int numShards = 16;
+
+struct  Shard
+       {XrdSysMutex                   myMutex;
+        XrdOucDLlist<XrdCmsRRQSlot>   waitQ;
+        XrdCmsRRQSlot                *freeSlot;
+        long long                     Add2Q;
+        long long                     PBack;
+        long long                     Resp;
+        long long                     Multi;
+        char                          pad[64];
+
+        Shard() : freeSlot(0), Add2Q(0), PBack(0), Resp(0), Multi(0) {}
+       };
+
+         Shard                         Shards[numShards];
+         XrdSysMutex                   slabMutex;
+         XrdCmsRRQSlot                *slabTab[numSlabs];
+         int                           slabNum;
+unsigned int                           allocNext;
+         int                           numWaiting;
+         XrdSysMutex                   myMutex;    // Ready queue and Stats
          XrdSysSemaphore               isWaiting;
          XrdSysSemaphore               isReady;
-         XrdCmsRRQSlot                 Slot[numSlots];
-         XrdOucDLlist<XrdCmsRRQSlot>   waitQ;
          XrdOucDLlist<XrdCmsRRQSlot>   readyQ;  // Redirect/Locate ready queue
 static   const int                     iov_cnt = 2;
          struct iovec                  data_iov[iov_cnt];
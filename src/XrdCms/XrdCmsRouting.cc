@@ -68,6 +68,7 @@ XrdCmsRouter::theRoute initRouter[] =
        {kYR_space,   "space",  &XrdCmsNode::do_Space},
        {kYR_state,   "state",  &XrdCmsNode::do_State},
        {kYR_status,  "status", &XrdCmsNode::do_Status},
+       {kYR_summary, "summary",&XrdCmsNode::do_Summary},
        {kYR_try,     "try",    &XrdCmsNode::do_Try},
        {kYR_update,  "update", &XrdCmsNode::do_Update},
        {kYR_usage,   "usage",  &XrdCmsNode::do_Usage},
@@ -159,6 +160,7 @@ XrdCmsRouting::theRouting initRSProuting[] =
       {kYR_load,    XrdCmsRouting::isSync},
       {kYR_pong,    XrdCmsRouting::isSync | XrdCmsRouting::noArgs},
       {kYR_status,  XrdCmsRouting::isSync | XrdCmsRouting::noArgs},
+      {kYR_summary, XrdCmsRouting::isSync},
       {0,           0}};
 }
 
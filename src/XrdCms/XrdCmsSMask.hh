@@ -0,0 +1,188 @@
+#ifndef XRDCMSSMASK__H
+#define XRDCMSSMASK__H
+/******************************************************************************/
+/*                                                                            */
+/*                        X r d C m s S M a s k . h h                         */
+/*                                                                            */
+/* (c) 2018 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+/******************************************************************************/
+/*                   6 4   B i t   M a s k   H e l p e r s                    */
+/******************************************************************************/
+
+// Return the number of bits set in the mask.
+//
+inline int SMaskCount(unsigned long long mask)
+{
+#if defined(__GNUC__)
+   return __builtin_popcountll(mask);
+#else
+   int n = 0;
+   while(mask) {mask &= (mask - 1); n++;}
+   return n;
+#endif
+}
+
+// Return the number of the lowest bit set in the mask or -1 if none are set.
+//
+inline int SMaskFirst(unsigned long long mask)
+{
+#if defined(__GNUC__)
+   return __builtin_ffsll(mask) - 1;
+#else
+   int n = 0;
+   if (!mask) return -1;
+   while(!(mask & 1ULL)) {mask >>= 1; n++;}
+   return n;
+#endif
+}
+
+/******************************************************************************/
+/*                   C l a s s   X r d C m s S M a s k N                      */
+/******************************************************************************/
+
+// This is a fixed width server mask used when a cell holds more than 64 nodes.
+// It behaves like an unsigned integer for the logical operators the cms uses
+// (and, or, xor, not, tests against zero) so that code written for a 64 bit
+// mask works unchanged. Shifts and arithmetic are not supported; use the
+// SMask helpers below (Bit, Count, First) which work for either mask type.
+// The word loops have a constant trip count and are readily vectorized.
+//
+template<int nBits>
+class XrdCmsSMaskN
+{
+public:
+
+static const int nWords = (nBits+63)/64;
+
+typedef void (XrdCmsSMaskN::*isTrue)() const;
+
+inline operator isTrue() const
+                {return (isZero() ? 0 : &XrdCmsSMaskN::isTrueHelper);}
+
+inline bool  operator!() const {return isZero();}
+
+inline bool  isZero() const
+                {unsigned long long x = 0;
+                 for (int i = 0; i < nWords; i++) x |= bits[i];
+                 return x == 0;
+                }
+
+inline int   Count() const
+                {int n = 0;
+                 for (int i = 0; i < nWords; i++) n += SMaskCount(bits[i]);
+                 return n;
+                }
+
+inline int   First() const
+                {for (int i = 0; i < nWords; i++)
+                     if (bits[i]) return i*64 + SMaskFirst(bits[i]);
+                 return -1;
+                }
+
+inline bool  isSet(int n) const {return (bits[n>>6] >> (n & 63)) & 1ULL;}
+
+inline void  Set(int n) {bits[n>>6] |= 1ULL << (n & 63);}
+
+inline XrdCmsSMaskN  operator~() const
+                {XrdCmsSMaskN r;
+                 for (int i = 0; i < nWords; i++) r.bits[i] = ~bits[i];
+                 return r;
+                }
+
+inline XrdCmsSMaskN &operator&=(const XrdCmsSMaskN &rhs)
+                {for (int i = 0; i < nWords; i++) bits[i] &= rhs.bits[i];
+                 return *this;
+                }
+
+inline XrdCmsSMaskN &operator|=(const XrdCmsSMaskN &rhs)
+                {for (int i = 0; i < nWords; i++) bits[i] |= rhs.bits[i];
+                 return *this;
+                }
+
+inline XrdCmsSMaskN &operator^=(const XrdCmsSMaskN &rhs)
+                {for (int i = 0; i < nWords; i++) bits[i] ^= rhs.bits[i];
+                 return *this;
+                }
+
+friend XrdCmsSMaskN  operator&(XrdCmsSMaskN lhs, const XrdCmsSMaskN &rhs)
+                {return lhs &= rhs;}
+
+friend XrdCmsSMaskN  operator|(XrdCmsSMaskN lhs, const XrdCmsSMaskN &rhs)
+                {return lhs |= rhs;}
+
+friend XrdCmsSMaskN  operator^(XrdCmsSMaskN lhs, const XrdCmsSMaskN &rhs)
+                {return lhs ^= rhs;}
+
+friend bool          operator==(const XrdCmsSMaskN &lhs,const XrdCmsSMaskN &rhs)
+                {for (int i = 0; i < nWords; i++)
+                     if (lhs.bits[i] != rhs.bits[i]) return false;
+                 return true;
+                }
+
+friend bool          operator!=(const XrdCmsSMaskN &lhs,const XrdCmsSMaskN &rhs)
+                {return !(lhs == rhs);}
+
+// Comparisons against an integer (almost always zero) must not be ambiguous
+// with the boolean conversion.
+//
+friend bool          operator==(const XrdCmsSMaskN &lhs, int rhs)
+                {return lhs == XrdCmsSMaskN(rhs);}
+
+friend bool          operator!=(const XrdCmsSMaskN &lhs, int rhs)
+                {return !(lhs == XrdCmsSMaskN(rhs));}
+
+static XrdCmsSMaskN  Bit(int n) {XrdCmsSMaskN r; r.Set(n); return r;}
+
+                     XrdCmsSMaskN(unsigned long long v=0)
+                                 {bits[0] = v;
+                                  for (int i = 1; i < nWords; i++) bits[i] = 0;
+                                 }
+
+                     XrdCmsSMaskN(int v)
+                                 {bits[0] = static_cast<unsigned long long>(v);
+                                  for (int i = 1; i < nWords; i++)
+                                      bits[i] = (v < 0 ? ~0ULL : 0);
+                                 }
+
+private:
+
+void                 isTrueHelper() const {}
+
+unsigned long long   bits[nWords];
+};
+
+/******************************************************************************/
+/*                   W i d e   M a s k   H e l p e r s                        */
+/******************************************************************************/
+
+template<int nBits>
+inline int SMaskCount(const XrdCmsSMaskN<nBits> &mask) {return mask.Count();}
+
+template<int nBits>
+inline int SMaskFirst(const XrdCmsSMaskN<nBits> &mask) {return mask.First();}
+#endif
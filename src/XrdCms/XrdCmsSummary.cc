@@ -0,0 +1,433 @@
+/******************************************************************************/
+/*                                                                            */
+/*                      X r d C m s S u m m a r y . c c                       */
+/*                                                                            */
+/* (c) 2018 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <netinet/in.h>
+#include <time.h>
+#include <sys/uio.h>
+
+#include "XProtocol/YProtocol.hh"
+
+#include "XrdCms/XrdCmsConfig.hh"
+#include "XrdCms/XrdCmsManager.hh"
+#include "XrdCms/XrdCmsPList.hh"
+#include "XrdCms/XrdCmsSummary.hh"
+#include "XrdCms/XrdCmsTrace.hh"
+#include "XrdOuc/XrdOucCRC.hh"
+#include "XrdOuc/XrdOucNSWalk.hh"
+#include "XrdSys/XrdSysError.hh"
+
+using namespace XrdCms;
+
+/******************************************************************************/
+/*                        G l o b a l   O b j e c t s                         */
+/******************************************************************************/
+
+XrdCmsSummary XrdCms::Summary;
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+  
+XrdCmsSummary::XrdCmsSummary() : sumVec(0), sumHi(-1), trustTime(0), pubCV(0),
+                                 curBits(0), newBits(0), pubBits(0),
+                                 pubGen(0), pubHash(0), pubTime(0),
+                                 pubKick(false), sumOn(0)
+{
+   memset(nodeTab, 0, sizeof(nodeTab));
+}
+
+/******************************************************************************/
+/*                                 A d d e d                                  */
+/******************************************************************************/
+  
+void XrdCmsSummary::Added(const char *Path)
+{
+   unsigned int h1, h2;
+
+// Only servers that publish a summary need to do this. The lock also makes
+// sure that the have request sent afterwards follows any summary being sent.
+//
+   if (!pubTime) return;
+   Hash(Path, h1, h2);
+
+   pubCV.Lock();
+   if (curBits) SetBits(curBits, pubBits, pubHash, h1, h2);
+   if (newBits) SetBits(newBits, pubBits, pubHash, h1, h2);
+   pubCV.UnLock();
+}
+
+/******************************************************************************/
+/* Private:                        B u i l d                                  */
+/******************************************************************************/
+  
+int XrdCmsSummary::Build(unsigned char *bP)
+{
+   static const int wOpts = XrdOucNSWalk::retAll  | XrdOucNSWalk::Recurse
+                          | XrdOucNSWalk::skpErrs;
+   XrdCmsPList *pP = Config.PathList.First();
+   XrdOucNSWalk::NSEnt *nP, *nnP;
+   const char *lfn;
+   char pfn[XrdCmsMAX_PATH_LEN], path[XrdCmsMAX_PATH_LEN];
+   unsigned int h1, h2;
+   int pfnLen, rc, numEnt = 0;
+
+// Walk each exported path. Entries are added to the filter under their logical
+// name, which is the exported path followed by the entry's path relative to
+// the physical location of the export.
+//
+   do {lfn = (pP ? pP->Path() : "/");
+       if (Config.GenLocalPath(lfn, pfn)) continue;
+       pfnLen = strlen(pfn);
+       Hash(lfn, h1, h2);
+       pubCV.Lock(); SetBits(bP, pubBits, pubHash, h1, h2); pubCV.UnLock();
+
+       XrdOucNSWalk nsWalk(0, pfn, 0, wOpts);
+       while((nP = nsWalk.Index(rc)))
+            {pubCV.Lock();
+             do {snprintf(path, sizeof(path), "%s%s", lfn, nP->Path+pfnLen);
+                 Hash(path, h1, h2);
+                 SetBits(bP, pubBits, pubHash, h1, h2);
+                 numEnt++;
+                 nnP = nP->Next; delete nP;
+                } while((nP = nnP));
+             pubCV.UnLock();
+            }
+      } while(pP && (pP = pP->Next()));
+
+   return numEnt;
+}
+
+/******************************************************************************/
+/* Private:                         H a s h                                   */
+/******************************************************************************/
+  
+void XrdCmsSummary::Hash(const char *Path, unsigned int &h1, unsigned int &h2)
+{
+   char buff[XrdCmsMAX_PATH_LEN];
+   int i, n = 0;
+
+   *buff = 0;
+
+// Collapse repeated slashes and drop any trailing one so that all of the usual
+// spellings of a path hash identically.
+//
+   while(*Path && n < (int)sizeof(buff))
+        {if (*Path == '/' && n && buff[n-1] == '/') {Path++; continue;}
+         buff[n++] = *Path++;
+        }
+   if (n > 1 && buff[n-1] == '/') n--;
+
+// The filter uses double hashing: a CRC32 and an FNV-1a hash of the path. The
+// second hash is made odd so that it can never degenerate to a single bit.
+//
+   h1 = XrdOucCRC::CRC32((const unsigned char *)buff, n);
+   h2 = 2166136261U;
+   for (i = 0; i < n; i++) {h2 ^= (unsigned char)buff[i]; h2 *= 16777619U;}
+   h2 |= 1;
+}
+
+/******************************************************************************/
+/*                                  H a v e                                   */
+/******************************************************************************/
+  
+void XrdCmsSummary::Have(int sNum, const char *Path)
+{
+   unsigned int h1, h2;
+
+   if (!sumOn || sNum < 0 || sNum >= STMax) return;
+   Hash(Path, h1, h2);
+
+   tabLock.WriteLock();
+   if (nodeTab[sNum].Bits)
+      SetBits(nodeTab[sNum].Bits, nodeTab[sNum].nBits, nodeTab[sNum].nHash,
+              h1, h2);
+   tabLock.UnLock();
+}
+
+/******************************************************************************/
+/*                                  I n i t                                   */
+/******************************************************************************/
+  
+void XrdCmsSummary::Init(int Interval, int Size, int Hashes, int Trust)
+{
+   tabLock.WriteLock();
+   trustTime = Trust;
+   tabLock.UnLock();
+   pubCV.Lock();
+   pubTime = Interval;
+   pubBits = static_cast<unsigned int>(Size)*8;
+   pubHash = Hashes;
+   pubCV.UnLock();
+   sumOn   = 1;
+}
+
+/******************************************************************************/
+/*                                  K i c k                                   */
+/******************************************************************************/
+  
+void XrdCmsSummary::Kick()
+{
+   pubCV.Lock();
+   pubKick = true;
+   pubCV.Signal();
+   pubCV.UnLock();
+}
+
+/******************************************************************************/
+/*                                 M a y b e                                  */
+/******************************************************************************/
+  
+SMask_t XrdCmsSummary::Maybe(const char *Path, SMask_t mask)
+{
+   SMask_t bit, vec;
+   time_t oldest;
+   unsigned int h1, h2;
+   int i;
+
+// If we have no summaries then all nodes may have the file
+//
+   if (!sumOn) return mask;
+   Hash(Path, h1, h2);
+
+// Eliminate each node whose summary says it certainly does not have the file.
+// Summaries too old to be relied upon are ignored.
+//
+   tabLock.ReadLock();
+   oldest = time(0) - trustTime;
+   if ((vec = mask & sumVec))
+      for (i = 0; i <= sumHi; i++)
+          {bit = SMaskBit(i);
+           if ((vec & bit) && nodeTab[i].bTime > oldest
+           &&  !TstBits(nodeTab[i].Bits, nodeTab[i].nBits,
+                        nodeTab[i].nHash, h1, h2)) mask &= ~bit;
+          }
+   tabLock.UnLock();
+   return mask;
+}
+
+/******************************************************************************/
+/*                               P u b l i s h                                */
+/******************************************************************************/
+  
+void *XrdCmsSummary::Publish()
+{
+   EPNAME("Publish");
+   unsigned char *bP;
+   time_t nextPub = 0;
+   int numEnt, wTime;
+
+// Each interval we build a fresh summary and send it to all managers that
+// want one. In between, a kick simply resends the current summary.
+//
+   pubCV.Lock();
+   do {pubKick = false;
+       while(!pubKick && (wTime = nextPub - time(0)) > 0) pubCV.Wait(wTime);
+       if (curBits && time(0) < nextPub) {Send(); continue;}
+
+       if (!(bP = (unsigned char *)calloc(pubBits/8, 1)))
+          {Say.Emsg("Publish", ENOMEM, "build name space summary");
+           nextPub = time(0) + pubTime;
+           continue;
+          }
+       newBits = bP;
+       pubCV.UnLock();
+       numEnt = Build(bP);
+       pubCV.Lock();
+
+       if (curBits) free(curBits);
+       curBits = newBits; newBits = 0; pubGen++;
+       Send();
+       DEBUG("summary " <<pubGen <<" has " <<numEnt <<" names");
+       nextPub = time(0) + pubTime;
+      } while(1);
+
+// We never get here
+//
+   pubCV.UnLock();
+   return (void *)0;
+}
+
+/******************************************************************************/
+/*                                 R e s e t                                  */
+/******************************************************************************/
+  
+void XrdCmsSummary::Reset(int sNum)
+{
+   if (!sumOn || sNum < 0 || sNum >= STMax) return;
+
+   tabLock.WriteLock();
+   if (nodeTab[sNum].Bits) {free(nodeTab[sNum].Bits); nodeTab[sNum].Bits = 0;}
+   if (nodeTab[sNum].Pend) {free(nodeTab[sNum].Pend); nodeTab[sNum].Pend = 0;}
+   sumVec &= ~SMaskBit(sNum);
+   tabLock.UnLock();
+}
+
+/******************************************************************************/
+/* Private:                         S e n d                                   */
+/******************************************************************************/
+
+// Called with pubCV locked
+  
+void XrdCmsSummary::Send()
+{
+   CmsSummaryRequest sReq;
+   struct iovec ioV[2];
+   unsigned int fLen = pubBits/8, fOff, n;
+
+// Construct the invariant part of the request
+//
+   memset(&sReq, 0, sizeof(sReq));
+   sReq.Hdr.rrCode   = kYR_summary;
+   sReq.Hdr.modifier = kYR_raw;
+   sReq.Data.Gen     = htonl(pubGen);
+   sReq.Data.Bits    = htonl(pubBits);
+   sReq.Data.nHash   = htons(static_cast<kXR_unt16>(pubHash));
+   ioV[0].iov_base   = (char *)&sReq;
+   ioV[0].iov_len    = sizeof(sReq);
+
+// Send the filter in fragments. We stop as soon as no manager wants it.
+//
+   for (fOff = 0; fOff < fLen; fOff += n)
+       {n = fLen - fOff;
+        if (n > (unsigned int)CmsSummaryRequest::maxFrag)
+           n = CmsSummaryRequest::maxFrag;
+        sReq.Data.Offset = htonl(fOff);
+        sReq.Data.Flags  = htons(fOff+n < fLen ? 0 : CmsSummaryRequest::kYR_last);
+        sReq.Hdr.datalen = htons(static_cast<unsigned short>
+                                 (sizeof(CmsSummaryData)+n));
+        ioV[1].iov_base  = (char *)curBits+fOff;
+        ioV[1].iov_len   = n;
+        if (!XrdCmsManager::Summarize(ioV, 2, sizeof(sReq)+n)) break;
+       }
+}
+
+/******************************************************************************/
+/* Private:                      S e t B i t s                                */
+/******************************************************************************/
+  
+void XrdCmsSummary::SetBits(unsigned char *bP, unsigned int nBits, int nHash,
+                            unsigned int h1, unsigned int h2)
+{
+   unsigned int bit;
+
+   for (int i = 0; i < nHash; i++)
+       {bit = (h1 + i*h2) % nBits;
+        bP[bit>>3] |= static_cast<unsigned char>(1 << (bit & 7));
+       }
+}
+
+/******************************************************************************/
+/* Private:                      T s t B i t s                                */
+/******************************************************************************/
+  
+bool XrdCmsSummary::TstBits(unsigned char *bP, unsigned int nBits, int nHash,
+                            unsigned int h1, unsigned int h2)
+{
+   unsigned int bit;
+
+   for (int i = 0; i < nHash; i++)
+       {bit = (h1 + i*h2) % nBits;
+        if (!(bP[bit>>3] & (1 << (bit & 7)))) return false;
+       }
+   return true;
+}
+
+/******************************************************************************/
+/*                                U p d a t e                                 */
+/******************************************************************************/
+  
+void XrdCmsSummary::Update(int sNum, const char *Data, int Dlen)
+{
+   EPNAME("Update");
+   CmsSummaryData sHdr;
+   unsigned int fGen, fBits, fOff, fLen;
+   int fHash, fFlags;
+
+// Extract the fragment header
+//
+   if (!sumOn || sNum < 0 || sNum >= STMax
+   ||  Dlen < static_cast<int>(sizeof(sHdr))) return;
+   memcpy(&sHdr, Data, sizeof(sHdr));
+   fGen   = ntohl(sHdr.Gen);
+   fBits  = ntohl(sHdr.Bits);
+   fOff   = ntohl(sHdr.Offset);
+   fHash  = ntohs(sHdr.nHash);
+   fFlags = ntohs(sHdr.Flags);
+   Data  += sizeof(sHdr);
+   fLen   = Dlen - sizeof(sHdr);
+
+// The first fragment establishes the pending filter
+//
+   tabLock.WriteLock();
+   Filter &fP = nodeTab[sNum];
+   if (!fOff)
+      {if (fBits < (unsigned int)minSize*8 || fBits > (unsigned int)maxSize*8
+       ||  (fBits & 7) || fHash < 1 || fHash > maxHash)
+          {tabLock.UnLock();
+           Say.Emsg("Update", "Invalid name space summary ignored.");
+           return;
+          }
+       if (fP.Pend && fP.pBits != fBits) {free(fP.Pend); fP.Pend = 0;}
+       if (!fP.Pend && !(fP.Pend = (unsigned char *)malloc(fBits/8)))
+          {tabLock.UnLock(); return;}
+       fP.pBits = fBits; fP.pGen = fGen; fP.pHash = fHash; fP.pNext = 0;
+      }
+
+// Fragments must arrive in sequence; anything else discards the pending filter
+// until the next summary starts.
+//
+   if (!fP.Pend || fGen != fP.pGen || fOff != fP.pNext
+   ||  fOff + fLen > fP.pBits/8)
+      {if (fP.Pend) {free(fP.Pend); fP.Pend = 0;}
+       tabLock.UnLock();
+       return;
+      }
+   memcpy(fP.Pend+fOff, Data, fLen);
+   fP.pNext += fLen;
+
+// If this is the last fragment, the pending filter replaces the current one
+//
+   if (fFlags & CmsSummaryRequest::kYR_last)
+      {if (fP.pNext == fP.pBits/8)
+          {if (fP.Bits) free(fP.Bits);
+           fP.Bits  = fP.Pend;  fP.Pend  = 0;
+           fP.nBits = fP.pBits; fP.nHash = fP.pHash;
+           fP.bTime = time(0);
+           sumVec |= SMaskBit(sNum);
+           if (sNum > sumHi) sumHi = sNum;
+           DEBUG("node " <<sNum <<" summary " <<fGen <<" installed");
+          } else {free(fP.Pend); fP.Pend = 0;}
+      }
+   tabLock.UnLock();
+}
@@ -0,0 +1,141 @@
+#ifndef __CMS_SUMMARY__H
+#define __CMS_SUMMARY__H
+/******************************************************************************/
+/*                                                                            */
+/*                      X r d C m s S u m m a r y . h h                       */
+/*                                                                            */
+/* (c) 2018 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <time.h>
+
+#include "XrdCms/XrdCmsTypes.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+/******************************************************************************/
+/*                   C l a s s   X r d C m s S u m m a r y                    */
+/******************************************************************************/
+
+// A summary is a Bloom filter of every name a data server exports. Servers
+// periodically publish their summary to those managers that asked for one at
+// login time and keep it current via the usual have requests for new files.
+// Managers use summaries to avoid querying servers that certainly do not have
+// a file. Removals are only reflected when the next summary is published; in
+// the meantime they merely cause a superfluous query. Files added other than
+// via the server are not reflected either, so a summary is only relied upon
+// for as long as the non-existence of a file may be cached.
+//
+class XrdCmsSummary
+{
+public:
+
+// Added() records a newly created file in the summary being published (server).
+//
+void          Added(const char *Path);
+
+// Have() records that server sNum now has Path (manager).
+//
+void          Have(int sNum, const char *Path);
+
+// Init() enables summaries with the indicated publishing parameters. Managers
+// only rely on summaries that were received less than Trust seconds ago.
+//
+void          Init(int Interval, int Size, int Hashes, int Trust=0);
+
+inline int    isOn() {return sumOn;}
+
+// Kick() causes the current summary to be resent (i.e. a manager logged in).
+//
+void          Kick();
+
+// Maybe() returns the subset of nodes in mask that may have Path (manager).
+//
+SMask_t       Maybe(const char *Path, SMask_t mask);
+
+// Publish() is the thread that periodically builds and sends the summary.
+//
+void         *Publish();
+
+// Reset() discards the summary for server sNum as it just logged in (manager).
+//
+void          Reset(int sNum);
+
+// Update() adds a summary fragment from server sNum (manager).
+//
+void          Update(int sNum, const char *Data, int Dlen);
+
+              XrdCmsSummary();
+             ~XrdCmsSummary() {}   // Never gets deleted
+
+static const int minSize =     1024;
+static const int maxSize = 64*1024*1024;
+static const int maxHash = 16;
+
+private:
+
+struct Filter
+      {unsigned char *Bits;    // Complete filter (valid if in sumVec)
+       unsigned char *Pend;    // Filter being received
+       unsigned int   nBits;
+       unsigned int   pBits;
+       unsigned int   pGen;
+       unsigned int   pNext;   // Next expected fragment offset
+       time_t         bTime;   // When Bits was installed
+                int   nHash;
+                int   pHash;
+      };
+
+int           Build(unsigned char *bP);
+static void   Hash(const char *Path, unsigned int &h1, unsigned int &h2);
+void          Send();
+static void   SetBits(unsigned char *bP, unsigned int nBits, int nHash,
+                      unsigned int h1, unsigned int h2);
+static bool   TstBits(unsigned char *bP, unsigned int nBits, int nHash,
+                      unsigned int h1, unsigned int h2);
+
+XrdSysRWLock   tabLock;        // Manager: serializes the items below
+Filter         nodeTab[STMax];
+SMask_t        sumVec;         // Nodes with a complete summary
+int            sumHi;
+int            trustTime;      // Seconds a summary is relied upon
+
+XrdSysCondVar  pubCV;          // Server: serializes the items below
+unsigned char *curBits;        // Summary last published
+unsigned char *newBits;        // Summary being built, if any
+unsigned int   pubBits;
+unsigned int   pubGen;
+int            pubHash;
+int            pubTime;
+bool           pubKick;
+
+int            sumOn;
+};
+
+namespace XrdCms
+{
+extern    XrdCmsSummary Summary;
+}
+#endif
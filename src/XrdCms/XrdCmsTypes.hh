@@ -30,13 +30,24 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
   
-typedef unsigned long long SMask_t;
-
-#define FULLMASK 0xFFFFFFFFFFFFFFFFULL
+#include "XrdCms/XrdCmsSMask.hh"
 
-// The following defines our cell size (maximum subscribers)
+// The following defines our cell size (maximum subscribers). It defaults to
+// 64 but may be raised at build time (-DXRDCMS_MAXNODES=n, n a multiple of 64)
+// so that a single manager can serve more than 64 data servers. Wider cells
+// use a multi-word server mask; otherwise the mask is a plain 64 bit integer.
 //
+#if defined(XRDCMS_MAXNODES) && XRDCMS_MAXNODES > 64
+#define STMax XRDCMS_MAXNODES
+typedef XrdCmsSMaskN<STMax> SMask_t;
+inline  SMask_t SMaskBit(int n) {return SMask_t::Bit(n);}
+#else
 #define STMax 64
+typedef unsigned long long SMask_t;
+inline  SMask_t SMaskBit(int n) {return 1ULL << n;}
+#endif
+
+#define FULLMASK (~SMask_t(0))
 
 // The following defines the maximum number of redirectors. It is one greater
 // than the actual maximum as the zeroth is never used.
@@ -204,9 +204,226 @@ int  XrdFfsDent_dentcache_search(struct XrdFfsDentcache *cache, char *dname, cha
 struct XrdFfsDentcache XrdFfsDentCaches[XrdFfsDent_NDENTCACHES];
 pthread_mutex_t XrdFfsDentCaches_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/* managing the stat cache, a hash of full path names */
+
+#define XrdFfsDent_STCACHE_LIFE 10        /* seconds, same as FUSE attr_timeout */
+#define XrdFfsDent_STCACHE_NHASH 8192
+#define XrdFfsDent_STCACHE_NLOCKS 64
+#define XrdFfsDent_STCACHE_MAXENTS 262144
+
+struct XrdFfsDentstat {
+    char *path;
+    time_t t0;
+    int srv;                  /* index of the data server that listed it */
+    uid_t uid;                /* user on whose behalf it was listed */
+    struct stat stbuf;
+    struct XrdFfsDentstat *next;
+};
+
+struct XrdFfsDentstat *XrdFfsDentStcache[XrdFfsDent_STCACHE_NHASH];
+pthread_mutex_t XrdFfsDentStcache_mutex[XrdFfsDent_STCACHE_NLOCKS];
+int XrdFfsDentStcache_nents[XrdFfsDent_STCACHE_NLOCKS];  /* entries per lock */
+int XrdFfsDentStcache_nwrts[XrdFfsDent_STCACHE_NHASH];   /* files open for write */
+
+unsigned int XrdFfsDent_stcache_hash(const char *path)
+{
+    unsigned int h = 5381;
+    while (*path != '\0')
+        h = h * 33 + (unsigned char)(*path++);
+    return h % XrdFfsDent_STCACHE_NHASH;
+}
+
+void XrdFfsDent_stcache_init()
+{
+    int i;
+    for (i = 0; i < XrdFfsDent_STCACHE_NHASH; i++)
+    {
+        XrdFfsDentStcache[i] = NULL;
+        XrdFfsDentStcache_nwrts[i] = 0;
+    }
+    for (i = 0; i < XrdFfsDent_STCACHE_NLOCKS; i++)
+    {
+        pthread_mutex_init(&XrdFfsDentStcache_mutex[i], NULL);
+        XrdFfsDentStcache_nents[i] = 0;
+    }
+}
+
+/* must be called with the bucket lock held, removes expired entries (and path if not NULL) */
+void XrdFfsDent_stcache_purge(unsigned int h, const char *path)
+{
+    struct XrdFfsDentstat *e, **pp;
+    time_t t1 = time(NULL);
+
+    pp = &XrdFfsDentStcache[h];
+    while ((e = *pp) != NULL)
+    {
+        if ((t1 - e->t0) >= XrdFfsDent_STCACHE_LIFE || (path != NULL && strcmp(e->path, path) == 0))
+        {
+            *pp = e->next;
+            free(e->path);
+            free(e);
+            XrdFfsDentStcache_nents[h % XrdFfsDent_STCACHE_NLOCKS]--;
+        }
+        else
+            pp = &e->next;
+    }
+}
+
+/* must be called with the bucket lock held, removes entry e */
+void XrdFfsDent_stcache_unlink(unsigned int h, struct XrdFfsDentstat *e)
+{
+    struct XrdFfsDentstat **pp;
+
+    for (pp = &XrdFfsDentStcache[h]; *pp != NULL; pp = &(*pp)->next)
+        if (*pp == e)
+        {
+            *pp = e->next;
+            free(e->path);
+            free(e);
+            XrdFfsDentStcache_nents[h % XrdFfsDent_STCACHE_NLOCKS]--;
+            break;
+        }
+}
+
+/*
+   with several data servers the same name may be listed by more than one of
+   them. Like XrdFfsPosix_statall(), prefer the entry from the first server
+   (lowest srv) rather than whichever listing happened to finish last.
+ */
+void XrdFfsDent_stcache_add(const char *dname, const char *dentname, struct stat *stbuf, int srv, uid_t uid)
+{
+    struct XrdFfsDentstat *e;
+    unsigned int h;
+    size_t len = strlen(dname);
+    int keep = 0;
+    char *path;
+
+    path = (char*) malloc(len + strlen(dentname) + 2);
+    strcpy(path, dname);
+    if (len == 0 || path[len -1] != '/')
+        strcat(path, "/");
+    strcat(path, dentname);
+
+    h = XrdFfsDent_stcache_hash(path);
+    pthread_mutex_lock(&XrdFfsDentStcache_mutex[h % XrdFfsDent_STCACHE_NLOCKS]);
+    XrdFfsDent_stcache_purge(h, NULL);
+    for (e = XrdFfsDentStcache[h]; e != NULL; e = e->next)
+        if (e->uid == uid && strcmp(e->path, path) == 0)
+        {
+            keep = (e->srv < srv);
+            break;
+        }
+    if (! keep && e != NULL)
+        XrdFfsDent_stcache_unlink(h, e);
+    if (keep || XrdFfsDentStcache_nwrts[h] > 0
+             || XrdFfsDentStcache_nents[h % XrdFfsDent_STCACHE_NLOCKS] >= XrdFfsDent_STCACHE_MAXENTS / XrdFfsDent_STCACHE_NLOCKS)
+    {
+        pthread_mutex_unlock(&XrdFfsDentStcache_mutex[h % XrdFfsDent_STCACHE_NLOCKS]);
+        free(path);
+        return;
+    }
+    e = (struct XrdFfsDentstat*) malloc(sizeof(struct XrdFfsDentstat));
+    e->path = path;
+    e->t0 = time(NULL);
+    e->srv = srv;
+    e->uid = uid;
+    memcpy(&e->stbuf, stbuf, sizeof(struct stat));
+    e->next = XrdFfsDentStcache[h];
+    XrdFfsDentStcache[h] = e;
+    XrdFfsDentStcache_nents[h % XrdFfsDent_STCACHE_NLOCKS]++;
+    pthread_mutex_unlock(&XrdFfsDentStcache_mutex[h % XrdFfsDent_STCACHE_NLOCKS]);
+}
+
+int XrdFfsDent_stcache_search(const char *path, struct stat *stbuf, uid_t uid)
+{
+    struct XrdFfsDentstat *e;
+    unsigned int h;
+    int rval = 0;
+
+    h = XrdFfsDent_stcache_hash(path);
+    pthread_mutex_lock(&XrdFfsDentStcache_mutex[h % XrdFfsDent_STCACHE_NLOCKS]);
+    XrdFfsDent_stcache_purge(h, NULL);
+    for (e = XrdFfsDentStcache[h]; e != NULL && XrdFfsDentStcache_nwrts[h] == 0; e = e->next)
+        if (e->uid == uid && strcmp(e->path, path) == 0)
+        {
+            memcpy(stbuf, &e->stbuf, sizeof(struct stat));
+            rval = 1;
+            break;
+        }
+    pthread_mutex_unlock(&XrdFfsDentStcache_mutex[h % XrdFfsDent_STCACHE_NLOCKS]);
+    return rval;
+}
+
+void XrdFfsDent_stcache_del(const char *path)
+{
+    unsigned int h;
+
+    h = XrdFfsDent_stcache_hash(path);
+    pthread_mutex_lock(&XrdFfsDentStcache_mutex[h % XrdFfsDent_STCACHE_NLOCKS]);
+    XrdFfsDent_stcache_purge(h, path);
+    pthread_mutex_unlock(&XrdFfsDentStcache_mutex[h % XrdFfsDent_STCACHE_NLOCKS]);
+}
+
+/* remove path and, if it is a directory, everything cached below it */
+void XrdFfsDent_stcache_deltree(const char *path)
+{
+    struct XrdFfsDentstat *e, **pp;
+    size_t len = strlen(path);
+    int i;
+
+    while (len > 1 && path[len -1] == '/') len--;
+    for (i = 0; i < XrdFfsDent_STCACHE_NHASH; i++)
+    {
+        pthread_mutex_lock(&XrdFfsDentStcache_mutex[i % XrdFfsDent_STCACHE_NLOCKS]);
+        pp = &XrdFfsDentStcache[i];
+        while ((e = *pp) != NULL)
+        {
+            if (strncmp(e->path, path, len) == 0 && (e->path[len] == '\0' || e->path[len] == '/'))
+            {
+                *pp = e->next;
+                free(e->path);
+                free(e);
+                XrdFfsDentStcache_nents[i % XrdFfsDent_STCACHE_NLOCKS]--;
+            }
+            else
+                pp = &e->next;
+        }
+        pthread_mutex_unlock(&XrdFfsDentStcache_mutex[i % XrdFfsDent_STCACHE_NLOCKS]);
+    }
+}
+
+/*
+   a file open for write changes under any cached entry, so nothing is cached
+   for it (or, as the count is per hash bucket, for its bucket neighbours)
+   until the last writer closes it
+ */
+void XrdFfsDent_stcache_wopen(const char *path)
+{
+    unsigned int h;
+
+    h = XrdFfsDent_stcache_hash(path);
+    pthread_mutex_lock(&XrdFfsDentStcache_mutex[h % XrdFfsDent_STCACHE_NLOCKS]);
+    XrdFfsDentStcache_nwrts[h]++;
+    XrdFfsDent_stcache_purge(h, path);
+    pthread_mutex_unlock(&XrdFfsDentStcache_mutex[h % XrdFfsDent_STCACHE_NLOCKS]);
+}
+
+void XrdFfsDent_stcache_wclose(const char *path)
+{
+    unsigned int h;
+
+    h = XrdFfsDent_stcache_hash(path);
+    pthread_mutex_lock(&XrdFfsDentStcache_mutex[h % XrdFfsDent_STCACHE_NLOCKS]);
+    if (XrdFfsDentStcache_nwrts[h] > 0)   /* the file may have been renamed */
+        XrdFfsDentStcache_nwrts[h]--;
+    XrdFfsDent_stcache_purge(h, path);
+    pthread_mutex_unlock(&XrdFfsDentStcache_mutex[h % XrdFfsDent_STCACHE_NLOCKS]);
+}
+
 void XrdFfsDent_cache_init()
 {
     int i;
+    XrdFfsDent_stcache_init();
     for (i = 0; i < XrdFfsDent_NDENTCACHES; i++)
     {
         XrdFfsDentCaches[i].t0 = 0;
@@ -261,8 +478,18 @@ int XrdFfsDent_cache_search(char *dname, char *dentname)
 void XrdFfsDent_cache_destroy()
 {
     int i;
+    struct XrdFfsDentstat *e;
     for (i = 0; i < XrdFfsDent_NDENTCACHES; i++)
         XrdFfsDent_dentcache_free(&XrdFfsDentCaches[i]);
+    for (i = 0; i < XrdFfsDent_STCACHE_NHASH; i++)
+        while ((e = XrdFfsDentStcache[i]) != NULL)
+        {
+            XrdFfsDentStcache[i] = e->next;
+            free(e->path);
+            free(e);
+        }
+    for (i = 0; i < XrdFfsDent_STCACHE_NLOCKS; i++)
+        XrdFfsDentStcache_nents[i] = 0;
 }
 
 /*
@@ -31,6 +31,7 @@
 #include <stdlib.h>
 #include <time.h>
 #include <pthread.h>
+#include <sys/stat.h>
 
 #ifdef __cplusplus
   extern "C" {
@@ -51,6 +52,23 @@ void XrdFfsDent_cache_destroy();
 int  XrdFfsDent_cache_fill(char *dname, char ***dnarray, int nents);
 int  XrdFfsDent_cache_search(char *dname, char *dentname);
 
+/* 
+   short-lived cache of stat() results collected by readdir (with kXR_dstat),
+   so that the getattr() calls following a listing are answered locally.
+   _stcache_search() returns 1 and fills stbuf if path has a fresh entry.
+   srv is the index of the data server that listed the entry (lower wins).
+   Entries are kept per uid as listings may be made with per-user (sss)
+   credentials; removing a path removes it for every user.
+   _stcache_deltree() also drops everything below path. Between _wopen()
+   and _wclose() path is open for write and is neither cached nor answered.
+*/
+void XrdFfsDent_stcache_add(const char *dname, const char *dentname, struct stat *stbuf, int srv, uid_t uid);
+int  XrdFfsDent_stcache_search(const char *path, struct stat *stbuf, uid_t uid);
+void XrdFfsDent_stcache_del(const char *path);
+void XrdFfsDent_stcache_deltree(const char *path);
+void XrdFfsDent_stcache_wopen(const char *path);
+void XrdFfsDent_stcache_wclose(const char *path);
+
 #ifdef __cplusplus
   }
 #endif
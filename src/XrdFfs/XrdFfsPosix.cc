@@ -47,6 +47,8 @@
 #include <stdlib.h>
 #include <syslog.h>
 #include "XrdFfs/XrdFfsPosix.hh"
+#include "XrdPosix/XrdPosixAdmin.hh"
+#include "XrdPosix/XrdPosixMap.hh"
 #include "XrdPosix/XrdPosixXrootd.hh"
 #include "XrdFfs/XrdFfsMisc.hh"
 #include "XrdFfs/XrdFfsDent.hh"
@@ -409,10 +411,42 @@ int XrdFfsPosix_truncateall(const char *rdrurl, const char *path, off_t size, ui
 
 struct XrdFfsPosixX_readdirall_args {
     char *url;
+    const char *path;
+    int srv;
+    uid_t uid;
     int *res;
     int *err;
     struct XrdFfsDentnames **dents;
 };
+
+/* 
+   convert the stat info of a dirlist entry the same way XrdPosixXrootd::Stat()
+   and XrdFfsPosix_stat() do
+*/
+void XrdFfsPosix_x_statinfo2stat(XrdCl::StatInfo *sInfo, struct stat *stbuf)
+{
+    dev_t rdev;
+
+    memset(stbuf, 0, sizeof(struct stat));
+    stbuf->st_blksize = 64*1024;
+    stbuf->st_nlink   = 1;
+    stbuf->st_uid     = getuid();
+    stbuf->st_gid     = getgid();
+    stbuf->st_size    = static_cast<off_t>(sInfo->GetSize());
+    stbuf->st_blocks  = stbuf->st_size/512+1;
+    stbuf->st_atime   = stbuf->st_mtime = stbuf->st_ctime = static_cast<time_t>(sInfo->GetModTime());
+    stbuf->st_ino     = static_cast<ino_t>(strtoll(sInfo->GetId().c_str(), 0, 10));
+    stbuf->st_mode    = XrdPosixMap::Flags2Mode(&rdev, sInfo->GetFlags());
+    stbuf->st_rdev    = rdev;
+    if (S_ISBLK(stbuf->st_mode))
+    {
+        stbuf->st_mode &= 0007777;
+        if ( stbuf->st_mode & S_IXUSR )
+            stbuf->st_mode |= 0040000;
+        else
+            stbuf->st_mode |= 0100000;
+    }
+}
  
 /*
    It seems xrootd posix return dp[i] != NULL even if the dir
@@ -426,29 +460,44 @@ struct XrdFfsPosixX_readdirall_args {
 void* XrdFfsPosix_x_readdirall(void* x)
 {
     struct XrdFfsPosixX_readdirall_args *args = (struct XrdFfsPosixX_readdirall_args*) x;
-    DIR *dp;
-    struct dirent *de;
+    XrdPosixAdmin adm(args->url);
+    XrdCl::XRootDStatus xStatus;
+    XrdCl::DirectoryList *dList = 0;
+    XrdCl::DirectoryList::Iterator it;
+    struct stat stbuf;
 
 /*
-   Xrootd's Opendir will not return NULL even under some error. For instance,
-   when it is supposed to return ENOENT or ENOTDIR, it actually returns 
-   EINPROGRESS (115), and DIR *dp will not be NULL.
+   List the directory with kXR_dstat so that the following getattr() calls
+   can be answered from the stat cache (XrdCl stats each entry itself if the
+   data server doesn't support it).
  */
-    dp = XrdFfsPosix_opendir(args->url);
-    if ( dp == NULL && errno != 0)
+    if (! adm.isOK())
+    {
+        *(args->err) = errno;
+        *(args->res) = -1;
+        return NULL;
+    }
+    xStatus = adm.Xrd.DirList(adm.Url.GetPathWithParams(), XrdCl::DirListFlags::Stat, dList);
+    if (! xStatus.IsOK())
     {
+        XrdPosixMap::Result(xStatus);
         *(args->err) = errno;
         *(args->res) = -1;
-        if (dp != NULL)
-            XrdFfsPosix_closedir(dp);
     }
     else
     {
         *(args->res) = 0;
-        while ((de = XrdFfsPosix_readdir(dp)) != NULL)
-            XrdFfsDent_names_add(args->dents, de->d_name);
-        XrdFfsPosix_closedir(dp);
+        for (it = dList->Begin(); it != dList->End(); ++it)
+        {
+            XrdFfsDent_names_add(args->dents, (char *)(*it)->GetName().c_str());
+            if (args->path != NULL && (*it)->GetStatInfo() != NULL)
+            {
+                XrdFfsPosix_x_statinfo2stat((*it)->GetStatInfo(), &stbuf);
+                XrdFfsDent_stcache_add(args->path, (*it)->GetName().c_str(), &stbuf, args->srv, args->uid);
+            }
+        }
     }
+    delete dList;
     return NULL;
 }
 
@@ -491,6 +540,9 @@ int XrdFfsPosix_readdirall(const char *rdrurl, const char *path, char*** direnta
         strncat(newurls[i], path,  MAXROOTURLLEN - strlen(newurls[i]) -1);
         XrdFfsMisc_xrd_secsss_editurl(newurls[i], user_uid, 0);
         args[i].url = newurls[i];
+        args[i].path = (path[0] == '/'? path : NULL);  /* XrdPssDir passes "" */
+        args[i].srv = i;
+        args[i].uid = user_uid;
         args[i].err = &errno_i[i];
         args[i].res = &res_i[i];
         args[i].dents = &dir_i[i];
@@ -750,6 +802,10 @@ int XrdFfsPosix_statall(const char *rdrurl, const char *path, struct stat *stbuf
 
     char *p1, *p2, *dir, *file, rootpath[MAXROOTURLLEN];
 
+// answered by a recent readdir made on behalf of the same user?
+    if (XrdFfsDent_stcache_search(path, stbuf, user_uid))
+        return 0;
+
     rootpath[0] = '\0';
     strncat(rootpath,rdrurl, MAXROOTURLLEN - strlen(rootpath) -1);
     strncat(rootpath,path,  MAXROOTURLLEN - strlen(rootpath) -1);
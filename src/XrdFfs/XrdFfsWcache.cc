@@ -35,6 +35,17 @@
    Note that fuse 2.8.0 pre2 or above and kernel 2.6.27 or above provide
    a big_writes option to allow > 4KByte writing. It will make this 
    smiple write caching obsolete. 
+
+   Each file descriptor owns one buffer that collects consecutive writes.
+   When more than one buffer per file is configured (see XrdFfsWcache_init()),
+   a full buffer is handed over to one of the write-behind slots and sent
+   with an asynchronous XrdPosixXrootd::Pwrite() while the application keeps
+   filling the next buffer. At most nbufs-1 writes per file are in flight. A
+   buffer that overlaps a write still in flight waits for that write, so the
+   data on the server is the same as if the writes were done in order. The
+   first failed write is remembered and reported by the next write or by
+   XrdFfsWcache_flush(), which waits for all outstanding writes (fsync, close,
+   read and truncate all flush first).
 */
 #define XrdFfsWcacheBufsize 131072
 
@@ -57,8 +68,28 @@
 #include "XrdFfs/XrdFfsWcache.hh"
 #ifndef NOXRD
     #include "XrdFfs/XrdFfsPosix.hh"
+    #include "XrdPosix/XrdPosixCallBack.hh"
+    #include "XrdPosix/XrdPosixXrootd.hh"
 #endif
 
+/* callback of an asynchronous write issued from a write-behind slot */
+
+class XrdFfsWcacheWbuf : public XrdPosixCallBackIO
+{
+public:
+
+void Complete(ssize_t Result);
+
+    int    fd;
+    off_t  offset;
+    size_t len;
+    char  *buf;
+    int    busy;
+
+           XrdFfsWcacheWbuf() : fd(0), offset(0), len(0), buf(0), busy(0) {}
+          ~XrdFfsWcacheWbuf() {}
+};
+
 #ifdef __cplusplus
   extern "C" {
 #endif
@@ -68,6 +99,10 @@ struct XrdFfsWcacheFilebuf {
     size_t len;
     char *buf;
     pthread_mutex_t *mlock;
+    pthread_cond_t *wcond;       /* signaled when a write-behind slot is freed */
+    XrdFfsWcacheWbuf *wbufs;     /* XrdFfsWcacheNbufs-1 write-behind slots */
+    int inflight;                /* number of async writes not yet completed */
+    int werrno;                  /* errno of the first failed async write */
 };
 
 struct XrdFfsWcacheFilebuf *XrdFfsWcacheFbufs;
@@ -75,7 +110,9 @@ struct XrdFfsWcacheFilebuf *XrdFfsWcacheFbufs;
 /* #include "xrdposix.h" */
 
 int XrdFfsPosix_baseFD, XrdFfsWcacheNFILES;
-void XrdFfsWcache_init(int basefd, int maxfd)
+int XrdFfsWcacheNbufs = 1;
+
+void XrdFfsWcache_init(int basefd, int maxfd, int nbufs)
 {
     int fd;
 /* We are now using virtual file descriptors (from Xrootd Posix interface) in XrdFfsXrootdfs.cc so we need to set 
@@ -90,6 +127,7 @@ void XrdFfsWcache_init(int basefd, int maxfd)
 
    XrdFfsPosix_baseFD = basefd;
    XrdFfsWcacheNFILES = maxfd; 
+   XrdFfsWcacheNbufs = (nbufs < 1 ? 1 : nbufs);
    
 /*    printf("%d %d\n", XrdFfsWcacheNFILES, sizeof(struct XrdFfsWcacheFilebuf)); */
     XrdFfsWcacheFbufs = (struct XrdFfsWcacheFilebuf*)malloc(sizeof(struct XrdFfsWcacheFilebuf) * XrdFfsWcacheNFILES);
@@ -99,11 +137,17 @@ void XrdFfsWcache_init(int basefd, int maxfd)
         XrdFfsWcacheFbufs[fd].len = 0;
         XrdFfsWcacheFbufs[fd].buf = NULL;
         XrdFfsWcacheFbufs[fd].mlock = NULL;
+        XrdFfsWcacheFbufs[fd].wcond = NULL;
+        XrdFfsWcacheFbufs[fd].wbufs = NULL;
+        XrdFfsWcacheFbufs[fd].inflight = 0;
+        XrdFfsWcacheFbufs[fd].werrno = 0;
     }
 }
 
 int XrdFfsWcache_create(int fd) 
 {
+    int i;
+
     XrdFfsWcache_destroy(fd);
     fd -= XrdFfsPosix_baseFD;
 
@@ -117,87 +161,274 @@ int XrdFfsWcache_create(int fd)
         return 0;
     else
         pthread_mutex_init(XrdFfsWcacheFbufs[fd].mlock, NULL);
+/* buffers of the write-behind slots are only allocated when they are first used */
+    if (XrdFfsWcacheNbufs > 1)
+    {
+        XrdFfsWcacheFbufs[fd].wcond = (pthread_cond_t*)malloc(sizeof(pthread_cond_t));
+        if (XrdFfsWcacheFbufs[fd].wcond == NULL)
+            return 0;
+        pthread_cond_init(XrdFfsWcacheFbufs[fd].wcond, NULL);
+        XrdFfsWcacheFbufs[fd].wbufs = new XrdFfsWcacheWbuf[XrdFfsWcacheNbufs - 1];
+        for (i = 0; i < XrdFfsWcacheNbufs - 1; i++)
+            XrdFfsWcacheFbufs[fd].wbufs[i].fd = fd;
+    }
+    XrdFfsWcacheFbufs[fd].inflight = 0;
+    XrdFfsWcacheFbufs[fd].werrno = 0;
     return 1;
 }
 
 void XrdFfsWcache_destroy(int fd)
 {
+    int i;
 /*  XrdFfsWcache_flush(fd); */
     fd -= XrdFfsPosix_baseFD;
 
+/* never free a buffer that an async write is still using */
+    if (XrdFfsWcacheFbufs[fd].mlock != NULL && XrdFfsWcacheFbufs[fd].wcond != NULL)
+    {
+        pthread_mutex_lock(XrdFfsWcacheFbufs[fd].mlock);
+        while (XrdFfsWcacheFbufs[fd].inflight > 0)
+            pthread_cond_wait(XrdFfsWcacheFbufs[fd].wcond, XrdFfsWcacheFbufs[fd].mlock);
+        pthread_mutex_unlock(XrdFfsWcacheFbufs[fd].mlock);
+    }
+
     XrdFfsWcacheFbufs[fd].offset = 0;
     XrdFfsWcacheFbufs[fd].len = 0;
     if (XrdFfsWcacheFbufs[fd].buf != NULL) 
         free(XrdFfsWcacheFbufs[fd].buf);
     XrdFfsWcacheFbufs[fd].buf = NULL;
+    if (XrdFfsWcacheFbufs[fd].wbufs != NULL)
+    {
+        for (i = 0; i < XrdFfsWcacheNbufs - 1; i++)
+            if (XrdFfsWcacheFbufs[fd].wbufs[i].buf != NULL)
+                free(XrdFfsWcacheFbufs[fd].wbufs[i].buf);
+        delete [] XrdFfsWcacheFbufs[fd].wbufs;
+    }
+    XrdFfsWcacheFbufs[fd].wbufs = NULL;
+    if (XrdFfsWcacheFbufs[fd].wcond != NULL)
+    {
+        pthread_cond_destroy(XrdFfsWcacheFbufs[fd].wcond);
+        free(XrdFfsWcacheFbufs[fd].wcond);
+    }
+    XrdFfsWcacheFbufs[fd].wcond = NULL;
     if (XrdFfsWcacheFbufs[fd].mlock != NULL)
     {
         pthread_mutex_destroy(XrdFfsWcacheFbufs[fd].mlock);
         free(XrdFfsWcacheFbufs[fd].mlock);
     }
     XrdFfsWcacheFbufs[fd].mlock = NULL;
+    XrdFfsWcacheFbufs[fd].inflight = 0;
+    XrdFfsWcacheFbufs[fd].werrno = 0;
 }
 
-ssize_t XrdFfsWcache_flush(int fd)
+/* 
+   Write out the buffer of a file. Must be called with mlock held. In 
+   write-behind mode the buffer is handed to a free slot and the lock is 
+   released while the async write is issued, so the caller has to re-check 
+   the buffer after this returns. Returns < 0 on error with errno set.
+*/
+static ssize_t XrdFfsWcache_spill(int fd)
 {
     ssize_t rc;
+    int i, busy;
+    char *bufptr;
+    XrdFfsWcacheWbuf *wb;
+    struct XrdFfsWcacheFilebuf *fb = &XrdFfsWcacheFbufs[fd];
+
+    if (fb->len == 0 || fb->buf == NULL)
+        return 0;
+
+    if (fb->wbufs == NULL)
+    {
+        rc = XrdFfsPosix_pwrite(fd + XrdFfsPosix_baseFD, fb->buf, fb->len, fb->offset);
+        if (rc > 0)
+        {
+            fb->offset = 0;
+            fb->len = 0;
+        }
+        return rc;
+    }
+
+/* 
+   find a free slot, also wait for in-flight writes overlapping this buffer so
+   that they can not be reordered with it.
+*/
+    while (1)
+    {
+        wb = NULL;
+        busy = 0;
+        for (i = 0; i < XrdFfsWcacheNbufs - 1; i++)
+        {
+            if (! fb->wbufs[i].busy) 
+            {
+                if (wb == NULL) wb = &fb->wbufs[i];
+            }
+            else if (fb->wbufs[i].offset < (off_t)(fb->offset + fb->len) &&
+                     fb->offset < (off_t)(fb->wbufs[i].offset + fb->wbufs[i].len))
+                busy = 1;
+        }
+        if (wb != NULL && ! busy) break;
+        pthread_cond_wait(fb->wcond, fb->mlock);
+        if (fb->len == 0) return 0;  /* another thread spilled it meanwhile */
+    }
+
+    if (wb->buf == NULL)
+    {
+        wb->buf = (char*)malloc(XrdFfsWcacheBufsize);
+        if (wb->buf == NULL)
+        {
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+
+/* swap buffers, the slot now owns the data and the file gets an empty buffer */
+    bufptr = wb->buf;
+    wb->buf = fb->buf;
+    wb->offset = fb->offset;
+    wb->len = fb->len;
+    wb->busy = 1;
+    fb->buf = bufptr;
+    fb->offset = 0;
+    fb->len = 0;
+    fb->inflight++;
+
+    pthread_mutex_unlock(fb->mlock);
+    XrdPosixXrootd::Pwrite(fd + XrdFfsPosix_baseFD, wb->buf, wb->len, wb->offset, wb);
+    pthread_mutex_lock(fb->mlock);
+    return (ssize_t)wb->len;
+}
+
+/* 
+   write out the cached data and wait for the writes in flight. A failed write
+   is remembered until it has been reported by fsync() or close() (report != 0)
+   as the other callers may discard the result.
+*/
+static ssize_t XrdFfsWcache_drain(int fd, int report)
+{
+    ssize_t rc;
+    struct XrdFfsWcacheFilebuf *fb;
     fd -= XrdFfsPosix_baseFD;
 
-    if (XrdFfsWcacheFbufs[fd].len == 0 || XrdFfsWcacheFbufs[fd].buf == NULL )
+    if (fd < 0 || fd >= XrdFfsWcacheNFILES) return 0;
+    fb = &XrdFfsWcacheFbufs[fd];
+    if (fb->mlock == NULL || fb->buf == NULL)
         return 0;
 
-    rc = XrdFfsPosix_pwrite(fd + XrdFfsPosix_baseFD, 
-                            XrdFfsWcacheFbufs[fd].buf, XrdFfsWcacheFbufs[fd].len, XrdFfsWcacheFbufs[fd].offset);
-    if (rc > 0)
+    pthread_mutex_lock(fb->mlock);
+    rc = XrdFfsWcache_spill(fd);
+    if (rc < 0 && fb->werrno == 0)
+        fb->werrno = (errno != 0 ? errno : EIO);
+    if (fb->wbufs != NULL)
+        while (fb->inflight > 0)
+            pthread_cond_wait(fb->wcond, fb->mlock);
+    rc = 0;
+    if (fb->werrno != 0)
     {
-        XrdFfsWcacheFbufs[fd].offset = 0;
-        XrdFfsWcacheFbufs[fd].len = 0;
+        errno = fb->werrno;
+        rc = -1;
+        if (report) fb->werrno = 0;
     }
+    pthread_mutex_unlock(fb->mlock);
     return rc;
 }
 
+ssize_t XrdFfsWcache_flush(int fd)
+{
+    return XrdFfsWcache_drain(fd, 0);
+}
+
+ssize_t XrdFfsWcache_sync(int fd)
+{
+    return XrdFfsWcache_drain(fd, 1);
+}
+
 ssize_t XrdFfsWcache_pwrite(int fd, char *buf, size_t len, off_t offset)
 {
     ssize_t rc;
     char *bufptr;
+    size_t maxlen;
+    struct XrdFfsWcacheFilebuf *fb;
     fd -= XrdFfsPosix_baseFD;
 
-/* do not use caching under these cases */
-    if (len > XrdFfsWcacheBufsize/2 || fd >= XrdFfsWcacheNFILES)
+/* 
+   do not use caching under these cases. Writes too large for a buffer must 
+   still wait for the data cached before them.
+*/
+    maxlen = (XrdFfsWcacheNbufs > 1 ? XrdFfsWcacheBufsize : XrdFfsWcacheBufsize/2);
+    if (fd >= XrdFfsWcacheNFILES || XrdFfsWcacheFbufs[fd].mlock == NULL
+                                 || XrdFfsWcacheFbufs[fd].buf == NULL)
+    {
+        rc = XrdFfsPosix_pwrite(fd + XrdFfsPosix_baseFD, buf, len, offset);
+        return rc;
+    }
+    if (len > maxlen)
     {
+        if (XrdFfsWcache_flush(fd + XrdFfsPosix_baseFD) < 0)
+            return -1;
         rc = XrdFfsPosix_pwrite(fd + XrdFfsPosix_baseFD, buf, len, offset);
         return rc;
     }
 
-    pthread_mutex_lock(XrdFfsWcacheFbufs[fd].mlock);
-    rc = XrdFfsWcacheFbufs[fd].len;
+    fb = &XrdFfsWcacheFbufs[fd];
+    pthread_mutex_lock(fb->mlock);
 /* 
-   in the following two cases, a XrdFfsWcache_flush is required:
+   in the following two cases, a XrdFfsWcache_spill is required:
    1. current offset isnn't pointing to the tail of data in buffer
    2. adding new data will exceed the current buffer 
+   in write-behind mode the lock may be dropped while spilling, so check again.
 */ 
-    if (offset != (off_t)(XrdFfsWcacheFbufs[fd].offset + XrdFfsWcacheFbufs[fd].len) ||
-        (off_t)(offset + len) > (XrdFfsWcacheFbufs[fd].offset + XrdFfsWcacheBufsize))
-        rc = XrdFfsWcache_flush(fd + XrdFfsPosix_baseFD);
+    rc = 0;
+    while (fb->len != 0 &&
+           (offset != (off_t)(fb->offset + fb->len) ||
+            (off_t)(offset + len) > (fb->offset + XrdFfsWcacheBufsize)))
+    {
+        rc = XrdFfsWcache_spill(fd);
+        if (rc < 0) break;
+    }
 
     errno = 0;
+    if (rc >= 0 && fb->werrno != 0)
+    {
+        errno = fb->werrno;
+        pthread_mutex_unlock(fb->mlock);
+        return -1;
+    }
     if (rc < 0) 
     {
         errno = ENOSPC;
-        pthread_mutex_unlock(XrdFfsWcacheFbufs[fd].mlock);
+        pthread_mutex_unlock(fb->mlock);
         return -1;
     }
 
-    bufptr = &XrdFfsWcacheFbufs[fd].buf[XrdFfsWcacheFbufs[fd].len];
+    bufptr = &fb->buf[fb->len];
     memcpy(bufptr, buf, len);
-    if (XrdFfsWcacheFbufs[fd].len == 0)
-        XrdFfsWcacheFbufs[fd].offset = offset;
-    XrdFfsWcacheFbufs[fd].len += len;
+    if (fb->len == 0)
+        fb->offset = offset;
+    fb->len += len;
 
-    pthread_mutex_unlock(XrdFfsWcacheFbufs[fd].mlock);
+    pthread_mutex_unlock(fb->mlock);
     return (ssize_t)len;
 }
 
 #ifdef __cplusplus
   }
 #endif
+
+/* runs on an XrdPosix callback thread (or the caller's on immediate errors) */
+
+void XrdFfsWcacheWbuf::Complete(ssize_t Result)
+{
+    struct XrdFfsWcacheFilebuf *fb = &XrdFfsWcacheFbufs[fd];
+
+    pthread_mutex_lock(fb->mlock);
+    if (Result < 0 || (size_t)Result != len)
+    {
+        if (fb->werrno == 0)
+            fb->werrno = (Result < 0 && errno != 0 ? errno : EIO);
+    }
+    busy = 0;
+    fb->inflight--;
+    pthread_cond_broadcast(fb->wcond);
+    pthread_mutex_unlock(fb->mlock);
+}
@@ -31,11 +31,19 @@
   extern "C" {
 #endif
 
-void    XrdFfsWcache_init(int basefd, int maxfd);
+/* 
+   nbufs is the number of buffers per file; with more than one, full buffers
+   are written behind asynchronously and up to nbufs-1 writes are in flight.
+   XrdFfsWcache_flush() waits for them and returns -1 (errno set) if any failed.
+   The error sticks until XrdFfsWcache_sync(), which is otherwise the same, has
+   returned it (i.e. from fsync() or close()).
+*/
+void    XrdFfsWcache_init(int basefd, int maxfd, int nbufs);
 int     XrdFfsWcache_create(int fd);
 void    XrdFfsWcache_destroy(int fd);
 ssize_t  XrdFfsWcache_flush(int fd);
 ssize_t  XrdFfsWcache_pwrite(int fd, char *buf, size_t len, off_t offset);
+ssize_t  XrdFfsWcache_sync(int fd);
 
 #ifdef __cplusplus
   }
@@ -64,7 +64,7 @@
 #include "XrdFfs/XrdFfsMisc.hh"
 #include "XrdFfs/XrdFfsWcache.hh"
 #include "XrdFfs/XrdFfsQueue.hh"
-//#include "XrdFfs/XrdFfsDent.hh"
+#include "XrdFfs/XrdFfsDent.hh"
 #include "XrdFfs/XrdFfsFsinfo.hh"
 #include "XrdPosix/XrdPosixXrootd.hh"
 
@@ -80,12 +80,13 @@ struct XROOTDFS {
     bool ofsfwd;
     int  nworkers;
     int  maxfd;
+    int  nwbufs;
 };
 
 int cwdfd; // File descript of the initial working dir
 
 struct XROOTDFS xrootdfs;
-static struct fuse_opt xrootdfs_opts[14];
+static struct fuse_opt xrootdfs_opts[15];
 
 enum { OPT_KEY_HELP, OPT_KEY_SECSSS, };
 
@@ -127,7 +128,7 @@ static void* xrootdfs_init(struct fuse_conn_info *conn)
 /* put Xrootd related initialization calls here, after fuse daemonize itself. */
     XrdPosixXrootd *abc = new XrdPosixXrootd(-xrootdfs.maxfd);
     XrdFfsMisc_xrd_init(xrootdfs.rdr,xrootdfs.urlcachelife,0);
-    XrdFfsWcache_init(abc->fdOrigin(), xrootdfs.maxfd);
+    XrdFfsWcache_init(abc->fdOrigin(), xrootdfs.maxfd, xrootdfs.nwbufs);
 /*
    From FAQ:
       Miscellaneous threads should be started from the init() method.
@@ -447,6 +448,8 @@ static int xrootdfs_unlink(const char *path)
     int res;
     char rootpath[MAXROOTURLLEN];
 
+    XrdFfsDent_stcache_del(path);
+
     rootpath[0]='\0';
     strncat(rootpath,xrootdfs.rdr, MAXROOTURLLEN - strlen(rootpath) -1);
     strncat(rootpath,path, MAXROOTURLLEN - strlen(rootpath) -1);
@@ -483,6 +486,8 @@ static int xrootdfs_rmdir(const char *path)
 //  struct stat stbuf;
     char rootpath[MAXROOTURLLEN];
 
+    XrdFfsDent_stcache_deltree(path);
+
     rootpath[0]='\0';
     strncat(rootpath,xrootdfs.rdr, MAXROOTURLLEN - strlen(rootpath) -1);
     strncat(rootpath,path, MAXROOTURLLEN - strlen(rootpath) -1);
@@ -543,6 +548,9 @@ static int xrootdfs_rename(const char *from, const char *to)
     char from_path[MAXROOTURLLEN], to_path[MAXROOTURLLEN];
     struct stat stbuf;
 
+    XrdFfsDent_stcache_deltree(from);
+    XrdFfsDent_stcache_deltree(to);
+
     from_path[0]='\0';
     strncat(from_path, xrootdfs.rdr, MAXROOTURLLEN - strlen(from_path) -1);
     strncat(from_path, from, MAXROOTURLLEN - strlen(from_path) -1);
@@ -639,6 +647,7 @@ static int xrootdfs_ftruncate(const char *path, off_t size,
                                                                                                                                            
     fd = (int) fi->fh;
     XrdFfsWcache_flush(fd);
+    XrdFfsDent_stcache_del(path);
     res = XrdFfsPosix_ftruncate(fd, size);
     if (res == -1)
         return -errno;
@@ -666,6 +675,8 @@ static int xrootdfs_truncate(const char *path, off_t size)
     int res;
     char rootpath[MAXROOTURLLEN];
 
+    XrdFfsDent_stcache_del(path);
+
     rootpath[0]='\0';
     strncat(rootpath,xrootdfs.rdr, MAXROOTURLLEN - strlen(rootpath) -1);
     strncat(rootpath,path, MAXROOTURLLEN - strlen(rootpath) -1);
@@ -679,6 +690,8 @@ static int xrootdfs_truncate(const char *path, off_t size)
     else
         res = XrdFfsPosix_truncateall(xrootdfs.rdr, path, size, fuse_get_context()->uid);
 
+/* a readdir may have cached the old size while we were truncating */
+    XrdFfsDent_stcache_del(path);
     if (res == -1)
         return -errno;
 
@@ -729,6 +742,8 @@ static int xrootdfs_open(const char *path, struct fuse_file_info *fi)
 
     fi->fh = res;
     XrdFfsWcache_create(fi->fh);
+    if ((fi->flags & O_ACCMODE) != O_RDONLY)
+        XrdFfsDent_stcache_wopen(path);
     return 0;
 }
 
@@ -847,6 +862,8 @@ static int xrootdfs_release(const char *path, struct fuse_file_info *fi)
     XrdFfsWcache_destroy(fd);
     XrdFfsPosix_close(fd);
     fi->fh = 0;
+    if ((fi->flags & O_ACCMODE) != O_RDONLY)
+        XrdFfsDent_stcache_wclose(path);
 /* 
    Return at here because the current version of Cluster Name Space daemon 
    doesn't implement the 'truncate' functon we originally planned.
@@ -928,13 +945,25 @@ static int xrootdfs_release(const char *path, struct fuse_file_info *fi)
     return 0;
 }
 
+static int xrootdfs_flush(const char *path, struct fuse_file_info *fi)
+{
+    int fd;
+
+/* report errors of the write-behind cache to close() */
+    fd = (int) fi->fh;
+    if (XrdFfsWcache_sync(fd) < 0)
+        return -errno;
+    return 0;
+}
+
 static int xrootdfs_fsync(const char *path, int isdatasync,
                      struct fuse_file_info *fi)
 {
     int fd;
 
     fd = (int) fi->fh;
-    XrdFfsWcache_flush(fd);
+    if (XrdFfsWcache_sync(fd) < 0)
+        return -errno;
     XrdFfsPosix_fsync(fd);
     return 0;
 }
@@ -1168,6 +1197,8 @@ static void xrootdfs_usage(const char *progname)
 "                                 Absents of this option will disable automatically refreshing\n"
 "    -o maxfd=N               number of virtual file descriptors for posix requests, default 8192 (min 2048)\n"
 "    -o nworkers=N            number of workers to handle parallel requests to data servers, default 4\n"
+"    -o nwbufs=N              number of 128KB write buffers per file, N-1 of them are written behind\n"
+"                             asynchronously, default 4 (1 disables write-behind)\n"
 "    -o fastls=RDR            set to RDR when CNS is presented will cause stat() to go to redirector\n"
 "\n", progname);
 }
@@ -1221,6 +1252,7 @@ int main(int argc, char *argv[])
     xrootdfs_oper.write		= xrootdfs_write;
     xrootdfs_oper.statfs	= xrootdfs_statfs;
     xrootdfs_oper.release	= xrootdfs_release;
+    xrootdfs_oper.flush		= xrootdfs_flush;
     xrootdfs_oper.fsync		= xrootdfs_fsync;
     xrootdfs_oper.setxattr	= xrootdfs_setxattr;
     xrootdfs_oper.getxattr	= xrootdfs_getxattr;
@@ -1300,7 +1332,12 @@ int main(int argc, char *argv[])
     xrootdfs_opts[12].offset = offsetof(struct XROOTDFS, maxfd);
     xrootdfs_opts[12].value = 0;
 
-    xrootdfs_opts[13].templ = NULL;
+/* number of write buffers per file */
+    xrootdfs_opts[13].templ = "nwbufs=%d";
+    xrootdfs_opts[13].offset = offsetof(struct XROOTDFS, nwbufs);
+    xrootdfs_opts[13].value = 0;
+
+    xrootdfs_opts[14].templ = NULL;
 
 /* initialize struct xrootdfs */
 //    memset(&xrootdfs, 0, sizeof(xrootdfs));
@@ -1313,6 +1350,7 @@ int main(int argc, char *argv[])
     xrootdfs.urlcachelife = strdup("3650d"); /* 10 years */
     xrootdfs.nworkers = 4;
     xrootdfs.maxfd = 8192;
+    xrootdfs.nwbufs = 4;
 
 /* Get options from environment variables first */
     xrootdfs.rdr = getenv("XROOTDFS_RDRURL");
@@ -1323,6 +1361,7 @@ int main(int argc, char *argv[])
     if (getenv("XROOTDFS_OFSFWD") != NULL && ! strcmp(getenv("XROOTDFS_OFSFWD"),"1")) xrootdfs.ofsfwd = true;
     if (getenv("XROOTDFS_NWORKERS") != NULL) sscanf(getenv("XROOTDFS_NWORKERS"), "%d", &xrootdfs.nworkers);
     if (getenv("XROOTDFS_MAXFD") != NULL) sscanf(getenv("XROOTDFS_MAXFD"), "%d", &xrootdfs.maxfd);
+    if (getenv("XROOTDFS_NWBUFS") != NULL) sscanf(getenv("XROOTDFS_NWBUFS"), "%d", &xrootdfs.nwbufs);
 
 /* Parse XrootdFS options, will overwrite those defined in environment variables */
     fuse_opt_parse(&args, &xrootdfs, xrootdfs_opts, xrootdfs_opt_proc);
@@ -1356,6 +1395,7 @@ int main(int argc, char *argv[])
     }
 
     if (xrootdfs.maxfd < 2048) xrootdfs.maxfd = 2048;
+    if (xrootdfs.nwbufs < 1) xrootdfs.nwbufs = 1;
 
     signal(SIGUSR1,xrootdfs_sigusr1_handler);
 
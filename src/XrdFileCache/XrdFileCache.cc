@@ -79,8 +79,11 @@ XrdOucCache2 *XrdOucGetCache2(XrdSysLogger *logger,
    }
    err.Emsg("Retrieve", "Success - returning a factory.");
 
-   pthread_t tid1;
-   XrdSysThread::Run(&tid1, ProcessWriteTaskThread, (void*)(&factory), 0, "XrdFileCache WriteTasks ");
+   for (int wti = 0; wti < factory.RefConfiguration().m_wqueue_threads; ++wti)
+   {
+      pthread_t tid1;
+      XrdSysThread::Run(&tid1, ProcessWriteTaskThread, (void*)(&factory), 0, "XrdFileCache WriteTasks ");
+   }
 
    pthread_t tid2;
    XrdSysThread::Run(&tid2, PrefetchThread, (void*)(&factory), 0, "XrdFileCache Prefetch ");
@@ -220,30 +223,64 @@ void Cache::RemoveWriteQEntriesFor(File *iFile)
 void
 Cache::ProcessWriteTasks()
 {
+   std::vector<Block*> blks_to_write;
+   blks_to_write.reserve(m_configuration.m_wqueue_blocks);
+
    while (true)
    {
       m_writeQ.condVar.Lock();
-      while (m_writeQ.queue.empty())
+
+      // Take the first block of a file no other writer is busy with, so that
+      // blocks of one file are written in queue order by a single thread.
+      std::list<Block*>::iterator i;
+      while (true)
       {
+         for (i = m_writeQ.queue.begin(); i != m_writeQ.queue.end(); ++i)
+         {
+            if (m_writeQ.writing.find((*i)->m_file) == m_writeQ.writing.end()) break;
+         }
+         if (i != m_writeQ.queue.end()) break;
          m_writeQ.condVar.Wait();
       }
-      Block* block = m_writeQ.queue.front();
-      m_writeQ.queue.pop_front();
-      m_writeQ.size--;
-      TRACE(Dump, "Cache::ProcessWriteTasks  for %p " <<  (void*)(block) << " path " << block->m_file->lPath());
+
+      File *file = (*i)->m_file;
+      m_writeQ.writing.insert(file);
+      while (i != m_writeQ.queue.end() && (int) blks_to_write.size() < m_configuration.m_wqueue_blocks)
+      {
+         if ((*i)->m_file == file)
+         {
+            TRACE(Dump, "Cache::ProcessWriteTasks  for %p " <<  (void*)(*i) << " path " << file->lPath());
+            blks_to_write.push_back(*i);
+            i = m_writeQ.queue.erase(i);
+            m_writeQ.size--;
+         }
+         else
+         {
+            ++i;
+         }
+      }
       m_writeQ.condVar.UnLock();
 
-      block->m_file->WriteBlockToDisk(block);
+      file->WriteBlocksToDisk(blks_to_write);
+      blks_to_write.clear();
+
+      m_writeQ.condVar.Lock();
+      m_writeQ.writing.erase(file);
+      m_writeQ.condVar.Broadcast();
+      m_writeQ.condVar.UnLock();
    }
 }
 
 //______________________________________________________________________________
 
 bool
-Cache::RequestRAMBlock()
+Cache::RequestRAMBlock(bool promote)
 {
+   const Configuration &conf = Cache::GetInstance().RefConfiguration();
+   const int limit = conf.m_NRamBuffers + (promote ? conf.m_readv_promote : 0);
+
    XrdSysMutexHelper lock(&m_RAMblock_mutex);
-   if ( m_RAMblocks_used < Cache::GetInstance().RefConfiguration().m_NRamBuffers )
+   if ( m_RAMblocks_used < limit )
    {
       m_RAMblocks_used++;
       return true;
@@ -19,6 +19,7 @@
 //----------------------------------------------------------------------------------
 #include <string>
 #include <list>
+#include <set>
 
 #include "XrdVersion.hh"
 #include "XrdSys/XrdSysPthread.hh"
@@ -59,7 +60,10 @@ struct Configuration
       m_RamAbsAvailable(0),
       m_NRamBuffers(-1),
       m_prefetch_max_blocks(10),
-      m_hdfsbsize(128*1024*1024)
+      m_hdfsbsize(128*1024*1024),
+      m_wqueue_blocks(16),
+      m_wqueue_threads(4),
+      m_readv_promote(0)
    {}
 
    bool m_hdfsmode;                     //!< flag for enabling block-level operation
@@ -78,6 +82,10 @@ struct Configuration
    size_t    m_prefetch_max_blocks;     //!< maximum number of blocks to prefetch per file
 
    long long m_hdfsbsize;               //!< used with m_hdfsmode, default 128MB
+
+   int       m_wqueue_blocks;           //!< maximum number of blocks written to disk in one call
+   int       m_wqueue_threads;          //!< number of threads writing blocks to disk
+   int       m_readv_promote;           //!< RAM blocks readv may add to fetch missed blocks into the cache
 };
 
 struct TmpConfiguration
@@ -172,11 +180,17 @@ public:
    void RemoveWriteQEntriesFor(File *f);
 
    //---------------------------------------------------------------------
-   //! Separate task which writes blocks from ram to disk.
+   //! Separate task which writes blocks from ram to disk. Several of
+   //! these run in parallel, each taking a batch of blocks of one file
+   //! that no other writer is working on.
    //---------------------------------------------------------------------
    void ProcessWriteTasks();
 
-   bool RequestRAMBlock();
+   //---------------------------------------------------------------------
+   //! Reserve a RAM block. When promote is true the configured readv
+   //! promotion blocks may be used on top of the regular RAM limit.
+   //---------------------------------------------------------------------
+   bool RequestRAMBlock(bool promote = false);
 
    void RAMBlockReleased();
 
@@ -233,6 +247,7 @@ private:
       XrdSysCondVar condVar;                //!< write list condVar
       size_t size;                          //!< cache size of a container
       std::list<Block*>     queue;          //!< container
+      std::set<File*>       writing;        //!< files being written by a writer thread
    };
 
    WriteQ m_writeQ;
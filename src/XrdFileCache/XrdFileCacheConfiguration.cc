@@ -240,6 +240,8 @@ bool Cache::Config(XrdSysLogger *logger, const char *config_filename, const char
                       "       pfc.ram %.fg\n"
                       "       pfc.diskusage %lld %lld sleep %d\n"
                       "       pfc.spaces %s %s\n"
+                      "       pfc.writequeue %d %d\n"
+                      "       pfc.readv promote %d\n"
                       "       pfc.trace %d",
                       config_filename,
                       m_configuration.m_bufferSize,
@@ -250,6 +252,9 @@ bool Cache::Config(XrdSysLogger *logger, const char *config_filename, const char
                       m_configuration.m_purgeInterval,
                       m_configuration.m_data_space.c_str(),
                       m_configuration.m_meta_space.c_str(),
+                      m_configuration.m_wqueue_blocks,
+                      m_configuration.m_wqueue_threads,
+                      m_configuration.m_readv_promote,
                       m_trace->What);
 
       if (m_configuration.m_hdfsmode)
@@ -365,6 +370,34 @@ bool Cache::ConfigParameters(std::string part, XrdOucStream& config, TmpConfigur
          return false;
       }
    }
+   else if ( part == "writequeue" )
+   {
+      if (XrdOuca2x::a2i(m_log, "Error getting number of blocks per write", config.GetWord(), &m_configuration.m_wqueue_blocks, 1, 1024))
+      {
+         return false;
+      }
+      const char* params = config.GetWord();
+      if (params)
+      {
+         if (XrdOuca2x::a2i(m_log, "Error getting number of write threads", params, &m_configuration.m_wqueue_threads, 1, 64))
+         {
+            return false;
+         }
+      }
+   }
+   else if ( part == "readv" )
+   {
+      const char* params = config.GetWord();
+      if ( ! params || strcmp(params, "promote"))
+      {
+         m_log.Emsg("Config", "Error: readv parameter requires 'promote <nblocks>'.");
+         return false;
+      }
+      if (XrdOuca2x::a2i(m_log, "Error getting number of readv promotion blocks", config.GetWord(), &m_configuration.m_readv_promote, 0, 1024*1024))
+      {
+         return false;
+      }
+   }
    else if ( part == "hdfsmode" )
    {
       m_configuration.m_hdfsmode = true;
@@ -22,6 +22,7 @@
 #include "XrdFileCacheTrace.hh"
 #include <stdio.h>
 #include <sstream>
+#include <algorithm>
 #include <fcntl.h>
 #include <assert.h>
 #include "XrdCl/XrdClLog.hh"
@@ -708,12 +709,84 @@ int File::Read(char* iUserBuff, long long iUserOff, int iUserSize)
 
 //------------------------------------------------------------------------------
 
+namespace
+{
+   bool BlockOffsetLess(const Block* a, const Block* b)
+   {
+      return a->m_offset < b->m_offset;
+   }
+}
+
+long long File::BlockSizeOnDisk(Block* b)
+{
+   long long offset = b->m_offset - m_offset;
+   return (offset +  m_cfi.GetBufferSize()) > m_fileSize ? (m_fileSize - offset) : m_cfi.GetBufferSize();
+}
+
+//------------------------------------------------------------------------------
+
+void File::WriteBlocksToDisk(std::vector<Block*>& blocks)
+{
+   std::sort(blocks.begin(), blocks.end(), BlockOffsetLess);
+
+   std::vector<XrdOucIOVec> writeV;
+   writeV.reserve(blocks.size());
+
+   size_t i = 0;
+   while (i < blocks.size())
+   {
+      // find the run of blocks that are adjacent on disk
+      size_t j = i + 1;
+      while (j < blocks.size() && blocks[j]->m_offset == blocks[j-1]->m_offset + m_cfi.GetBufferSize())
+      {
+         ++j;
+      }
+
+      if (j - i > 1)
+      {
+         writeV.clear();
+         long long total = 0;
+         for (size_t k = i; k < j; ++k)
+         {
+            XrdOucIOVec v;
+            v.offset = blocks[k]->m_offset - m_offset;
+            v.size   = (int) BlockSizeOnDisk(blocks[k]);
+            v.info   = 0;
+            v.data   = blocks[k]->get_buff();
+            writeV.push_back(v);
+            total += v.size;
+         }
+
+         ssize_t retval = m_output->WriteV(&writeV[0], (int) writeV.size());
+         if (retval == total)
+         {
+            TRACEF(Dump, "File::WriteBlocksToDisk() wrote " << j - i << " blocks from offset " << blocks[i]->m_offset);
+            for (size_t k = i; k < j; ++k)
+            {
+               BlockWrittenToDisk(blocks[k]);
+            }
+            i = j;
+            continue;
+         }
+         TRACEF(Warning, "File::WriteBlocksToDisk() vector write of " << j - i << " blocks failed, error " << retval << ", writing blocks one by one");
+      }
+
+      for (size_t k = i; k < j; ++k)
+      {
+         WriteBlockToDisk(blocks[k]);
+      }
+      i = j;
+   }
+}
+
+//------------------------------------------------------------------------------
+
 void File::WriteBlockToDisk(Block* b)
 {
    int retval = 0;
    // write block buffer into disk file
    long long offset = b->m_offset - m_offset;
-   long long size = (offset +  m_cfi.GetBufferSize()) > m_fileSize ? (m_fileSize - offset) : m_cfi.GetBufferSize();
+   long long size = BlockSizeOnDisk(b);
    int buffer_remaining = size;
    int buffer_offset = 0;
    int cnt = 0;
@@ -737,8 +810,15 @@ void File::WriteBlockToDisk(Block* b)
       }
    }
 
-   // set bit fetched
    TRACEF(Dump, "File::WriteToDisk() success set bit for block " <<  b->m_offset << " size " <<  size);
+   BlockWrittenToDisk(b);
+}
+
+//------------------------------------------------------------------------------
+
+void File::BlockWrittenToDisk(Block* b)
+{
+   // set bit fetched
    int pfIdx =  (b->m_offset - m_offset)/m_cfi.GetBufferSize();
 
    bool schedule_sync = false;
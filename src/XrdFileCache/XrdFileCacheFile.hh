@@ -169,6 +169,12 @@ public:
    void ProcessBlockResponse(Block* b, int res);
    void WriteBlockToDisk(Block* b);
 
+   //----------------------------------------------------------------------
+   //! Write blocks to disk, adjacent blocks are written with one WriteV().
+   //! Sorts the vector by block offset.
+   //----------------------------------------------------------------------
+   void WriteBlocksToDisk(std::vector<Block*>& blocks);
+
    void Prefetch();
 
    float GetPrefetchScore() const;
@@ -238,6 +244,10 @@ private:
                 long long &off,        // offset in user buffer
                 long long &blk_off,    // offset in block
                 long long &size);
+   // Write
+   long long BlockSizeOnDisk(Block* b);
+   void      BlockWrittenToDisk(Block* b);
+
    // Read
    Block* PrepareBlockRequest(int i, bool prefetch);
    
@@ -239,7 +239,9 @@ bool File::VReadPreProcess(const XrdOucIOVec *readV, int n,
          }
          else
          {
-            if (Cache::GetInstance().RequestRAMBlock())
+            // With readv promotion a miss is fetched as a full block, and thus
+            // written to disk, even when the regular RAM blocks are all in use.
+            if (Cache::GetInstance().RequestRAMBlock(true))
             {
                Block *b = PrepareBlockRequest(block_idx, false);
                // TODO this can not fail (other than out of memory which we don't handle).
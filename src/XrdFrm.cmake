@@ -17,6 +17,7 @@ add_library(
   XrdFrm/XrdFrmReqBoss.cc       XrdFrm/XrdFrmReqBoss.hh
   XrdFrm/XrdFrmTransfer.cc      XrdFrm/XrdFrmTransfer.hh
   XrdFrm/XrdFrmXfrAgent.cc      XrdFrm/XrdFrmXfrAgent.hh
+  XrdFrm/XrdFrmXfrCopy.cc       XrdFrm/XrdFrmXfrCopy.hh
   XrdFrm/XrdFrmXfrDaemon.cc     XrdFrm/XrdFrmXfrDaemon.hh
                                 XrdFrm/XrdFrmXfrJob.hh
   XrdFrm/XrdFrmXfrQueue.cc      XrdFrm/XrdFrmXfrQueue.hh
@@ -75,6 +76,7 @@ target_link_libraries(
   frm_xfrd
   XrdFrm
   XrdServer
+  XrdCl
   XrdUtils
   pthread
   ${EXTRA_LIBS}
@@ -91,6 +93,7 @@ target_link_libraries(
   frm_xfragent
   XrdFrm
   XrdServer
+  XrdCl
   XrdUtils
   pthread
   ${EXTRA_LIBS}
@@ -150,11 +150,13 @@ XrdFrmConfig::XrdFrmConfig(SubSys ss, const char *vopts, const char *uinfo)
    QPath    = 0;
    AdminMode= 0740;
    xfrMax   = 2;
+   xfrMaxCl = 0;
    FailHold = 3*60*60;
    IdleHold = 10*60;
    WaitMigr = 60*60;
    WaitPurge= 600;
    WaitQChk = 300;
+   nsThreads= 0;
    MSSCmd   = 0;
    memset(&xfrCmd, 0, sizeof(xfrCmd));
    xfrCmd[0].Desc = "copycmd in";     xfrCmd[1].Desc = "copycmd out";
@@ -1006,6 +1008,7 @@ int XrdFrmConfig::ConfigXeq(char *var, int mbok)
    if (!strcmp(var, "all.pidpath"   )) return Grab(var, &PidPath, 0);
    if (!strcmp(var, "all.manager"   )) {haveCMS = 1; return 0;}
    if (!strcmp(var, "frm.all.cnsd"  )) return xcnsd();
+   if (!strcmp(var, "frm.all.scanthreads")) return xscan();
 
 // Process directives specific to each subsystem
 //
@@ -1100,8 +1103,13 @@ int XrdFrmConfig::ConfigXfr()
                ioOK[i%2]  = 1;
                else isBad = 1;
            }
+        if (xfrCmd[i].Opts & cmdXrdCl) ioOK[i%2] = 1;
        }
 
+// Establish the number of in-process copies we may run at the same time
+//
+   if (xfrMaxCl <= 0) xfrMaxCl = xfrMax;
+
 // Verify that we can actually do something
 //
    if (!(ioOK[0] | ioOK[1]))
@@ -1397,9 +1405,10 @@ int XrdFrmConfig::xcnsd()
 
 /* Function: copycmd
 
-   Purpose:  To parse the directive: copycmd [Options] cmd [args]
+   Purpose:  To parse the directive: copycmd [Options] [cmd [args]]
 
    Options:  [in] [noalloc] [out] [rmerr] [stats] [timeout <sec>] [url] [xpd]
+             [xrdcl]
 
              in        use command for incomming copies.
              noalloc   do not pre-allocate space for incomming copies.
@@ -1407,15 +1416,20 @@ int XrdFrmConfig::xcnsd()
              rmerr     remove incomming file when copy ends with an error.
                        Default unless noalloc is specified.
              stats     print transfer statistics in the log.
-             timeout   how long the cmd can run before it is killed.
+             timeout   how long the cmd can run before it is killed. It can't
+                       be combined with xrdcl as in-process copies can't be
+                       timed out.
              url       use command for url-based transfers.
              xpd       extend monitoring with program data.
+             xrdcl     copy root and xroot urls in-process using the xrootd
+                       client instead of running cmd. This implies url and
+                       cmd, which is then optional, is used for all other urls.
 
    Output: 0 upon success or !0 upon failure.
 */
 int XrdFrmConfig::xcopy()
 {  int cmdIO[2] = {0,0}, TLim=0, Stats=0, hasMDP=0, cmdUrl=0, noAlo=0, rmErr=0;
-   int monPD = 0;
+   int monPD = 0, xrdCl = 0;
    char *val, *theCmd = 0;
    struct copyopts {const char *opname; int *oploc;} cpopts[] =
          {
@@ -1426,7 +1440,8 @@ int XrdFrmConfig::xcopy()
           {"stats",  &Stats},
           {"timeout",&TLim},
           {"url",    &cmdUrl},
-          {"xpd",    &monPD}
+          {"xpd",    &monPD},
+          {"xrdcl",  &xrdCl}
          };
    int i, n, numopts = sizeof(cpopts)/sizeof(struct copyopts);
 
@@ -1438,6 +1453,7 @@ int XrdFrmConfig::xcopy()
              {if (!strcmp(val,cpopts[i].opname))
                  {if (strcmp("timeout", val)) {*cpopts[i].oploc = 1; break;}
                      else if (!xcopy(TLim)) return 1;
+                             else break;
                  }
              }
          if (i >= numopts)
@@ -1445,16 +1461,26 @@ int XrdFrmConfig::xcopy()
          val = cFile->GetWord();
         }
 
-// Pick up the program
+// Pick up the program. It is optional when copies are done in-process.
 //
    if (!val || !*val)
-      {Say.Emsg("Config", "copy command not specified"); return 1;}
-   if (Grab(val, &theCmd, -1)) return 1;
+      {if (!xrdCl)
+          {Say.Emsg("Config", "copy command not specified"); return 1;}
+      } else if (Grab(val, &theCmd, -1)) return 1;
+   if (xrdCl) cmdUrl = 1;
+
+// In-process copies can't be killed, so a time limit would silently not apply
+//
+   if (xrdCl && TLim)
+      {Say.Emsg("Config", "copycmd timeout may not be specified with xrdcl");
+       if (theCmd) free(theCmd);
+       return 1;
+      }
 
 // Find if $MDP is present here
 //
    if (!cmdIO[0] && !cmdIO[1]) cmdIO[0] = cmdIO[1] = 1;
-   if (cmdIO[1]) hasMDP = (strstr(theCmd, "$MDP") != 0);
+   if (cmdIO[1] && theCmd) hasMDP = (strstr(theCmd, "$MDP") != 0);
 
 // Initialzie the appropriate command structures
 //
@@ -1462,7 +1488,8 @@ int XrdFrmConfig::xcopy()
    i = 1;
    do {if (cmdIO[i])
           {if (xfrCmd[n].theCmd) free(xfrCmd[n].theCmd);
-           xfrCmd[n].theCmd = strdup(theCmd);
+           xfrCmd[n].theCmd = (theCmd ? strdup(theCmd) : 0);
+           if (xrdCl)  xfrCmd[n].Opts  |= cmdXrdCl;
            if (Stats)  xfrCmd[n].Opts  |= cmdStats;
            if (monPD)  xfrCmd[n].Opts  |= cmdXPD;
            if (hasMDP) xfrCmd[n].Opts  |= cmdMDP;
@@ -1476,7 +1503,7 @@ int XrdFrmConfig::xcopy()
 
 // All done
 //
-   free(theCmd);
+   if (theCmd) free(theCmd);
    return 0;
 }
 
@@ -1498,20 +1525,31 @@ int XrdFrmConfig::xcopy(int &TLim)
 
 /* Function: copymax
 
-   Purpose:  To parse the directive: copymax  <num>
+   Purpose:  To parse the directive: copymax  <num> [xrdcl <xnum>]
 
              <num>     maximum number of simultaneous transfers
+             <xnum>    maximum number of simultaneous in-process (xrdcl)
+                       transfers. The default is <num>.
 
    Output: 0 upon success or !0 upon failure.
 */
 int XrdFrmConfig::xcmax()
-{   int xmax = 1;
+{   int xmax = 1, cmax = 0;
     char *val;
 
     if (!(val = cFile->GetWord()))
        {Say.Emsg("Config", "maxio value not specified"); return 1;}
     if (XrdOuca2x::a2i(Say, "maxio", val, &xmax, 1)) return 1;
-    xfrMax = xmax;
+
+    if ((val = cFile->GetWord()))
+       {if (strcmp(val, "xrdcl"))
+           {Say.Emsg("Config", "invalid copymax option '",val,"'."); return 1;}
+        if (!(val = cFile->GetWord()))
+           {Say.Emsg("Config", "copymax xrdcl value not specified"); return 1;}
+        if (XrdOuca2x::a2i(Say, "copymax xrdcl", val, &cmax, 1)) return 1;
+       }
+
+    xfrMax = xmax; xfrMaxCl = cmax;
     return 0;
 }
 
@@ -1942,6 +1980,31 @@ int XrdFrmConfig::xqchk()
    return 0;
 }
 
+/******************************************************************************/
+/* Private:                        x s c a n                                  */
+/******************************************************************************/
+
+/* Function: xscan
+
+   Purpose:  To parse the directive: scanthreads <num>
+
+             <num>     number of threads used to index directories when the
+                       name space is scanned for purging or migration. The
+                       default is 0 (the scanning thread does all indexing).
+
+   Output: 0 upon success or !0 upon failure.
+*/
+int XrdFrmConfig::xscan()
+{   int nthr;
+    char *val;
+
+    if (!(val = cFile->GetWord()))
+       {Say.Emsg("Config", "scanthreads value not specified"); return 1;}
+    if (XrdOuca2x::a2i(Say, "scanthreads", val, &nthr, 0, 64)) return 1;
+    nsThreads = nthr;
+    return 0;
+}
+
 /******************************************************************************/
 /*                                  x s i t                                   */
 /******************************************************************************/
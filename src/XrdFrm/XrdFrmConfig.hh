@@ -81,6 +81,7 @@ static const int    cmdMDP   = 0x0002;
 static const int    cmdStats = 0x0004;
 static const int    cmdXPD   = 0x0008;
 static const int    cmdRME   = 0x0010;
+static const int    cmdXrdCl = 0x0020;
 
 int                 xfrIN;
 int                 xfrOUT;
@@ -97,11 +98,13 @@ int                 cmdHold;
 int                 AdminMode;
 int                 isAgent;
 int                 xfrMax;
+int                 xfrMaxCl;  // Maximum number of in-process (xrdcl) copies
 int                 FailHold;
 int                 IdleHold;
 int                 WaitQChk;
 int                 WaitPurge;
 int                 WaitMigr;
+int                 nsThreads; // Threads used to index directories
 int                 haveCMS;
 int                 isOTO;
 int                 Fix;
@@ -206,6 +209,7 @@ int          xmon();
 int          xpol();
 int          xpolprog();
 int          xqchk();
+int          xscan();
 int          xsit();
 int          xspace(int isPrg=0, int isXA=1);
 void         xspaceBuild(char *grp, char *fn, int isxa);
@@ -316,6 +316,10 @@ XrdFrmFiles::XrdFrmFiles(const char *dname, int opts,
 // Set Call Back method
 //
    nsObj.setCallBack(cbP);
+
+// Index directories in parallel when walking a tree, if so configured
+//
+   if (opts & Recursive) nsObj.setThreads(Config.nsThreads);
 }
 
 /******************************************************************************/
@@ -46,6 +46,7 @@
 #include "XrdFrm/XrdFrmConfig.hh"
 #include "XrdFrm/XrdFrmMonitor.hh"
 #include "XrdFrm/XrdFrmTransfer.hh"
+#include "XrdFrm/XrdFrmXfrCopy.hh"
 #include "XrdFrm/XrdFrmXfrJob.hh"
 #include "XrdFrm/XrdFrmXfrQueue.hh"
 #include "XrdNet/XrdNetCmsNotify.hh"
@@ -99,6 +100,8 @@ struct XrdFrmTranChk
   
 XrdSysMutex               XrdFrmTransfer::pMutex;
 XrdOucHash<char>          XrdFrmTransfer::pTab;
+XrdSysSemaphore          *XrdFrmTransfer::cmdGate = 0;
+XrdSysSemaphore          *XrdFrmTransfer::xclGate = 0;
 
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
@@ -157,6 +160,7 @@ const char *XrdFrmTransfer::Fetch()
    char lfnpath[MAXPATHLEN+1024+512+8], *Lfn, Rfn[MAXPATHLEN+256], *theSrc;
    char pdBuff[1024];
    int iXfr, pdSZ, lfnEnd, rc, isURL = 0, doRM = 0;
+   bool isXrdCl = false;
    long long fSize = 0;
 
 // The remote source is either the url-lfn or a translated lfn
@@ -171,8 +175,10 @@ const char *XrdFrmTransfer::Fetch()
 // Check if we can actually handle this transfer
 //
    if (isURL)
-      {if (xfrCmd[2]) iXfr = 2;
-          else return "url copies not configured";
+      {iXfr = 2;
+       if (Config.xfrCmd[2].Opts & Config.cmdXrdCl)
+          isXrdCl = XrdFrmXfrCopy::Native(theSrc);
+       if (!isXrdCl && !xfrCmd[2]) return "url copies not configured";
       } else {
        if (xfrCmd[0]) iXfr = 0;
           else return "non-url copies not configured";
@@ -200,14 +206,16 @@ const char *XrdFrmTransfer::Fetch()
        strcpy(&xfrP->PFN[xfrP->pfnEnd], ".anew");
       }
 
-// Setup the command
+// Setup the command unless we will be copying the file ourselves
 //
-   cmdArg.theCmd = xfrCmd[iXfr];
-   cmdArg.theVec = Config.xfrCmd[iXfr].theVec;
    cmdArg.theSrc = theSrc;
    cmdArg.theDst = xfrP->PFN;
    cmdArg.theINS = xfrP->reqData.iName;
-   if (!SetupCmd(&cmdArg)) return "incoming transfer setup failed";
+   if (!isXrdCl)
+      {cmdArg.theCmd = xfrCmd[iXfr];
+       cmdArg.theVec = Config.xfrCmd[iXfr].theVec;
+       if (!SetupCmd(&cmdArg)) return "incoming transfer setup failed";
+      }
 
 // If the copycmd needs a placeholder in the filesystem for this transfer, we
 // must create one. We first remove any existing "anew" file because we will
@@ -226,14 +234,15 @@ const char *XrdFrmTransfer::Fetch()
 
 // Setup program monitoring data
 //
-   pdSZ = (Config.xfrCmd[iXfr].Opts & Config.cmdXPD ? sizeof(pdBuff) : 0);
+   pdSZ = (Config.xfrCmd[iXfr].Opts & Config.cmdXPD && !isXrdCl
+        ? sizeof(pdBuff) : 0);
 
 // Now run the command to get the file and make sure the file is there
 // If it is, make sure that if a lock file exists its date/time is greater than
 // the file we just fetched; then rename it to be the correct name.
 //
    xfrET = time(0);
-   if (!(rc = cmdArg.theCmd->Run(pdBuff, pdSZ)))
+   if (!(rc = RunCopy(&cmdArg, pdBuff, pdSZ)))
       {if ((rc = Config.Stat(lfnpath, xfrP->PFN, &pfnStat)))
           {Say.Emsg("Fetch", lfnpath, "fetched but not resident!"); fSize = 0;}
           else {fSize  = pfnStat.st_size;
@@ -418,9 +427,13 @@ int XrdFrmTransfer::Init()
 //
    if (!XrdFrmXfrQueue::Init()) return 0;
 
-// Start the required number of transfer threads
+// Start the required number of transfer threads. When more in-process copies
+// than command copies are allowed (or vice versa), we start enough threads
+// for the larger number and gate the other kind of copy with a semaphore.
 //
-   n = Config.xfrMax;
+   n = (Config.xfrMax > Config.xfrMaxCl ? Config.xfrMax : Config.xfrMaxCl);
+   if (n > Config.xfrMax)   cmdGate = new XrdSysSemaphore(Config.xfrMax);
+   if (n > Config.xfrMaxCl) xclGate = new XrdSysSemaphore(Config.xfrMaxCl);
    while(n--)
         {if ((retc = XrdSysThread::Run(&tid, InitXfer, (void *)0,
                                        XRDSYSTHREAD_BIND, "transfer")))
@@ -432,6 +445,27 @@ int XrdFrmTransfer::Init()
    return 1;
 }
 
+/******************************************************************************/
+/* Private:                      R u n C o p y                                */
+/******************************************************************************/
+
+// Run the copy command or, when there is none, copy the file in-process. The
+// return value is that of the copy command.
+
+int XrdFrmTransfer::RunCopy(XrdFrmTranArg *argP, char *pdBuff, int pdSZ)
+{
+   XrdSysSemaphore *gateP = (argP->theCmd ? cmdGate : xclGate);
+   int rc;
+
+// Copies of a particular kind may be limited to fewer than our thread count
+//
+   if (gateP) gateP->Wait();
+   if (argP->theCmd) rc = argP->theCmd->Run(pdBuff, pdSZ);
+      else rc = XrdFrmXfrCopy::Copy(argP->theSrc, argP->theDst);
+   if (gateP) gateP->Post();
+   return rc;
+}
+
 /******************************************************************************/
 /* Private:                     S e t u p C m d                               */
 /******************************************************************************/
@@ -599,6 +633,7 @@ const char *XrdFrmTransfer::Throw()
    char pdBuff[1024];
    int isMigr = xfrP->reqData.Options & XrdFrcRequest::Migrate;
    int iXfr, isURL, pdSZ, rc, mDP = -1;
+   bool isXrdCl = false;
 
 // The remote source is either the url-lfn or a translated lfn
 //
@@ -612,8 +647,10 @@ const char *XrdFrmTransfer::Throw()
 // Check if we can actually handle this transfer
 //
    if (isURL)
-      {if (xfrCmd[3]) iXfr = 3;
-          else return "url copies not configured";
+      {iXfr = 3;
+       if (Config.xfrCmd[3].Opts & Config.cmdXrdCl)
+          isXrdCl = XrdFrmXfrCopy::Native(theDest);
+       if (!isXrdCl && !xfrCmd[3]) return "url copies not configured";
       } else {
        if (xfrCmd[1]) iXfr = 1;
           else return "non-url copies not configured";
@@ -640,26 +677,30 @@ const char *XrdFrmTransfer::Throw()
        return 0;
       }
 
-// Setup the command, including directory tracking, as needed
+// Setup the command, including directory tracking, as needed. Nothing needs
+// to be setup when we copy the file ourselves.
 //
-   cmdArg.theCmd = xfrCmd[iXfr];
-   cmdArg.theVec = Config.xfrCmd[iXfr].theVec;
    cmdArg.theDst = theDest;
    cmdArg.theSrc = xfrP->PFN;
    cmdArg.theINS = xfrP->reqData.iName;
-   if (Config.xfrCmd[iXfr].Opts & Config.cmdMDP)
-      mDP = TrackDC(lfnpath+xfrP->reqData.LFO, cmdArg.theMDP, Rfn);
-   if (!SetupCmd(&cmdArg)) return "outgoing transfer setup failed";
+   if (!isXrdCl)
+      {cmdArg.theCmd = xfrCmd[iXfr];
+       cmdArg.theVec = Config.xfrCmd[iXfr].theVec;
+       if (Config.xfrCmd[iXfr].Opts & Config.cmdMDP)
+          mDP = TrackDC(lfnpath+xfrP->reqData.LFO, cmdArg.theMDP, Rfn);
+       if (!SetupCmd(&cmdArg)) return "outgoing transfer setup failed";
+      }
 
 // Setup program monitoring data
 //
-   pdSZ = (Config.xfrCmd[iXfr].Opts & Config.cmdXPD ? sizeof(pdBuff) : 0);
+   pdSZ = (Config.xfrCmd[iXfr].Opts & Config.cmdXPD && !isXrdCl
+        ? sizeof(pdBuff) : 0);
 
 // Now run the command to put the file. If the command fails and this is a
 // migration request, cretae a fail file if one does not exist.
 //
    xfrET = time(0);
-   if ((rc = cmdArg.theCmd->Run(pdBuff, pdSZ)))
+   if ((rc = RunCopy(&cmdArg, pdBuff, pdSZ)))
       {if (isMigr) ffMake(rc == -2);
        retMsg = "copy failed";
       }
@@ -57,6 +57,7 @@ const char *Fetch();
 const char *FetchDone(char *lfnpath, struct stat &Stat, int &rc);
 const char *ffCheck();
       void  ffMake(int nofile=0);
+      int   RunCopy(XrdFrmTranArg *argP, char *pdBuff, int pdSZ);
       int   SetupCmd(XrdFrmTranArg *aP);
       int   TrackDC(char *Lfn, char *Mdp, char *Rfn);
       int   TrackDC(char *Rfn);
@@ -67,6 +68,8 @@ const char *ThrowOK(XrdFrmTranChk *cP);
 
 static XrdSysMutex               pMutex;
 static XrdOucHash<char>          pTab;
+static XrdSysSemaphore          *cmdGate;   // Limits command copies
+static XrdSysSemaphore          *xclGate;   // Limits in-process copies
 
 XrdOucProg    *xfrCmd[4];
 XrdFrmXfrJob  *xfrP;
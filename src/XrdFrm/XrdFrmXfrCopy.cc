@@ -0,0 +1,97 @@
+/******************************************************************************/
+/*                                                                            */
+/*                      X r d F r m X f r C o p y . c c                       */
+/*                                                                            */
+/* (c) 2018 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <errno.h>
+#include <string.h>
+#include <string>
+
+#include "XrdCl/XrdClCopyProcess.hh"
+#include "XrdCl/XrdClPropertyList.hh"
+#include "XrdCl/XrdClXRootDResponses.hh"
+#include "XrdFrc/XrdFrcTrace.hh"
+#include "XrdFrm/XrdFrmXfrCopy.hh"
+#include "XProtocol/XProtocol.hh"
+#include "XrdSys/XrdSysError.hh"
+
+using namespace XrdFrc;
+
+/******************************************************************************/
+/*                                  C o p y                                   */
+/******************************************************************************/
+  
+int XrdFrmXfrCopy::Copy(const char *Src, const char *Dst)
+{
+   EPNAME("Copy");
+   XrdCl::CopyProcess  cProc;
+   XrdCl::PropertyList cProps, cResults;
+   XrdCl::XRootDStatus cStat;
+
+// Describe the copy. Since we run a single job, the copy process runs it in
+// our thread and the client takes care of reusing existing connections.
+//
+   cProps.Set("source",  Src);
+   cProps.Set("target",  Dst);
+   cProps.Set("force",   true);
+   cProps.Set("makeDir", true);
+
+// Run the copy
+//
+   DEBUG("copying " <<Src <<" to " <<Dst);
+   cStat = cProc.AddJob(cProps, &cResults);
+   if (cStat.IsOK()) cStat = cProc.Prepare();
+   if (cStat.IsOK()) cStat = cProc.Run(0);
+   if (cStat.IsOK()) cResults.Get("status", cStat);
+   if (cStat.IsOK()) return 0;
+
+// The copy failed, report it and map the error to what a copy command would
+// have returned (i.e. 2 for a missing file and the xrdcp exit code otherwise).
+//
+   std::string eMsg = cStat.ToStr();
+   while(!eMsg.empty() && eMsg[eMsg.size()-1] == '\n') eMsg.erase(eMsg.size()-1);
+   Say.Emsg("Copy", Src, "copy failed;", eMsg.c_str());
+   if ((cStat.code == XrdCl::errErrorResponse && cStat.errNo == kXR_NotFound)
+   ||  (cStat.code == XrdCl::errOSError       && cStat.errNo == ENOENT))
+      return -2;
+   return -cStat.GetShellCode();
+}
+
+/******************************************************************************/
+/*                                N a t i v e                                 */
+/******************************************************************************/
+  
+bool XrdFrmXfrCopy::Native(const char *Url)
+{
+   static const char *pName[] = {"root://", "xroot://", "roots://", "xroots://"};
+   static const int   pNum    = sizeof(pName)/sizeof(pName[0]);
+
+   for (int i = 0; i < pNum; i++)
+       if (!strncmp(Url, pName[i], strlen(pName[i]))) return true;
+   return false;
+}
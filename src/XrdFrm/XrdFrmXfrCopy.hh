@@ -0,0 +1,55 @@
+#ifndef __XRDFRMXFRCOPY_HH__
+#define __XRDFRMXFRCOPY_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                      X r d F r m X f r C o p y . h h                       */
+/*                                                                            */
+/* (c) 2018 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+// This class copies files in-process using the XrdCl copy engine. It is used
+// by transfer threads for xroot url copies when copycmd specifies xrdcl so
+// that no program needs to be forked per file. All copies share the client's
+// connections so that repeated copies to the same server reuse the channel.
+
+class XrdFrmXfrCopy
+{
+public:
+
+// Copy() copies Src to Dst, overwriting Dst if it exists and creating any
+// missing directories. The return value is 0 upon success, -2 if the source
+// does not exist, and the negative xrdcp exit code for any other failure.
+//
+static int  Copy(const char *Src, const char *Dst);
+
+// Native() returns true if the url can be copied by this class.
+//
+static bool Native(const char *Url);
+
+            XrdFrmXfrCopy() {}
+           ~XrdFrmXfrCopy() {}
+};
+#endif
@@ -273,7 +273,8 @@ int XrdFrmXfrQueue::Init()
    // queue. This prevents stalls when a particular queue is stopped but keeps
    // us from exceeding internal resources when we get flooded with requests.
    //
-        n = Config.xfrMax*2;
+        n = (Config.xfrMax > Config.xfrMaxCl ? Config.xfrMax
+                                             : Config.xfrMaxCl)*2;
         while(n--)
              {xP = new XrdFrmXfrJob;
               xP->Next = xfrQ[qNum].Free;
@@ -367,12 +367,16 @@ int XrdNetAddrInfo::Resolve()
    else return EAI_FAMILY;
 
 // Do lookup of canonical name. If an error is returned we simply assume that
-// the name is not resolvable and return the address as the host name.
+// the name is not resolvable and return the address as the host name. This
+// is remembered for a while so that the lookup is not repeated on every call.
 //
    if ((rc = getnameinfo(&IP.Addr, n, hBuff+1, sizeof(hBuff)-2, 0, 0, 0)))
       {int ec = errno;
        if (Format(hBuff, sizeof(hBuff), fmtAddr, noPort))
-          {hostName = strdup(hBuff); return 0;}
+          {hostName = strdup(hBuff);
+           if (dnsCache) dnsCache->Add(this, hostName, true);
+           return 0;
+          }
        errno = ec;
        return rc;
       }
@@ -326,6 +326,8 @@ XrdNetAddrInfo &operator=(XrdNetAddrInfo const &rhs)
                          }
 
 protected:
+friend class XrdNetCache;
+
        char               *LowCase(char *str);
        int                 QFill(char *bAddr, int bLen);
        int                 Resolve();
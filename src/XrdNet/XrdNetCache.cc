@@ -30,11 +30,14 @@
 
 #include <stdlib.h>
 #include <time.h>
+#include <netinet/in.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 
+#include "XrdNet/XrdNetAddr.hh"
 #include "XrdNet/XrdNetAddrInfo.hh"
 #include "XrdNet/XrdNetCache.hh"
+#include "XrdSys/XrdSysPthread.hh"
 
 /******************************************************************************/
 /*                        S t a t i c   M e m b e r s                         */
@@ -42,73 +45,87 @@
   
 int XrdNetCache::keepTime = 0;
 
+int XrdNetCache::negTime  = 60;
+
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
 /******************************************************************************/
   
 XrdNetCache::XrdNetCache(int psize, int csize)
+                        : rfCond(0), rfFirst(0), rfLast(0), rfNum(0),
+                          rfRunning(false)
 {
-     prevtablesize = psize;
-     nashtablesize = csize;
-     Threshold     = (csize * LoadMax) / 100;
-     nashnum       = 0;
-     nashtable     = (anItem **)malloc( (size_t)(csize*sizeof(anItem *)) );
-     memset((void *)nashtable, 0, (size_t)(csize*sizeof(anItem *)));
+   for (int i = 0; i < nShards; i++)
+       {Shard[i].prevtablesize = psize;
+        Shard[i].nashtablesize = csize;
+        Shard[i].Threshold     = (csize * LoadMax) / 100;
+        Shard[i].nashnum       = 0;
+        Shard[i].nashtable     = (anItem **)malloc( (size_t)(csize*sizeof(anItem *)) );
+        memset((void *)Shard[i].nashtable, 0, (size_t)(csize*sizeof(anItem *)));
+       }
 }
 
 /******************************************************************************/
 /* public                            A d d                                    */
 /******************************************************************************/
   
-void XrdNetCache::Add(XrdNetAddrInfo *hAddr, const char *hName)
+void XrdNetCache::Add(XrdNetAddrInfo *hAddr, const char *hName, bool isNeg)
 {
    anItem Item, *hip;
-   int    kent;
+   int    kent, kt;
 
 // Get the key and make sure this is a valid address (should be)
 //
    if (!GenKey(Item, hAddr)) return;
+   aShard &sP = ShardOf(Item);
+
+// Negative entries are kept for a shorter time
+//
+   kt = (isNeg && negTime < keepTime ? negTime : keepTime);
 
 // We may be in a race condition, check we have this item
 //
-   myMutex.Lock();
-   if ((hip = Locate(Item)))
+   sP.rwLock.WriteLock();
+   if ((hip = Locate(sP, Item, time(0))))
       {if (hip->hName) free(hip->hName);
        hip->hName = strdup(hName);
-       hip->expTime = time(0) + keepTime;
-       myMutex.UnLock();
+       hip->expTime = time(0) + kt;
+       hip->isNeg = isNeg;
+       hip->inRefresh = 0;
+       sP.rwLock.UnLock();
        return;
       }
 
 // Check if we should expand the table
 //
-   if (++nashnum > Threshold) Expand();
+   if (++sP.nashnum > sP.Threshold) Expand(sP);
 
 // Allocate a new entry
 //
-   hip = new anItem(Item, hName, keepTime);
+   hip = new anItem(Item, hName, kt, isNeg);
 
 // Add the entry to the table
 //
-   kent = hip->aHash % nashtablesize;
-   hip->Next = nashtable[kent];
-   nashtable[kent] = hip;
-   myMutex.UnLock();
+   kent = hip->aHash % sP.nashtablesize;
+   hip->Next = sP.nashtable[kent];
+   sP.nashtable[kent] = hip;
+   sP.rwLock.UnLock();
 }
   
 /******************************************************************************/
 /* private                        E x p a n d                                 */
 /******************************************************************************/
   
-void XrdNetCache::Expand()
+void XrdNetCache::Expand(XrdNetCache::aShard &sP)
 {
    int newsize, newent, i;
    size_t memlen;
+   time_t now = time(0);
    anItem **newtab, *nip, *nextnip;
 
 // Compute new size for table using a fibonacci series
 //
-   newsize = prevtablesize + nashtablesize;
+   newsize = sP.prevtablesize + sP.nashtablesize;
 
 // Allocate the new table
 //
@@ -116,29 +133,31 @@ void XrdNetCache::Expand()
    if (!(newtab = (anItem **) malloc(memlen))) return;
    memset((void *)newtab, 0, memlen);
 
-// Redistribute all of the current items
+// Redistribute all of the current items, dropping the ones that expired
 //
-   for (i = 0; i < nashtablesize; i++)
-       {nip = nashtable[i];
+   for (i = 0; i < sP.nashtablesize; i++)
+       {nip = sP.nashtable[i];
         while(nip)
              {nextnip = nip->Next;
-              newent  = nip->aHash % newsize;
-              nip->Next = newtab[newent];
-              newtab[newent] = nip;
+              if (nip->expTime <= now) {delete nip; sP.nashnum--;}
+                 else {newent  = nip->aHash % newsize;
+                       nip->Next = newtab[newent];
+                       newtab[newent] = nip;
+                      }
               nip = nextnip;
              }
        }
 
 // Free the old table and plug in the new table
 //
-   free((void *)nashtable);
-   nashtable     = newtab;
-   prevtablesize = nashtablesize;
-   nashtablesize = newsize;
+   free((void *)sP.nashtable);
+   sP.nashtable     = newtab;
+   sP.prevtablesize = sP.nashtablesize;
+   sP.nashtablesize = newsize;
 
 // Compute new expansion threshold
 //
-   Threshold = static_cast<int>((static_cast<long long>(newsize)*LoadMax)/100);
+   sP.Threshold = static_cast<int>((static_cast<long long>(newsize)*LoadMax)/100);
 }
 
 /******************************************************************************/
@@ -147,39 +166,28 @@ void XrdNetCache::Expand()
   
 char *XrdNetCache::Find(XrdNetAddrInfo *hAddr)
 {
-  anItem Item, *nip, *pip = 0;
-  int kent;
+  anItem Item, *nip;
+  char *hName = 0;
+  time_t now;
+  int rfWin;
 
 // Get the hash for this address
 //
    if (!GenKey(Item, hAddr)) return 0;
+   aShard &sP = ShardOf(Item);
 
-// Compute position of the hash table entry
-//
-   myMutex.Lock();
-   kent = Item.aHash%nashtablesize;
-
-// Find the entry
-//
-   nip = nashtable[kent];
-   while(nip && *nip != Item) {pip = nip; nip = nip->Next;}
-   if (!nip) {myMutex.UnLock(); return 0;}
-
-// Make sure entry has not expired
+// Find the entry. Lookups only take the read lock of the shard so that they
+// never wait for each other. Expired entries are left for Add() to remove.
 //
-   if (nip->expTime > time(0))
-      {char *hName = strdup(nip->hName);
-       myMutex.UnLock();
-       return hName;
+   now = time(0);
+   sP.rwLock.ReadLock();
+   if ((nip = Locate(sP, Item)) && nip->expTime > now)
+      {hName = strdup(nip->hName);
+       rfWin = (nip->isNeg && negTime < keepTime ? negTime : keepTime) / 8;
+       if (nip->expTime - now <= rfWin) Refresh(nip);
       }
-
-// Remove the entry and return not found
-//
-   if (pip) pip->Next       = nip->Next;
-      else  nashtable[kent] = nip->Next;
-   myMutex.UnLock();
-   delete nip;
-   return 0;
+   sP.rwLock.UnLock();
+   return hName;
 }
 
 /******************************************************************************/
@@ -221,15 +229,133 @@ int XrdNetCache::GenKey(XrdNetCache::anItem &Item, XrdNetAddrInfo *hAddr)
 /* Private:                       L o c a t e                                 */
 /******************************************************************************/
   
-XrdNetCache::anItem *XrdNetCache::Locate(XrdNetCache::anItem &Item)
+// Locate() can be called with either lock of the shard held.
+//
+XrdNetCache::anItem *XrdNetCache::Locate(XrdNetCache::aShard &sP,
+                                         XrdNetCache::anItem &Item)
 {
   anItem *nip;
   unsigned int kent;
 
 // Find the entry
 //
-   kent = Item.aHash%nashtablesize;
-   nip = nashtable[kent];
+   kent = Item.aHash%sP.nashtablesize;
+   nip = sP.nashtable[kent];
    while(nip && *nip != Item) nip = nip->Next;
    return nip;
 }
+
+/******************************************************************************/
+
+// This version of Locate() removes expired entries from the chain while it
+// searches it and must be called with the write lock of the shard held.
+//
+XrdNetCache::anItem *XrdNetCache::Locate(XrdNetCache::aShard &sP,
+                                         XrdNetCache::anItem &Item, time_t now)
+{
+  anItem *nip, *pip = 0, *nextnip;
+  unsigned int kent;
+
+// Find the entry
+//
+   kent = Item.aHash%sP.nashtablesize;
+   nip = sP.nashtable[kent];
+   while(nip && *nip != Item)
+        {nextnip = nip->Next;
+         if (nip->expTime > now) pip = nip;
+            else {if (pip) pip->Next = nextnip;
+                     else  sP.nashtable[kent] = nextnip;
+                  delete nip; sP.nashnum--;
+                 }
+         nip = nextnip;
+        }
+   return nip;
+}
+
+/******************************************************************************/
+/* Private:                      R e f r e s h                                */
+/******************************************************************************/
+
+// Refresh() must be called with a lock of the item's shard held. Since Add()
+// resets inRefresh only with the write lock held, inRefresh is consistent.
+//
+void XrdNetCache::Refresh(XrdNetCache::anItem *hip)
+{
+   anItem *rip;
+   pthread_t tid;
+
+// Ignore this if a refresh is already pending or we are overloaded
+//
+   rfCond.Lock();
+   if (hip->inRefresh || rfNum >= rfMax) {rfCond.UnLock(); return;}
+
+// Start the refresh thread if we have not done so yet
+//
+   if (!rfRunning)
+      {if (XrdSysThread::Run(&tid, XrdNetCache::Refresher, (void *)this,
+                             0, "DNS cache refresher"))
+          {rfCond.UnLock(); return;}
+       rfRunning = true;
+      }
+
+// Queue a copy of the address
+//
+   rip = new anItem();
+   memcpy(rip->aVal, hip->aVal, hip->aLen);
+   rip->aLen  = hip->aLen;
+   rip->aHash = hip->aHash;
+   if (rfLast) rfLast->Next = rip;
+      else     rfFirst      = rip;
+   rfLast = rip;
+   rfNum++;
+   hip->inRefresh = 1;
+   rfCond.Signal();
+   rfCond.UnLock();
+}
+
+/******************************************************************************/
+/* Private:                    R e f r e s h e r                              */
+/******************************************************************************/
+
+void *XrdNetCache::Refresher(void *carg)
+{
+   XrdNetCache *cP = (XrdNetCache *)carg;
+
+   cP->Refresher();
+   return (void *)0;
+}
+
+/******************************************************************************/
+
+void XrdNetCache::Refresher()
+{
+   union {struct sockaddr     Addr;
+          struct sockaddr_in  v4;
+          struct sockaddr_in6 v6;
+         } sAddr;
+   anItem *rip;
+
+// Resolve each queued address. Resolve() adds the result, positive or
+// negative, to the cache which also clears the pending refresh indicator.
+//
+   while(1)
+        {rfCond.Lock();
+         while(!(rip = rfFirst)) rfCond.Wait();
+         if (!(rfFirst = rip->Next)) rfLast = 0;
+         rfNum--;
+         rfCond.UnLock();
+
+         memset(&sAddr, 0, sizeof(sAddr));
+         if (rip->aLen == 4)
+            {sAddr.v4.sin_family = AF_INET;
+             memcpy(&sAddr.v4.sin_addr,  rip->aVal, 4);
+            } else {
+             sAddr.v6.sin6_family = AF_INET6;
+             memcpy(&sAddr.v6.sin6_addr, rip->aVal, 16);
+            }
+         delete rip;
+
+         XrdNetAddr theAddr;
+         if (!theAddr.Set(&sAddr.Addr)) theAddr.Resolve();
+        }
+}
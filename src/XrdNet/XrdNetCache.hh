@@ -48,12 +48,17 @@ public:
 //!
 //! @param  hAddr  points to the address of the name.
 //! @param  hName  points to the name to be associated with the address.
+//! @param  isNeg  when true, the address could not be resolved and hName is
+//!                the textual address. The entry is kept for the negative
+//!                keep time so that lookups are not repeated on every call.
 //------------------------------------------------------------------------------
 
-void   Add(XrdNetAddrInfo *hAddr, const char *hName);
+void   Add(XrdNetAddrInfo *hAddr, const char *hName, bool isNeg=false);
 
 //------------------------------------------------------------------------------
-//! Locate an address-hostname association in the cache.
+//! Locate an address-hostname association in the cache. When the entry is
+//! about to expire, a background refresh of the entry is scheduled and the
+//! current name is returned so that the caller never waits for a lookup.
 //!
 //! @param  hAddr  points to the address of the name.
 //!
@@ -71,15 +76,25 @@ char  *Find(XrdNetAddrInfo *hAddr);
 static
 void   SetKT(int ktval) {keepTime = ktval;}
 
+//------------------------------------------------------------------------------
+//! Set the keep time for unresolvable addresses during initialization. The
+//! effective value never exceeds the default keep time.
+//!
+//! @param  ktVal  the number of seconds to keep a negative entry in the cache.
+//------------------------------------------------------------------------------
+static
+void   SetNKT(int ktval) {negTime = ktval;}
+
 //------------------------------------------------------------------------------
 //! Constructor. When allocateing a new hash, two adjacent Fibonocci numbers.
-//! The series is simply n[j] = n[j-1] + n[j-2].
+//! The series is simply n[j] = n[j-1] + n[j-2]. The cache is split into
+//! independently locked shards each of which starts with a table of csize.
 //!
 //! @param  psize  the correct Fibonocci antecedent to csize.
-//! @param  csize  the initial size of the table.
+//! @param  csize  the initial size of the table of each shard.
 //------------------------------------------------------------------------------
 
-       XrdNetCache(int psize = 987, int csize = 1597);
+       XrdNetCache(int psize = 89, int csize = 144);
 
 //------------------------------------------------------------------------------
 //! Destructor. The XrdNetCache object is not designed to be deleted. Doing
@@ -91,6 +106,9 @@ void   SetKT(int ktval) {keepTime = ktval;}
 private:
 
 static const int LoadMax = 80;
+static const int nShardBits = 4;
+static const int nShards = 1 << nShardBits;
+static const int rfMax   = 4096;  // Maximum number of pending refreshes
 
 struct anItem
       {union    {long long aV6[2];
@@ -102,32 +120,54 @@ struct anItem
        time_t    expTime;   // Expiration time
 unsigned int     aHash;     // Hash value
        int       aLen;      // Actual length 4 or 16
+       char      isNeg;     // Address could not be resolved
+       char      inRefresh; // Refresh has been scheduled
 
 inline int       operator!=(const anItem &oth)
                            {return aLen != oth.aLen || aHash != oth.aHash
                                 || memcmp(aVal, oth.aVal, aLen);
                            }
 
-                 anItem() : Next(0), hName(0), aLen(0) {}
+                 anItem() : Next(0), hName(0), aLen(0), isNeg(0), inRefresh(0) {}
 
-                 anItem(anItem &Item, const char *hn, int kt)
+                 anItem(anItem &Item, const char *hn, int kt, bool neg)
                          : Next(0), hName(strdup(hn)), expTime(time(0)+kt),
-                           aHash(Item.aHash), aLen(Item.aLen)
+                           aHash(Item.aHash), aLen(Item.aLen),
+                           isNeg(neg), inRefresh(0)
                          {memcpy(aVal, Item.aVal, Item.aLen);}
                 ~anItem() {if (hName) free(hName);}
       };
 
-void             Expand();
+struct aShard
+      {XrdSysRWLock     rwLock;
+       anItem         **nashtable;
+       int              prevtablesize;
+       int              nashtablesize;
+       int              nashnum;
+       int              Threshold;
+      };
+
+void             Expand(aShard &sP);
 int              GenKey(anItem &Item, XrdNetAddrInfo *hAddr);
-anItem          *Locate(anItem &Item);
+anItem          *Locate(aShard &sP, anItem &Item);
+anItem          *Locate(aShard &sP, anItem &Item, time_t now);
+void             Refresh(anItem *hip);
+static void     *Refresher(void *carg);
+void             Refresher();
+inline aShard   &ShardOf(anItem &Item)
+                        {return Shard[(Item.aHash * 2654435761U)
+                                      >> (32 - nShardBits)];
+                        }
 
 static int       keepTime;
+static int       negTime;
+
+aShard           Shard[nShards];
 
-XrdSysMutex      myMutex;
-anItem         **nashtable;
-int              prevtablesize;
-int              nashtablesize;
-int              nashnum;
-int              Threshold;
+XrdSysCondVar    rfCond;
+anItem          *rfFirst;
+anItem          *rfLast;
+int              rfNum;
+bool             rfRunning;
 };
 #endif
@@ -43,6 +43,7 @@
 #include <sys/types.h>
 
 #include "XrdCks/XrdCks.hh"
+#include "XrdCks/XrdCksCalc.hh"
 #include "XrdCks/XrdCksConfig.hh"
 #include "XrdCks/XrdCksData.hh"
 
@@ -53,6 +54,7 @@
 #include "XrdOfs/XrdOfs.hh"
 #include "XrdOfs/XrdOfsEvs.hh"
 #include "XrdOfs/XrdOfsHandle.hh"
+#include "XrdOfs/XrdOfsOpenJob.hh"
 #include "XrdOfs/XrdOfsPoscq.hh"
 #include "XrdOfs/XrdOfsTrace.hh"
 #include "XrdOfs/XrdOfsSecurity.hh"
@@ -172,6 +174,8 @@ XrdOfsFile::XrdOfsFile(const char *user, int monid) : XrdSfsFile(user, monid)
    dorawio = 0;
    viaDel  = 0;
    myTPC   = 0;
+   cksCalc = 0;
+   cksNext = 0;
    tident = (user ? user : "");
 }
 
@@ -456,6 +460,13 @@ int XrdOfsFile::open(const char          *path,      // In
       }
    XrdOfsFS->ocMutex.UnLock();
 
+// If the oss wants opens done in the background (e.g. the proxy oss whose opens
+// go to the origin) and the caller can attach the file later, do so.
+//
+   if (XrdOfsOpenJob::Allowed(error))
+      return XrdOfsFS->fsError(error, XrdOfsOpenJob::Schedule(this, path,
+                                              open_mode, Mode, client, info));
+
 // Handle the open mode options
 //
    if (open_mode & crMask)
@@ -590,6 +601,7 @@ int XrdOfsFile::open(const char          *path,      // In
       {dorawio = (oh->isCompressed && open_mode & SFS_O_RAWIO ? 1 : 0);
        if (tpcKey && isRW)
           return XrdOfsFS->Emsg(epname, error, EALREADY, "tpc", path);
+       if (isRW) oP.hP->noCkStrm = 1;
        XrdOfsFS->ocMutex.Lock(); oh = oP.hP; XrdOfsFS->ocMutex.UnLock();
        FTRACE(open, "attach use=" <<oh->Usage());
        if (oP.poscNum > 0) XrdOfsFS->poscQ->Commit(path, oP.poscNum);
@@ -637,6 +649,13 @@ int XrdOfsFile::open(const char          *path,      // In
    oP.hP->Activate(oP.fP);
    oP.hP->UnLock();
 
+// If the file starts out empty, checksum the data as it is written so that the
+// checksum need not be calculated by reading the file back afterwards.
+//
+   if ((XrdOfsFS->Options & XrdOfs::CksStream) && XrdOfsFS->Cks
+   &&  (open_flag & O_TRUNC) && !dorawio)
+      {cksCalc = XrdOfsFS->Cks->Object(0); cksNext = 0;}
+
 // Send an open event if we must
 //
    if (XrdOfsFS->evsObject)
@@ -700,6 +719,13 @@ int XrdOfsFile::close()  // In
     XrdOfsFS->ocMutex.UnLock();
     hP->Lock();
 
+// Pick up any checksum we computed while the file was written
+//
+   cksMutex.Lock();
+   XrdCksCalc *csP = cksCalc;
+   cksCalc = 0;
+   cksMutex.UnLock();
+
 // Delete the tpc object, if any
 //
    if (myTPC) {myTPC->Del(); myTPC = 0;}
@@ -721,7 +747,8 @@ int XrdOfsFile::close()  // In
 //
    if ((poscNum = hP->PoscGet(theMode, !viaDel)))
       {if (viaDel)
-          {if (hP->Inactive() || !XrdOfsFS->poscHold)
+          {if (csP) csP->Recycle();
+           if (hP->Inactive() || !XrdOfsFS->poscHold)
               {XrdOfsFS->Unpersist(hP, !hP->Inactive()); hP->Retire(cRetc);}
               else hP->Retire(hCB, XrdOfsFS->poscHold);
            return SFS_OK;
@@ -733,6 +760,10 @@ int XrdOfsFile::close()  // In
                }
       }
 
+// Record the checksum computed while writing if the writes covered the file
+//
+   if (csP) CksDone(hP, csP);
+
 // We need to handle the cunudrum that an event may have to be sent upon
 // the final close. However, that would cause the path name to be destroyed.
 // So, we have two modes of logic where we copy out the pathname if a final
@@ -1022,7 +1053,13 @@ XrdSfsXferSize XrdOfsFile::write(XrdSfsFileOffset  offset,    // In
    nbytes = (XrdSfsXferSize)(oh->Select().Write((const void *)buff,
                             (off_t)offset, (size_t)blen));
    if (nbytes < 0)
-      return XrdOfsFS->Emsg(epname, error, (int)nbytes, "write", oh);
+      {if (XrdOfsFS->Options & XrdOfs::CksStream) CksUpdate(offset, 0, 0);
+       return XrdOfsFS->Emsg(epname, error, (int)nbytes, "write", oh);
+      }
+
+// Include the data in the running checksum
+//
+   if (XrdOfsFS->Options & XrdOfs::CksStream) CksUpdate(offset, buff, nbytes);
 
 // Return number of bytes written
 //
@@ -1038,6 +1075,7 @@ XrdSfsXferSize XrdOfsFile::write(XrdSfsFileOffset  offset,    // In
 int XrdOfsFile::write(XrdSfsAio *aiop)
 {
    EPNAME("aiowrite");
+   bool doCks = false;
    int rc;
 
 // Perform any required tracing
@@ -1046,8 +1084,11 @@ int XrdOfsFile::write(XrdSfsAio *aiop)
 
 // If this is a POSC file, we must convert the async call to a sync call as we
 // must trap any errors that unpersist the file. We can't do that via aio i/f.
+// The same applies when checksumming the data as it is written.
 //
-   if (oh->isRW == XrdOfsHandle::opPC)
+   if (XrdOfsFS->Options & XrdOfs::CksStream)
+      {cksMutex.Lock(); doCks = (cksCalc != 0); cksMutex.UnLock();}
+   if (oh->isRW == XrdOfsHandle::opPC || doCks)
       {aiop->Result = this->write(aiop->sfsAio.aio_offset,
                                   (const char *)aiop->sfsAio.aio_buf,
                                   aiop->sfsAio.aio_nbytes);
@@ -1224,6 +1265,10 @@ int XrdOfsFile::truncate(XrdSfsFileOffset  flen)  // In
    if (XrdOfsFS->evsObject && !(oh->isChanged)
    &&  XrdOfsFS->evsObject->Enabled(XrdOfsEvs::Fwrite)) GenFWEvent();
 
+// Truncating anywhere but at the end of what we checksummed invalidates it
+//
+   if (XrdOfsFS->Options & XrdOfs::CksStream) CksTrunc(flen);
+
 // Perform the function
 //
    oh->isPending = 1;
@@ -1261,6 +1306,82 @@ int XrdOfsFile::getCXinfo(char cxtype[4], int &cxrsz)
 /******************************************************************************/
 /*                  P r i v a t e   F i l e   M e t h o d s                   */
 /******************************************************************************/
+/******************************************************************************/
+/* private                       C k s D o n e                                */
+/******************************************************************************/
+
+// Called at close with the handle locked. The checksum is stored only if no
+// other writer ever attached to the file and the writes covered it from start
+// to end.
+  
+void XrdOfsFile::CksDone(XrdOfsHandle *hP, XrdCksCalc *csP)
+{
+   EPNAME("CksDone");
+   XrdCksData cksData;
+   struct stat Stat;
+   const char *Path = hP->Name();
+   char pfnBuff[MAXPATHLEN+8], *csVal;
+   int csSize, rc;
+
+// Make sure the checksum reflects the whole file
+//
+   if (hP->Inactive() || hP->Usage() > 1 || hP->noCkStrm
+   ||  hP->Select().Fstat(&Stat)
+   ||  Stat.st_size != cksNext)
+      {csP->Recycle(); return;}
+
+// Fill out the checksum
+//
+   cksData.Set(csP->Type(csSize));
+   csVal = csP->Final();
+   memcpy(cksData.Value, csVal, csSize);
+   cksData.Length = csSize;
+   csP->Recycle();
+
+// Record it
+//
+   if (XrdOfsFS->CksPfn
+   &&  !(Path = XrdOfsOss->Lfn2Pfn(Path, pfnBuff, MAXPATHLEN, rc)))
+      {XrdOfsFS->Emsg(epname, error, rc, "checksum", hP->Name()); return;}
+   if ((rc = XrdOfsFS->Cks->Set(Path, cksData)))
+      XrdOfsFS->Emsg(epname, error, rc, "set checksum for", hP->Name());
+      else {XTRACE(close, hP->Name(), cksData.Name <<" checksum set");}
+}
+
+/******************************************************************************/
+/* private                     C k s U p d a t e                              */
+/******************************************************************************/
+
+// Include data in the running checksum. A nil buffer or data that does not
+// immediately follow what was included so far discards the checksum as does
+// another writer attaching to the file.
+  
+void XrdOfsFile::CksUpdate(XrdSfsFileOffset offset, const char *buff,
+                           XrdSfsXferSize   blen)
+{
+   XrdSysMutexHelper cksLock(cksMutex);
+
+   if (!cksCalc) return;
+   if (buff && offset == cksNext && !oh->noCkStrm)
+      {cksCalc->Update(buff, blen); cksNext += blen; return;}
+   cksCalc->Recycle();
+   cksCalc = 0;
+}
+
+/******************************************************************************/
+/* private                      C k s T r u n c                               */
+/******************************************************************************/
+
+// Truncating the file anywhere but at the end of the checksummed data discards
+// the checksum.
+
+void XrdOfsFile::CksTrunc(XrdSfsFileOffset flen)
+{
+   XrdSysMutexHelper cksLock(cksMutex);
+
+   if (cksCalc && flen != cksNext) {cksCalc->Recycle(); cksCalc = 0;}
+}
+
 /******************************************************************************/
 /* protected                  G e n F W E v e n t                             */
 /******************************************************************************/
@@ -97,6 +97,7 @@ char           dname[MAXNAMLEN];
 /*                            X r d O f s F i l e                             */
 /******************************************************************************/
 
+class XrdCksCalc;
 class XrdOfsTPC;
   
 class XrdOfsFile : public XrdSfsFile
@@ -163,10 +164,17 @@ protected:
 
 private:
 
+void           CksDone(XrdOfsHandle *hP, XrdCksCalc *csP);
+void           CksTrunc(XrdSfsFileOffset flen);
+void           CksUpdate(XrdSfsFileOffset offset, const char *buff,
+                         XrdSfsXferSize blen);
 void           GenFWEvent();
 
 XrdOfsHandle  *oh;
 XrdOfsTPC     *myTPC;
+XrdCksCalc    *cksCalc;   // Checksum of what was written so far, if any
+long long      cksNext;   // Offset the next write must have to be included
+XrdSysMutex    cksMutex;
 int            dorawio;
 char           viaDel;
 };
@@ -293,6 +301,7 @@ virtual               ~XrdOfs() {}  // Too complicate to delete :-)
 //
 enum {Authorize = 0x0001,    // Authorization wanted
       XAttrPlug = 0x0002,    // Extended Attribute Plugin
+      CksStream = 0x0004,    // Checksum files as they are written
       isPeer    = 0x0050,    // Role peer
       isProxy   = 0x0020,    // Role proxy
       isManager = 0x0040,    // Role manager
@@ -46,6 +46,7 @@
 #include "XrdOfs/XrdOfs.hh"
 #include "XrdOfs/XrdOfsConfigPI.hh"
 #include "XrdOfs/XrdOfsEvs.hh"
+#include "XrdOfs/XrdOfsOpenJob.hh"
 #include "XrdOfs/XrdOfsPoscq.hh"
 #include "XrdOfs/XrdOfsStats.hh"
 #include "XrdOfs/XrdOfsTPC.hh"
@@ -295,6 +296,16 @@ int XrdOfs::Configure(XrdSysError &Eroute, XrdOucEnv *EnvInfo) {
           Eroute.Say("Config POSC has been disabled by the osslib plugin.");
       } else if (poscAuto != -1 && !NoGo) NoGo |= ConfigPosc(Eroute);
 
+// Start the threads that complete opens in the background if the osslib plugin
+// asked for them (i.e. opening a file may take a long time).
+//
+   if ((tmp = getenv("XRDOFS_BGOPEN")) && !NoGo && !(Options & isManager))
+      {char nBuff[16];
+       sprintf(nBuff, "%d", XrdOfsOpenJob::Start(Eroute, atoi(tmp)));
+       Eroute.Say("Config opens are completed in the background using ",
+                  nBuff, " thread(s) as requested by the osslib plugin.");
+      }
+
 // Setup statistical monitoring
 //
    OfsStats.setRole(myRole);
@@ -330,12 +341,13 @@ void XrdOfs::Config_Display(XrdSysError &Eroute)
 
      snprintf(buff, sizeof(buff), "Config effective %s ofs configuration:\n"
                                   "       all.role %s\n"
-                                  "%s"
+                                  "%s%s"
                                   "       ofs.maxdelay   %d\n"
                                   "       ofs.persist    %s hold %d%s%s\n"
                                   "       ofs.trace      %x",
               cloc, myRole,
               (Options & Authorize ? "       ofs.authorize\n" : ""),
+              (Options & CksStream ? "       ofs.cksstream\n" : ""),
                MaxDelay,
                pval, poscHold, (poscLog ? " logdir " : ""),
                (poscLog ? poscLog    : ""), OfsTrace.What);
@@ -578,6 +590,7 @@ int XrdOfs::ConfigXeq(char *var, XrdOucStream &Config,
     TS_XPI("authlib",       theAutLib);
     TS_XPI("ckslib",        theCksLib);
     TS_Xeq("cksrdsz",       xcrds);
+    TS_Bit("cksstream",     Options, CksStream);
     TS_XPI("cmslib",        theCmsLib);
     TS_Xeq("forward",       xforward);
     TS_Xeq("maxdelay",      xmaxd);
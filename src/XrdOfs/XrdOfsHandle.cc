@@ -254,6 +254,7 @@ int XrdOfsHandle::Alloc(XrdOfsHanKey theKey, int Opts, XrdOfsHandle **Handle)
        hP->isCompressed = 0;                       // Compression
        hP->isPending    = 0;                       // Pending output
        hP->isRW         = (Opts & opPC);           // File mode
+       hP->noCkStrm     = 0;                       // Streamed cksum is ok
        hP->ssi          = ossDF;                   // No storage system yet
        hP->Posc         = 0;                       // No creator
        hP->Lock();                                 // Wait is not possible
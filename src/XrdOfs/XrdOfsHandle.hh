@@ -130,6 +130,7 @@ char                isPending;    // 1-> File  is pending sync()
 char                isChanged;    // 1-> File was modified
 char                isCompressed; // 1-> File  is compressed
 char                isRW;         // T-> File  is open in r/w mode
+char                noCkStrm;     // 1-> Another writer attached to the file
 
 void                Activate(XrdOssDF *ssP) {ssi = ssP;}
 
@@ -0,0 +1,190 @@
+/******************************************************************************/
+/*                                                                            */
+/*                      X r d O f s O p e n J o b . c c                       */
+/*                                                                            */
+/* (c) 2018 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "XrdOfs/XrdOfs.hh"
+#include "XrdOfs/XrdOfsOpenJob.hh"
+#include "XrdSys/XrdSysError.hh"
+
+/******************************************************************************/
+/*                        S t a t i c   O b j e c t s                         */
+/******************************************************************************/
+
+XrdSysCondVar  XrdOfsOpenJob::jobCV(0, "ofs open job");
+XrdOfsOpenJob *XrdOfsOpenJob::jobFirst   = 0;
+XrdOfsOpenJob *XrdOfsOpenJob::jobLast    = 0;
+int            XrdOfsOpenJob::numThreads = 0;
+
+/******************************************************************************/
+/*            E x t e r n a l   T h r e a d   I n t e r f a c e s             */
+/******************************************************************************/
+
+void *XrdOfsOpenRun(void *carg)
+{
+   (void)carg;
+   XrdOfsOpenJob::Run();
+   return (void *)0;
+}
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdOfsOpenJob::XrdOfsOpenJob(XrdOfsFile         *fP,
+                             const char         *path,
+                             XrdSfsFileOpenMode  oMode,
+                             mode_t              cMode,
+                             const XrdSecEntity *client,
+                             const char         *info)
+                            : Next(0), fileP(fP), cbObj(0), cbArg(0),
+                              Client(client), Path(strdup(path)),
+                              Info(info ? strdup(info) : 0),
+                              openMode(oMode), createMode(cMode), cbSync(0)
+{}
+
+/******************************************************************************/
+/*                            D e s t r u c t o r                             */
+/******************************************************************************/
+
+XrdOfsOpenJob::~XrdOfsOpenJob()
+{
+   if (Path) free(Path);
+   if (Info) free(Info);
+}
+
+/******************************************************************************/
+/*                                  D o I t                                   */
+/******************************************************************************/
+
+void XrdOfsOpenJob::DoIt()
+{
+   XrdOucErrInfo &error = fileP->error;
+   const char *eText;
+   int rc, eCode;
+
+// Wait until the client has been told to wait for the response. Until then
+// the caller may still be using the file's error object.
+//
+   cbSync.Wait();
+
+// Open the file. Since we no longer offer a callback the open is done inline.
+// The oss that asks for background opens never asks us to wait for an event.
+//
+   error.setErrCB(0);
+   error.setUCap(error.getUCap() & ~(XrdOucEI::uOpnCB | XrdOucEI::uOpnDF));
+   rc = fileP->open(Path, openMode, createMode, Client, Info);
+
+// Effect the callback with a copy of the result. The caller attaches the file
+// (or deletes it) and then calls our Done() once more. After that, neither the
+// file nor this object may be referenced by us.
+//
+   XrdOucErrInfo cbInfo(error.getErrUser(), this, cbArg, error.getErrMid());
+   eText = error.getErrText(eCode);
+   cbInfo.setErrInfo(eCode, eText);
+   cbObj->Done(rc, &cbInfo, Path);
+   cbSync.Wait();
+   delete this;
+}
+
+/******************************************************************************/
+/*                                   R u n                                    */
+/******************************************************************************/
+
+void XrdOfsOpenJob::Run()
+{
+   XrdOfsOpenJob *jP;
+
+// Complete opens as they are queued
+//
+   while(1)
+        {jobCV.Lock();
+         while(!(jP = jobFirst)) jobCV.Wait();
+         if (!(jobFirst = jP->Next)) jobLast = 0;
+         jobCV.UnLock();
+         jP->DoIt();
+        }
+}
+
+/******************************************************************************/
+/*                              S c h e d u l e                               */
+/******************************************************************************/
+
+int XrdOfsOpenJob::Schedule(XrdOfsFile         *fP,
+                            const char         *path,
+                            XrdSfsFileOpenMode  oMode,
+                            mode_t              cMode,
+                            const XrdSecEntity *client,
+                            const char         *info)
+{
+   XrdOfsOpenJob *jP = new XrdOfsOpenJob(fP,path,oMode,cMode,client,info);
+   XrdOucErrInfo &error = fP->error;
+
+// Take over the callback and tell the caller that we will complete the open
+//
+   jP->cbObj = error.getErrCB(jP->cbArg);
+   error.setErrCB(jP, jP->cbArg);
+   error.setUCap(error.getUCap() | XrdOucEI::uOpnDF);
+   error.setErrInfo(0, "");
+
+// Queue the open for the next available thread
+//
+   jobCV.Lock();
+   if (jobLast) jobLast->Next = jP;
+      else      jobFirst       = jP;
+   jobLast = jP;
+   jobCV.Signal();
+   jobCV.UnLock();
+   return SFS_STARTED;
+}
+
+/******************************************************************************/
+/*                                 S t a r t                                  */
+/******************************************************************************/
+
+int XrdOfsOpenJob::Start(XrdSysError &eDest, int tNum)
+{
+   pthread_t tid;
+   int rc;
+
+// Start the requested number of threads. Opens are done inline until at least
+// one thread is running.
+//
+   while(numThreads < tNum)
+        {if ((rc = XrdSysThread::Run(&tid, XrdOfsOpenRun, (void *)0, 0,
+                                     "Background opener")))
+            {eDest.Emsg("Config", rc, "create background open thread");
+             break;
+            }
+         numThreads++;
+        }
+   return numThreads;
+}
@@ -0,0 +1,108 @@
+#ifndef __XRDOFSOPENJOB_HH__
+#define __XRDOFSOPENJOB_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                      X r d O f s O p e n J o b . h h                       */
+/*                                                                            */
+/* (c) 2018 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <sys/types.h>
+
+#include "XrdOuc/XrdOucErrInfo.hh"
+#include "XrdSfs/XrdSfsInterface.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdOfsFile;
+class XrdSecEntity;
+class XrdSysError;
+
+/******************************************************************************/
+/*                         X r d O f s O p e n J o b                          */
+/******************************************************************************/
+
+// This object completes an open in the background when the oss asked for it
+// (i.e. its opens go over the network) and the caller is prepared to attach a
+// file whose open completes via callback (see XrdSfsFile::open()). The object
+// stands in as the callback object of the file's error object so that it
+// knows when the client has been told to wait and when the callback is done.
+
+class XrdOfsOpenJob : public XrdOucEICB
+{
+public:
+
+static bool Allowed(XrdOucErrInfo &eInfo)
+                   {return numThreads
+                       && (eInfo.getUCap() & XrdOucEI::uOpnCB)
+                       &&  eInfo.getErrCB();
+                   }
+
+       void DoIt();
+
+       void Done(int &Result, XrdOucErrInfo *eInfo, const char *Path=0)
+                {(void)Result; (void)eInfo; (void)Path; cbSync.Post();}
+
+static int  Schedule(XrdOfsFile         *fP,
+                     const char         *path,
+                     XrdSfsFileOpenMode  oMode,
+                     mode_t              cMode,
+                     const XrdSecEntity *client,
+                     const char         *info);
+
+       int  Same(unsigned long long arg1, unsigned long long arg2)
+                {(void)arg1; (void)arg2; return 0;}
+
+static void Run();
+
+static int  Start(XrdSysError &eDest, int tNum);
+
+private:
+            XrdOfsOpenJob(XrdOfsFile         *fP,
+                          const char         *path,
+                          XrdSfsFileOpenMode  oMode,
+                          mode_t              cMode,
+                          const XrdSecEntity *client,
+                          const char         *info);
+
+           ~XrdOfsOpenJob();
+
+static XrdSysCondVar       jobCV;
+static XrdOfsOpenJob      *jobFirst;
+static XrdOfsOpenJob      *jobLast;
+static int                 numThreads;
+
+XrdOfsOpenJob             *Next;
+XrdOfsFile                *fileP;
+XrdOucEICB                *cbObj;
+unsigned long long         cbArg;
+const XrdSecEntity        *Client;
+char                      *Path;
+char                      *Info;
+XrdSfsFileOpenMode         openMode;
+mode_t                     createMode;
+XrdSysSemaphore            cbSync;
+};
+#endif
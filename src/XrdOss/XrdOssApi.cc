@@ -41,6 +41,8 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/param.h>
+#include <sys/uio.h>
+#include <limits.h>
 #ifdef __solaris__
 #include <sys/vnode.h>
 #endif
@@ -757,6 +759,9 @@ int XrdOssFile::Open(const char *path, int Oflag, mode_t Mode, XrdOucEnv &Env)
        if (popts & XRDEXP_MMAP  || Info.Attr.Flags & XrdFrcXAttrMem::memMap)
           mopts |= OSSMIO_MMAP;
        if (mopts) mmFile = XrdOssMio::Map(local_path, fd, mopts);
+          else if (XrdOssMio::isHot() && !(Oflag & (O_WRONLY | O_RDWR)))
+                  mmFile = XrdOssMio::Hot(local_path, fd,
+                                        popts & XRDEXP_NOTRW);
       } else mmFile = 0;
 
 // Return the result of this open
@@ -1000,6 +1005,73 @@ ssize_t XrdOssFile::Write(const void *buff, off_t offset, size_t blen)
      return retval;
 }
 
+/******************************************************************************/
+/*                                W r i t e V                                 */
+/******************************************************************************/
+
+/*
+  Function: Write the segments described by 'writeV' to the associated file.
+            Segments that are adjacent in the file are written together with
+            a single pwritev() call.
+
+  Input:    writeV    - Array of offset, length and buffer pointer triples.
+            n         - Number of elements in writeV.
+
+  Output:   Returns the number of bytes written upon success and -errno o/w.
+            If the number of bytes written is less than requested, it is
+            considered an error.
+*/
+
+ssize_t XrdOssFile::WriteV(XrdOucIOVec *writeV, int n)
+{
+#if defined(__linux__)
+   struct iovec iov[IOV_MAX];
+   ssize_t wrsz, totBytes = 0;
+   long long offset, segBytes;
+   int i, j, k, iovcnt;
+
+   if (fd < 0) return (ssize_t)-XRDOSS_E8004;
+
+// Coalesce runs of adjacent segments into one iovec array each
+//
+   for (i = 0; i < n; i = j)
+       {offset   = writeV[i].offset;
+        segBytes = 0;
+        iovcnt   = 0;
+        for (j = i; j < n && iovcnt < IOV_MAX; j++)
+            {if (j > i && writeV[j].offset != offset + segBytes) break;
+             iov[iovcnt].iov_base = writeV[j].data;
+             iov[iovcnt].iov_len  = writeV[j].size;
+             segBytes += writeV[j].size;
+             iovcnt++;
+            }
+
+        if (XrdOssSS->MaxSize && offset + segBytes > XrdOssSS->MaxSize)
+           return (ssize_t)-XRDOSS_E8007;
+
+        do {wrsz = pwritev(fd, iov, iovcnt, offset);}
+           while(wrsz < 0 && errno == EINTR);
+        if (wrsz < 0) return (ssize_t)-errno;
+
+   // A short write is finished segment by segment using plain writes
+   //
+        if (wrsz < segBytes)
+           {for (k = i; k < j; k++)
+                {if (wrsz >= writeV[k].size) {wrsz -= writeV[k].size; continue;}
+                 if (Write(writeV[k].data + wrsz, writeV[k].offset + wrsz,
+                           writeV[k].size - wrsz) != writeV[k].size - wrsz)
+                    return (ssize_t)-ESPIPE;
+                 wrsz = 0;
+                }
+           }
+        totBytes += segBytes;
+       }
+   return totBytes;
+#else
+   return XrdOssDF::WriteV(writeV, n);
+#endif
+}
+
 /******************************************************************************/
 /*                                F c h m o d                                 */
 /******************************************************************************/
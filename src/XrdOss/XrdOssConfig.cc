@@ -487,9 +487,20 @@ void XrdOssSys::ConfigMio(XrdSysError &Eroute)
       }
 #endif
 
-// If no memory flags are set, turn off memory mapped files
+// Automatic mapping of hot files needs memory mapping support
 //
-   if (!(flags & XRDEXP_MEMAP) || setoff)
+#if !defined(_POSIX_MAPPED_FILES)
+   if (XrdOssMio::isHot())
+      {Eroute.Say("Config warning: memory mapped files not supported; "
+                             "memfile hot disabled.");
+       XrdOssMio::SetHot(0, 0, 0, -1, -1);
+      }
+#endif
+
+// If no memory flags are set and hot files are not mapped automatically,
+// turn off memory mapped files
+//
+   if ((!(flags & XRDEXP_MEMAP) && !XrdOssMio::isHot()) || setoff)
      {XrdOssMio::Set(0, 0, 0);
       tryMmap = 0; chkMmap = 0;
      }
@@ -1190,6 +1201,9 @@ int XrdOssSys::xmaxsz(XrdOucStream &Config, XrdSysError &Eroute)
 
    Purpose:  Parse the directive: memfile [off] [max <msz>]
                                           [check xattr] [preload]
+                                          [evict {lfu | lru}]
+                                          [hot <n>] [hotmax <hsz>]
+                                          [hotwin <sec>] [hotlock] [huge]
 
              check      Applies memory mapping options based on file's xattrs.
                         For backward compatibility, we also accept:
@@ -1199,6 +1213,16 @@ int XrdOssSys::xmaxsz(XrdOucStream &Config, XrdSysError &Eroute)
              on         Enables memory mapping
              preload    Preloads the file after every opn reference.
              <msz>      Maximum amount of memory to use (can be n% or real mem).
+             evict      How idle mappings are evicted when <msz> is reached:
+                        lru evicts the least recently used (default) and lfu
+                        the least frequently used one.
+             hot        Automatically maps a file after it has been opened <n>
+                        times for reading with no more than <sec> seconds
+                        between opens (default 600). Only files no larger than
+                        <hsz> (default 16m) are mapped and only if they are
+                        in a read/only path or have no write permission.
+             hotlock    Locks automatically mapped files in memory.
+             huge       Requests huge pages for automatically mapped files.
 
    Output: 0 upon success or !0 upon failure.
 */
@@ -1206,16 +1230,23 @@ int XrdOssSys::xmaxsz(XrdOucStream &Config, XrdSysError &Eroute)
 int XrdOssSys::xmemf(XrdOucStream &Config, XrdSysError &Eroute)
 {
     char *val;
-    int i, j, V_check=-1, V_preld = -1, V_on=-1;
-    long long V_max = 0;
+    int i, j, V_check=-1, V_preld = -1, V_on=-1, V_evict = -1;
+    int V_hot = -1, V_hotwin = 0, V_hotlock = -1, V_huge = -1;
+    long long V_max = 0, V_hotmax = 0;
 
     static struct mmapopts {const char *opname; int otyp;
                             const char *opmsg;} mmopts[] =
        {
         {"off",        0, ""},
         {"preload",    1, "memfile preload"},
-        {"check",      2, "memfile check"},
-        {"max",        3, "memfile max"}};
+        {"hotlock",    2, "memfile hotlock"},
+        {"huge",       3, "memfile huge"},
+        {"check",      4, "memfile check"},
+        {"max",        5, "memfile max"},
+        {"evict",      6, "memfile evict"},
+        {"hot",        7, "memfile hot"},
+        {"hotmax",     8, "memfile hotmax"},
+        {"hotwin",     9, "memfile hotwin"}};
     int numopts = sizeof(mmopts)/sizeof(struct mmapopts);
 
     if (!(val = Config.GetWord()))
@@ -1226,7 +1257,7 @@ int XrdOssSys::xmemf(XrdOucStream &Config, XrdSysError &Eroute)
               if (!strcmp(val, mmopts[i].opname)) break;
           if (i >= numopts)
              Eroute.Say("Config warning: ignoring invalid memfile option '",val,"'.");
-             else {if (mmopts[i].otyp >  1 && !(val = Config.GetWord()))
+             else {if (mmopts[i].otyp >  3 && !(val = Config.GetWord()))
                       {Eroute.Emsg("Config","memfile",mmopts[i].opname,
                                    "value not specified");
                        return 1;
@@ -1234,7 +1265,11 @@ int XrdOssSys::xmemf(XrdOucStream &Config, XrdSysError &Eroute)
                    switch(mmopts[i].otyp)
                          {case 1: V_preld = 1;
                                   break;
-                          case 2: if (!strcmp("xattr",val)
+                          case 2: V_hotlock = 1;
+                                  break;
+                          case 3: V_huge = 1;
+                                  break;
+                          case 4: if (!strcmp("xattr",val)
                                   ||  !strcmp("lock", val)
                                   ||  !strcmp("map",  val)
                                   ||  !strcmp("keep", val)) V_check=1;
@@ -1243,7 +1278,7 @@ int XrdOssSys::xmemf(XrdOucStream &Config, XrdSysError &Eroute)
                                        return 1;
                                       }
                                   break;
-                          case 3: j = strlen(val);
+                          case 5: j = strlen(val);
                                   if (val[j-1] == '%')
                                      {val[j-1] = '\0';
                                       if (XrdOuca2x::a2i(Eroute,mmopts[i].opmsg,
@@ -1253,6 +1288,25 @@ int XrdOssSys::xmemf(XrdOucStream &Config, XrdSysError &Eroute)
                                                 mmopts[i].opmsg, val, &V_max,
                                                 10*1024*1024)) return 1;
                                   break;
+                          case 6: if (!strcmp("lru", val)) V_evict = OSSMIO_LRU;
+                                     else if (!strcmp("lfu", val))
+                                             V_evict = OSSMIO_LFU;
+                                     else {Eroute.Emsg("Config",
+                                           "memfile evict argument not lfu or lru");
+                                           return 1;
+                                          }
+                                  break;
+                          case 7: if (XrdOuca2x::a2i(Eroute, mmopts[i].opmsg,
+                                                     val, &V_hot, 1)) return 1;
+                                  break;
+                          case 8: if (XrdOuca2x::a2sz(Eroute, mmopts[i].opmsg,
+                                                      val, &V_hotmax, 1))
+                                     return 1;
+                                  break;
+                          case 9: if (XrdOuca2x::a2tm(Eroute, mmopts[i].opmsg,
+                                                      val, &V_hotwin, 1))
+                                     return 1;
+                                  break;
                           default: V_on = 0; break;
                          }
                   val = Config.GetWord();
@@ -1263,6 +1317,8 @@ int XrdOssSys::xmemf(XrdOucStream &Config, XrdSysError &Eroute)
 //
    XrdOssMio::Set(V_on, V_preld, V_check);
    XrdOssMio::Set(V_max);
+   XrdOssMio::SetEvict(V_evict);
+   XrdOssMio::SetHot(V_hot, V_hotmax, V_hotwin, V_hotlock, V_huge);
    return 0;
 }
 
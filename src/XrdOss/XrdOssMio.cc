@@ -30,6 +30,7 @@
 
 #include <unistd.h>
 #include <stdio.h>
+#include <time.h>
 #include <sys/param.h>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -50,6 +51,9 @@
 XrdOucHash<XrdOssMioFile> XrdOssMio::MM_Hash;
 
 XrdSysMutex    XrdOssMio::MM_Mutex;
+XrdSysMutex    XrdOssMio::MM_hotMutex;
+
+XrdOssMio::HotEnt XrdOssMio::MM_hotTab[XrdOssMio::MM_hotsz];
 
 XrdOssMioFile *XrdOssMio::MM_Perm     = 0;
 XrdOssMioFile *XrdOssMio::MM_Idle     = 0;
@@ -59,6 +63,12 @@ char           XrdOssMio::MM_on       = 1;
 char           XrdOssMio::MM_chk      = 0;
 char           XrdOssMio::MM_okmlock  = 1;
 char           XrdOssMio::MM_preld    = 0;
+char           XrdOssMio::MM_evict    = OSSMIO_LRU;
+char           XrdOssMio::MM_hotlock  = 0;
+char           XrdOssMio::MM_huge     = 0;
+int            XrdOssMio::MM_hotcnt   = 0;
+int            XrdOssMio::MM_hotwin   = 600;
+long long      XrdOssMio::MM_hotmax   = 16*1024*1024;
 long long      XrdOssMio::MM_pagsz    = (long long)sysconf(_SC_PAGESIZE);
 #ifdef __APPLE__
 long long      XrdOssMio::MM_pages    = 1024*1024*1024;
@@ -71,6 +81,25 @@ long long      XrdOssMio::MM_inuse    = 0;
 extern XrdSysError OssEroute;
 
 extern XrdOucTrace OssTrace;
+
+/******************************************************************************/
+/*                       L o c a l   F u n c t i o n s                        */
+/******************************************************************************/
+
+// Return the sub-second part of the modification time so that a file that is
+// rewritten within the same second to the same size is still seen as stale.
+//
+namespace
+{
+long Mtnsec(struct stat &statb)
+{
+#if defined(__APPLE__)
+   return statb.st_mtimespec.tv_nsec;
+#else
+   return statb.st_mtim.tv_nsec;
+#endif
+}
+}
   
 /******************************************************************************/
 /*                               D i s p l a y                                */
@@ -78,14 +107,88 @@ extern XrdOucTrace OssTrace;
 
 void XrdOssMio::Display(XrdSysError &Eroute)
 {
-     char buff[1080];
-     snprintf(buff, sizeof(buff), "       oss.memfile %s%s%s max %lld",
+     char buff[1080], hbuff[256];
+
+     if (!MM_hotcnt) *hbuff = 0;
+        else snprintf(hbuff, sizeof(hbuff), " hot %d hotmax %lld hotwin %d%s%s",
+                      MM_hotcnt, MM_hotmax, MM_hotwin,
+                      (MM_hotlock ? " hotlock" : ""), (MM_huge ? " huge" : ""));
+     snprintf(buff, sizeof(buff), "       oss.memfile %s%s%s max %lld evict %s%s",
              (MM_on      ? ""            : "off "),
-             (MM_preld   ? "preload"     : ""),
-             (MM_chk     ? "check xattr" : ""), MM_max);
+             (MM_preld   ? "preload "    : ""),
+             (MM_chk     ? "check xattr" : ""), MM_max,
+             (MM_evict == OSSMIO_LFU ? "lfu" : "lru"), hbuff);
      Eroute.Say(buff);
 }
 
+/******************************************************************************/
+/*                                   H o t                                    */
+/******************************************************************************/
+
+// Hot() is called for every read-only open of a file that was not explicitly
+// selected for memory mapping. It counts references to the file and maps it
+// once it was opened hotcnt times with no gap longer than hotwin seconds. The
+// reference counts are kept in a fixed size table indexed by device and inode
+// so that tracking costs neither memory allocation nor the MM_Mutex lock.
+// Only files that cannot change underneath the mapping are candidates: those
+// in a read/only exported path (isRO) or having no write permission at all.
+// A file being written or truncated would otherwise be served stale data or,
+// worse, cause a SIGBUS when a read touches a page past the new end of file.
+//
+XrdOssMioFile *XrdOssMio::Hot(char *path, int fd, int isRO)
+{
+#if defined(_POSIX_MAPPED_FILES)
+   EPNAME("MioHot");
+   struct stat statb;
+   HotEnt *hp;
+   time_t now;
+   int n, opts;
+
+// Only small non-empty files are candidates
+//
+   if (fstat(fd, &statb) || !statb.st_size || statb.st_size > MM_hotmax)
+      return 0;
+
+// Skip files that may still be modified
+//
+   if (!isRO && (statb.st_mode & (S_IWUSR | S_IWGRP | S_IWOTH))) return 0;
+
+// Locate the tracking slot for this file
+//
+   n = static_cast<int>(((unsigned long long)statb.st_ino
+                      ^ ((unsigned long long)statb.st_dev << 20)) % MM_hotsz);
+   hp = &MM_hotTab[n];
+   now = time(0);
+
+// Count this reference. A slot held by another recently referenced file is
+// not simply taken over; its count is reduced instead so that two colliding
+// hot files do not keep resetting each other.
+//
+   MM_hotMutex.Lock();
+   if (hp->Ino != statb.st_ino || hp->Dev != statb.st_dev)
+      {if (hp->Count > 1 && now - hp->Last <= MM_hotwin)
+          {hp->Count--; MM_hotMutex.UnLock(); return 0;}
+       hp->Dev = statb.st_dev; hp->Ino = statb.st_ino; hp->Count = 0;
+      } else if (now - hp->Last > MM_hotwin) hp->Count = 0;
+   hp->Last = now;
+   if (hp->Count < MM_hotcnt) hp->Count++;
+   n = hp->Count;
+   MM_hotMutex.UnLock();
+
+// If the file is not hot enough, tell the caller to use regular I/O
+//
+   if (n < MM_hotcnt) return 0;
+   DEBUG("hot file refs=" <<n <<" size=" <<statb.st_size <<" path=" <<path);
+
+// Map the file
+//
+   opts = OSSMIO_MMAP | OSSMIO_MHOT | (MM_hotlock ? OSSMIO_MLOK : 0);
+   return Map(path, fd, opts, statb);
+#else
+   return 0;
+#endif
+}
+
 /******************************************************************************/
 /*                                   M a p                                    */
 /******************************************************************************/
@@ -93,12 +196,7 @@ void XrdOssMio::Display(XrdSysError &Eroute)
 XrdOssMioFile *XrdOssMio::Map(char *path, int fd, int opts)
 {
 #if defined(_POSIX_MAPPED_FILES)
-   EPNAME("MioMap");
-   XrdSysMutexHelper mapMutex;
    struct stat statb;
-   XrdOssMioFile *mp;
-   void *thefile;
-   char hashname[64];
 
 // Get the size of the file
 //
@@ -106,6 +204,22 @@ XrdOssMioFile *XrdOssMio::Map(char *path, int fd, int opts)
       {OssEroute.Emsg("Mio", errno, "fstat file", path);
        return 0;
       }
+   return Map(path, fd, opts, statb);
+#else
+   return 0;
+#endif
+}
+
+/******************************************************************************/
+
+XrdOssMioFile *XrdOssMio::Map(char *path, int fd, int opts, struct stat &statb)
+{
+#if defined(_POSIX_MAPPED_FILES)
+   EPNAME("MioMap");
+   XrdSysMutexHelper mapMutex;
+   XrdOssMioFile *mp;
+   void *thefile;
+   char hashname[64];
 
 // Develop hash name for this file
 //
@@ -121,10 +235,17 @@ XrdOssMioFile *XrdOssMio::Map(char *path, int fd, int opts)
 // Check if we already have this mapping
 //
    if ((mp = MM_Hash.Find(hashname)))
-      {DEBUG("Reusing mmap; usecnt=" <<mp->inUse <<" path=" <<path);
-       if (!(mp->Status & OSSMIO_MPRM) && !mp->inUse) Reclaim(mp);
-       mp->inUse++;
-       return mp;
+      {if (mp->Size  == statb.st_size  && mp->Mtime  == statb.st_mtime
+       &&  mp->Ctime == statb.st_ctime && mp->Mtnsec == Mtnsec(statb))
+          {DEBUG("Reusing mmap; usecnt=" <<mp->inUse <<" path=" <<path);
+           if (!(mp->Status & OSSMIO_MPRM) && !mp->inUse) Reclaim(mp);
+           mp->inUse++; mp->Hits++;
+           return mp;
+          }
+       DEBUG("Stale mmap; usecnt=" <<mp->inUse <<" path=" <<path);
+       if (mp->inUse || mp->Status & OSSMIO_MPRM) return 0;
+       Reclaim(mp);
+       Unmap(mp);
       }
 
 // Check if memory will be over committed
@@ -141,9 +262,19 @@ XrdOssMioFile *XrdOssMio::Map(char *path, int fd, int opts)
 //
    if ((thefile = mmap(0,statb.st_size,PROT_READ,MAP_PRIVATE,fd,0))==MAP_FAILED)
       {OssEroute.Emsg("Mio", errno, "mmap file", path);
+       MM_inuse -= statb.st_size;
        return 0;
       } else {DEBUG("mmap " <<statb.st_size <<" bytes for " <<path);}
 
+// Ask for huge pages backing hot files, if so wanted. This is only a hint;
+// most filesystems ignore it for file mappings.
+//
+#ifdef MADV_HUGEPAGE
+   if (MM_huge && (opts & OSSMIO_MHOT)
+   &&  madvise((char *)thefile, statb.st_size, MADV_HUGEPAGE))
+      {DEBUG("madvise(MADV_HUGEPAGE) failed; errno=" <<errno <<" path=" <<path);}
+#endif
+
 // Lock the file, if need be. Turn off locking if we don't have privs
 //
    if (MM_okmlock && (opts & OSSMIO_MLOK))
@@ -165,6 +296,7 @@ XrdOssMioFile *XrdOssMio::Map(char *path, int fd, int opts)
    if (!(mp = new XrdOssMioFile(hashname)))
       {OssEroute.Emsg("Mio", "Unable to allocate mmap file object for", path);
        munmap((char *)thefile, statb.st_size);
+       MM_inuse -= statb.st_size;
        return 0;
       }
 
@@ -174,13 +306,16 @@ XrdOssMioFile *XrdOssMio::Map(char *path, int fd, int opts)
    mp->Size   = statb.st_size;
    mp->Dev    = statb.st_dev;
    mp->Ino    = statb.st_ino;
+   mp->Mtime  = statb.st_mtime;
+   mp->Mtnsec = Mtnsec(statb);
+   mp->Ctime  = statb.st_ctime;
    mp->Status = opts;
 
 // Add the mapping to our hash table
 //
    if (MM_Hash.Add(hashname, mp))
       {OssEroute.Emsg("Mio", "Hash add failed for", path);
-       munmap((char *)thefile, statb.st_size);
+       MM_inuse -= statb.st_size;
        delete mp;
        return 0;
       }
@@ -239,23 +374,40 @@ void *XrdOssMio::preLoad(void *arg)
 /*                               R e c l a i m                                */
 /******************************************************************************/
   
-// Reclaim() can only be called if the caller has the MM_Mutex lock!
+// Reclaim() can only be called if the caller has the MM_Mutex lock! The idle
+// list is ordered by the time a mapping became unused so that LRU eviction
+// simply takes the head. LFU eviction takes the mapping with the fewest hits
+// and then halves the hits of the survivors so that old popularity fades.
 //
 int XrdOssMio::Reclaim(off_t amount)
 {
    EPNAME("MioReclaim");
-   XrdOssMioFile *mp;
+   XrdOssMioFile *mp, *pmp, *cmp, *pcmp;
    DEBUG("Trying to reclaim " <<amount <<" bytes.");
 
 // Try to reclaim memory
 //
    while((mp = MM_Idle) && amount > 0)
-        {MM_Idle = mp->Next;
-         MM_inuse -= mp->Size;
-         amount   -= mp->Size;
-         MM_Hash.Del(mp->HashName);  // This will delete the object
+        {pmp = 0;
+         if (MM_evict == OSSMIO_LFU)
+            {pcmp = mp; cmp = mp->Next;
+             while(cmp)
+                  {if (cmp->Hits < mp->Hits) {pmp = pcmp; mp = cmp;}
+                   pcmp = cmp; cmp = cmp->Next;
+                  }
+            }
+         if (pmp) pmp->Next = mp->Next;
+            else  MM_Idle   = mp->Next;
+         if (MM_IdleLast == mp) MM_IdleLast = pmp;
+         amount -= mp->Size;
+         Unmap(mp);
         }
 
+// Age the remaining idle mappings
+//
+   if (MM_evict == OSSMIO_LFU)
+      for (mp = MM_Idle; mp; mp = mp->Next) mp->Hits >>= 1;
+
 // Indicate whether we cleared enough
 //
    return amount <= 0;
@@ -284,6 +436,19 @@ int XrdOssMio::Reclaim(XrdOssMioFile *mp)
    return (cmp != 0);
 }
  
+/******************************************************************************/
+/*                                 U n m a p                                  */
+/******************************************************************************/
+
+// Unmap() can only be called if the caller has the MM_Mutex lock and the
+// mapping is on no list!
+//
+void XrdOssMio::Unmap(XrdOssMioFile *mp)
+{
+   MM_inuse -= mp->Size;
+   MM_Hash.Del(mp->HashName);  // This will delete the object
+}
+
 /******************************************************************************/
 /*                               R e c y c l e                                */
 /******************************************************************************/
@@ -326,6 +491,21 @@ void XrdOssMio::Set(long long V_max)
    if (V_max > 0) MM_max = V_max;
       else if (V_max < 0) MM_max = MM_pagsz*MM_pages*(-V_max)/100;
 }
+
+void XrdOssMio::SetEvict(int V_evict)
+{
+   if (V_evict   >= 0) MM_evict   = (char)V_evict;
+}
+
+void XrdOssMio::SetHot(int V_cnt, long long V_max, int V_win,
+                       int V_lock, int V_huge)
+{
+   if (V_cnt     >= 0) MM_hotcnt  = V_cnt;
+   if (V_max     >  0) MM_hotmax  = V_max;
+   if (V_win     >  0) MM_hotwin  = V_win;
+   if (V_lock    >= 0) MM_hotlock = (char)V_lock;
+   if (V_huge    >= 0) MM_huge    = (char)V_huge;
+}
  
 /******************************************************************************/
 /*             X r d O s s d M i o F i l e   D e s t r u c t o r              */
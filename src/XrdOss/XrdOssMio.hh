@@ -40,14 +40,26 @@
 #define OSSMIO_MLOK 0x0001
 #define OSSMIO_MMAP 0x0002
 #define OSSMIO_MPRM 0x0004
+#define OSSMIO_MHOT 0x0008
+
+// The following are the eviction policies for idle mappings
+//
+#define OSSMIO_LRU  0
+#define OSSMIO_LFU  1
+
+struct stat;
   
 class XrdOssMio
 {
 public:
 static void           Display(XrdSysError &Eroute);
 
+static XrdOssMioFile *Hot(char *path, int fd, int isRO);
+
 static char           isAuto() {return MM_chk;}
 
+static char           isHot()  {return MM_hotcnt != 0;}
+
 static char           isOn()   {return MM_on;}
 
 static XrdOssMioFile *Map(char *path, int fd, int opts);
@@ -60,9 +72,21 @@ static void           Set(int V_off, int V_preld, int V_check);
 
 static void           Set(long long V_max);
 
+static void           SetHot(int V_cnt, long long V_max, int V_win,
+                             int V_lock, int V_huge);
+
+static void           SetEvict(int V_evict);
+
 private:
+static XrdOssMioFile *Map(char *path, int fd, int opts, struct stat &statb);
 static int  Reclaim(off_t amount);
 static int  Reclaim(XrdOssMioFile *mp);
+static void Unmap(XrdOssMioFile *mp);
+
+struct HotEnt {dev_t Dev; ino_t Ino; time_t Last; int Count;};
+static const int  MM_hotsz = 4096;       // Number of hot tracking slots
+static HotEnt     MM_hotTab[MM_hotsz];
+static XrdSysMutex    MM_hotMutex;
 
 static XrdOucHash<XrdOssMioFile> MM_Hash;
 
@@ -75,6 +99,12 @@ static char       MM_on;
 static char       MM_chk;
 static char       MM_okmlock;
 static char       MM_preld;
+static char       MM_evict;
+static char       MM_hotlock;
+static char       MM_huge;
+static int        MM_hotcnt;
+static int        MM_hotwin;
+static long long  MM_hotmax;
 static long long  MM_max;
 static long long  MM_pagsz;
 static long long  MM_pages;
@@ -42,7 +42,8 @@ off_t Export(void **Addr) {*Addr = Base; return Size;}
 
        XrdOssMioFile(char *hname)
                     {strcpy(HashName, hname); 
-                     inUse = 1; Next = 0; Size = 0;
+                     inUse = 1; Hits = 1; Next = 0; Size = 0; Mtime = 0;
+                     Mtnsec = 0; Ctime = 0;
                     }
       ~XrdOssMioFile();
 
@@ -53,8 +54,12 @@ dev_t          Dev;
 ino_t          Ino;
 int            Status;
 int            inUse;
+int            Hits;
 void          *Base;
 off_t          Size;
+time_t         Mtime;
+long           Mtnsec;
+time_t         Ctime;
 char           HashName[64];
 };
 #endif
@@ -176,7 +176,7 @@ XrdOucCacheReal::~XrdOucCacheReal()
 
 // Delete the slots
 //
-   delete Slots; Slots = 0;
+   delete [] Slots; Slots = 0;
 
 // Unmap cache memory and associated hash table
 //
@@ -257,17 +257,19 @@ int XrdOucCacheReal::Detach(XrdOucCacheIO *ioP)
 
 // We will be deleting the CacheData object. So, we need to recycle its slots.
 //
+   LockAll();
    oP = &Slots[Fnum];
    while(oP->Own.Next != Fnum)
         {sP = &Slots[oP->Own.Next];
          sP->Owner(Slots);
-         if (sP->Contents < 0 || sP->Status.LRU.Next < 0) Faults++;
+         if (sP->Contents < 0 || sP->Uses) Faults++;
             else {sP->Hide(Slots, Slash, sP->Contents%HNum);
                   sP->Pull(Slots);
                   sP->unRef(Slots);
                   Free++;
                  }
         }
+   UnLockAll();
 
 // Reduce attach count and check if the cache is being deleted
 //
@@ -308,16 +310,20 @@ void XrdOucCacheReal::eMsg(const char *Path, const char *What, long long xOff,
 char *XrdOucCacheReal::Get(XrdOucCacheIO *ioP, long long lAddr,
                        int &rAmt, int &noIO)
 {
-   XrdSysMutexHelper Monitor(CMutex);
    XrdOucCacheSlot::ioQ *Waiter;
    XrdOucCacheSlot *sP;
-   int nUse, Fnum, Slot, segHash = lAddr%HNum;
+   XrdSysMutex *hP = hLock(lAddr%HNum), *vP;
+   long long vAddr;
+   int nUse, nMov, Fnum, Slot, segHash = lAddr%HNum;
    char *cBuff;
 
 // See if we have this logical address in the cache. Check if the page is in
-// transit and, if so, wait for it to arrive before proceeding.
+// transit and, if so, wait for it to arrive before proceeding. Only the lock
+// for this hash chain is needed as the slot stays where it is on the LRU chain
+// and is merely marked as referenced.
 //
    noIO = 1;
+   hP->Lock();
    if (Slash[segHash]
    &&  (Slot = XrdOucCacheSlot::Find(Slots, lAddr, Slash[segHash])))
       {sP = &Slots[Slot];
@@ -326,51 +332,75 @@ char *XrdOucCacheReal::Get(XrdOucCacheIO *ioP, long long lAddr,
            XrdOucCacheSlot::ioQ ioTrans(sP->Status.waitQ, &ioSem);
            sP->Status.waitQ = &ioTrans;
            if (Dbg > 1) cerr <<"Cache: Wait slot " <<Slot <<endl;
-           CMutex.UnLock(); ioSem.Wait(); CMutex.Lock();
-           if (sP->Contents != lAddr) {rAmt = -EIO; return 0;}
-          } else {
-            if (sP->Status.inUse < 0) sP->Status.inUse--;
-               else {sP->Pull(Slots); sP->Status.inUse = -1;}
-          }
+           hP->UnLock(); ioSem.Wait(); hP->Lock();
+           if (sP->Contents != lAddr) {hP->UnLock(); rAmt = -EIO; return 0;}
+          } else {sP->Uses++; sP->Refd = 1;}
        rAmt = (sP->Count < 0 ? sP->Count & XrdOucCacheSlot::lenMask : SegSize);
        if (sP->Count & XrdOucCacheSlot::isNew)
           {noIO = -1; sP->Count &= ~XrdOucCacheSlot::isNew;}
        if (Dbg > 2) cerr <<"Cache: Hit slot " <<Slot <<" sz " <<rAmt <<" nio "
-                         <<noIO <<" uc " <<sP->Status.inUse <<endl;
+                         <<noIO <<" uc " <<sP->Uses <<endl;
+       hP->UnLock();
        return Base+(static_cast<long long>(Slot)*SegSize);
       }
-
-// Page is not here. If no allocation wanted or we cannot obtain a free slot
-// return and indicate there is no associated cache page.
-//
-   if (!ioP || !(Slot = Slots[Slots->Status.LRU.Next].Pull(Slots)))
-      {rAmt = -ENOMEM; return 0;}
+   hP->UnLock();
+
+// Page is not here. If no allocation wanted we are done.
+//
+   if (!ioP) {rAmt = -ENOMEM; return 0;}
+
+// Obtain the least recently used slot. Since the slot may be hashed under a
+// different chain, we must lock that chain before taking the slot and then
+// verify that the slot was not reused or moved in the meantime. Slots that are
+// in use or were referenced since we last passed them over go to the end of
+// the chain. When every slot is in use we will have gone around twice.
+//
+   nMov = 0;
+   do {LMutex.Lock();
+       Slot  = Slots->Status.LRU.Next;
+       vAddr = Slots[Slot].Contents;
+       LMutex.UnLock();
+       if (!Slot || nMov > 2*SegCnt) {rAmt = -ENOMEM; return 0;}
+       sP = &Slots[Slot];
+
+       vP = (vAddr >= 0 ? hLock(vAddr%HNum) : 0);
+       if (vP) vP->Lock();
+       LMutex.Lock();
+       if (sP->Contents != vAddr || Slots->Status.LRU.Next != Slot) Slot = 0;
+          else if (sP->Uses || sP->Refd)
+                  {sP->Refd = 0; sP->Pull(Slots); sP->reRef(Slots);
+                   nMov++; Slot = 0;
+                  }
+          else {sP->Pull(Slots);
 
 // Remove ownership over this slot and remove it from the hash table
 //
-   sP = &Slots[Slot];
-   if (sP->Contents >= 0)
-      {if (sP->Own.Next != Slot) sP->Owner(Slots);
-       sP->Hide(Slots, Slash, sP->Contents%HNum);
-      }
+                if (vAddr >= 0)
+                   {if (sP->Own.Next != Slot)
+                       {OMutex.Lock(); sP->Owner(Slots); OMutex.UnLock();}
+                    sP->Hide(Slots, Slash, vAddr%HNum);
+                   }
+                sP->Count |= XrdOucCacheSlot::inTrans;
+                sP->Status.waitQ = 0;
+               }
+       LMutex.UnLock();
+       if (vP) vP->UnLock();
+      } while(!Slot);
 
 // Read the data into the buffer
 //
-   sP->Count |= XrdOucCacheSlot::inTrans;
-   sP->Status.waitQ = 0;
-   CMutex.UnLock();
    cBuff = Base+(static_cast<long long>(Slot)*SegSize);
    rAmt = ioP->Read(cBuff, (lAddr & Strip) << SegShft, SegSize);
-   CMutex.Lock();
+   hP->Lock();
 
-// Post anybody waiting for this slot. We hold the cache lock which will give us
+// Post anybody waiting for this slot. We hold the chain lock which will give us
 // time to complete the slot definition before the waiting thread looks at it.
 //
-   nUse = -1;
+   nUse = 1;
    while((Waiter = sP->Status.waitQ))
         {sP->Status.waitQ = sP->Status.waitQ->Next;
          sP->Status.waitQ->ioEnd->Post();
-         nUse--;
+         nUse++;
         }
 
 // If I/O succeeded, reinitialize the slot. Otherwise, return free it up
@@ -381,17 +411,19 @@ char *XrdOucCacheReal::Get(XrdOucCacheIO *ioP, long long lAddr,
        sP->HLink      = Slash[segHash];
        Slash[segHash] = Slot;
        Fnum = (lAddr >> Shift) + SegCnt;
-       Slots[Fnum].Owner(Slots, sP);
+       OMutex.Lock(); Slots[Fnum].Owner(Slots, sP); OMutex.UnLock();
        sP->Count = (rAmt == SegSize ? SegFull : rAmt|XrdOucCacheSlot::isShort);
-       sP->Status.inUse = nUse;
+       sP->Uses  = nUse;
+       LMutex.Lock(); sP->reRef(Slots); LMutex.UnLock();
        if (Dbg > 2) cerr <<"Cache: Miss slot " <<Slot <<" sz "
                          <<(sP->Count & XrdOucCacheSlot::lenMask) <<endl;
       } else {
        eMsg(ioP->Path(), "reading", (lAddr & Strip) << SegShft, SegSize, rAmt);
        cBuff = 0;
        sP->Contents = -1;
-       sP->unRef(Slots);
+       LMutex.Lock(); sP->unRef(Slots); LMutex.UnLock();
       }
+   hP->UnLock();
 
 // Return the associated buffer or zero, as per above
 //
@@ -449,6 +481,19 @@ int XrdOucCacheReal::ioDel(XrdOucCacheIO *KeyVal, int &iNum)
    return (cnt < 0 ? 1 : cnt+1);
 }
 
+/******************************************************************************/
+/*                               L o c k A l l                                */
+/******************************************************************************/
+
+// Obtain every cache lock except CMutex, which the caller may already hold.
+
+void XrdOucCacheReal::LockAll()
+{
+   for (int i = 0; i < hLocks; i++) hMutex[i].Lock();
+   LMutex.Lock();
+   OMutex.Lock();
+}
+
 /******************************************************************************/
 /*                               P r e R e a d                                */
 /******************************************************************************/
@@ -505,49 +550,79 @@ void XrdOucCacheReal::PreRead(XrdOucCacheReal::prTask *prReq)
 int XrdOucCacheReal::Ref(char *Addr, int rAmt, int sFlags)
 {
     XrdOucCacheSlot *sP = &Slots[(Addr-Base)>>SegShft];
-    int eof = 0;
+    XrdSysMutex *hP;
+    int eof = 0, reUse = 0;
+
+// Indicate how much data was not yet referenced. The slot was marked as
+// referenced when we got it. The LRU chain is only locked when the last
+// reference goes away and the slot is to be reused first (i.e. it was meant
+// for single use or all of its data has been referenced). A slot that is no
+// longer hashed is guarded by the LRU lock as in Upd().
+//
+   while(!(hP = slotLock(sP)))
+        {LMutex.Lock();
+         if (sP->Contents < 0) break;
+         LMutex.UnLock();
+        }
 
-// Indicate how much data was not yet referenced
-//
-   CMutex.Lock();
-   if (sP->Contents >= 0)
-      {if (sP->Count < 0) eof = 1;
-       sP->Status.inUse++;
-       if (sP->Status.inUse < 0)
-          {if (sFlags) sP->Count |= sFlags;
-              else if (!eof && (sP->Count -= rAmt) < 0) sP->Count = 0;
-          } else {
-           if (sFlags) {sP->Count |= sFlags;                 sP->reRef(Slots);}
-              else {     if (sP->Count & XrdOucCacheSlot::isSUSE)
-                                                             sP->unRef(Slots);
-                    else if (eof || (sP->Count -= rAmt) > 0) sP->reRef(Slots);
-                    else   {sP->Count = SegSize/2;           sP->unRef(Slots);}
-                   }
-          }
-      } else eof = 1;
+   if (!hP) {sP->Uses--; LMutex.UnLock(); eof = 1;}
+      else {if (sP->Count < 0) eof = 1;
+            sP->Uses--;
+                 if (sFlags) sP->Count |= sFlags;
+            else if (sP->Uses)
+                    {if (!eof && (sP->Count -= rAmt) < 0) sP->Count = 0;}
+            else if (sP->Count & XrdOucCacheSlot::isSUSE) reUse = 1;
+            else if (!eof && (sP->Count -= rAmt) <= 0)
+                    {sP->Count = SegSize/2; reUse = 1;}
+            if (reUse)
+               {sP->Refd = 0;
+                LMutex.Lock(); sP->Pull(Slots); sP->unRef(Slots); LMutex.UnLock();
+               }
+           }
 
 // All done
 //
    if (Dbg > 2) cerr <<"Cache: Ref " <<std::hex <<sP->Contents <<std::dec
                      << " slot " <<((Addr-Base)>>SegShft)
                      <<" sz " <<(sP->Count & XrdOucCacheSlot::lenMask)
-                     <<" uc " <<sP->Status.inUse <<endl;
-   CMutex.UnLock();
+                     <<" uc " <<sP->Uses <<endl;
+   if (hP) hP->UnLock();
    return !eof;
 }
 
+/******************************************************************************/
+/* Private:                     s l o t L o c k                               */
+/******************************************************************************/
+
+// Lock the hash chain a referenced slot is on and return the associated mutex.
+// Zero is returned, and nothing is locked, if the slot is no longer hashed.
+
+XrdSysMutex *XrdOucCacheReal::slotLock(XrdOucCacheSlot *sP)
+{
+   XrdSysMutex *hP;
+   long long theAddr;
+
+   while((theAddr = sP->Contents) >= 0)
+        {hP = hLock(theAddr%HNum);
+         hP->Lock();
+         if (sP->Contents == theAddr) return hP;
+         hP->UnLock();
+        }
+   return 0;
+}
+
 /******************************************************************************/
 /*                                 T r u n c                                  */
 /******************************************************************************/
 
 void XrdOucCacheReal::Trunc(XrdOucCacheIO *ioP, long long lAddr)
 {
-   XrdSysMutexHelper Monitor(CMutex);
    XrdOucCacheSlot  *sP, *oP;
    int sNum, Free = 0, Left = 0, Fnum = (lAddr >> Shift) + SegCnt;
 
 // We will be truncating CacheData pages. So, we need to recycle those slots.
 //
+   LockAll();
    oP = &Slots[Fnum]; sP = &Slots[oP->Own.Next];
    while(oP != sP)
         {sNum = sP->Own.Next;
@@ -560,6 +635,7 @@ void XrdOucCacheReal::Trunc(XrdOucCacheIO *ioP, long long lAddr)
                  }
          sP = &Slots[sNum];
         }
+   UnLockAll();
 
 // Issue debugging message
 //
@@ -568,6 +644,17 @@ void XrdOucCacheReal::Trunc(XrdOucCacheIO *ioP, long long lAddr)
                  <<ioP->Path() <<endl;
 }
   
+/******************************************************************************/
+/*                             U n L o c k A l l                              */
+/******************************************************************************/
+
+void XrdOucCacheReal::UnLockAll()
+{
+   OMutex.UnLock();
+   LMutex.UnLock();
+   for (int i = hLocks-1; i >= 0; i--) hMutex[i].UnLock();
+}
+
 /******************************************************************************/
 /*                                   U p d                                    */
 /******************************************************************************/
@@ -575,26 +662,36 @@ void XrdOucCacheReal::Trunc(XrdOucCacheIO *ioP, long long lAddr)
 void XrdOucCacheReal::Upd(char *Addr, int wLen, int wOff)
 {
     XrdOucCacheSlot *sP = &Slots[(Addr-Base)>>SegShft];
+    XrdSysMutex *hP;
+
+// A slot that is no longer hashed (e.g. it was truncated) is only guarded by
+// the LRU lock, which Get() also holds while reclaiming such a slot. Should it
+// have been hashed again before we got that lock, use its chain lock instead.
+//
+   while(!(hP = slotLock(sP)))
+        {LMutex.Lock();
+         if (sP->Contents < 0) break;
+         LMutex.UnLock();
+        }
 
 // Check if we extended a short page
 //
-   CMutex.Lock();
    if (sP->Count < 0)
       {int theLen = sP->Count & XrdOucCacheSlot::lenMask;
        if (wLen + wOff > theLen)
           sP->Count = (wLen+wOff) | XrdOucCacheSlot::isShort;
       }
 
-// Adjust the reference counter and if no references, place on the LRU chain
+// Adjust the reference counter, the slot is already on the LRU chain
 //
-   sP->Status.inUse++;
-   if (sP->Status.inUse >= 0) sP->reRef(Slots);
+   sP->Uses--;
 
 // All done
 //
    if (Dbg > 2) cerr <<"Cache: Upd " <<std::hex <<sP->Contents <<std::dec
                      << " slot " <<((Addr-Base)>>SegShft)
                      <<" sz " <<(sP->Count & XrdOucCacheSlot::lenMask)
-                     <<" uc " <<sP->Status.inUse <<endl;
-   CMutex.UnLock();
+                     <<" uc " <<sP->Uses <<endl;
+   if (hP) hP->UnLock();
+      else LMutex.UnLock();
 }
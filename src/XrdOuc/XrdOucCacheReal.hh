@@ -80,8 +80,14 @@ int       ioLookup(int &pip, int hip, void *kval)
                    return hip;
                   }
 
+inline
+XrdSysMutex *hLock(int hip) {return &hMutex[hip % hLocks];}
+
+void      LockAll();
 int       Ref(char *Addr, int rAmt, int sFlags=0);
+XrdSysMutex *slotLock(XrdOucCacheSlot *sP);
 void      Trunc(XrdOucCacheIO *ioP, long long lAddr);
+void      UnLockAll();
 void      Upd(char *Addr, int wAmt, int wOff);
 
 static const long long Shift = 48;
@@ -90,7 +96,21 @@ static const long long MaxFO = 0x000007ffffffffffLL;  // Min 4K page -> 8TB-1
 
 XrdOucCacheIO::aprParms aprDefault; // Default automatic preread
 
+// The slot hash chains are protected by hLocks mutexes, each one covering the
+// chains whose hash value modulo hLocks selects it. The LRU chain is protected
+// by LMutex and the file ownership chains by OMutex. CMutex protects the file
+// table. Locks are always obtained in the order CMutex, hMutex (in ascending
+// order), LMutex, OMutex. Slots in use stay on the LRU chain; the use count
+// and referenced flag of a hashed slot are protected by its chain lock (of an
+// unhashed one by LMutex) and a slot is only moved when looking for a slot to
+// reuse. Hence, a cache hit does not need the LRU lock.
+//
+static const int hLocks = 64;
+
 XrdSysMutex      CMutex;
+XrdSysMutex      hMutex[hLocks];
+XrdSysMutex      LMutex;
+XrdSysMutex      OMutex;
 XrdOucCacheSlot *Slots;       // 1-to-1 slot to memory map
 int             *Slash;       // Slot hash table
 char            *Base;        // Base of memory cache
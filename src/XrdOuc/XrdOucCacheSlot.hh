@@ -57,7 +57,7 @@ inline void       Hide(XrdOucCacheSlot *Base, int *hTab, int hI)
                                   {while((hI=Base[j].HLink) && hI != Slot) j=hI;
                                    if (hI) Base[j].HLink = Base[hI].HLink;
                                   }
-                       Count = 0; Contents = -1;
+                       Count = 0; Contents = -1; Refd = 0;
                       }
 
 static void       Init(XrdOucCacheSlot *Base, int Num)
@@ -130,7 +130,6 @@ union  SlotState
       {struct  ioQ     *waitQ;
        XrdOucCacheData *Data;
        struct  SlotList LRU;
-       int              inUse;
       };
 
 union {long long        Contents;
@@ -140,6 +139,8 @@ SlotState               Status;
 SlotList                Own;
 int                     HLink;
 int                     Count;
+int                     Uses;   // Number of current users
+char                    Refd;   // Referenced since last passed over for reuse
 
 static const int  lenMask = 0x01ffffff; // Mask to get true value in Count
 static const int  isShort = 0x80000000; // Short page, Count & lenMask == size
@@ -147,7 +148,8 @@ static const int  inTrans = 0x40000000; // Segment is in transit
 static const int  isSUSE  = 0x20000000; // Segment is single use
 static const int  isNew   = 0x10000000; // Segment is new (not yet referenced)
 
-                  XrdOucCacheSlot() : Contents(-1), HLink(0), Count(0) {}
+                  XrdOucCacheSlot() : Contents(-1), HLink(0), Count(0),
+                                      Uses(0), Refd(0) {}
 
                  ~XrdOucCacheSlot() {}
 };
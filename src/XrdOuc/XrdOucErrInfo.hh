@@ -65,6 +65,10 @@ static const int uIPv4  = 0x08000000;  //! ucap: Supports only IPv4 info
 static const int uIPv64 = 0x04000000;  //! ucap: Supports IPv6|IPv4 info and
                                        //!       uIPv4 says IPv4 is prefered
 static const int uPrip  = 0x02000000;  //! ucap: Client is on a private net
+static const int uOpnCB = 0x01000000;  //! ucap: Caller attaches a file whose
+                                       //!       open completes via callback
+static const int uOpnDF = 0x00800000;  //! ucap: Callee will complete the open
+                                       //!       via callback (set by callee)
 
 inline     void clear(const char *usr=0, int uc=0)
                      {code=0; ucap = uc; message[0]='\0';
@@ -33,15 +33,119 @@
 #include <errno.h>
 #include <dirent.h>
 #include <unistd.h>
+#include <deque>
 
 #include "XrdOuc/XrdOucNSWalk.hh"
 #include "XrdOuc/XrdOucTList.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysHeaders.hh"
 #include "XrdSys/XrdSysPlatform.hh"
+#include "XrdSys/XrdSysPthread.hh"
 
 using namespace std;
 
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+// A Result describes a directory indexed by a worker thread that must be
+// returned by Index() or reported to the empty directory callback.
+
+struct XrdOucNSWalk::Result
+{
+Result       *next;
+NSEnt        *ents;
+char         *path;
+struct stat   dStat;
+int           rc;
+int           isEmpty;
+
+              Result() : next(0), ents(0), path(0), rc(0), isEmpty(0) {}
+             ~Result() {NSEnt *eP;
+                        while((eP = ents)) {ents = eP->Next; delete eP;}
+                        if (path) free(path);
+                       }
+};
+
+// The Pool holds the worker threads. Each worker has its own queue of
+// directories to index. It takes directories from the back of its queue so
+// that it walks its part of the tree depth first and, when the queue is empty,
+// steals from the front of another worker's queue where the directories
+// closest to the top of the tree are. Everything is protected by poolCV.
+
+struct XrdOucNSWalk::Pool
+{
+struct Slot {Pool               *pool;
+             XrdOucNSWalk       *walker;
+             std::deque<char *>  dirs;
+             pthread_t           tid;
+             int                 num;
+             bool                active;
+            };
+
+XrdSysCondVar  poolCV;
+Slot          *slot;
+Result        *rFirst;
+Result        *rLast;
+int            rNum;      // Number of results waiting for Index()
+int            rMax;      // Maximum number before workers wait
+int            nSlots;
+int            pending;   // Directories queued or being indexed
+bool           stop;
+
+char          *Get(int me);
+
+               Pool(int n) : poolCV(0, "NSWalk"), rFirst(0), rLast(0),
+                             rNum(0), rMax(n*8), nSlots(n), pending(0),
+                             stop(false)
+                           {slot = new Slot[n];
+                            for (int i = 0; i < n; i++)
+                                {slot[i].pool = this; slot[i].walker = 0;
+                                 slot[i].num  = i;    slot[i].active = false;
+                                }
+                           }
+              ~Pool() {Result *rP;
+                       for (int i = 0; i < nSlots; i++)
+                           {while(!slot[i].dirs.empty())
+                                 {free(slot[i].dirs.back());
+                                  slot[i].dirs.pop_back();
+                                 }
+                            if (slot[i].walker) delete slot[i].walker;
+                           }
+                       while((rP = rFirst)) {rFirst = rP->next; delete rP;}
+                       delete [] slot;
+                      }
+};
+
+/******************************************************************************/
+/*                              P o o l : : G e t                             */
+/******************************************************************************/
+
+// Must be called with poolCV locked
+
+char *XrdOucNSWalk::Pool::Get(int me)
+{
+   char *dir;
+
+// Use our own directories first
+//
+   if (!slot[me].dirs.empty())
+      {dir = slot[me].dirs.back(); slot[me].dirs.pop_back();
+       return dir;
+      }
+
+// Steal a directory from another worker
+//
+   for (int i = 1; i < nSlots; i++)
+       {Slot &vS = slot[(me+i) % nSlots];
+        if (!vS.dirs.empty())
+           {dir = vS.dirs.front(); vS.dirs.pop_front();
+            return dir;
+           }
+       }
+   return 0;
+}
+
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
 /******************************************************************************/
@@ -62,14 +166,47 @@ XrdOucNSWalk::XrdOucNSWalk(XrdSysError *erp, const char *dpath,
    errOK= opts & skpErrs;
    DEnts= 0;
    edCB = 0;
+   nThreads = 0;
+   wPool    = 0;
 
 // Copy the exclude list if one exists
 //
-   if (!xlist) XList = 0;
-      else while(xlist)
-                {XList = new XrdOucTList(xlist->text,xlist->ival,XList);
-                 xlist = xlist->next;
-                }
+   XList = 0;
+   while(xlist)
+        {XList = new XrdOucTList(xlist->text,xlist->ival,XList);
+         xlist = xlist->next;
+        }
+}
+
+/******************************************************************************/
+
+// This constructor creates the walker used by a worker thread
+
+XrdOucNSWalk::XrdOucNSWalk(XrdOucNSWalk *parent)
+{
+   XrdOucTList *xlist = parent->XList;
+
+// Copy the parent's settings. The directory list starts out empty.
+//
+   eDest = parent->eDest;
+   mPfx  = parent->mPfx;
+   DList = 0;
+   LKFn  = (parent->LKFn ? strdup(parent->LKFn) : 0);
+   Opts  = parent->Opts;
+   DPfd  = LKfd = -1;
+   errOK = parent->errOK;
+   DEnts = 0;
+   edCB  = parent->edCB;
+   nThreads = 0;
+   wPool    = 0;
+
+// Each walker needs its own copy of the exclude list
+//
+   XList = 0;
+   while(xlist)
+        {XList = new XrdOucTList(xlist->text,xlist->ival,XList);
+         xlist = xlist->next;
+        }
 }
 
 /******************************************************************************/
@@ -80,6 +217,19 @@ XrdOucNSWalk::~XrdOucNSWalk()
 {
    XrdOucTList *tP;
 
+// Stop any worker threads and wait for them to finish
+//
+   if (wPool)
+      {wPool->poolCV.Lock();
+       wPool->stop = true;
+       wPool->poolCV.Broadcast();
+       wPool->poolCV.UnLock();
+       for (int i = 0; i < wPool->nSlots; i++)
+           if (wPool->slot[i].active)
+              XrdSysThread::Join(wPool->slot[i].tid, 0);
+       delete wPool;
+      }
+
    if (LKFn) free(LKFn);
 
    while((tP = DList)) {DList = tP->next; delete tP;}
@@ -96,6 +246,10 @@ XrdOucNSWalk::NSEnt *XrdOucNSWalk::Index(int &rc, const char **dPath)
    XrdOucTList *tP;
    NSEnt *eP;
 
+// Use the worker threads if so requested
+//
+   if (wPool || (nThreads > 1 && (Opts & Recurse))) return Next(rc, dPath);
+
 // Sequence the directory
 //
    rc = 0; *DPath = '\0';
@@ -180,8 +334,12 @@ int XrdOucNSWalk::Build()
    DPfd = -1;
 #endif
 
-// Open the directory
+// Open the directory, reusing the descriptor we have if possible
 //
+#ifdef HAVE_FSTATAT
+   if (DPfd >= 0 && (theEnt.D = fdopendir(DPfd))) theEnt.F = -1;
+      else
+#endif
    if (!(theEnt.D = opendir(DPath)))
       return Emsg("Build", errno, "open directory", DPath);
 
@@ -191,6 +349,21 @@ int XrdOucNSWalk::Build()
    while((dp = readdir(theEnt.D)))
         {if (!strcmp(dp->d_name, ".") || !strcmp(dp->d_name, "..")) continue;
          strcpy(File, dp->d_name); nEnt++;
+
+      // When the directory tells us the entry type we need not stat entries
+      // that we will not return. Directories are then only descended into.
+      //
+#ifdef _DIRENT_HAVE_D_TYPE
+         if (dp->d_type == DT_DIR && !(Opts & retDir))
+            {if (Opts & Recurse && (!XList || !inXList(File)))
+                DList = new XrdOucTList(DPath, 0, DList);
+             continue;
+            }
+         if (dp->d_type == DT_REG && !(Opts & retFile))
+            {if (chkED && !xLKF) xLKF = !strcmp(File, LKFn);
+             continue;
+            }
+#endif
          if (!theEnt.P) theEnt.P = new NSEnt();
          rc = getStat(theEnt.P, getLI);
          switch(theEnt.P->Type)
@@ -394,6 +567,79 @@ int XrdOucNSWalk::LockFile()
    return rc;
 }
 
+/******************************************************************************/
+/*                                  N e x t                                   */
+/******************************************************************************/
+
+// This is the threaded version of Index()
+
+XrdOucNSWalk::NSEnt *XrdOucNSWalk::Next(int &rc, const char **dPath)
+{
+   XrdOucTList *tP;
+   Result *rP;
+   NSEnt *eP = 0;
+   int n = 0;
+
+// Start the worker threads the first time through. The first worker gets the
+// directories we have been given. Should no thread start we do it ourselves.
+//
+   rc = 0; *DPath = '\0';
+   if (!wPool)
+      {wPool = new Pool(nThreads);
+       while((tP = DList))
+            {DList = tP->next;
+             wPool->slot[0].dirs.push_back(tP->text);
+             tP->text = 0; delete tP;
+             wPool->pending++;
+            }
+       for (int i = 0; i < nThreads; i++)
+           {Pool::Slot &sP = wPool->slot[i];
+            sP.walker = new XrdOucNSWalk(this);
+            if ((rc = XrdSysThread::Run(&sP.tid, XrdOucNSWalk::Worker,
+                                        (void *)&sP, XRDSYSTHREAD_HOLD,
+                                        "NSWalk worker")))
+               Emsg("Index", rc, "start walker thread");
+               else {sP.active = true; n++;}
+           }
+       if (!n)
+          {for (int i = 0; i < nThreads; i++)
+               while(!wPool->slot[i].dirs.empty())
+                    {DList = new XrdOucTList(0, 0, DList);
+                     DList->text = wPool->slot[i].dirs.back();
+                     wPool->slot[i].dirs.pop_back();
+                    }
+           delete wPool; wPool = 0; nThreads = 0;
+           return Index(rc, dPath);
+          }
+       rc = 0;
+      }
+
+// Get the next directory the workers have indexed. Directories that are empty
+// are reported to the callback here so that it is always called on our thread.
+//
+   do {wPool->poolCV.Lock();
+       while(!(rP = wPool->rFirst) && wPool->pending) wPool->poolCV.Wait();
+       if (rP)
+          {if (!(wPool->rFirst = rP->next)) wPool->rLast = 0;
+           if (wPool->rNum-- >= wPool->rMax) wPool->poolCV.Broadcast();
+          }
+       wPool->poolCV.UnLock();
+       if (!rP) break;
+
+       strlcpy(DPath, rP->path, sizeof(DPath));
+       File = DPath + strlen(DPath);
+       eP = rP->ents; rP->ents = 0;
+       if (eP || (rc = rP->rc)) {delete rP; break;}
+       if (edCB && rP->isEmpty) edCB->isEmpty(&rP->dStat, DPath, LKFn);
+       delete rP;
+      } while(1);
+
+// Return the result
+//
+   if (dPath) *dPath = DPath;
+   return eP;
+}
+
 /******************************************************************************/
 /*                               s e t P a t h                                */
 /******************************************************************************/
@@ -408,3 +654,83 @@ void XrdOucNSWalk::setPath(char *newpath)
       {DPath[n++] = '/'; DPath[n] = '\0';}
    File = DPath+n;
 }
+
+/******************************************************************************/
+/*                                  S t e p                                   */
+/******************************************************************************/
+
+// Index the directory in DPath as Index() does for a single directory. The
+// return code is negative when the lock file could not be obtained.
+
+int XrdOucNSWalk::Step()
+{
+   int rc;
+
+   isEmpty = 0;
+   if (LKFn && (rc = LockFile())) return -rc;
+   rc = Build();
+   if (LKfd >= 0) {close(LKfd); LKfd = -1;}
+   return rc;
+}
+
+/******************************************************************************/
+/*                                W o r k e r                                 */
+/******************************************************************************/
+
+void *XrdOucNSWalk::Worker(void *carg)
+{
+   Pool::Slot   *sP = (Pool::Slot *)carg;
+   Pool         *pP = sP->pool;
+   XrdOucNSWalk *wP = sP->walker;
+   XrdOucTList  *tP;
+   Result       *rP;
+   char         *dir;
+   int           rc;
+
+// Index directories until there are none left anywhere or we are stopped
+//
+   pP->poolCV.Lock();
+   do {while(!pP->stop && !(dir = pP->Get(sP->num)) && pP->pending)
+             pP->poolCV.Wait();
+       if (pP->stop || !dir) break;
+       pP->poolCV.UnLock();
+
+   // Index the directory
+   //
+       wP->setPath(dir); free(dir);
+       rc = wP->Step();
+       if (wP->DEnts || (rc && (rc < 0 || !wP->errOK))
+       ||  (wP->edCB && wP->isEmpty))
+          {rP = new Result;
+           rP->ents = wP->DEnts; wP->DEnts = 0;
+           rP->path = strdup(wP->DPath);
+           rP->rc   = (rc < 0 ? -rc : rc);
+           if ((rP->isEmpty = wP->isEmpty)) rP->dStat = wP->dStat;
+          } else rP = 0;
+
+   // Queue any subdirectories we found and hand off the result
+   //
+       pP->poolCV.Lock();
+       while((tP = wP->DList))
+            {wP->DList = tP->next;
+             sP->dirs.push_back(tP->text);
+             tP->text = 0; delete tP;
+             pP->pending++;
+            }
+       if (rP)
+          {while(pP->rNum >= pP->rMax && !pP->stop) pP->poolCV.Wait();
+           if (pP->stop) delete rP;
+              else {if (pP->rLast) pP->rLast->next = rP;
+                       else        pP->rFirst      = rP;
+                    pP->rLast = rP; pP->rNum++;
+                   }
+          }
+       pP->pending--;
+       pP->poolCV.Broadcast();
+      } while(!pP->stop);
+
+// All done
+//
+   pP->poolCV.UnLock();
+   return (void *)0;
+}
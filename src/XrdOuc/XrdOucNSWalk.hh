@@ -101,6 +101,14 @@ void         setCallBack(CallBack *cbP=0) {edCB = cbP;}
 //
 void         setMsgOn(const char *pfx) {mPfx = pfx;}
 
+// When the walk is recursive, setThreads() may be called before the first call
+// to Index() to have numThreads threads index directories ahead of the caller.
+// Directories are then returned in no particular order though the entries of
+// a directory are still returned together and ordered as requested. Callbacks
+// are always made on the thread calling Index().
+//
+void         setThreads(int numThreads) {nThreads = numThreads;}
+
 // The following are processing options passed to the constructor
 //
 static const int retDir =  0x0001; // Return directories (implies retStat)
@@ -130,6 +138,11 @@ static const int skpErrs=  0x8000; // Skip any entry causing an error
 //       as a directory entry if an empty directory call back has been set.
 
 private:
+struct        Pool;
+struct        Result;
+
+              XrdOucNSWalk(XrdOucNSWalk *parent);
+
 void          addEnt(XrdOucNSWalk::NSEnt *eP);
 int           Build();
 int           Emsg(const char *pfx, int rc, const char *tx1, const char *tx2=0);
@@ -139,7 +152,10 @@ int           getStat();
 int           inXList(const char *dName);
 int           isSymlink();
 int           LockFile();
+NSEnt        *Next(int &rc, const char **dPath);
 void          setPath(char *newpath);
+int           Step();
+static void  *Worker(void *carg);
 
 XrdSysError  *eDest;
 XrdOucTList  *DList;
@@ -156,5 +172,7 @@ int           DPfd;
 int           Opts;
 int           errOK;
 int           isEmpty;
+int           nThreads;
+Pool         *wPool;
 };
 #endif
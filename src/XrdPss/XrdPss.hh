@@ -171,6 +171,7 @@ static const char  *hdrData;
 static const char  *urlRdr;
 static int          Streams;
 static int          Workers;
+static int          Openers;
 static int          Trace;
 
 static bool         outProxy; // True means outgoing proxy
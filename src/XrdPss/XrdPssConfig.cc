@@ -100,6 +100,7 @@ const char  *XrdPssSys::hdrData   =  0;
 const char  *XrdPssSys::urlRdr    =  0;
 int          XrdPssSys::Streams   =512;
 int          XrdPssSys::Workers   = 16;
+int          XrdPssSys::Openers   = 16;
 
 char         XrdPssSys::allChmod  =  0;
 char         XrdPssSys::allMkdir  =  0;
@@ -216,6 +217,12 @@ int XrdPssSys::Configure(const char *cfn)
 //
    XrdOucEnv::Export("XRDXROOTD_NOPOSC", "1");
 
+// Opening a file means opening it at the origin, which may take a while. Ask
+// the ofs to do that in the background so the client need not retry the open.
+//
+   sprintf(theRdr, "%d", Openers);
+   XrdOucEnv::Export("XRDOFS_BGOPEN", theRdr);
+
 // Initialize an alternate cache if one is present
 //
    if (cPath && !getCache()) return 1;
@@ -711,6 +718,7 @@ char *XrdPssSys::xcapr(XrdSysError *Eroute, XrdOucStream &Config, char *pBuff)
    Purpose:  To parse the directive: config <keyword> <value>
 
              <keyword> is one of the following:
+             openers   number of threads opening files in the background > 0
              workers   number of queue workers > 0
 
    Output: 0 upon success or 1 upon failure.
@@ -721,7 +729,8 @@ int XrdPssSys::xconf(XrdSysError *Eroute, XrdOucStream &Config)
    char  *val, *kvp;
    int    kval;
    struct Xtab {const char *Key; int *Val;} Xopts[] =
-               {{"streams", &Streams},
+               {{"openers", &Openers},
+                {"streams", &Streams},
                 {"workers", &Workers}};
    int i, numopts = sizeof(Xopts)/sizeof(struct Xtab);
 
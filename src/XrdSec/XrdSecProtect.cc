@@ -109,6 +109,7 @@ kXR_close,     kXR_signIgnore, kXR_signIgnore, kXR_signNeeded, kXR_signNeeded,
 kXR_decrypt,   kXR_signIgnore, kXR_signIgnore, kXR_signIgnore, kXR_signIgnore, 
 kXR_dirlist,   kXR_signIgnore, kXR_signIgnore, kXR_signIgnore, kXR_signNeeded,
 kXR_endsess,   kXR_signIgnore, kXR_signIgnore, kXR_signNeeded, kXR_signNeeded,
+kXR_fetch,     kXR_signLikely, kXR_signNeeded, kXR_signNeeded, kXR_signNeeded,
 kXR_getfile,   kXR_signNeeded, kXR_signNeeded, kXR_signNeeded, kXR_signNeeded, 
 kXR_locate,    kXR_signIgnore, kXR_signIgnore, kXR_signIgnore, kXR_signNeeded,
 kXR_login,     kXR_signIgnore, kXR_signIgnore, kXR_signIgnore, kXR_signIgnore, 
@@ -190,6 +191,10 @@ bool XrdSecProtect::Screen(ClientRequest &thereq)
        return (opts & rwOpen) != 0;
       }
 
+// Fetch opens files like open() does but only ever for reading.
+//
+   if (reqCode == kXR_fetch) return false;
+
 // Security is conditional based on query() trying to modify something.
 //
    if (reqCode == kXR_query)
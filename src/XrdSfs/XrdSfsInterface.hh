@@ -677,6 +677,14 @@ public:
 //! @param  opaque - path's CGI information (see common description).
 //!
 //! @return One of SFS_OK, SFS_ERROR, SFS_REDIRECT, SFS_STALL, or SFS_STARTED
+//!
+//! @note   Normally, when SFS_STARTED is returned the callback merely tells the
+//!         client to retry the open. However, if error.getUCap() includes
+//!         XrdOucEI::uOpnCB the caller is prepared to attach this object once
+//!         the callback reports SFS_OK. To use this, add XrdOucEI::uOpnDF to
+//!         the ucap (i.e. error.setUCap()) before returning SFS_STARTED and
+//!         only invoke the callback once the file is actually open. The object
+//!         must not be deleted by the file system in the interim.
 //-----------------------------------------------------------------------------
 
 virtual int            open(const char                *fileName,
@@ -31,6 +31,7 @@
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
   
 #include "XrdSys/XrdSysFD.hh"
 #include "XrdSys/XrdSysIOEvents.hh"
@@ -267,6 +268,7 @@ XrdSys::IOEvents::Channel::Channel(Poller   *pollP, int   fd,
    attList.next = attList.prev = this;
    tmoList.next = tmoList.prev = this;
    inTOQ    = 0;
+   tmoSlot  = 0;
    pollEnt  = 0;
    chStat   = isClear;
    Reset(&pollInit, fd);
@@ -546,7 +548,10 @@ XrdSys::IOEvents::Poller::Poller(int rFD, int cFD)
 // Now initialize local class members
 //
    attBase         = 0;
-   tmoBase         = 0;
+   memset(tmoWheel, 0, sizeof(tmoWheel));
+   tmoNow          = time(0);
+   tmoWake         = maxTime;
+   tmoCount        = 0;
    cmdFD           = cFD;
    reqFD           = rFD;
    wakePend        = false;
@@ -585,17 +590,43 @@ void XrdSys::IOEvents::Poller::Attach(XrdSys::IOEvents::Channel *cP)
 
 void XrdSys::IOEvents::Poller::CbkTMO()
 {
-   Channel *cP;
+   Channel *cP, *rBase;
+   time_t tNow = time(0);
+   int i;
 
-// Process each element in the timeout queue, calling the callback function
-// if the timeout has passed. As this method can be called with a lock on the
-// channel mutex, we need to drop it prior to calling the callback.
+// Turn the timer wheel up to the current time, calling the callback function
+// for each channel in a passed slot. As this method can be called with a lock
+// on the channel mutex, we need to drop it prior to calling the callback. The
+// callback removes the channel from the wheel.
 //
    toMutex.Lock();
-   while((cP = tmoBase) && cP->deadLine <= time(0))
-        {toMutex.UnLock();
-         CbkXeq(cP, cP->dlType, 0, 0);
-         toMutex.Lock();
+   while(tmoNow <= tNow)
+        {if (!tmoCount) {tmoNow = tNow+1; break;}
+
+      // At the start of each block, move the channels in the block's second
+      // level slot into the first level (or back into the second level when
+      // they are more than a full turn of the wheel away).
+      //
+         if (!(tmoNow & tmoMsk))
+            {i = tmoSlots + ((tmoNow >> tmoBits) & tmoMsk);
+             rBase = tmoWheel[i]; tmoWheel[i] = 0;
+             while((cP = rBase))
+                  {REMOVE(rBase, tmoList, cP);
+                   tmoCount--;
+                   TmoIns(cP);
+                  }
+            }
+
+      // Call back each channel in this second's slot. All of these have
+      // reached their deadline.
+      //
+         i = tmoNow & tmoMsk;
+         while((cP = tmoWheel[i]))
+              {toMutex.UnLock();
+               CbkXeq(cP, cP->dlType, 0, 0);
+               toMutex.Lock();
+              }
+         tmoNow++;
         }
    toMutex.UnLock();
 }
@@ -799,7 +830,7 @@ void XrdSys::IOEvents::Poller::Detach(XrdSys::IOEvents::Channel *cP,
 //
    if (cP->inTOQ)
       {toMutex.Lock();
-       REMOVE(tmoBase, tmoList, cP);
+       TmoRem(cP);
        toMutex.UnLock();
       }
 
@@ -1057,17 +1088,9 @@ void XrdSys::IOEvents::Poller::Stop()
 bool XrdSys::IOEvents::Poller::TmoAdd(XrdSys::IOEvents::Channel *cP, int tmoSet)
 {
    XrdSysMutexHelper mHelper(toMutex);
-   time_t tNow;
-   Channel *ncP;
+   time_t tNow, oldDL = cP->deadLine;
    bool setRTO, setWTO;
 
-// Remove element from timeout queue if it is there
-//
-   if (cP->inTOQ)
-      {REMOVE(tmoBase, tmoList, cP);
-       cP->inTOQ = 0;
-      }
-
 // Determine which timeouts need to be reset
 //
    tmoSet|= cP->dlType >> 4;
@@ -1093,24 +1116,26 @@ bool XrdSys::IOEvents::Poller::TmoAdd(XrdSys::IOEvents::Channel *cP, int tmoSet)
    IF_TRACE(TmoAdd, cP->chFD, "t=" <<tNow <<" rdDL=" <<setRTO <<' ' <<cP->rdDL
                                           <<" wrDL=" <<setWTO <<' ' <<cP->wrDL);
 
+// If the channel is already in the timer wheel with the same deadline, which
+// is typical when the timeout is re-enabled for every message, leave it where
+// it is. Otherwise, take it out.
+//
+   if (cP->inTOQ)
+      {if (cP->deadLine == oldDL) return false;
+       TmoRem(cP);
+      }
+
 // If no timeout really applies, we are done
 //
    if (cP->deadLine == maxTime) return false;
 
-// Add the channel to the timeout queue in correct deadline position.
+// Add the channel to the timer wheel
 //
-   if ((ncP = tmoBase))
-      {do {if (cP->deadLine < ncP->deadLine) break;
-           ncP = ncP->tmoList.next;
-          } while(ncP != tmoBase);
-       INSERT(tmoList, ncP, cP);
-       if (cP->deadLine < tmoBase->deadLine) tmoBase = cP;
-      } else tmoBase = cP;
-   cP->inTOQ = 1;
+   TmoIns(cP);
 
 // Indicate to the caller whether or not a wakeup is required
 //
-   return (tmoBase == cP);
+   return (cP->deadLine < tmoWake);
 }
   
 /******************************************************************************/
@@ -1123,11 +1148,87 @@ void XrdSys::IOEvents::Poller::TmoDel(XrdSys::IOEvents::Channel *cP)
 // Get the timeout queue lock and remove the channel from the queue
 //
    toMutex.Lock();
-   REMOVE(tmoBase, tmoList, cP);
-   cP->inTOQ = 0;
+   if (cP->inTOQ) TmoRem(cP);
    toMutex.UnLock();
 }
 
+/******************************************************************************/
+/*                                T m o I n s                                 */
+/******************************************************************************/
+
+// The caller must hold the timeout queue lock!
+//
+void XrdSys::IOEvents::Poller::TmoIns(XrdSys::IOEvents::Channel *cP)
+{
+   Channel *ncP;
+   time_t dl = (cP->deadLine < tmoNow ? tmoNow : cP->deadLine);
+   int i;
+
+// Select the slot. A deadline that already passed goes into the slot that is
+// processed next.
+//
+   if (dl - tmoNow < tmoSlots) i = dl & tmoMsk;
+      else i = tmoSlots + ((dl >> tmoBits) & tmoMsk);
+
+// Add the channel to the slot's ring
+//
+   if ((ncP = tmoWheel[i])) {INSERT(tmoList, ncP, cP);}
+      else tmoWheel[i] = cP;
+   cP->tmoSlot = static_cast<short>(i);
+   cP->inTOQ   = 1;
+   tmoCount++;
+}
+
+/******************************************************************************/
+/*                               T m o N e x t                                */
+/******************************************************************************/
+
+// The caller must hold the timeout queue lock! Returns the time at which the
+// wheel must next be turned, either to call back channels or to move channels
+// from the second level into the first one. The scan is bounded by the size
+// of the wheel, not by the number of channels in it.
+//
+time_t XrdSys::IOEvents::Poller::TmoNext()
+{
+   time_t tmo;
+   int i;
+
+// If the wheel is empty there is no need to wake up
+//
+   if (!tmoCount) return maxTime;
+
+// Find the first second that has an occupied first level slot or that starts
+// a block with an occupied second level slot. First level slots only hold
+// channels less than a full turn of the wheel away.
+//
+   for (i = 0, tmo = tmoNow; i < tmoSlots; i++, tmo++)
+       {if (!(tmo & tmoMsk) && tmoWheel[tmoSlots + ((tmo >> tmoBits) & tmoMsk)])
+           return tmo;
+        if (tmoWheel[tmo & tmoMsk]) return tmo;
+       }
+
+// The remaining channels are in the second level; find the next block start
+// with an occupied slot.
+//
+   tmo = ((tmo >> tmoBits) + (tmo & tmoMsk ? 1 : 0)) << tmoBits;
+   for (i = 0; i < tmoSlots; i++, tmo += tmoSlots)
+       if (tmoWheel[tmoSlots + ((tmo >> tmoBits) & tmoMsk)]) return tmo;
+   return tmo;
+}
+
+/******************************************************************************/
+/*                                T m o R e m                                 */
+/******************************************************************************/
+
+// The caller must hold the timeout queue lock!
+//
+void XrdSys::IOEvents::Poller::TmoRem(XrdSys::IOEvents::Channel *cP)
+{
+   REMOVE(tmoWheel[cP->tmoSlot], tmoList, cP);
+   cP->inTOQ = 0;
+   tmoCount--;
+}
+
 /******************************************************************************/
 /*                                T m o G e t                                 */
 /******************************************************************************/
@@ -1143,8 +1244,8 @@ int XrdSys::IOEvents::Poller::TmoGet()
 // Calculate wait time. If the deadline passed, invoke the timeout callback.
 // we will need to drop the timeout lock as we don't have the channel lock.
 //
-   do {if (!tmoBase) {wtval = -1; break;}
-       wtval = (tmoBase->deadLine - time(0)) * 1000;
+   do {if ((tmoWake = TmoNext()) == maxTime) {wtval = -1; break;}
+       wtval = (tmoWake - time(0)) * 1000;
        if (wtval > 0) break;
        toMutex.UnLock();
        CbkTMO();
@@ -349,6 +349,7 @@ char           chEvents;    // Enabled events as Channel type
 char           chStat;      // Channel status below (!0 -> in callback mode)
 enum Status   {isClear = 0, isCBMode, isDead};
 char           inTOQ;       // True if the channel is in the timeout queue
+short          tmoSlot;     // The timer wheel slot when in the timeout queue
 char           inPSet;      // FD is in the actual poll set
 char           reMod;       // Modify issued while defered, re-issue needed
 short          chFault;     // Defered error, 0 if all is well
@@ -445,6 +446,9 @@ inline  void  LockChannel(Channel *cP) {cP->chMutex.Lock();}
         bool  TmoAdd(Channel *cP, int tmoSet);
         void  TmoDel(Channel *cP);
         int   TmoGet();
+        void  TmoIns(Channel *cP);
+        time_t TmoNext();
+        void  TmoRem(Channel *cP);
 inline  void  UnLockChannel(Channel *cP) {cP->chMutex.UnLock();}
 
 //! Start the polling event loop. An implementation must be supplied. Begin()
@@ -486,7 +490,20 @@ virtual void Shutdown() = 0;
 // The following is common to all implementations
 //
 Channel        *attBase;    // -> First channel in attach  queue or 0
-Channel        *tmoBase;    // -> First channel in timeout queue or 0
+
+// Channels with a deadline are kept in a two level timer wheel. The first level
+// has a slot for each of the next tmoSlots seconds, the second level a slot for
+// each of the following blocks of tmoSlots seconds. Channels further out are
+// hashed into the second level and simply re-inserted when their slot comes up.
+//
+static const int tmoBits  = 8;
+static const int tmoSlots = 1 << tmoBits;
+static const int tmoMsk   = tmoSlots - 1;
+
+Channel        *tmoWheel[2*tmoSlots]; // Timer wheel slots, each a channel ring
+time_t          tmoNow;     // The next second to be processed by the wheel
+time_t          tmoWake;    // The deadline the poller is waiting for
+int             tmoCount;   // Number of channels in the timer wheel
 
 pthread_t       pollTid;    // Poller's thread ID
 
@@ -38,6 +38,7 @@
 #include "XrdSfs/XrdSfsInterface.hh"
 #include "XrdXrootd/XrdXrootdAio.hh"
 #include "XrdXrootd/XrdXrootdFile.hh"
+#include "XrdXrootd/XrdXrootdLatency.hh"
 #include "XrdXrootd/XrdXrootdProtocol.hh"
 #include "XrdXrootd/XrdXrootdStats.hh"
 #include "XrdXrootd/XrdXrootdTrace.hh"
@@ -116,6 +117,10 @@ XrdXrootdAio *XrdXrootdAio::Alloc(XrdXrootdAioReq *arp, int bsize)
   
 void XrdXrootdAio::doneRead()
 {
+// Record how long the file system took to complete this read
+//
+   XrdXrootdLatency::Done(XrdXrootdLatency::fsRead, tBeg);
+
 // Plase this aio request on the completed queue
 //
    aioReq->aioDone = this;
@@ -143,6 +148,10 @@ void XrdXrootdAio::doneWrite()
 {
    char recycle = 0;
 
+// Record how long the file system took to complete this write
+//
+   XrdXrootdLatency::Done(XrdXrootdLatency::fsWrite, tBeg);
+
 // Lock the aioreq object against competition
 //
    aioReq->Lock();
@@ -397,6 +406,7 @@ int XrdXrootdAioReq::Read()
    myIOLen  -= aiop->sfsAio.aio_nbytes;
    myOffset += aiop->sfsAio.aio_nbytes;
    numActive++;
+   aiop->tBeg = XrdXrootdLatency::Now();
    if ((rc = myFile->XrdSfsp->read((XrdSfsAio *)aiop))) 
       {numActive--; Recycle();} // Only 1!
 
@@ -472,6 +482,7 @@ int XrdXrootdAioReq::Write(XrdXrootdAio *aiop)
 // Fire up the I/O. Be optimistic that this will succeed.
 //
    Lock(); numActive++; UnLock();
+   aiop->tBeg = XrdXrootdLatency::Now();
    if ((rc = myFile->XrdSfsp->write((XrdSfsAio *)aiop))) 
       {Lock(); numActive--; UnLock(); Recycle(-1);}
 
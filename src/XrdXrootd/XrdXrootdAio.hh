@@ -63,7 +63,7 @@ virtual void          doneWrite();
 virtual void          Recycle();
 
 
-              XrdXrootdAio() {Next=0; aioReq=0; buffp=0;}
+              XrdXrootdAio() {Next=0; aioReq=0; buffp=0; tBeg=0;}
              ~XrdXrootdAio() {};
 
 private:
@@ -81,6 +81,7 @@ static  int              maxAio;  // Maximum Aio objects we can yet have
 
         XrdXrootdAio    *Next;    // Chain pointer
         XrdXrootdAioReq *aioReq;  // -> Associated request object
+        long long        tBeg;    // Time the I/O was started
 };
 
 /******************************************************************************/
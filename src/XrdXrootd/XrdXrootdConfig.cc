@@ -64,11 +64,13 @@
 #include "XrdXrootd/XrdXrootdAdmin.hh"
 #include "XrdXrootd/XrdXrootdAio.hh"
 #include "XrdXrootd/XrdXrootdCallBack.hh"
+#include "XrdXrootd/XrdXrootdFdPass.hh"
 #include "XrdXrootd/XrdXrootdFile.hh"
 #include "XrdXrootd/XrdXrootdFileLock.hh"
 #include "XrdXrootd/XrdXrootdFileLock1.hh"
 #include "XrdXrootd/XrdXrootdJob.hh"
 #include "XrdXrootd/XrdXrootdMonitor.hh"
+#include "XrdXrootd/XrdXrootdOpenCB.hh"
 #include "XrdXrootd/XrdXrootdPrepare.hh"
 #include "XrdXrootd/XrdXrootdProtocol.hh"
 #include "XrdXrootd/XrdXrootdStats.hh"
@@ -172,6 +174,7 @@ int XrdXrootdProtocol::Configure(char *parms, XrdProtocol_Config *pi)
 // Set the callback object static areas now!
 //
    XrdXrootdCallBack::setVals(&eDest, SI, Sched, Port);
+   XrdXrootdOpenCB::setVals(Sched);
 
 // Prohibit this program from executing as superuser
 //
@@ -427,6 +430,13 @@ int XrdXrootdProtocol::Configure(char *parms, XrdProtocol_Config *pi)
    if (!(AdminSock = XrdNetSocket::Create(&eDest, adminp, "admin", pi->AdmMode))
    ||  !XrdXrootdAdmin::Init(&eDest, AdminSock)) return 0;
 
+// Start passing file descriptors to local clients if so wanted
+//
+   if (locfdPath)
+      {if (!XrdXrootdFdPass::Init(&eDest, locfdPath)) return 0;
+       eDest.Say("Config passing local file descriptors via ", locfdPath);
+      }
+
 // Setup pid file
 //
    PidFile();
@@ -470,6 +480,7 @@ int XrdXrootdProtocol::Config(const char *ConfigFN)
              else if TS_Xeq("diglib",        xdig);
              else if TS_Xeq("export",        xexp);
              else if TS_Xeq("fslib",         xfsl);
+             else if TS_Xeq("localfd",       xlocfd);
              else if TS_Xeq("log",           xlog);
              else if TS_Xeq("monitor",       xmon);
              else if TS_Xeq("pidpath",       xpidf);
@@ -964,6 +975,41 @@ int XrdXrootdProtocol::xfsL(XrdOucStream &Config, char *val, int lix)
    return 0;
 }
 
+/******************************************************************************/
+/*                                x l o c f d                                 */
+/******************************************************************************/
+
+/* Function: xlocfd
+
+   Purpose:  To parse the directive: localfd <path>
+
+             <path>    the path of the unix socket via which descriptors of
+                       files opened for reading are passed to clients running
+                       on this host. The socket's directory must be searchable
+                       by those clients. By default, descriptors are not passed.
+
+  Output: 0 upon success or !0 upon failure.
+*/
+
+int XrdXrootdProtocol::xlocfd(XrdOucStream &Config)
+{
+    char *val;
+
+// Get the path
+//
+   val = Config.GetWord();
+   if (!val || !val[0])
+      {eDest.Emsg("Config", "localfd path not specified"); return 1;}
+   if (*val != '/')
+      {eDest.Emsg("Config", "localfd path not absolute"); return 1;}
+
+// Record the path
+//
+   if (locfdPath) free(locfdPath);
+   locfdPath = strdup(val);
+   return 0;
+}
+
 /******************************************************************************/
 /*                                  x l o g                                   */
 /******************************************************************************/
@@ -0,0 +1,282 @@
+/******************************************************************************/
+/*                                                                            */
+/*                    X r d X r o o t d F d P a s s . c c                     */
+/*                                                                            */
+/* (c) 2018 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include "XrdNet/XrdNetSocket.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysFD.hh"
+#include "XrdSys/XrdSysTimer.hh"
+#include "XrdXrootd/XrdXrootdFdPass.hh"
+
+/******************************************************************************/
+/*                        S t a t i c   O b j e c t s                         */
+/******************************************************************************/
+
+XrdSysMutex             XrdXrootdFdPass::gMutex;
+XrdXrootdFdPass::Grant *XrdXrootdFdPass::gList    = 0;
+int                     XrdXrootdFdPass::gNum     = 0;
+XrdSysError            *XrdXrootdFdPass::eDest    = 0;
+char                   *XrdXrootdFdPass::sockPath = 0;
+int                     XrdXrootdFdPass::sockFD   = -1;
+int                     XrdXrootdFdPass::randFD   = -1;
+
+/******************************************************************************/
+/* Private:                       E x p i r e                                 */
+/******************************************************************************/
+
+// Caller must hold gMutex
+
+void XrdXrootdFdPass::Expire(time_t tNow)
+{
+   Grant *gP = gList, *pP = 0, *nP;
+
+   while(gP)
+        {nP = gP->next;
+         if (gP->expires > tNow) pP = gP;
+            else {if (pP) pP->next = nP;
+                     else gList    = nP;
+                  close(gP->fd);
+                  delete gP;
+                  gNum--;
+                 }
+         gP = nP;
+        }
+}
+
+/******************************************************************************/
+/*                                  I n i t                                   */
+/******************************************************************************/
+
+bool XrdXrootdFdPass::Init(XrdSysError *eP, const char *path)
+{
+   XrdNetSocket *sP;
+   pthread_t tid;
+   int rc;
+
+// Get the random number source used to generate tokens
+//
+   eDest = eP;
+   if ((randFD = XrdSysFD_Open("/dev/urandom", O_RDONLY)) < 0)
+      {eDest->Emsg("FdPass", errno, "open /dev/urandom"); return false;}
+
+// Create the socket. Anyone may connect to it as a descriptor is only passed
+// in exchange for a token obtained via an authenticated xroot session.
+//
+   if (!(sP = XrdNetSocket::Create(eDest, path, 0, S_IRWXU)))
+      {close(randFD); randFD = -1; return false;}
+   chmod(path, S_IRWXU|S_IRWXG|S_IRWXO);
+   sockPath = strdup(path);
+   sockFD   = sP->Detach();
+   delete sP;
+
+// Start the thread that passes the descriptors
+//
+   if ((rc = XrdSysThread::Run(&tid, XrdXrootdFdPass::Serve, 0,
+                               XRDSYSTHREAD_BIND, "Local fd passing")))
+      {eDest->Emsg("FdPass", rc, "create local fd passing thread");
+       close(sockFD); sockFD = -1;
+       return false;
+      }
+   return true;
+}
+
+/******************************************************************************/
+/*                                 O f f e r                                  */
+/******************************************************************************/
+
+int XrdXrootdFdPass::Offer(int fd, char *buff, int blen)
+{
+   static const char hv[] = "0123456789abcdef";
+   unsigned char rBuff[tokLen/2];
+   time_t tNow = time(0);
+   Grant *gP;
+   int i, n;
+
+// Get the random bits for the token
+//
+   if (read(randFD, rBuff, sizeof(rBuff)) != (ssize_t)sizeof(rBuff))
+      return -EIO;
+
+// Make sure the response fits
+//
+   if (blen < (int)strlen(sockPath) + tokLen + 2) return -ENAMETOOLONG;
+
+// Create the grant
+//
+   gP = new Grant;
+   for (i = 0; i < tokLen/2; i++)
+       {gP->token[i*2]   = hv[rBuff[i] >> 4];
+        gP->token[i*2+1] = hv[rBuff[i] & 0x0f];
+       }
+   gP->token[tokLen] = 0;
+   gP->expires = tNow + holdTime;
+   if ((gP->fd = XrdSysFD_Dup(fd)) < 0) {n = errno; delete gP; return -n;}
+
+// Add it to the list, getting rid of any that were never claimed
+//
+   gMutex.Lock();
+   Expire(tNow);
+   if (gNum >= maxGrant)
+      {gMutex.UnLock();
+       close(gP->fd); delete gP;
+       return -EBUSY;
+      }
+   gP->next = gList; gList = gP; gNum++;
+
+// Format the response while we still own the grant
+//
+   n = snprintf(buff, blen, "%s %s", sockPath, gP->token);
+   gMutex.UnLock();
+   return n;
+}
+
+/******************************************************************************/
+/* Private:                         P a s s                                   */
+/******************************************************************************/
+
+void XrdXrootdFdPass::Pass(int conFD)
+{
+   struct pollfd pfd;
+   struct msghdr msg;
+   struct iovec  iov;
+   union {struct cmsghdr hdr;
+          char   buff[CMSG_SPACE(sizeof(int))];
+         } cmsg;
+   char token[tokLen+1], ok = 'n';
+   int fd = -1, rc, tLen = 0;
+   unsigned long tWaited;
+   XrdSysTimer tWait;
+
+// Read the token but don't let a client hold us up. The whole token must
+// arrive within a second; a client trickling it in does not extend that.
+//
+   pfd.fd = conFD; pfd.events = POLLIN;
+   tWait.Reset();
+   while(tLen < tokLen)
+        {do {tWaited = 0; tWait.Report(tWaited);
+             if (tWaited >= 1000) {rc = 0; break;}
+             rc = poll(&pfd, 1, 1000 - static_cast<int>(tWaited));
+            } while(rc < 0 && errno == EINTR);
+         if (rc <= 0) break;
+         do {rc = read(conFD, token+tLen, tokLen-tLen);}
+            while(rc < 0 && errno == EINTR);
+         if (rc <= 0) break;
+         tLen += rc;
+        }
+   token[tLen] = 0;
+
+// Find the descriptor
+//
+   if (tLen == tokLen && (fd = Take(token)) >= 0) ok = 'y';
+
+// Send the result with the descriptor, if we have one
+//
+   memset(&msg, 0, sizeof(msg));
+   iov.iov_base = &ok; iov.iov_len = 1;
+   msg.msg_iov  = &iov; msg.msg_iovlen = 1;
+   if (fd >= 0)
+      {struct cmsghdr *cP;
+       memset(&cmsg, 0, sizeof(cmsg));
+       msg.msg_control    = cmsg.buff;
+       msg.msg_controllen = sizeof(cmsg.buff);
+       cP = CMSG_FIRSTHDR(&msg);
+       cP->cmsg_level = SOL_SOCKET;
+       cP->cmsg_type  = SCM_RIGHTS;
+       cP->cmsg_len   = CMSG_LEN(sizeof(int));
+       memcpy(CMSG_DATA(cP), &fd, sizeof(int));
+      }
+   do {rc = sendmsg(conFD, &msg, 0);} while(rc < 0 && errno == EINTR);
+   if (rc < 0) eDest->Emsg("FdPass", errno, "pass file descriptor");
+
+// The client has its own copy now
+//
+   if (fd >= 0) close(fd);
+   close(conFD);
+}
+
+/******************************************************************************/
+/*                                 S e r v e                                  */
+/******************************************************************************/
+
+void *XrdXrootdFdPass::Serve(void *)
+{
+   int conFD;
+
+// Handle one connection at a time, each one is a short local exchange
+//
+   while(1)
+        {if ((conFD = XrdSysFD_Accept(sockFD, 0, 0)) < 0)
+            {if (errno != EINTR && errno != ECONNABORTED)
+                {eDest->Emsg("FdPass", errno, "accept local fd connection");
+                 XrdSysTimer::Wait(1000);
+                }
+             continue;
+            }
+         Pass(conFD);
+        }
+   return (void *)0;
+}
+
+/******************************************************************************/
+/* Private:                         T a k e                                   */
+/******************************************************************************/
+
+int XrdXrootdFdPass::Take(const char *token)
+{
+   Grant *gP, *pP = 0;
+   int fd = -1;
+
+// Find and remove the grant, it can only be used once
+//
+   gMutex.Lock();
+   Expire(time(0));
+   gP = gList;
+   while(gP && strcmp(gP->token, token)) {pP = gP; gP = gP->next;}
+   if (gP)
+      {if (pP) pP->next = gP->next;
+          else gList    = gP->next;
+       gNum--;
+       fd = gP->fd;
+       delete gP;
+      }
+   gMutex.UnLock();
+   return fd;
+}
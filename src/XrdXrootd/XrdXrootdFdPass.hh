@@ -0,0 +1,98 @@
+#ifndef __XRDXROOTDFDPASS_HH__
+#define __XRDXROOTDFDPASS_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                    X r d X r o o t d F d P a s s . h h                     */
+/*                                                                            */
+/* (c) 2018 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <time.h>
+
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdSysError;
+
+/******************************************************************************/
+/*                 C l a s s   X r d X r o o t d F d P a s s                  */
+/******************************************************************************/
+
+// This class hands file descriptors of open files to clients running on the
+// same host. A client that opened a file asks for its descriptor with a
+// kXR_Qlocfd query. The server duplicates the descriptor, files it under a
+// random token and returns "<sockpath> <token>". The client then connects to
+// the unix socket, sends the token and receives the descriptor via
+// SCM_RIGHTS. Tokens are good for one use and expire after holdTime seconds.
+
+class XrdXrootdFdPass
+{
+public:
+
+// Enabled() returns true if descriptors may be passed to local clients.
+//
+static bool  Enabled() {return sockFD >= 0;}
+
+// Init() creates the unix socket at path and starts the thread serving it.
+// It returns true upon success and false otherwise.
+//
+static bool  Init(XrdSysError *eP, const char *path);
+
+// Offer() files a copy of fd under a new token and places the response for
+// the client ("<sockpath> <token>") in buff. The return value is the response
+// length upon success or -errno upon failure.
+//
+static int   Offer(int fd, char *buff, int blen);
+
+static void *Serve(void *);
+
+                 XrdXrootdFdPass() {}
+                ~XrdXrootdFdPass() {}
+
+private:
+
+static const int tokLen   = 32;    // Hex characters in a token
+static const int holdTime = 30;    // Seconds an unclaimed token is kept
+static const int maxGrant = 4096;  // Maximum number of unclaimed tokens
+
+struct Grant {Grant  *next;
+              time_t  expires;
+              int     fd;
+              char    token[tokLen+1];
+             };
+
+static void  Expire(time_t tNow);
+static void  Pass(int conFD);
+static int   Take(const char *token);
+
+static XrdSysMutex  gMutex;
+static Grant       *gList;
+static int          gNum;
+static XrdSysError *eDest;
+static char        *sockPath;
+static int          sockFD;
+static int          randFD;
+};
+#endif
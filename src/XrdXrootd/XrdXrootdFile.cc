@@ -58,6 +58,10 @@ extern XrdOucTrace      *XrdXrootdTrace;
        const char      *XrdXrootdFile::TraceID      = "File";
        const char      *XrdXrootdFileTable::TraceID = "FileTable";
 
+namespace {char rsvMark;}
+
+XrdXrootdFile *const XrdXrootdFileTable::rsvFile = (XrdXrootdFile *)&rsvMark;
+
 /******************************************************************************/
 /*                        x r d _ F i l e   C l a s s                         */
 /******************************************************************************/
@@ -142,6 +146,67 @@ XrdXrootdFile::~XrdXrootdFile()
 /******************************************************************************/
   
 int XrdXrootdFileTable::Add(XrdXrootdFile *fp)
+{
+   int fnum;
+
+   ftMutex.Lock();
+   fnum = Insert(fp);
+   ftMutex.UnLock();
+   return fnum;
+}
+
+/******************************************************************************/
+/*                                   D e l                                    */
+/******************************************************************************/
+  
+void XrdXrootdFileTable::Del(int fnum)
+{
+   XrdXrootdFile *fp;
+
+   ftMutex.Lock();
+   if (fnum < XRD_FTABSIZE) 
+      {fp = FTab[fnum];
+       FTab[fnum] = 0;
+       if (fnum < FTfree) FTfree = fnum;
+      } else {
+       fnum -= XRD_FTABSIZE;
+       if (XTab && fnum < XTnum)
+          {fp = XTab[fnum];
+           XTab[fnum] = 0;
+           if (fnum < XTfree) XTfree = fnum;
+          }
+           else fp = 0;
+      }
+   ftMutex.UnLock();
+
+   if (fp && fp != rsvFile) delete fp;  // Will do the close
+}
+
+/******************************************************************************/
+/*                                  F i l l                                   */
+/******************************************************************************/
+  
+bool XrdXrootdFileTable::Fill(int fnum, XrdXrootdFile *fp)
+{
+   XrdXrootdFile **slot = 0;
+   bool aOK;
+
+   ftMutex.Lock();
+   if (fnum >= 0)
+      {if (fnum < XRD_FTABSIZE) slot = &FTab[fnum];
+          else if (XTab && (fnum-XRD_FTABSIZE) < XTnum)
+                  slot = &XTab[fnum-XRD_FTABSIZE];
+      }
+   if ((aOK = (slot && *slot == rsvFile))) *slot = fp;
+   ftMutex.UnLock();
+   return aOK;
+}
+
+/******************************************************************************/
+/* Private:                       I n s e r t                                 */
+/******************************************************************************/
+  
+int XrdXrootdFileTable::Insert(XrdXrootdFile *fp)
 {
    const int allocsz = XRD_FTABSIZE*sizeof(fp);
    XrdXrootdFile **newXTab, **oldXTab;
@@ -187,31 +252,6 @@ int XrdXrootdFileTable::Add(XrdXrootdFile *fp)
    return i+XRD_FTABSIZE;
 }
  
-/******************************************************************************/
-/*                                   D e l                                    */
-/******************************************************************************/
-  
-void XrdXrootdFileTable::Del(int fnum)
-{
-   XrdXrootdFile *fp;
-
-   if (fnum < XRD_FTABSIZE) 
-      {fp = FTab[fnum];
-       FTab[fnum] = 0;
-       if (fnum < FTfree) FTfree = fnum;
-      } else {
-       fnum -= XRD_FTABSIZE;
-       if (XTab && fnum < XTnum)
-          {fp = XTab[fnum];
-           XTab[fnum] = 0;
-           if (fnum < XTfree) XTfree = fnum;
-          }
-           else fp = 0;
-      }
-
-   if (fp) delete fp;  // Will do the close
-}
-
 /******************************************************************************/
 /*                               R e c y c l e                                */
 /******************************************************************************/
@@ -228,7 +268,7 @@ void XrdXrootdFileTable::Recycle(XrdXrootdMonitor *monP, bool monF)
 //
    FTfree = 0;
    for (i = 0; i < XRD_FTABSIZE; i++)
-       if (FTab[i])
+       if (FTab[i] && FTab[i] != rsvFile)
           {if (monP) monP->Close(FTab[i]->Stats.FileID,
                                  FTab[i]->Stats.xfr.read+FTab[i]->Stats.xfr.readv,
                                  FTab[i]->Stats.xfr.write);
@@ -240,7 +280,7 @@ void XrdXrootdFileTable::Recycle(XrdXrootdMonitor *monP, bool monF)
 //
 if (XTab)
   {for (i = 0; i < XTnum; i++)
-      {if (XTab[i])
+      {if (XTab[i] && XTab[i] != rsvFile)
           {if (monP) monP->Close(XTab[i]->Stats.FileID,
                                  XTab[i]->Stats.xfr.read+XTab[i]->Stats.xfr.readv,
                                  XTab[i]->Stats.xfr.write);
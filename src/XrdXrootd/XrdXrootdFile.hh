@@ -32,6 +32,7 @@
 #include <string.h>
 
 #include "XProtocol/XPtypes.hh"
+#include "XrdSys/XrdSysPthread.hh"
 #include "XrdXrootd/XrdXrootdFileStats.hh"
 
 /******************************************************************************/
@@ -95,15 +96,24 @@ public:
 
        void           Del(int fnum);
 
+// Fill() places a file into a handle previously obtained via Reserve(). It
+// may be called by a thread other than the one serving the link. A reserved
+// handle refers to no file until it is filled.
+//
+       bool           Fill(int fnum, XrdXrootdFile *fp);
+
 inline XrdXrootdFile *Get(int fnum)
-                         {if (fnum >= 0)
-                             {if (fnum < XRD_FTABSIZE) return FTab[fnum];
-                              if (XTab && (fnum-XRD_FTABSIZE)<XTnum)
-                                 return XTab[fnum-XRD_FTABSIZE];
+                         {XrdXrootdFile *fP = 0;
+                          if (fnum >= 0)
+                             {if (fnum < XRD_FTABSIZE) fP = FTab[fnum];
+                                 else if (XTab && (fnum-XRD_FTABSIZE)<XTnum)
+                                         fP = XTab[fnum-XRD_FTABSIZE];
                              }
-                          return (XrdXrootdFile *)0;
+                          return (fP != rsvFile ? fP : 0);
                          }
 
+inline int            Reserve() {return Add(rsvFile);}
+
        void           Recycle(XrdXrootdMonitor *monP=0, bool monF=false);
 
        XrdXrootdFileTable(unsigned int mid=0) : FTfree(0), monID(mid),
@@ -114,7 +124,12 @@ private:
 
       ~XrdXrootdFileTable() {} // Always use Recycle() to delete this object!
 
+       int    Insert(XrdXrootdFile *fp);
+
 static const char *TraceID;
+static XrdXrootdFile *const rsvFile;
+
+XrdSysMutex    ftMutex;   // Serializes changes to the tables
 
 XrdXrootdFile *FTab[XRD_FTABSIZE];
 int            FTfree;
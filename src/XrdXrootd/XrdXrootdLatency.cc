@@ -0,0 +1,252 @@
+/******************************************************************************/
+/*                                                                            */
+/*                   X r d X r o o t d L a t e n c y . c c                    */
+/*                                                                            */
+/* (c) 2018 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+
+#include "XrdXrootd/XrdXrootdLatency.hh"
+
+/******************************************************************************/
+/*                        S t a t i c   O b j e c t s                         */
+/******************************************************************************/
+
+XrdSysMutex              XrdXrootdLatency::histMutex;
+XrdXrootdLatency::Hist  *XrdXrootdLatency::histList = 0;
+XrdXrootdLatency::Hist  *XrdXrootdLatency::histDone = 0;
+pthread_key_t            XrdXrootdLatency::histKey;
+bool                     XrdXrootdLatency::keyOK =
+                         !pthread_key_create(&XrdXrootdLatency::histKey,
+                                             XrdXrootdLatency::Retire);
+
+namespace
+{
+const char *opName[XrdXrootdLatency::opNum] =
+                   {"open",   "rd",   "rv",   "wr",   "sync",  "rdr",
+                    "fsopen", "fsrd", "fsrv", "fswr", "fssync"};
+}
+
+/******************************************************************************/
+/* Private:                      B i n 2 V a l                                */
+/******************************************************************************/
+
+// Return the largest value that falls into the bin
+
+int XrdXrootdLatency::Bin2Val(int bin)
+{
+   static const int subNum = 1 << subBits;
+   long long val;
+   int  exp;
+
+   if (++bin < subNum) return bin - 1;
+   if (bin >= numBins) return 0x7fffffff;
+
+   exp = (bin >> subBits) - 1;
+   val = (((long long)(subNum | (bin & (subNum-1)))) << exp) - 1;
+   return (val > 0x7fffffff ? 0x7fffffff : (int)val);
+}
+
+/******************************************************************************/
+/* Private:                         F o l d                                   */
+/******************************************************************************/
+
+void XrdXrootdLatency::Fold(long long (*Sum)[numBins], Hist *hP)
+{
+   for (int i = 0; i < opNum; i++)
+       for (int j = 0; j < numBins; j++) Sum[i][j] += hP->Bin[i][j];
+}
+
+/******************************************************************************/
+/*                                F o r m a t                                 */
+/******************************************************************************/
+
+int XrdXrootdLatency::Format(char *buff, int blen, bool xml)
+{
+   static const char *xFmt = "<%s><n>%lld</n><p50>%d</p50><p99>%d</p99>"
+                             "<p999>%d</p999><max>%d</max></%s>";
+   static const char *tFmt = "%s=%lld,%d,%d,%d,%d%c";
+   long long (*Sum)[numBins], Tot, Cnt;
+   int pVal[4], n, len = 0;
+   Hist *hP;
+
+// If no buffer, return the maximum size we will generate
+//
+   if (!buff)
+      {char dummy[256];
+       for (int i = 0; i < opNum; i++)
+           len += snprintf(dummy, sizeof(dummy), xFmt, opName[i],
+                           0x7fffffffffffffffLL, 0x7fffffff, 0x7fffffff,
+                           0x7fffffff, 0x7fffffff, opName[i]);
+       return len + 11;
+      }
+
+// Merge all of the histograms
+//
+   Sum = (long long (*)[numBins])calloc(opNum, sizeof(*Sum));
+   if (!Sum) return 0;
+   histMutex.Lock();
+   if (histDone) Fold(Sum, histDone);
+   hP = histList;
+   while(hP) {Fold(Sum, hP); hP = hP->next;}
+   histMutex.UnLock();
+
+// Generate the report
+//
+   if (xml && blen > 5) {strcpy(buff, "<lat>"); len = 5;}
+   for (int i = 0; i < opNum && len < blen; i++)
+       {Tot = 0;
+        for (int j = 0; j < numBins; j++) Tot += Sum[i][j];
+        memset(pVal, 0, sizeof(pVal));
+        if (Tot)
+           {long long Lim[3] = {(Tot*500+999)/1000, (Tot*990+999)/1000,
+                                (Tot*999+999)/1000};
+            int k = 0;
+            Cnt = 0;
+            for (int j = 0; j < numBins; j++)
+                {if (!Sum[i][j]) continue;
+                 Cnt += Sum[i][j];
+                 while(k < 3 && Cnt >= Lim[k]) pVal[k++] = Bin2Val(j);
+                 pVal[3] = Bin2Val(j);
+                }
+           }
+        if (xml) n = snprintf(buff+len, blen-len, xFmt, opName[i], Tot,
+                              pVal[0], pVal[1], pVal[2], pVal[3], opName[i]);
+           else  n = snprintf(buff+len, blen-len, tFmt, opName[i], Tot,
+                              pVal[0], pVal[1], pVal[2], pVal[3],
+                              (i+1 < opNum ? ' ' : '\n'));
+        len += n;
+       }
+   if (xml && len + 6 < blen) {strcpy(buff+len, "</lat>"); len += 6;}
+   free(Sum);
+   return (len < blen ? len : blen-1);
+}
+
+/******************************************************************************/
+/* Private:                         H o o k                                   */
+/******************************************************************************/
+
+// Allocate a histogram for the calling thread and chain it into the list
+
+XrdXrootdLatency::Hist *XrdXrootdLatency::Hook()
+{
+   Hist *hP;
+
+   if (!keyOK || !(hP = (Hist *)calloc(1, sizeof(Hist)))) return 0;
+   pthread_setspecific(histKey, hP);
+
+   histMutex.Lock();
+   if ((hP->next = histList)) histList->prev = hP;
+   histList = hP;
+   histMutex.UnLock();
+   return hP;
+}
+
+/******************************************************************************/
+/*                                   N o w                                    */
+/******************************************************************************/
+
+long long XrdXrootdLatency::Now()
+{
+#ifdef CLOCK_MONOTONIC
+   struct timespec tNow;
+   clock_gettime(CLOCK_MONOTONIC, &tNow);
+   return (long long)tNow.tv_sec*1000000LL + tNow.tv_nsec/1000;
+#else
+   struct timeval tNow;
+   gettimeofday(&tNow, 0);
+   return (long long)tNow.tv_sec*1000000LL + tNow.tv_usec;
+#endif
+}
+
+/******************************************************************************/
+/*                                R e c o r d                                 */
+/******************************************************************************/
+
+void XrdXrootdLatency::Record(Op op, long long usec)
+{
+   Hist *hP;
+
+// Find this thread's histogram, creating one if this is the first time. Only
+// this thread ever updates it so no locking is needed.
+//
+   if (!keyOK) return;
+   if (!(hP = (Hist *)pthread_getspecific(histKey)) && !(hP = Hook())) return;
+   hP->Bin[op][Val2Bin(usec)]++;
+}
+
+/******************************************************************************/
+/* Private:                       R e t i r e                                 */
+/******************************************************************************/
+
+// Called when a thread exits; fold its histogram into the common one
+
+void XrdXrootdLatency::Retire(void *hVoid)
+{
+   Hist *hP = (Hist *)hVoid;
+
+   histMutex.Lock();
+   if (hP->prev) hP->prev->next = hP->next;
+      else histList = hP->next;
+   if (hP->next) hP->next->prev = hP->prev;
+   if (!histDone) {hP->next = hP->prev = 0; histDone = hP; hP = 0;}
+      else for (int i = 0; i < opNum; i++)
+               for (int j = 0; j < numBins; j++)
+                   histDone->Bin[i][j] += hP->Bin[i][j];
+   histMutex.UnLock();
+   if (hP) free(hP);
+}
+
+/******************************************************************************/
+/* Private:                      V a l 2 B i n                                */
+/******************************************************************************/
+
+int XrdXrootdLatency::Val2Bin(long long usec)
+{
+   static const int subNum = 1 << subBits;
+   int msb;
+
+// Small values have a bin of their own
+//
+   if (usec < subNum) return (usec < 0 ? 0 : (int)usec);
+
+// Find the most significant bit; the next subBits bits select the sub-bucket
+//
+#if defined(__GNUC__)
+   msb = 63 - __builtin_clzll((unsigned long long)usec);
+#else
+   msb = subBits;
+   while(usec >> (msb+1)) msb++;
+#endif
+   if (msb > maxBits) return numBins-1;
+   return ((msb-subBits+1) << subBits)
+        | (int)((usec >> (msb-subBits)) & (subNum-1));
+}
@@ -0,0 +1,101 @@
+#ifndef __XRDXROOTDLATENCY_HH__
+#define __XRDXROOTDLATENCY_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                   X r d X r o o t d L a t e n c y . h h                    */
+/*                                                                            */
+/* (c) 2018 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <pthread.h>
+
+#include "XrdSys/XrdSysPthread.hh"
+
+/******************************************************************************/
+/*                C l a s s   X r d X r o o t d L a t e n c y                 */
+/******************************************************************************/
+
+// This class keeps log-linear latency histograms (8 sub-buckets per power of
+// two microseconds) for the hot request paths. Each thread records into its
+// own histogram without any locking; the histograms are merged when a report
+// is generated. Histograms of threads that exit are folded into a common one.
+
+class XrdXrootdLatency
+{
+public:
+
+enum Op {xOpen = 0, xRead, xReadV, xWrite, xSync, xRedir,
+         fsOpen,    fsRead, fsReadV, fsWrite, fsSync, opNum
+        };
+
+// Done() records the time elapsed since tBeg (as returned by Now()).
+//
+static void      Done(Op op, long long tBeg)
+                     {long long tNow = Now();
+                      Record(op, (tNow > tBeg ? tNow - tBeg : 0));
+                     }
+
+// Format() places a report into buff. When xml is true, an xml <lat> element
+// suitable for the summary stream is generated. Otherwise, a single text line
+// of the form "<op>=<n>,<p50>,<p99>,<p999>,<max> ..." is generated. All times
+// are in microseconds. The return value is the number of bytes placed in buff.
+// When buff is nil, the maximum length that may be generated is returned.
+//
+static int       Format(char *buff, int blen, bool xml);
+
+// Now() returns a monotonic time in microseconds.
+//
+static long long Now();
+
+static void      Record(Op op, long long usec);
+
+                 XrdXrootdLatency() {}
+                ~XrdXrootdLatency() {}
+
+private:
+
+static const int subBits = 3;
+static const int maxBits = 34;   // Largest tracked value is about 4.7 hours
+static const int numBins = (maxBits-subBits+2) << subBits;
+
+struct Hist {Hist     *next;
+             Hist     *prev;
+             long long Bin[opNum][numBins];
+            };
+
+static int       Bin2Val(int bin);
+static void      Fold(long long (*Sum)[numBins], Hist *hP);
+static Hist     *Hook();
+static void      Retire(void *hP);
+static int       Val2Bin(long long usec);
+
+static XrdSysMutex    histMutex;
+static Hist          *histList;
+static Hist          *histDone;
+static pthread_key_t  histKey;
+static bool           keyOK;
+};
+#endif
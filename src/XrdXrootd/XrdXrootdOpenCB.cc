@@ -0,0 +1,220 @@
+/******************************************************************************/
+/*                                                                            */
+/*                    X r d X r o o t d O p e n C B . c c                     */
+/*                                                                            */
+/* (c) 2018 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include "Xrd/XrdScheduler.hh"
+#include "XProtocol/XProtocol.hh"
+#include "XrdSfs/XrdSfsInterface.hh"
+#include "XrdXrootd/XrdXrootdCallBack.hh"
+#include "XrdXrootd/XrdXrootdMonData.hh"
+#include "XrdXrootd/XrdXrootdOpenCB.hh"
+#include "XrdXrootd/XrdXrootdProtocol.hh"
+#include "XrdXrootd/XrdXrootdReqID.hh"
+
+/******************************************************************************/
+/*                        S t a t i c   O b j e c t s                         */
+/******************************************************************************/
+
+namespace
+{
+XrdXrootdCallBack openCB("open file", XROOTD_MON_OPENR);
+}
+
+XrdXrootdCallBack *XrdXrootdOpenCB::dfltCB = &openCB;
+XrdScheduler      *XrdXrootdOpenCB::Sched  = 0;
+
+/******************************************************************************/
+/*                     X r d X r o o t d O p e n P e n d                      */
+/******************************************************************************/
+/******************************************************************************/
+/*                                  D o I t                                   */
+/******************************************************************************/
+  
+void XrdXrootdOpenPend::DoIt()
+{
+   XrdXrootdOpenCB *ocbP = Owner;
+
+// Make sure the link is no longer using the file object and that the client
+// was told to wait for the response before we send it.
+//
+   Ready.Wait();
+
+// Attach the file to the link or report the failure to the client
+//
+   bool isOpen = ocbP->Prot->openDone(this);
+
+// Tell the file system that the callback has completed. Only then may a file
+// that could not be attached be deleted as it may hold the callback object.
+//
+   if (eInfo->getErrCB()) eInfo->getErrCB()->Done(Result, eInfo);
+      else delete eInfo;
+   eInfo = 0;
+   if (!isOpen) delete fileP;
+
+// This open is now complete, wake up anyone waiting for all of them to finish
+//
+   ocbP->pendCV.Lock();
+   if (!(--(ocbP->pendNum))) ocbP->pendCV.Broadcast();
+   ocbP->pendCV.UnLock();
+   delete this;
+}
+
+/******************************************************************************/
+/*                       X r d X r o o t d O p e n C B                        */
+/******************************************************************************/
+/******************************************************************************/
+/*                                   A d d                                    */
+/******************************************************************************/
+  
+void XrdXrootdOpenCB::Add(XrdXrootdOpenPend *opP)
+{
+   pendCV.Lock();
+   opP->Owner = this;
+   opP->Next  = pendList;
+   pendList   = opP;
+   pendNum++;
+   pendCV.UnLock();
+}
+
+/******************************************************************************/
+/*                                   A r m                                    */
+/******************************************************************************/
+
+// The file system will complete the open in the background. If the callback
+// already arrived, schedule the attach now. Otherwise, Done() will do so.
+
+void XrdXrootdOpenCB::Arm(XrdXrootdOpenPend *opP)
+{
+   pendCV.Lock();
+   if (opP->fired)
+      {Remove(opP);
+       pendCV.UnLock();
+       Sched->Schedule((XrdJob *)opP);
+       return;
+      }
+   opP->armed = true;
+   pendCV.UnLock();
+}
+
+/******************************************************************************/
+/*                                C a n c e l                                 */
+/******************************************************************************/
+
+// The open was not deferred. Discard the pending open and pass any callback
+// that has already arrived to the standard callback object. The file object
+// still belongs to the caller.
+
+void XrdXrootdOpenCB::Cancel(XrdXrootdOpenPend *opP)
+{
+   pendCV.Lock();
+   Remove(opP);
+   if (!(--pendNum)) pendCV.Broadcast();
+   pendCV.UnLock();
+
+   if (opP->fired) dfltCB->Done(opP->Result, opP->eInfo, opP->Path);
+   delete opP;
+}
+
+/******************************************************************************/
+/*                                  D o n e                                   */
+/******************************************************************************/
+
+void XrdXrootdOpenCB::Done(int           &Result,   //I/O: Function result
+                           XrdOucErrInfo *eInfo,    // In: Error information
+                           const char    *Path)     // In: Path related
+{
+   XrdXrootdOpenPend *opP;
+   unsigned long long reqID = eInfo->getErrArg();
+
+// Find the pending open this callback is for. If open() has not returned yet,
+// we don't know whether the open was deferred. So, simply record the callback
+// and let Arm() or Cancel() handle it. Otherwise, remove it from the list.
+//
+   pendCV.Lock();
+   opP = pendList;
+   while(opP && opP->reqID != reqID) opP = opP->Next;
+   if (opP)
+      {if (!opP->armed)
+          {opP->Result = Result;
+           opP->eInfo  = eInfo;
+           opP->fired  = true;
+           pendCV.UnLock();
+           return;
+          }
+       Remove(opP);
+      }
+   pendCV.UnLock();
+
+// If this is not a deferred open, it is handled the standard way
+//
+   if (!opP) {dfltCB->Done(Result, eInfo, Path); return;}
+
+// Attaching the file may take a while, so do it asynchronously
+//
+   opP->Result = Result;
+   opP->eInfo  = eInfo;
+   Sched->Schedule((XrdJob *)opP);
+}
+
+/******************************************************************************/
+/*                                 D r a i n                                  */
+/******************************************************************************/
+  
+void XrdXrootdOpenCB::Drain()
+{
+   pendCV.Lock();
+   while(pendNum) pendCV.Wait();
+   pendCV.UnLock();
+}
+
+/******************************************************************************/
+/* Private:                       R e m o v e                                 */
+/******************************************************************************/
+
+// Remove a pending open from the list, the caller must hold pendCV.
+
+bool XrdXrootdOpenCB::Remove(XrdXrootdOpenPend *opP)
+{
+   XrdXrootdOpenPend *xP = pendList, *pP = 0;
+
+   while(xP && xP != opP) {pP = xP; xP = xP->Next;}
+   if (!xP) return false;
+   if (pP) pP->Next = xP->Next;
+      else pendList = xP->Next;
+   return true;
+}
+
+/******************************************************************************/
+/*                                  S a m e                                   */
+/******************************************************************************/
+  
+int XrdXrootdOpenCB::Same(unsigned long long arg1, unsigned long long arg2)
+{
+   return dfltCB->Same(arg1, arg2);
+}
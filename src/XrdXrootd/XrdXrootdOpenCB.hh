@@ -0,0 +1,140 @@
+#ifndef __XRDXROOTDOPENCB_HH__
+#define __XRDXROOTDOPENCB_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                    X r d X r o o t d O p e n C B . h h                     */
+/*                                                                            */
+/* (c) 2018 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Xrd/XrdJob.hh"
+#include "XrdOuc/XrdOucErrInfo.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdScheduler;
+class XrdSfsFile;
+class XrdXrootdCallBack;
+class XrdXrootdProtocol;
+
+/******************************************************************************/
+/*                     X r d X r o o t d O p e n P e n d                      */
+/******************************************************************************/
+
+// This object describes an open that the file system is completing in the
+// background. It is scheduled to attach the file once the open completes.
+
+class XrdXrootdOpenCB;
+
+class XrdXrootdOpenPend : public XrdJob
+{
+public:
+
+XrdXrootdOpenPend  *Next;
+XrdXrootdOpenCB    *Owner;
+XrdSfsFile         *fileP;       // The file being opened
+XrdOucErrInfo      *eInfo;       // Callback information when completed
+char               *Path;        // The file's path (used for monitoring)
+unsigned long long  reqID;       // The request ID (i.e. callback argument)
+int                 fHandle;     // Reserved file handle, -1 if none
+int                 Result;      // The result of the open
+int                 pOpt;        // Path export options
+char                usage;       // 'r' or 'w'
+char                isAsync;     // File is to be in async mode
+bool                doForce;     // kXR_force
+bool                retStat;     // kXR_retstat
+bool                compChk;     // kXR_compress
+bool                armed;       // The file system deferred the open
+bool                fired;       // Callback arrived before the open returned
+XrdSysSemaphore     Ready;       // Posted once the client was told to wait
+
+void                DoIt();
+
+                    XrdXrootdOpenPend(XrdSfsFile *fP, const char *path)
+                                     : XrdJob("deferred open"), Next(0),
+                                       Owner(0), fileP(fP), eInfo(0),
+                                       Path(strdup(path)), reqID(0),
+                                       fHandle(-1), Result(0), pOpt(0),
+                                       usage('r'), isAsync(0), doForce(false),
+                                       retStat(false), compChk(false),
+                                       armed(false), fired(false),
+                                       Ready(0) {}
+
+                   ~XrdXrootdOpenPend() {if (Path) free(Path);}
+};
+
+/******************************************************************************/
+/*                       X r d X r o o t d O p e n C B                        */
+/******************************************************************************/
+
+// Each protocol object has one of these and uses it as the callback object for
+// all of its opens. Callbacks for opens the file system deferred in order to
+// complete them in the background are used to attach the file to the link.
+// All other callbacks are simply passed to the standard open callback object.
+// A pending open is added before the file system is asked to open the file so
+// that a callback arriving before open() returns is never lost. Once open()
+// returns, Arm() is called if the open was deferred and Cancel() otherwise.
+
+class XrdXrootdOpenCB : public XrdOucEICB
+{
+friend class XrdXrootdOpenPend;
+public:
+
+        void  Add(XrdXrootdOpenPend *opP);
+
+        void  Arm(XrdXrootdOpenPend *opP);
+
+        void  Cancel(XrdXrootdOpenPend *opP);
+
+        void  Done(int &Result, XrdOucErrInfo *eInfo, const char *Path=0);
+
+        void  Drain();
+
+        int   Same(unsigned long long arg1, unsigned long long arg2);
+
+static  void  setVals(XrdScheduler *schP) {Sched = schP;}
+
+              XrdXrootdOpenCB(XrdXrootdProtocol *pP)
+                             : pendCV(0, "openCB"), pendList(0), pendNum(0),
+                               Prot(pP) {}
+             ~XrdXrootdOpenCB() {}
+
+static XrdXrootdCallBack *dfltCB;
+
+private:
+
+        bool  Remove(XrdXrootdOpenPend *opP);
+
+static XrdScheduler      *Sched;
+
+XrdSysCondVar             pendCV;
+XrdXrootdOpenPend        *pendList;  // Opens waiting for their callback
+int                       pendNum;   // Opens not yet fully completed
+XrdXrootdProtocol        *Prot;
+};
+#endif
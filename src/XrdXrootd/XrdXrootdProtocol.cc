@@ -68,6 +68,7 @@ XrdSecService        *XrdXrootdProtocol::CIA      = 0;
 XrdSecProtector      *XrdXrootdProtocol::DHS      = 0;
 char                 *XrdXrootdProtocol::SecLib   = 0;
 char                 *XrdXrootdProtocol::pidPath  = strdup("/tmp");
+char                 *XrdXrootdProtocol::locfdPath= 0;
 XrdScheduler         *XrdXrootdProtocol::Sched;
 XrdBuffManager       *XrdXrootdProtocol::BPool;
 XrdSysError           XrdXrootdProtocol::eDest(0, "Xrootd");
@@ -197,7 +198,7 @@ int XrdgetProtocolPort(const char *pname, char *parms, XrdProtocol_Config *pi)
 
 XrdXrootdProtocol::XrdXrootdProtocol() 
                     : XrdProtocol("xrootd protocol handler"), ProtLink(this),
-                      Entity("")
+                      OpenCB(this), Entity("")
 {
    Reset();
 }
@@ -336,18 +337,30 @@ int dlen, rc;
   
 int XrdXrootdProtocol::Process(XrdLink *lp) // We ignore the argument here
 {
+   XrdSysMutexHelper reqLock;
    int rc;
    kXR_unt16 reqID;
 
-// Check if we are servicing a slow link
+// Opens that the file system completes in the background are attached to the
+// link by a scheduler thread. The request lock keeps that from happening while
+// we are working on the file table or the link's monitoring and file counts.
+//
+   reqLock.Lock(&reqMutex);
+
+// Check if we are servicing a slow link. A write whose data trickles in is
+// only done when its continuation finishes, so record its latency then.
 //
    if (Resume)
       {if (myBlen && (rc = getData("data", myBuff, myBlen)) != 0)
           {if (rc < 0 && myAioReq) myAioReq->Recycle(-1);
            return rc;
           }
-          else if ((rc = (*this.*Resume)()) != 0) return rc;
-                  else {Resume = 0; return 0;}
+       bool isWrite = Resume == &XrdXrootdProtocol::do_WriteCont
+                   || Resume == &XrdXrootdProtocol::do_WriteNone;
+       if ((rc = (*this.*Resume)()) > 0) return rc;
+       if (isWrite) XrdXrootdLatency::Done(XrdXrootdLatency::xWrite, reqStart);
+       if (rc) return rc;
+       Resume = 0; return 0;
       }
 
 // Read the next request header
@@ -410,6 +423,12 @@ int XrdXrootdProtocol::Process(XrdLink *lp) // We ignore the argument here
   
 int XrdXrootdProtocol::Process2()
 {
+   int rc;
+
+// Note when we started processing this request for latency reporting
+//
+   reqStart = XrdXrootdLatency::Now();
+
 // If we are verifying requests, see if this request needs to be verified
 //
    if (sigNeed)
@@ -454,11 +473,13 @@ int XrdXrootdProtocol::Process2()
 // sync() which return with a callback, so handle it here.
 //
    switch(Request.header.requestid)   // First, the ones with file handles
-         {case kXR_read:     return do_Read();
-          case kXR_readv:    return do_ReadV();
-          case kXR_write:    return do_Write();
+         {case kXR_read:     return latDone(XrdXrootdLatency::xRead,do_Read());
+          case kXR_readv:    return latDone(XrdXrootdLatency::xReadV,
+                                            do_ReadV());
+          case kXR_write:    if ((rc = do_Write()) > 0) return rc;
+                             return latDone(XrdXrootdLatency::xWrite, rc);
           case kXR_sync:     ReqID.setID(Request.header.streamid);
-                             return do_Sync();
+                             return latDone(XrdXrootdLatency::xSync,do_Sync());
           case kXR_close:    return do_Close();
           case kXR_truncate: if (!Request.header.dlen) return do_Truncate();
                              break;
@@ -506,7 +527,9 @@ int XrdXrootdProtocol::Process2()
 // Process items that keep own statistics
 //
    switch(Request.header.requestid)
-         {case kXR_open:      return do_Open();
+         {case kXR_open:      return latDone(XrdXrootdLatency::xOpen,
+                                             do_Open());
+          case kXR_fetch:     return do_Fetch();
           case kXR_getfile:   return do_Getfile();
           case kXR_putfile:   return do_Putfile();
           default:            break;
@@ -732,6 +755,11 @@ void XrdXrootdProtocol::Cleanup()
 //
    if (Status != XRD_BOUNDPATH) osFS->Disc(Client);
 
+// Wait for opens the filesystem is completing in the background to finish as
+// they need the file table and the link.
+//
+   OpenCB.Drain();
+
 // Delete the FTab if we have it
 //
    if (FTab)
@@ -827,6 +855,7 @@ void XrdXrootdProtocol::Reset()
    cumSegsV           = 0;
    cumWrites          = 0;
    totReadP           = 0;
+   reqStart           = 0;
    hcPrev             =13;
    hcNext             =21;
    hcNow              =13;
@@ -40,7 +40,9 @@
 
 #include "Xrd/XrdObject.hh"
 #include "Xrd/XrdProtocol.hh"
+#include "XrdXrootd/XrdXrootdLatency.hh"
 #include "XrdXrootd/XrdXrootdMonitor.hh"
+#include "XrdXrootd/XrdXrootdOpenCB.hh"
 #include "XrdXrootd/XrdXrootdReqID.hh"
 #include "XrdXrootd/XrdXrootdResponse.hh"
 #include "XProtocol/XProtocol.hh"
@@ -67,6 +69,7 @@
 class XrdNetSocket;
 class XrdOucEnv;
 class XrdOucErrInfo;
+struct XrdOucIOVec;
 class XrdOucReqID;
 class XrdOucStream;
 class XrdOucTList;
@@ -93,6 +96,7 @@ class XrdXrootdProtocol : public XrdProtocol, public XrdSfsDio
 {
 friend class XrdXrootdAdmin;
 friend class XrdXrootdAioReq;
+friend class XrdXrootdOpenPend;
 public:
 
 static int           Configure(char *parms, XrdProtocol_Config *pi);
@@ -145,6 +149,7 @@ enum RD_func {RD_chmod = 0, RD_chksum,  RD_dirlist, RD_locate, RD_mkdir,
        int   do_Dirlist();
        int   do_DirStat(XrdSfsDirectory *dp, char *pbuff, char *opaque);
        int   do_Endsess();
+       int   do_Fetch();
        int   do_Getfile();
        int   do_Login();
        int   do_Locate();
@@ -159,6 +164,7 @@ enum RD_func {RD_chmod = 0, RD_chksum,  RD_dirlist, RD_locate, RD_mkdir,
        int   do_Putfile();
        int   do_Qconf();
        int   do_Qfh();
+       int   do_Qlocfd(XrdXrootdFile *fp);
        int   do_Qopaque(short);
        int   do_Qspace();
        int   do_Query();
@@ -193,12 +199,18 @@ static int   Config(const char *fn);
 static int   ConfigSecurity(XrdOucEnv &xEnv, const char *cfn);
        int   fsError(int rc, char opc, XrdOucErrInfo &myError,
                      const char *Path, char *Cgi);
+       int   fsRead(char *buff, int blen);
+       int   fsReadV(XrdOucIOVec *rdV, int rdVnum);
        int   fsRedir(RD_func xfnc);
        int   fsRedirNoEnt(const char *eMsg, char *Cgi, int popt);
+       int   fsWrite(const char *buff, int blen);
        int   getBuff(const int isRead, int Quantum);
        int   getData(const char *dtype, char *buff, int blen);
+inline int   latDone(XrdXrootdLatency::Op op, int rc)
+                    {XrdXrootdLatency::Done(op, reqStart); return rc;}
        void  logLogin(bool xauth=false);
 static int   mapMode(int mode);
+       bool  openDone(XrdXrootdOpenPend *opP);
 static void  PidFile();
        void  Reset();
 static int   rpCheck(char *fn, char **opaque);
@@ -215,6 +227,7 @@ static int   xfsl(XrdOucStream &Config);
 static int   xfsL(XrdOucStream &Config, char *val, int lix);
 static int   xpidf(XrdOucStream &Config);
 static int   xprep(XrdOucStream &Config);
+static int   xlocfd(XrdOucStream &Config);
 static int   xlog(XrdOucStream &Config);
 static int   xmon(XrdOucStream &Config);
 static int   xred(XrdOucStream &Config);
@@ -225,6 +238,7 @@ static int   xtrace(XrdOucStream &Config);
 
 static XrdObjectQ<XrdXrootdProtocol> ProtStack;
 XrdObject<XrdXrootdProtocol>         ProtLink;
+XrdXrootdOpenCB                      OpenCB;
 
 protected:
 
@@ -245,6 +259,7 @@ static XrdSysError           eDest;     // Error message handler
 static const char           *myInst;
 static const char           *TraceID;
 static       char           *pidPath;
+static       char           *locfdPath;
 static int                   RQLxist;   // Something is present in RQList
 static int                   myPID;
 static int                   myRole;     // Role for kXR_protocol (>= 2.9.7)
@@ -317,6 +332,7 @@ int                        cumReadV;     // Count less numReadV
 int                        cumSegsV;     // Count less numSegsV
 int                        cumWrites;    // Count less numWrites
 long long                  totReadP;     // Bytes
+long long                  reqStart;     // Time the current request started
 
 // Data local to each protocol/link combination
 //
@@ -324,6 +340,7 @@ XrdLink                   *Link;
 XrdBuffer                 *argp;
 XrdXrootdFileTable        *FTab;
 XrdXrootdMonitor::User     Monitor;
+XrdSysMutex                reqMutex;     // Serializes requests with openDone()
 int                        clientPV;
 short                      rdType;
 char                       Status;
@@ -28,9 +28,11 @@
 /******************************************************************************/
  
 #include <stdio.h>
+#include <string.h>
   
 #include "Xrd/XrdStats.hh"
 #include "XrdSfs/XrdSfsInterface.hh"
+#include "XrdXrootd/XrdXrootdLatency.hh"
 #include "XrdXrootd/XrdXrootdResponse.hh"
 #include "XrdXrootd/XrdXrootdStats.hh"
  
@@ -85,7 +87,7 @@ int XrdXrootdStats::Stats(char *buff, int blen, int do_sync)
    "<sig><ok>%d</ok><bad>%d</bad><ign>%d</ign></sig>"
    "<aio><num>%lld</num><max>%d</max><rej>%lld</rej></aio>"
    "<err>%d</err><rdr>%lld</rdr><dly>%d</dly>"
-   "<lgn><num>%d</num><af>%d</af><au>%d</au><ua>%d</ua></lgn></stats>";
+   "<lgn><num>%d</num><af>%d</af><au>%d</au><ua>%d</ua></lgn>";
 //                                   1 2 3 4 5 6 7 8
    static const long long LLMax = 0x7fffffffffffffffLL;
    static const int       INMax = 0x7fffffff;
@@ -101,6 +103,7 @@ int XrdXrootdStats::Stats(char *buff, int blen, int do_sync)
                       INMax, INMax, INMax,
                       LLMax, INMax, LLMax, INMax, LLMax, INMax,
                       INMax, INMax, INMax, INMax);
+       len += XrdXrootdLatency::Format(0, 0, true) + 8;
        return len + (fsP ? fsP->getStats(0,0) : 0);
       }
 
@@ -115,6 +118,11 @@ int XrdXrootdStats::Stats(char *buff, int blen, int do_sync)
                   LoginAT, AuthBad, LoginAU, LoginUA);
    statsMutex.UnLock();
 
+// Add the latency histogram summary and close off our element
+//
+   if (len < blen) len += XrdXrootdLatency::Format(buff+len, blen-len, true);
+   if (len + 8 < blen) {strcpy(buff+len, "</stats>"); len += 8;}
+
 // Now include filesystem statistics and return
 //
    if (fsP) len += fsP->getStats(buff+len, blen-len);
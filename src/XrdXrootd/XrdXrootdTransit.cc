@@ -366,7 +366,8 @@ do{rc = realProt->Process((reInvoke ? 0 : lp));
       {reInvoke = (rc == 0);
        if (runError) rc = Fatal(rc);
           else {runDone = false;
-                rc = (Resume ? XrdXrootdProtocol::Process(lp) : Process2());
+                if (Resume) rc = XrdXrootdProtocol::Process(lp);
+                   else {reqMutex.Lock(); rc = Process2(); reqMutex.UnLock();}
                 if (rc >= 0)
                    {if (runWait)
                        {if (runWait >= 0)
@@ -414,7 +415,8 @@ int XrdXrootdTransit::Process()
 // be deleted while a timer is outstanding as the link has been disabled. So,
 // we can reissue the request with little worry.
 //
-   if (!runALen || RunCopy(runArgs, runALen)) rc = Process2();
+   if (!runALen || RunCopy(runArgs, runALen))
+      {reqMutex.Lock(); rc = Process2(); reqMutex.UnLock();}
       else rc = Send(kXR_error, ioV, 2, 0);
 
 // Defer the request if need be
@@ -45,6 +45,7 @@
 #include "Xrd/XrdLink.hh"
 #include "XrdXrootd/XrdXrootdAio.hh"
 #include "XrdXrootd/XrdXrootdCallBack.hh"
+#include "XrdXrootd/XrdXrootdFdPass.hh"
 #include "XrdXrootd/XrdXrootdFile.hh"
 #include "XrdXrootd/XrdXrootdFileLock.hh"
 #include "XrdXrootd/XrdXrootdJob.hh"
@@ -708,6 +709,160 @@ int XrdXrootdProtocol::do_Endsess()
    return Response.Send();
 }
 
+/******************************************************************************/
+/*                              d o _ F e t c h                               */
+/******************************************************************************/
+
+// Each path in the newline separated list is opened, the leading rlen bytes
+// are read and the file is closed. The results are returned as a sequence of
+// ServerResponseBody_Fetch items, each followed by the data or error message.
+// Files that cannot be served here (e.g. they need a redirect) cause the whole
+// request to be redirected when it is the first path; otherwise, the client is
+// told to open such a file individually.
+
+int XrdXrootdProtocol::do_Fetch()
+{
+   static const int hdrSz = sizeof(ServerResponseBody_Fetch);
+   static const int errSz = 2048;
+   XrdOucTokenizer pathlist(argp->buff);
+   ServerResponseBody_Fetch myItem;
+   XrdBuffer *bP;
+   XrdSfsFile *fp;
+   XrdXrootdFile *xp;
+   struct stat statbuf;
+   char *path, *opaque, *bnext, *bend, *dP, ebuff[errSz];
+   const char *eText;
+   long long fSize, tBeg;
+   int rc, ecode, dlen, need, popt, ropt = 0, rlen;
+   bool isFirst = true;
+
+// Unmarshall the data
+//
+   rlen = (int)ntohl(Request.fetch.rlen);
+   TRACEP(FS, "fetch rlen=" <<rlen);
+
+// Get a buffer to hold the response. We can't use the argument buffer as it
+// holds the path list.
+//
+   if (!(bP = BPool->Obtain(maxBuffsz)) || bP->bsize < hdrSz+errSz)
+      {if (bP) BPool->Release(bP);
+       return Response.Send(kXR_NoMemory, "insufficient memory to fetch files");
+      }
+   bnext = bP->buff; bend = bP->buff + bP->bsize;
+
+// Each item must fit into an otherwise empty buffer
+//
+   if (rlen <= 0 || rlen > bP->bsize - hdrSz) rlen = bP->bsize - hdrSz;
+   need = hdrSz + (rlen > errSz ? rlen : errSz);
+
+// Process each path
+//
+   while((path = pathlist.GetLine()))
+        {if (!*path) continue;
+         if (rpCheck(path, &opaque))
+            {BPool->Release(bP); return rpEmsg("Fetching", path);}
+         if (!(popt = Squash(path)))
+            {BPool->Release(bP); return vpEmsg("Fetching", path);}
+         SI->Bump(SI->openCnt);
+         TRACEP(FS, "fetch " <<path);
+
+// Send what we have so far if this item may not fit
+//
+         if (bend - bnext < need)
+            {if ((rc = Response.Send(kXR_oksofar, bP->buff, bnext-bP->buff)))
+                {BPool->Release(bP); return rc;}
+             bnext = bP->buff;
+            }
+         dP = bnext + hdrSz; fSize = 0; dlen = 0; ecode = 0; eText = 0;
+
+// Check if static redirection applies. Only the first file may redirect us.
+//
+         if (SFS_LCLPATH(path)
+         ||  (Route[RD_open1].Host[rdType] && (ropt = RPList.Validate(path))))
+            {if (isFirst && !SFS_LCLPATH(path))
+                {BPool->Release(bP);
+                 return Response.Send(kXR_redirect, Route[ropt].Port[rdType],
+                                                    Route[ropt].Host[rdType]);
+                }
+             ecode = kXR_Unsupported;
+            }
+
+// Open the file without allowing the file system to defer the response
+//
+         else if (!(fp = osFS->newFile(Link->ID, Monitor.Did)))
+                 {ecode = kXR_NoMemory; eText = "insufficient memory";}
+         else {fp->error.setUCap(clientPV);
+               tBeg = XrdXrootdLatency::Now();
+               rc = fp->open(path, SFS_O_RDONLY, 0, CRED, opaque);
+               XrdXrootdLatency::Done(XrdXrootdLatency::fsOpen, tBeg);
+               if (rc == SFS_ERROR)
+                  {eText = fp->error.getErrText(ecode);
+                   ecode = XProtocol::mapError(ecode);
+                  }
+               else if (rc && isFirst)
+                  {BPool->Release(bP);
+                   rc = fsError(rc, XROOTD_MON_OPENR, fp->error, path, opaque);
+                   delete fp;
+                   return rc;
+                  }
+               else if (rc) ecode = kXR_Unsupported;
+
+// Lock the file and read the leading bytes. Deleting the hyper file object
+// unlocks and closes the file.
+//
+               if (rc) {if (eText) {strlcpy(ebuff, eText, errSz); eText = ebuff;}
+                        delete fp;
+                       }
+               else if (!(xp = new XrdXrootdFile(Link->ID, fp, 'r', 0, 0,
+                                                 &statbuf)))
+                       {ecode = kXR_NoMemory; eText = "insufficient memory";
+                        delete fp;
+                       }
+               else if (!(popt & XROOTDXP_NOLK) && Locker->Lock(xp, 0))
+                       {ecode = kXR_FileLocked;
+                        eText = "file is already opened for writing";
+                        delete fp; xp->XrdSfsp = 0; delete xp;
+                       }
+               else {fSize = statbuf.st_size;
+                     if ((dlen = (fSize < rlen ? (int)fSize : rlen)))
+                        {numReads++;
+                         tBeg = XrdXrootdLatency::Now();
+                         dlen = fp->read(0, dP, dlen);
+                         XrdXrootdLatency::Done(XrdXrootdLatency::fsRead, tBeg);
+                         if (dlen < 0)
+                            {strlcpy(ebuff, fp->error.getErrText(ecode), errSz);
+                             ecode = XProtocol::mapError(ecode);
+                             eText = ebuff; dlen = 0;
+                            }
+                        }
+                     delete xp;
+                    }
+              }
+
+// Fill out the item. Errors are returned as a null terminated message.
+//
+         if (ecode)
+            {if (eText) strlcpy(dP, eText, errSz);
+                else snprintf(dP, errSz, "%s must be opened individually", path);
+             dlen = strlen(dP) + 1;
+             fSize = 0;
+             TRACEP(FS, "fetch " <<path <<" failed; " <<dP);
+            }
+         myItem.fsize  = htonll(fSize);
+         myItem.errnum = htonl(ecode);
+         myItem.dlen   = htonl(dlen);
+         memcpy(bnext, &myItem, hdrSz);
+         bnext = dP + dlen;
+         isFirst = false;
+        }
+
+// Send the final response
+//
+   rc = Response.Send(bP->buff, bnext-bP->buff);
+   BPool->Release(bP);
+   return rc;
+}
+
 /******************************************************************************/
 /*                            d o   G e t f i l e                             */
 /******************************************************************************/
@@ -1171,7 +1326,6 @@ int XrdXrootdProtocol::do_OffloadIO()
   
 int XrdXrootdProtocol::do_Open()
 {
-   static XrdXrootdCallBack openCB("open file", XROOTD_MON_OPENR);
    int fhandle;
    int rc, mode, opts, openopts, doforce = 0, compchk = 0;
    int popt, retStat = 0;
@@ -1179,11 +1333,13 @@ int XrdXrootdProtocol::do_Open()
    bool doDig;
    char *fn = argp->buff, opt[16], *op=opt, isAsync = '\0';
    XrdSfsFile *fp;
+   XrdXrootdOpenPend *opP = 0;
    XrdXrootdFile *xp;
    struct stat statbuf;
    struct ServerResponseBody_Open myResp;
    int resplen = sizeof(myResp.fhandle);
    struct iovec IOResp[3];  // Note that IOResp[0] is completed by Response
+   long long tBeg;
 
 // Keep Statistics
 //
@@ -1270,16 +1426,49 @@ int XrdXrootdProtocol::do_Open()
        return Response.Send(kXR_NoMemory, ebuff);
       }
 
-// The open is elegible for a defered response, indicate we're ok with that
+// The open is elegible for a defered response, indicate we're ok with that.
+// We also accept having the filesystem complete the open in the background.
 //
-   fp->error.setErrCB(&openCB, ReqID.getID());
-   fp->error.setUCap(clientPV);
+   fp->error.setErrCB(&OpenCB, ReqID.getID());
+   fp->error.setUCap(clientPV | (doDig ? 0 : XrdOucEI::uOpnCB));
+
+// Register a pending open before opening the file as the file system may
+// invoke the callback before open() returns.
+//
+   if (!doDig)
+      {opP = new XrdXrootdOpenPend(fp, fn);
+       opP->reqID = ReqID.getID();
+       OpenCB.Add(opP);
+      }
 
 // Open the file
 //
-   if ((rc = fp->open(fn, (XrdSfsFileOpenMode)openopts,
-                     (mode_t)mode, CRED, opaque)))
-      {rc = fsError(rc, opC, fp->error, fn, opaque); delete fp; return rc;}
+   tBeg = XrdXrootdLatency::Now();
+   rc = fp->open(fn, (XrdSfsFileOpenMode)openopts, (mode_t)mode, CRED, opaque);
+   XrdXrootdLatency::Done(XrdXrootdLatency::fsOpen, tBeg);
+
+// If the filesystem is completing the open in the background, reserve a file
+// handle and remember what we need to attach the file when the callback occurs.
+// The file object now belongs to the pending open. Otherwise, discard it.
+//
+   if (opP)
+      {if (rc != SFS_STARTED || !(fp->error.getUCap() & XrdOucEI::uOpnDF))
+          OpenCB.Cancel(opP);
+          else {if (!FTab) FTab = new XrdXrootdFileTable(Monitor.Did);
+                opP->fHandle = (FTab ? FTab->Reserve() : -1);
+                opP->pOpt    = popt;
+                opP->usage   = usage;
+                opP->isAsync = isAsync;
+                opP->doForce = (doforce != 0);
+                opP->retStat = (retStat != 0);
+                opP->compChk = (compchk != 0);
+                OpenCB.Arm(opP);
+                rc = fsError(rc, opC, fp->error, fn, opaque);
+                opP->Ready.Post();
+                return rc;
+               }
+      }
+   if (rc) {rc = fsError(rc, opC, fp->error, fn, opaque); delete fp; return rc;}
 
 // Obtain a hyper file object
 //
@@ -1614,6 +1803,10 @@ int XrdXrootdProtocol::do_Qconf()
                else n = snprintf(bp, bleft, "%s\n", "cms");
             bp += n; bleft -= n;
            }
+   else if (!strcmp("latency", val))
+           {n = XrdXrootdLatency::Format(bp, bleft, false);
+            bp += n; bleft -= n;
+           }
    else if (!strcmp("pio_max", val))
            {n = snprintf(bp, bleft, "%d\n", maxPio+1);
             bp += n; bleft -= n;
@@ -1714,6 +1907,7 @@ int XrdXrootdProtocol::do_Qfh()
                             rc = fp->XrdSfsp->fctl(SFS_FCTL_STATV, 0,
                                                    fp->XrdSfsp->error);
                             break;
+          case kXR_Qlocfd:  return do_Qlocfd(fp);
           default:          return Response.Send(kXR_ArgMissing, 
                                    "Required query argument not present");
          }
@@ -1729,6 +1923,42 @@ int XrdXrootdProtocol::do_Qfh()
    return Response.Send();
 }
   
+/******************************************************************************/
+/*                             d o _ Q l o c f d                              */
+/******************************************************************************/
+
+// Hand the descriptor of a file opened for reading to a client on this host.
+// The open was authorized as usual; the client reads the file directly.
+  
+int XrdXrootdProtocol::do_Qlocfd(XrdXrootdFile *fp)
+{
+   XrdNetAddr myAddr;
+   char buff[1024];
+   int rc;
+
+// Descriptors are only passed when enabled and for files opened for reading
+// that are backed by one.
+//
+   if (!XrdXrootdFdPass::Enabled())
+      return Response.Send(kXR_Unsupported, "local fd passing is not enabled");
+   if (fp->FileMode != 'r' || fp->fdNum < 0)
+      return Response.Send(kXR_Unsupported, "file can not be read locally");
+
+// The client must be running on this host
+//
+   if (!Link->AddrInfo()->isLoopback()
+   &&  (myAddr.Set(Link->FDnum(), false) || !myAddr.Same(Link->AddrInfo())))
+      return Response.Send(kXR_NotAuthorized, "client is not local");
+
+// File the descriptor and tell the client where to pick it up
+//
+   rc = XrdXrootdFdPass::Offer(fp->fdNum, buff, sizeof(buff));
+   TRACEP(FS, "query Qlocfd rc=" <<rc <<" fd=" <<fp->fdNum);
+   if (rc < 0) return Response.Send((XErrorCode)XProtocol::mapError(-rc),
+                                    strerror(-rc));
+   return Response.Send(buff, rc);
+}
+
 /******************************************************************************/
 /*                            d o _ Q o p a q u e                             */
 /******************************************************************************/
@@ -1982,7 +2212,7 @@ int XrdXrootdProtocol::do_ReadAll(int asyncOK)
 // amount of the request even if we really do not get to read that much!
 //
    myFile->Stats.rdOps(myIOLen);
-   do {if ((xframt = myFile->XrdSfsp->read(myOffset, buff, Quantum)) <= 0) break;
+   do {if ((xframt = fsRead(buff, Quantum)) <= 0) break;
        if (xframt >= myIOLen) return Response.Send(buff, xframt);
        if (Response.Send(kXR_oksofar, buff, xframt) < 0) return -1;
        myOffset += xframt; myIOLen -= xframt;
@@ -2147,7 +2377,7 @@ int XrdXrootdProtocol::do_ReadV()
 //
    for (i = 0; i < rdVecNum; i++)
        {if (rdVec[i].info != currFH)
-           {xfrSZ = myFile->XrdSfsp->readv(&rdVec[rdVNow], i-rdVNow);
+           {xfrSZ = fsReadV(&rdVec[rdVNow], i-rdVNow);
             if (xfrSZ != rdVAmt) break;
             rdVNum = i - rdVBeg; rdVXfr += rdVAmt;
             myFile->Stats.rvOps(rdVXfr, rdVNum);
@@ -2169,7 +2399,7 @@ int XrdXrootdProtocol::do_ReadV()
 
         if (Qleft < (rdVec[i].size + hdrSZ))
            {if (rdVAmt)
-               {xfrSZ = myFile->XrdSfsp->readv(&rdVec[rdVNow], i-rdVNow);
+               {xfrSZ = fsReadV(&rdVec[rdVNow], i-rdVNow);
                 if (xfrSZ != rdVAmt) break;
                }
             if (Response.Send(kXR_oksofar,argp->buff,Quantum-Qleft) < 0)
@@ -2461,6 +2691,7 @@ int XrdXrootdProtocol::do_Statx()
 int XrdXrootdProtocol::do_Sync()
 {
    static XrdXrootdCallBack syncCB("sync", 0);
+   long long tBeg;
    int rc;
    XrdXrootdFile *fp;
    XrdXrootdFHandle fh(Request.sync.fhandle);
@@ -2480,7 +2711,9 @@ int XrdXrootdProtocol::do_Sync()
 
 // Sync the file
 //
+   tBeg = XrdXrootdLatency::Now();
    rc = fp->XrdSfsp->sync();
+   XrdXrootdLatency::Done(XrdXrootdLatency::fsSync, tBeg);
    TRACEP(FS, "sync rc=" <<rc <<" fh=" <<fh.handle);
    if (SFS_OK != rc) return fsError(rc, 0, fp->XrdSfsp->error, 0, 0);
 
@@ -2648,7 +2881,7 @@ int XrdXrootdProtocol::do_WriteAll()
                 }
              return rc;
             }
-         if ((rc = myFile->XrdSfsp->write(myOffset, argp->buff, Quantum)) < 0)
+         if ((rc = fsWrite(argp->buff, Quantum)) < 0)
             {myIOLen  = myIOLen-Quantum; myEInfo[0] = rc;
              return do_WriteNone();
             }
@@ -2676,7 +2909,7 @@ int XrdXrootdProtocol::do_WriteCont()
 
 // Write data that was finaly finished comming in
 //
-   if ((rc = myFile->XrdSfsp->write(myOffset, argp->buff, myBlast)) < 0)
+   if ((rc = fsWrite(argp->buff, myBlast)) < 0)
       {myIOLen  = myIOLen-myBlast; myEInfo[0] = rc;
        return do_WriteNone();
       }
@@ -2755,7 +2988,7 @@ int XrdXrootdProtocol::do_WriteSpan()
 
 // Write data that was already read
 //
-   if ((rc = myFile->XrdSfsp->write(myOffset, myBuff, myBlast)) < 0)
+   if ((rc = fsWrite(myBuff, myBlast)) < 0)
       {myIOLen  = myIOLen-myBlast; myEInfo[0] = rc;
        return do_WriteNone();
       }
@@ -2859,6 +3092,7 @@ int XrdXrootdProtocol::fsError(int rc, char opC, XrdOucErrInfo &myError,
            XrdXrootdMonitor::Redirect(Monitor.Did, eMsg, Port, opC, Path);
        TRACEI(REDIR, Response.ID() <<"redirecting to " << eMsg <<':' <<ecode);
        rs = Response.Send(kXR_redirect, ecode, eMsg, myError.getErrTextLen());
+       XrdXrootdLatency::Done(XrdXrootdLatency::xRedir, reqStart);
        if (myError.extData()) myError.Reset();
        return rs;
       }
@@ -2919,6 +3153,34 @@ int XrdXrootdProtocol::fsError(int rc, char opC, XrdOucErrInfo &myError,
    }
 }
 
+/******************************************************************************/
+/*                                f s R e a d                                 */
+/******************************************************************************/
+
+// Read from the current file at the current offset, noting the latency
+  
+int XrdXrootdProtocol::fsRead(char *buff, int blen)
+{
+   long long tBeg = XrdXrootdLatency::Now();
+   int rc = myFile->XrdSfsp->read(myOffset, buff, blen);
+
+   XrdXrootdLatency::Done(XrdXrootdLatency::fsRead, tBeg);
+   return rc;
+}
+
+/******************************************************************************/
+/*                               f s R e a d V                                */
+/******************************************************************************/
+  
+int XrdXrootdProtocol::fsReadV(XrdOucIOVec *rdV, int rdVnum)
+{
+   long long tBeg = XrdXrootdLatency::Now();
+   int rc = myFile->XrdSfsp->readv(rdV, rdVnum);
+
+   XrdXrootdLatency::Done(XrdXrootdLatency::fsReadV, tBeg);
+   return rc;
+}
+
 /******************************************************************************/
 /*                               f s R e d i r                                */
 /******************************************************************************/
@@ -3013,6 +3275,21 @@ int XrdXrootdProtocol::fsRedirNoEnt(const char *eMsg, char *Cgi, int popt)
    return Response.Send(kXR_redirect, ioV, 4, tlen);
 }
 
+/******************************************************************************/
+/*                               f s W r i t e                                */
+/******************************************************************************/
+
+// Write to the current file at the current offset, noting the latency
+  
+int XrdXrootdProtocol::fsWrite(const char *buff, int blen)
+{
+   long long tBeg = XrdXrootdLatency::Now();
+   int rc = myFile->XrdSfsp->write(myOffset, buff, blen);
+
+   XrdXrootdLatency::Done(XrdXrootdLatency::fsWrite, tBeg);
+   return rc;
+}
+
 /******************************************************************************/
 /*                               g e t B u f f                                */
 /******************************************************************************/
@@ -3122,6 +3399,124 @@ void XrdXrootdProtocol::MonAuth()
    if (Entity.moninfo) {free(Entity.moninfo); Entity.moninfo = 0;}
 }
   
+/******************************************************************************/
+/*                              o p e n D o n e                               */
+/******************************************************************************/
+
+// Called via the scheduler when the filesystem completes an open that it was
+// doing in the background. Returns true if the file was attached to the link.
+// The request lock is held so that the link cannot be processing a request
+// that uses the same file table, monitor or file count while we attach it.
+
+bool XrdXrootdProtocol::openDone(XrdXrootdOpenPend *opP)
+{
+   XrdSysMutexHelper reqLock(reqMutex);
+   XrdXrootdCallBack *cbP = XrdXrootdOpenCB::dfltCB;
+   XrdOucErrInfo     *eInfo = opP->eInfo;
+   XrdSfsFile        *fp = opP->fileP;
+   const char        *fn = opP->Path;
+   XrdXrootdFile *xp;
+   struct stat statbuf;
+   struct ServerResponseBody_Open myResp;
+   int resplen, fhandle = opP->fHandle, ecode = kXR_NoMemory, rc;
+   struct iovec IOResp[3];  // Note that IOResp[0] is completed by sendVesp
+   char ebuff[2048];
+
+// If the open failed, release the file handle and tell the client why
+//
+   if (opP->Result != SFS_OK)
+      {if (fhandle >= 0) FTab->Del(fhandle);
+       cbP->sendError(opP->Result, eInfo, fn);
+       return false;
+      }
+
+// Obtain a hyper file object
+//
+   if (fhandle < 0
+   || !(xp=new XrdXrootdFile(Link->ID,fp,opP->usage,opP->isAsync,
+                                        Link->sfOK,&statbuf)))
+      {if (fhandle >= 0) FTab->Del(fhandle);
+       snprintf(ebuff, sizeof(ebuff)-1, "Insufficient memory to open %s", fn);
+       eDest.Emsg("Xeq", ebuff);
+       cbP->sendResp(eInfo, kXR_error, &ecode, ebuff, strlen(ebuff)+1);
+       return false;
+      }
+
+// Lock this file
+//
+   if (!(opP->pOpt & XROOTDXP_NOLK) && (rc = Locker->Lock(xp, opP->doForce)))
+      {const char *who;
+       if (rc > 0) who = (rc > 1 ? "readers" : "reader");
+          else {   rc = -rc;
+                   who = (rc > 1 ? "writers" : "writer");
+               }
+       snprintf(ebuff, sizeof(ebuff)-1,
+                "%s file %s is already opened by %d %s; open denied.",
+                ('r' == opP->usage ? "Input" : "Output"), fn, rc, who);
+       xp->XrdSfsp = 0; delete xp;
+       FTab->Del(fhandle);
+       eDest.Emsg("Xeq", ebuff);
+       ecode = kXR_FileLocked;
+       cbP->sendResp(eInfo, kXR_error, &ecode, ebuff, strlen(ebuff)+1);
+       return false;
+      }
+
+// Insert this file into the handle we reserved for it
+//
+   FTab->Fill(fhandle, xp);
+
+// Document forced opens
+//
+   if (opP->doForce)
+      {int rdrs, wrtrs;
+       Locker->numLocks(xp, rdrs, wrtrs);
+       if (('r' == opP->usage && wrtrs) || ('w' == opP->usage && rdrs)
+       ||  wrtrs > 1)
+          {snprintf(ebuff, sizeof(ebuff)-1,
+             "%s file %s forced opened with %d reader(s) and %d writer(s).",
+             ('r' == opP->usage ? "Input" : "Output"), fn, rdrs, wrtrs);
+           eDest.Emsg("Xeq", ebuff);
+          }
+      }
+
+// Determine if file is compressed
+//
+   memset(&myResp, 0, sizeof(myResp));
+   resplen = sizeof(myResp.fhandle);
+   if (opP->compChk)
+      {int cpsize;
+       fp->getCXinfo((char *)myResp.cptype, cpsize);
+       if (cpsize) {myResp.cpsize = static_cast<kXR_int32>(htonl(cpsize));
+                    resplen = sizeof(myResp);
+                   }
+      }
+
+// If we are monitoring, send off a path to dictionary mapping (must try 1st!)
+//
+   if (Monitor.Files())
+      {xp->Stats.FileID = Monitor.MapPath(fn);
+       if (!(xp->Stats.monLvl)) xp->Stats.monLvl = XrdXrootdFileStats::monOn;
+       Monitor.Agent->Open(xp->Stats.FileID, statbuf.st_size);
+      }
+   if (Monitor.Fstat())
+      XrdXrootdMonFile::Open(&(xp->Stats), fn, Monitor.Did, opP->usage == 'w');
+
+// Insert the file handle
+//
+   memcpy((void *)myResp.fhandle,(const void *)&fhandle,sizeof(myResp.fhandle));
+   numFiles++;
+
+// Respond, including the stat information if the client wants it
+//
+   IOResp[1].iov_base = (char *)&myResp; IOResp[1].iov_len = resplen;
+   if (opP->retStat)
+      {IOResp[1].iov_len = sizeof(myResp);
+       IOResp[2].iov_base = ebuff; IOResp[2].iov_len = StatGen(statbuf, ebuff);
+       cbP->sendVesp(eInfo, kXR_ok, IOResp, 3);
+      } else cbP->sendVesp(eInfo, kXR_ok, IOResp, 2);
+   return true;
+}
+
 /******************************************************************************/
 /*                               r p C h e c k                                */
 /******************************************************************************/
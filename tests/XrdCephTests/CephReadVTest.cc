@@ -0,0 +1,207 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2018 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <XrdCeph/XrdCephPosix.hh>
+#include <algorithm>
+#include <errno.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#define MB 1024*1024
+struct CephFile {
+  std::string name;
+  std::string pool;
+  std::string userId;
+  unsigned int nbStripes;
+  unsigned long long stripeUnit;
+  unsigned long long objectSize;
+};
+ssize_t ceph_posix_internal_readv(CephAioReader &reader, const CephFile &file,
+                                  XrdOucIOVec *readV, int n);
+
+//------------------------------------------------------------------------------
+// In-memory stand-in for the object store
+//------------------------------------------------------------------------------
+class MemReader : public CephAioReader {
+public:
+  MemReader(const std::string &content) :
+    m_content(content), m_failStart(-1), m_failWait(-1), m_nbWaits(0) {}
+  virtual int start(size_t count, off64_t offset) {
+    // nothing may be waited for before all reads are started
+    CPPUNIT_ASSERT(0 == m_nbWaits);
+    if ((int)m_reads.size() == m_failStart) return -EIO;
+    m_reads.push_back(std::make_pair((unsigned long long)offset, count));
+    return 0;
+  }
+  virtual ssize_t wait(unsigned int idx) {
+    CPPUNIT_ASSERT(idx < m_reads.size());
+    m_nbWaits++;
+    if ((int)idx == m_failWait) return -EIO;
+    if (m_reads[idx].first >= m_content.size()) return 0;
+    return std::min((unsigned long long)m_reads[idx].second,
+                    (unsigned long long)m_content.size() - m_reads[idx].first);
+  }
+  virtual void copy(unsigned int idx, size_t pos, size_t len, char *buf) {
+    memcpy(buf, m_content.data() + m_reads[idx].first + pos, len);
+  }
+  std::string m_content;
+  std::vector<std::pair<unsigned long long, size_t> > m_reads;
+  int m_failStart;
+  int m_failWait;
+  unsigned int m_nbWaits;
+};
+
+//------------------------------------------------------------------------------
+// Declaration
+//------------------------------------------------------------------------------
+class CephReadVTest: public CppUnit::TestCase
+{
+  public:
+    CPPUNIT_TEST_SUITE( CephReadVTest );
+      CPPUNIT_TEST( CoalesceTest );
+      CPPUNIT_TEST( StripeTest );
+      CPPUNIT_TEST( ErrorTest );
+    CPPUNIT_TEST_SUITE_END();
+    void CoalesceTest();
+    void StripeTest();
+    void ErrorTest();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( CephReadVTest );
+
+//------------------------------------------------------------------------------
+// Helper functions
+//------------------------------------------------------------------------------
+static std::string makeContent(size_t size) {
+  std::string content(size, 0);
+  for (size_t i = 0; i < size; i++) content[i] = (char)(i * 7 + i / 251);
+  return content;
+}
+
+static ssize_t doReadV(MemReader &reader, const CephFile &file,
+                       const std::vector<std::pair<long long, int> > &segs,
+                       std::vector<std::string> &bufs) {
+  std::vector<XrdOucIOVec> readV(segs.size());
+  bufs.assign(segs.size(), std::string());
+  for (unsigned int i = 0; i < segs.size(); i++) {
+    bufs[i].resize(segs[i].second + 1);
+    readV[i].offset = segs[i].first;
+    readV[i].size = segs[i].second;
+    readV[i].info = 0;
+    readV[i].data = &bufs[i][0];
+  }
+  ssize_t rc = ceph_posix_internal_readv(reader, file, &readV[0], readV.size());
+  for (unsigned int i = 0; i < segs.size(); i++) bufs[i].resize(segs[i].second);
+  return rc;
+}
+
+static void checkData(const MemReader &reader,
+                      const std::vector<std::pair<long long, int> > &segs,
+                      const std::vector<std::string> &bufs) {
+  for (unsigned int i = 0; i < segs.size(); i++) {
+    CPPUNIT_ASSERT(bufs[i] == reader.m_content.substr(segs[i].first, segs[i].second));
+  }
+}
+
+//------------------------------------------------------------------------------
+// Coalescing test
+//------------------------------------------------------------------------------
+void CephReadVTest::CoalesceTest() {
+  CephFile file = {"f", "default", "admin", 1, 4*MB, 4*MB};
+  MemReader reader(makeContent(10*MB));
+  std::vector<std::pair<long long, int> > segs;
+  std::vector<std::string> bufs;
+  // unordered and overlapping segments of the first object and one segment
+  // of the third object; a segment far from the others in the first object
+  segs.push_back(std::make_pair(1000LL, 100));
+  segs.push_back(std::make_pair(8*MB + 5LL, 10));
+  segs.push_back(std::make_pair(0LL, 10));
+  segs.push_back(std::make_pair(1050LL, 2000));
+  segs.push_back(std::make_pair(100000LL, 0));
+  segs.push_back(std::make_pair(3*MB + 10LL, 16));
+  ssize_t rc = doReadV(reader, file, segs, bufs);
+  CPPUNIT_ASSERT(rc == 10 + 100 + 2000 + 10 + 16);
+  checkData(reader, segs, bufs);
+  CPPUNIT_ASSERT(reader.m_reads.size() == 3);
+  CPPUNIT_ASSERT(reader.m_reads[0].first == 0);
+  CPPUNIT_ASSERT(reader.m_reads[0].second == 3050);
+  CPPUNIT_ASSERT(reader.m_reads[1].first == 3*MB + 10);
+  CPPUNIT_ASSERT(reader.m_reads[2].first == 8*MB + 5);
+  CPPUNIT_ASSERT(reader.m_nbWaits == 3);
+  // segments on both sides of an object boundary are read separately
+  MemReader reader2(makeContent(10*MB));
+  segs.clear();
+  segs.push_back(std::make_pair(4*MB - 10LL, 10));
+  segs.push_back(std::make_pair(4*MB + 0LL, 10));
+  rc = doReadV(reader2, file, segs, bufs);
+  CPPUNIT_ASSERT(rc == 20);
+  checkData(reader2, segs, bufs);
+  CPPUNIT_ASSERT(reader2.m_reads.size() == 2);
+}
+
+//------------------------------------------------------------------------------
+// Striping test
+//------------------------------------------------------------------------------
+void CephReadVTest::StripeTest() {
+  // with several stripes, consecutive stripe units live in different objects
+  CephFile file = {"f", "default", "admin", 4, 64*1024, 4*MB};
+  MemReader reader(makeContent(MB));
+  std::vector<std::pair<long long, int> > segs;
+  std::vector<std::string> bufs;
+  segs.push_back(std::make_pair(10LL, 10));
+  segs.push_back(std::make_pair(100LL, 10));
+  segs.push_back(std::make_pair(64*1024 + 10LL, 10));
+  segs.push_back(std::make_pair(64*1024 - 5LL, 10));
+  ssize_t rc = doReadV(reader, file, segs, bufs);
+  CPPUNIT_ASSERT(rc == 40);
+  checkData(reader, segs, bufs);
+  CPPUNIT_ASSERT(reader.m_reads.size() == 3);
+  CPPUNIT_ASSERT(reader.m_reads[0].first == 10);
+  CPPUNIT_ASSERT(reader.m_reads[0].second == 100);
+  CPPUNIT_ASSERT(reader.m_reads[1].first == 64*1024 - 5);
+  CPPUNIT_ASSERT(reader.m_reads[1].second == 10);
+}
+
+//------------------------------------------------------------------------------
+// Error test
+//------------------------------------------------------------------------------
+void CephReadVTest::ErrorTest() {
+  CephFile file = {"f", "default", "admin", 1, 4*MB, 4*MB};
+  std::vector<std::pair<long long, int> > segs;
+  std::vector<std::string> bufs;
+  segs.push_back(std::make_pair(10LL, 10));
+  segs.push_back(std::make_pair(5*MB + 0LL, 10));
+  // reading past the end of the file
+  MemReader shortReader(makeContent(5*MB + 5));
+  CPPUNIT_ASSERT(doReadV(shortReader, file, segs, bufs) == -ESPIPE);
+  // failure to start a read, the started ones are still waited for
+  MemReader startReader(makeContent(10*MB));
+  startReader.m_failStart = 1;
+  CPPUNIT_ASSERT(doReadV(startReader, file, segs, bufs) == -EIO);
+  CPPUNIT_ASSERT(startReader.m_nbWaits == 1);
+  // failure of a read
+  MemReader waitReader(makeContent(10*MB));
+  waitReader.m_failWait = 1;
+  CPPUNIT_ASSERT(doReadV(waitReader, file, segs, bufs) == -EIO);
+  // invalid segment
+  MemReader badReader(makeContent(10*MB));
+  segs.push_back(std::make_pair(-1LL, 10));
+  CPPUNIT_ASSERT(doReadV(badReader, file, segs, bufs) == -EINVAL);
+  CPPUNIT_ASSERT(badReader.m_reads.empty());
+}
@@ -51,6 +51,7 @@ class FileSystemTest: public CppUnit::TestCase
       CPPUNIT_TEST( DirListTest );
       CPPUNIT_TEST( SendInfoTest );
       CPPUNIT_TEST( PrepareTest );
+      CPPUNIT_TEST( FetchTest );
       CPPUNIT_TEST( PlugInTest );
     CPPUNIT_TEST_SUITE_END();
     void LocateTest();
@@ -67,6 +68,7 @@ class FileSystemTest: public CppUnit::TestCase
     void DirListTest();
     void SendInfoTest();
     void PrepareTest();
+    void FetchTest();
     void PlugInTest();
 };
 
@@ -496,6 +498,47 @@ void FileSystemTest::PrepareTest()
   delete id;
 }
 
+//------------------------------------------------------------------------------
+// Fetch test
+//------------------------------------------------------------------------------
+void FileSystemTest::FetchTest()
+{
+  using namespace XrdCl;
+
+  Env *testEnv = TestEnv::GetEnv();
+
+  std::string address;
+  std::string remoteFile;
+
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "RemoteFile",    remoteFile ) );
+
+  URL url( address );
+  CPPUNIT_ASSERT( url.IsValid() );
+
+  FileSystem fs( url );
+  FetchInfo *response = 0;
+  std::vector<std::string> list;
+  list.push_back( remoteFile );
+  list.push_back( remoteFile + ".doesnotexist" );
+
+  CPPUNIT_ASSERT_XRDST( fs.Fetch( list, 4096, response ) );
+  CPPUNIT_ASSERT( response );
+  CPPUNIT_ASSERT( response->GetSize() == 2 );
+
+  FetchInfo::FetchEntry &e1 = response->At( 0 );
+  CPPUNIT_ASSERT( e1.GetPath() == remoteFile );
+  CPPUNIT_ASSERT_XRDST( e1.GetStatus() );
+  CPPUNIT_ASSERT( e1.GetSize() == 1048576000 );
+  CPPUNIT_ASSERT( e1.GetData().size() == 4096 );
+  CPPUNIT_ASSERT( !e1.IsComplete() );
+
+  FetchInfo::FetchEntry &e2 = response->At( 1 );
+  CPPUNIT_ASSERT( !e2.GetStatus().IsOK() );
+  CPPUNIT_ASSERT( e2.GetStatus().errNo == kXR_NotFound );
+  delete response;
+}
+
 //------------------------------------------------------------------------------
 // Plug-in test
 //------------------------------------------------------------------------------
@@ -49,6 +49,7 @@ class FileTest: public CppUnit::TestCase
       CPPUNIT_TEST( VectorReadTest );
       CPPUNIT_TEST( VirtualRedirectorTest );
       CPPUNIT_TEST( PlugInTest );
+      CPPUNIT_TEST( ProxyOpenTest );
     CPPUNIT_TEST_SUITE_END();
     void RedirectReturnTest();
     void ReadTest();
@@ -56,6 +57,7 @@ class FileTest: public CppUnit::TestCase
     void VectorReadTest();
     void VirtualRedirectorTest();
     void PlugInTest();
+    void ProxyOpenTest();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION( FileTest );
@@ -498,3 +500,80 @@ void FileTest::PlugInTest()
   VectorReadTest();
   XrdCl::DefaultEnv::GetPlugInManager()->RegisterDefaultFactory(0);
 }
+
+//------------------------------------------------------------------------------
+// Proxy open test
+//------------------------------------------------------------------------------
+void FileTest::ProxyOpenTest()
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Initialize
+  //----------------------------------------------------------------------------
+  Env *testEnv = TestEnv::GetEnv();
+
+  std::string address;
+  std::string dataPath;
+
+  CPPUNIT_ASSERT( testEnv->GetString( "ProxyServerURL", address ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "DataPath", dataPath ) );
+
+  std::string fileUrl = address + "/" + dataPath;
+  fileUrl += "/cb4aacf1-6f28-42f2-b68a-90a73460f424.dat";
+
+  //----------------------------------------------------------------------------
+  // The proxy opens files at the origin in the background and attaches them
+  // to the link when done, so have several opens outstanding at once
+  //----------------------------------------------------------------------------
+  const int nFiles = 4;
+  File                f[nFiles];
+  SyncResponseHandler h[nFiles];
+
+  for( int i = 0; i < nFiles; ++i )
+    CPPUNIT_ASSERT_XRDST( f[i].Open( fileUrl, OpenFlags::Read, Access::None,
+                                     &h[i] ) );
+
+  for( int i = 0; i < nFiles; ++i )
+  {
+    h[i].WaitForResponse();
+    XRootDStatus *status = h[i].GetStatus();
+    CPPUNIT_ASSERT( status );
+    CPPUNIT_ASSERT_XRDST( *status );
+    delete status;
+    delete h[i].GetResponse();
+  }
+
+  //----------------------------------------------------------------------------
+  // Each file must have its own handle with the stat information that came
+  // with the open and must be readable
+  //----------------------------------------------------------------------------
+  char     buffer[nFiles][64];
+  uint32_t bytesRead;
+
+  for( int i = 0; i < nFiles; ++i )
+  {
+    StatInfo *stat = 0;
+    CPPUNIT_ASSERT_XRDST( f[i].Stat( false, stat ) );
+    CPPUNIT_ASSERT( stat );
+    CPPUNIT_ASSERT( stat->GetSize() == 1048576000 );
+    delete stat;
+
+    CPPUNIT_ASSERT_XRDST( f[i].Read( 10*1024*1024, sizeof(buffer[i]),
+                                     buffer[i], bytesRead ) );
+    CPPUNIT_ASSERT( bytesRead == sizeof(buffer[i]) );
+    CPPUNIT_ASSERT( !memcmp( buffer[0], buffer[i], sizeof(buffer[i]) ) );
+  }
+
+  for( int i = 0; i < nFiles; ++i )
+    CPPUNIT_ASSERT_XRDST( f[i].Close() );
+
+  //----------------------------------------------------------------------------
+  // A failed background open must be reported as such
+  //----------------------------------------------------------------------------
+  File f1;
+  XRootDStatus status = f1.Open( address + "/" + dataPath + "/nonexistent",
+                                 OpenFlags::Read );
+  CPPUNIT_ASSERT_XRDST_NOTOK( status, errErrorResponse );
+  CPPUNIT_ASSERT( status.errNo == kXR_NotFound );
+}
@@ -27,8 +27,18 @@
 #include "XrdCl/XrdClURL.hh"
 #include "XrdCl/XrdClAnyObject.hh"
 #include "XrdCl/XrdClTaskManager.hh"
+#include "XrdCl/XrdClJobManager.hh"
 #include "XrdCl/XrdClSIDManager.hh"
 #include "XrdCl/XrdClPropertyList.hh"
+#include "XrdCl/XrdClUtils.hh"
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
 
 //------------------------------------------------------------------------------
 // Declaration
@@ -40,14 +50,18 @@ class UtilsTest: public CppUnit::TestCase
       CPPUNIT_TEST( URLTest );
       CPPUNIT_TEST( AnyTest );
       CPPUNIT_TEST( TaskManagerTest );
+      CPPUNIT_TEST( JobManagerTest );
       CPPUNIT_TEST( SIDManagerTest );
       CPPUNIT_TEST( PropertyListTest );
+      CPPUNIT_TEST( LocalFdTest );
     CPPUNIT_TEST_SUITE_END();
     void URLTest();
     void AnyTest();
     void TaskManagerTest();
+    void JobManagerTest();
     void SIDManagerTest();
     void PropertyListTest();
+    void LocalFdTest();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION( UtilsTest );
@@ -372,6 +386,87 @@ void UtilsTest::TaskManagerTest()
   CPPUNIT_ASSERT( taskMan.Stop() );
 }
 
+//------------------------------------------------------------------------------
+// Job Manager test helpers
+//------------------------------------------------------------------------------
+class TestJob: public XrdCl::Job
+{
+  public:
+    TestJob( XrdSysMutex &mutex, uint32_t &runs ):
+      pMutex( mutex ), pRuns( runs ) {}
+
+    virtual void Run( void *arg )
+    {
+      XrdSysMutexHelper scopedLock( pMutex );
+      ++pRuns;
+    }
+  private:
+    XrdSysMutex &pMutex;
+    uint32_t    &pRuns;
+};
+
+struct JobProducer
+{
+  XrdCl::JobManager *manager;
+  XrdCl::Job        *job;
+  uint32_t           count;
+};
+
+extern "C"
+{
+  static void *RunJobProducer( void *arg )
+  {
+    JobProducer *p = (JobProducer*)arg;
+    for( uint32_t i = 0; i < p->count; ++i )
+      p->manager->QueueJob( p->job );
+    return 0;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Job Manager test
+//------------------------------------------------------------------------------
+void UtilsTest::JobManagerTest()
+{
+  using namespace XrdCl;
+
+  XrdSysMutex  mutex;
+  uint32_t     runs = 0;
+  TestJob      job( mutex, runs );
+  JobManager   jobMan( 2, 8, 1000 );
+
+  //----------------------------------------------------------------------------
+  // Queue more jobs than the worker queues hold from several threads
+  //----------------------------------------------------------------------------
+  const uint32_t numProducers = 4;
+  const uint32_t numJobs      = 5000;
+  pthread_t      producers[numProducers];
+  JobProducer    producer = { &jobMan, &job, numJobs };
+
+  CPPUNIT_ASSERT( jobMan.Initialize() );
+  CPPUNIT_ASSERT( jobMan.Start() );
+  for( uint32_t i = 0; i < numProducers; ++i )
+    CPPUNIT_ASSERT( ::pthread_create( &producers[i], 0, RunJobProducer,
+                                      &producer ) == 0 );
+  for( uint32_t i = 0; i < numProducers; ++i )
+    ::pthread_join( producers[i], 0 );
+
+  for( int i = 0; i < 100; ++i )
+  {
+    XrdSysMutexHelper scopedLock( mutex );
+    if( runs == numProducers*numJobs )
+      break;
+    scopedLock.UnLock();
+    ::usleep( 100000 );
+  }
+
+  CPPUNIT_ASSERT( runs == numProducers*numJobs );
+  CPPUNIT_ASSERT( jobMan.GetNumWorkers() >= 2 );
+  CPPUNIT_ASSERT( jobMan.GetNumWorkers() <= 8 );
+  CPPUNIT_ASSERT( jobMan.Stop() );
+  CPPUNIT_ASSERT( jobMan.Finalize() );
+}
+
 //------------------------------------------------------------------------------
 // SID Manager test
 //------------------------------------------------------------------------------
@@ -459,3 +554,133 @@ void UtilsTest::PropertyListTest()
   for( size_t i = 0; i < v1.size(); ++i )
     CPPUNIT_ASSERT( v1[i] == v2[i] );
 }
+
+//------------------------------------------------------------------------------
+// Local descriptor test helpers, a stand-in for the server side of kXR_Qlocfd
+// that passes fd for the token "good", refuses "bad" and never answers "slow"
+//------------------------------------------------------------------------------
+struct FdServer
+{
+  int listenFd;
+  int fd;
+  int conns;
+};
+
+extern "C"
+{
+  static void *RunFdServer( void *arg )
+  {
+    FdServer *srv = (FdServer*)arg;
+    for( int i = 0; i < srv->conns; ++i )
+    {
+      int conn = ::accept( srv->listenFd, 0, 0 );
+      if( conn < 0 )
+        break;
+
+      char    token[16];
+      ssize_t len = ::read( conn, token, sizeof( token ) - 1 );
+      token[len > 0 ? len : 0] = 0;
+      if( !strcmp( token, "slow" ) )
+      {
+        while( ::read( conn, token, sizeof( token ) ) > 0 ) {}
+        ::close( conn );
+        continue;
+      }
+
+      union { struct cmsghdr hdr;
+              char           buff[CMSG_SPACE(sizeof(int))]; } cmsg;
+      struct msghdr msg;
+      struct iovec  iov;
+      char          ok = 'n';
+      memset( &msg, 0, sizeof( msg ) );
+      iov.iov_base = &ok; iov.iov_len = 1;
+      msg.msg_iov    = &iov;
+      msg.msg_iovlen = 1;
+      if( !strcmp( token, "good" ) )
+      {
+        ok = 'y';
+        msg.msg_control    = cmsg.buff;
+        msg.msg_controllen = sizeof( cmsg.buff );
+        struct cmsghdr *cP = CMSG_FIRSTHDR( &msg );
+        cP->cmsg_level = SOL_SOCKET;
+        cP->cmsg_type  = SCM_RIGHTS;
+        cP->cmsg_len   = CMSG_LEN( sizeof( int ) );
+        memcpy( CMSG_DATA( cP ), &srv->fd, sizeof( int ) );
+      }
+      ::sendmsg( conn, &msg, 0 );
+      ::close( conn );
+    }
+    return 0;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Local descriptor test
+//------------------------------------------------------------------------------
+void UtilsTest::LocalFdTest()
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Create the file to be passed and the socket to pass it through
+  //----------------------------------------------------------------------------
+  char dir[] = "/tmp/xrdcl-localfd-XXXXXX";
+  CPPUNIT_ASSERT_ERRNO( ::mkdtemp( dir ) );
+  std::string file = std::string( dir ) + "/data";
+  std::string path = std::string( dir ) + "/sock";
+
+  FdServer srv;
+  srv.fd = ::open( file.c_str(), O_RDWR | O_CREAT, 0600 );
+  CPPUNIT_ASSERT_ERRNO( srv.fd >= 0 );
+  CPPUNIT_ASSERT( ::write( srv.fd, "local", 5 ) == 5 );
+
+  struct sockaddr_un sun;
+  memset( &sun, 0, sizeof( sun ) );
+  sun.sun_family = AF_UNIX;
+  strcpy( sun.sun_path, path.c_str() );
+  srv.listenFd = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+  CPPUNIT_ASSERT_ERRNO( srv.listenFd >= 0 );
+  CPPUNIT_ASSERT_ERRNO( !::bind( srv.listenFd, (struct sockaddr*)&sun,
+                                 sizeof( sun ) ) );
+  CPPUNIT_ASSERT_ERRNO( !::listen( srv.listenFd, 4 ) );
+  srv.conns = 3;
+
+  pthread_t thread;
+  CPPUNIT_ASSERT_PTHREAD( ::pthread_create( &thread, 0, RunFdServer, &srv ) );
+
+  //----------------------------------------------------------------------------
+  // Malformed offers and missing sockets fail right away
+  //----------------------------------------------------------------------------
+  CPPUNIT_ASSERT( Utils::FetchLocalFd( "", 500 ) == -EINVAL );
+  CPPUNIT_ASSERT( Utils::FetchLocalFd( path, 500 ) == -EINVAL );
+  CPPUNIT_ASSERT( Utils::FetchLocalFd( path + "x good", 500 ) < 0 );
+
+  //----------------------------------------------------------------------------
+  // The descriptor refers to the very same file
+  //----------------------------------------------------------------------------
+  int fd = Utils::FetchLocalFd( path + " good", 500 );
+  CPPUNIT_ASSERT( fd >= 0 );
+  char buff[8];
+  CPPUNIT_ASSERT( ::pread( fd, buff, sizeof( buff ), 0 ) == 5 );
+  CPPUNIT_ASSERT( !memcmp( buff, "local", 5 ) );
+  CPPUNIT_ASSERT( fcntl( fd, F_GETFD ) & FD_CLOEXEC );
+  ::close( fd );
+
+  //----------------------------------------------------------------------------
+  // A refusal and a server that does not answer in time
+  //----------------------------------------------------------------------------
+  CPPUNIT_ASSERT( Utils::FetchLocalFd( path + " bad", 500 ) == -ENOENT );
+
+  timeval start, end;
+  gettimeofday( &start, 0 );
+  CPPUNIT_ASSERT( Utils::FetchLocalFd( path + " slow", 200 ) == -ETIMEDOUT );
+  gettimeofday( &end, 0 );
+  CPPUNIT_ASSERT( Utils::GetElapsedMicroSecs( start, end ) < 2000000 );
+
+  ::pthread_join( thread, 0 );
+  ::close( srv.listenFd );
+  ::close( srv.fd );
+  ::unlink( path.c_str() );
+  ::unlink( file.c_str() );
+  ::rmdir( dir );
+}
@@ -18,6 +18,7 @@ function printEnv()
 
 printEnv XRDTEST_MAINSERVERURL
 printEnv XRDTEST_DISKSERVERURL
+printEnv XRDTEST_PROXYSERVERURL
 printEnv XRDTEST_DATAPATH
 printEnv XRDTEST_LOCALFILE
 printEnv XRDTEST_REMOTEFILE
@@ -0,0 +1,111 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2011-2012 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "XrdCms/XrdCmsTypes.hh"
+
+//------------------------------------------------------------------------------
+// Declaration
+//------------------------------------------------------------------------------
+class SMaskTest: public CppUnit::TestCase
+{
+  public:
+    CPPUNIT_TEST_SUITE( SMaskTest );
+      CPPUNIT_TEST( WideCellTest );
+      CPPUNIT_TEST( BitTest );
+      CPPUNIT_TEST( LogicTest );
+      CPPUNIT_TEST( CompareTest );
+    CPPUNIT_TEST_SUITE_END();
+    void WideCellTest();
+    void BitTest();
+    void LogicTest();
+    void CompareTest();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( SMaskTest );
+
+//------------------------------------------------------------------------------
+// The tests are built for a wide cell
+//------------------------------------------------------------------------------
+void SMaskTest::WideCellTest()
+{
+  CPPUNIT_ASSERT( STMax > 64 );
+  CPPUNIT_ASSERT( SMaskCount( FULLMASK ) == STMax );
+  CPPUNIT_ASSERT( SMaskFirst( FULLMASK ) == 0 );
+  CPPUNIT_ASSERT( SMaskCount( SMask_t(0) ) == 0 );
+  CPPUNIT_ASSERT( SMaskFirst( SMask_t(0) ) == -1 );
+}
+
+//------------------------------------------------------------------------------
+// Single bits in every word of the mask
+//------------------------------------------------------------------------------
+void SMaskTest::BitTest()
+{
+  for( int i = 0; i < STMax; ++i )
+  {
+    SMask_t mask = SMaskBit( i );
+    CPPUNIT_ASSERT( mask );
+    CPPUNIT_ASSERT( SMaskCount( mask ) == 1 );
+    CPPUNIT_ASSERT( SMaskFirst( mask ) == i );
+    CPPUNIT_ASSERT( (mask & FULLMASK) == mask );
+    CPPUNIT_ASSERT( SMaskCount( ~mask ) == STMax - 1 );
+    CPPUNIT_ASSERT( !(mask & ~mask) );
+  }
+}
+
+//------------------------------------------------------------------------------
+// Masks spanning several words
+//------------------------------------------------------------------------------
+void SMaskTest::LogicTest()
+{
+  SMask_t lo = SMaskBit( 3 ) | SMaskBit( 63 );
+  SMask_t hi = SMaskBit( 64 ) | SMaskBit( STMax - 1 );
+  SMask_t all = lo | hi;
+
+  CPPUNIT_ASSERT( SMaskCount( all ) == 4 );
+  CPPUNIT_ASSERT( SMaskFirst( hi ) == 64 );
+  CPPUNIT_ASSERT( (all & hi) == hi );
+  CPPUNIT_ASSERT( (all ^ lo) == hi );
+  CPPUNIT_ASSERT( !(lo & hi) );
+
+  all &= ~SMaskBit( 3 );
+  CPPUNIT_ASSERT( SMaskFirst( all ) == 63 );
+  all &= ~lo;
+  CPPUNIT_ASSERT( all == hi );
+  all ^= hi;
+  CPPUNIT_ASSERT( !all );
+}
+
+//------------------------------------------------------------------------------
+// Comparisons against integers as written for the 64 bit mask
+//------------------------------------------------------------------------------
+void SMaskTest::CompareTest()
+{
+  SMask_t mask = 0;
+  CPPUNIT_ASSERT( mask == 0 );
+  mask |= SMaskBit( STMax - 1 );
+  CPPUNIT_ASSERT( mask != 0 );
+  CPPUNIT_ASSERT( SMask_t(-1) == FULLMASK );
+  CPPUNIT_ASSERT( SMask_t(1) == SMaskBit( 0 ) );
+}
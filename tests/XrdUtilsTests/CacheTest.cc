@@ -0,0 +1,298 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2011-2012 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "XrdOuc/XrdOucCacheDram.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+//------------------------------------------------------------------------------
+// Declaration
+//------------------------------------------------------------------------------
+class CacheTest: public CppUnit::TestCase
+{
+  public:
+    CPPUNIT_TEST_SUITE( CacheTest );
+      CPPUNIT_TEST( HitTest );
+      CPPUNIT_TEST( EvictTest );
+      CPPUNIT_TEST( UpdateTest );
+    CPPUNIT_TEST_SUITE_END();
+    void HitTest();
+    void EvictTest();
+    void UpdateTest();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( CacheTest );
+
+namespace
+{
+const int pageSize = 65536;
+const int numFiles = 4;
+const int numReads = 5000;
+
+//------------------------------------------------------------------------------
+// The contents of a file depend on the offset and on the file number
+//------------------------------------------------------------------------------
+inline char Pattern( long long off, int fNum )
+{
+  return (char)( off*31 + fNum + (off >> 16) );
+}
+
+//------------------------------------------------------------------------------
+// A file in memory that is read (and written) through the cache
+//------------------------------------------------------------------------------
+class MemIO: public XrdOucCacheIO
+{
+  public:
+    MemIO( int fNum, long long size ): pNum( fNum ), pSize( size )
+    {
+      snprintf( pName, sizeof(pName), "/mem%d", fNum );
+      pData = (char *)malloc( size );
+      for( long long i = 0; i < size; ++i )
+        pData[i] = Pattern( i, fNum );
+    }
+
+    virtual ~MemIO() { free( pData ); }
+
+    long long   FSize() { return pSize; }
+    const char *Path()  { return pName; }
+    int         Sync()  { return 0; }
+    int         Trunc( long long offs ) { return -ENOTSUP; }
+
+    int Read( char *buff, long long offs, int rlen )
+    {
+      if( offs >= pSize ) return 0;
+      if( offs + rlen > pSize ) rlen = pSize - offs;
+      memcpy( buff, pData+offs, rlen );
+      return rlen;
+    }
+
+    int Write( char *buff, long long offs, int wlen )
+    {
+      if( offs + wlen > pSize ) return -ENOSPC;
+      memcpy( pData+offs, buff, wlen );
+      return wlen;
+    }
+
+  private:
+    int        pNum;
+    long long  pSize;
+    char      *pData;
+    char       pName[32];
+};
+
+//------------------------------------------------------------------------------
+// Several readers going at the same files through the cache
+//------------------------------------------------------------------------------
+struct Reader
+{
+  XrdOucCacheIO **files;
+  long long       fSize;
+  unsigned int    seed;
+  int             bad;
+};
+
+extern "C"
+{
+  static void *RunReader( void *arg )
+  {
+    Reader *r = (Reader*)arg;
+    char    buff[3*pageSize/2];
+
+    for( int n = 0; n < numReads; ++n )
+    {
+      int       f    = rand_r( &r->seed ) % numFiles;
+      int       len  = 1 + rand_r( &r->seed ) % sizeof(buff);
+      long long offs = ( (long long)rand_r( &r->seed ) * 512 )
+                       % ( r->fSize - len );
+      if( r->files[f]->Read( buff, offs, len ) != len ) { r->bad++; continue; }
+      for( int i = 0; i < len; ++i )
+        if( buff[i] != Pattern( offs+i, f ) ) { r->bad++; break; }
+    }
+    return 0;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Run readers against a cache and return the number of bad reads
+//------------------------------------------------------------------------------
+int RunReaders( XrdOucCacheIO **files, long long fSize, int numThreads )
+{
+  pthread_t threads[8];
+  Reader    readers[8];
+  int       bad = 0;
+
+  for( int i = 0; i < numThreads; ++i )
+  {
+    readers[i].files = files;
+    readers[i].fSize = fSize;
+    readers[i].seed  = i+1;
+    readers[i].bad   = 0;
+    CPPUNIT_ASSERT( pthread_create( &threads[i], 0, RunReader,
+                                    &readers[i] ) == 0 );
+  }
+  for( int i = 0; i < numThreads; ++i )
+  {
+    pthread_join( threads[i], 0 );
+    bad += readers[i].bad;
+  }
+  return bad;
+}
+
+//------------------------------------------------------------------------------
+// Create a cache and attach the files to it
+//------------------------------------------------------------------------------
+XrdOucCache *Setup( XrdOucCacheIO **files, long long cSize, long long fSize,
+                    int opts = 0 )
+{
+  XrdOucCacheDram    dram;
+  XrdOucCache::Parms parms;
+  parms.CacheSize = cSize;
+  parms.PageSize  = pageSize;
+  parms.Options   = XrdOucCache::ioMTSafe;
+
+  XrdOucCache *cache = dram.Create( parms );
+  CPPUNIT_ASSERT( cache );
+  for( int i = 0; i < numFiles; ++i )
+    files[i] = cache->Attach( new MemIO( i, fSize ), opts );
+  CPPUNIT_ASSERT( cache->isAttached() == numFiles );
+  return cache;
+}
+
+//------------------------------------------------------------------------------
+// Detach the files and get rid of the cache
+//------------------------------------------------------------------------------
+void Cleanup( XrdOucCache *cache, XrdOucCacheIO **files, int &hits, int &miss )
+{
+  hits = miss = 0;
+  for( int i = 0; i < numFiles; ++i )
+  {
+    files[i]->Statistics.Lock();
+    hits += files[i]->Statistics.Hits;
+    miss += files[i]->Statistics.Miss;
+    files[i]->Statistics.UnLock();
+    delete files[i]->Detach();
+  }
+  CPPUNIT_ASSERT( cache->isAttached() == 0 );
+  delete cache;
+}
+}
+
+//------------------------------------------------------------------------------
+// Everything fits in the cache, once loaded every read must be a hit
+//------------------------------------------------------------------------------
+void CacheTest::HitTest()
+{
+  const long long fSize = 16*pageSize;
+  XrdOucCacheIO  *files[numFiles];
+  XrdOucCache    *cache = Setup( files, 2*numFiles*fSize, fSize );
+  char            buff[pageSize];
+  int             hits, miss;
+
+  for( int i = 0; i < numFiles; ++i )
+    for( long long offs = 0; offs < fSize; offs += pageSize )
+      CPPUNIT_ASSERT( files[i]->Read( buff, offs, pageSize ) == pageSize );
+
+  CPPUNIT_ASSERT( RunReaders( files, fSize, 4 ) == 0 );
+
+  Cleanup( cache, files, hits, miss );
+  CPPUNIT_ASSERT( miss == numFiles*fSize/pageSize );
+  CPPUNIT_ASSERT( hits > miss );
+}
+
+//------------------------------------------------------------------------------
+// The files are much larger than the cache so pages are constantly reused
+// while other threads still hit them
+//------------------------------------------------------------------------------
+void CacheTest::EvictTest()
+{
+  const long long fSize = 64*pageSize;
+  XrdOucCacheIO  *files[numFiles];
+  XrdOucCache    *cache = Setup( files, 256*pageSize, fSize );
+  int             hits, miss;
+
+  CPPUNIT_ASSERT( RunReaders( files, fSize, 4 ) == 0 );
+
+  Cleanup( cache, files, hits, miss );
+  CPPUNIT_ASSERT( miss > 0 );
+}
+
+//------------------------------------------------------------------------------
+// Cached pages are updated by writes while being read
+//------------------------------------------------------------------------------
+void CacheTest::UpdateTest()
+{
+  const long long fSize = 32*pageSize;
+  XrdOucCacheIO  *files[numFiles];
+  XrdOucCache    *cache = Setup( files, 512*pageSize, fSize,
+                                 XrdOucCache::optRW );
+  char            buff[pageSize];
+  int             hits, miss;
+
+  for( long long offs = 0; offs < fSize; offs += pageSize )
+    CPPUNIT_ASSERT( files[0]->Read( buff, offs, pageSize ) == pageSize );
+
+  //----------------------------------------------------------------------------
+  // Rewrite the first file with the same contents while others read it
+  //----------------------------------------------------------------------------
+  pthread_t threads[4];
+  Reader    readers[4];
+  for( int i = 0; i < 4; ++i )
+  {
+    readers[i].files = files;
+    readers[i].fSize = fSize;
+    readers[i].seed  = i+100;
+    readers[i].bad   = 0;
+    CPPUNIT_ASSERT( pthread_create( &threads[i], 0, RunReader,
+                                    &readers[i] ) == 0 );
+  }
+  for( int n = 0; n < 8; ++n )
+    for( long long offs = 0; offs < fSize; offs += pageSize/2 )
+    {
+      for( int i = 0; i < pageSize/2; ++i )
+        buff[i] = Pattern( offs+i, 0 );
+      CPPUNIT_ASSERT( files[0]->Write( buff, offs, pageSize/2 ) == pageSize/2 );
+    }
+  for( int i = 0; i < 4; ++i )
+  {
+    pthread_join( threads[i], 0 );
+    CPPUNIT_ASSERT( readers[i].bad == 0 );
+  }
+
+  //----------------------------------------------------------------------------
+  // Now change the data, the cache must return the new contents
+  //----------------------------------------------------------------------------
+  memset( buff, 'x', sizeof(buff) );
+  CPPUNIT_ASSERT( files[0]->Write( buff, pageSize, pageSize ) == pageSize );
+  memset( buff, 0, sizeof(buff) );
+  CPPUNIT_ASSERT( files[0]->Read( buff, pageSize, pageSize ) == pageSize );
+  for( int i = 0; i < pageSize; ++i )
+    CPPUNIT_ASSERT( buff[i] == 'x' );
+
+  Cleanup( cache, files, hits, miss );
+}
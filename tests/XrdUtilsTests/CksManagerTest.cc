@@ -0,0 +1,289 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2011-2012 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <string>
+
+#include "XrdVersion.hh"
+#include "XrdCks/XrdCksData.hh"
+#include "XrdCks/XrdCksManager.hh"
+#include "XrdCks/XrdCksManOss.hh"
+#include "XrdOss/XrdOss.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysLogger.hh"
+
+//------------------------------------------------------------------------------
+// Declaration
+//------------------------------------------------------------------------------
+class CksManagerTest: public CppUnit::TestCase
+{
+  public:
+    CPPUNIT_TEST_SUITE( CksManagerTest );
+      CPPUNIT_TEST( CalcManyTest );
+      CPPUNIT_TEST( CalcBatchTest );
+      CPPUNIT_TEST( OssCalcManyTest );
+    CPPUNIT_TEST_SUITE_END();
+    void setUp();
+    void tearDown();
+    void CalcManyTest();
+    void CalcBatchTest();
+    void OssCalcManyTest();
+  private:
+    std::string pDir;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( CksManagerTest );
+
+namespace
+{
+XrdVERSIONINFODEF( cksTestVer, ckstest, XrdVNUMBER, XrdVERSION );
+XrdSysLogger cksTestLogger;
+XrdSysError  cksTestErr( &cksTestLogger, "ckstest" );
+
+const int    numFiles = 6;
+
+//------------------------------------------------------------------------------
+// Create a file whose content depends on its number
+//------------------------------------------------------------------------------
+std::string MakeFile( const std::string &dir, int num )
+{
+  char name[32], buff[4096];
+  snprintf( name, sizeof(name), "/f%d", num );
+  std::string path = dir + name;
+  int fd = open( path.c_str(), O_CREAT|O_TRUNC|O_WRONLY, 0644 );
+  CPPUNIT_ASSERT( fd >= 0 );
+  for( int i = 0; i < 64+num; ++i )
+  {
+    for( int j = 0; j < (int)sizeof(buff); ++j )
+      buff[j] = (char)(i*31 + j*7 + num);
+    CPPUNIT_ASSERT( write( fd, buff, sizeof(buff) ) == (ssize_t)sizeof(buff) );
+  }
+  close( fd );
+  return path;
+}
+
+//------------------------------------------------------------------------------
+// Check that checksums calculated together match those calculated one by one
+//------------------------------------------------------------------------------
+void CheckOne( XrdCksManager &cksMan, const char *path, XrdCksData *cks,
+               int csNum )
+{
+  for( int i = 0; i < csNum; ++i )
+  {
+    XrdCksData single;
+    CPPUNIT_ASSERT( single.Set( cks[i].Name ) );
+    CPPUNIT_ASSERT( cksMan.Calc( path, single, 0 ) == 0 );
+    CPPUNIT_ASSERT( cks[i].Length == single.Length );
+    CPPUNIT_ASSERT( memcmp( cks[i].Value, single.Value, single.Length ) == 0 );
+  }
+}
+
+//------------------------------------------------------------------------------
+// A minimal oss that maps lfn's to files below a local directory
+//------------------------------------------------------------------------------
+class TestOssFile : public XrdOssDF
+{
+  public:
+    int Open( const char *path, int oflag, mode_t, XrdOucEnv & )
+    {
+      char pfn[1024];
+      int rc = oss->Lfn2Pfn( path, pfn, sizeof(pfn) );
+      if( rc ) return rc;
+      return ( (fd = open( pfn, oflag )) < 0 ? -errno : 0 );
+    }
+    int Fstat( struct stat *buf ) { return ( fstat( fd, buf ) ? -errno : 0 ); }
+    ssize_t Read( void *buff, off_t offset, size_t blen )
+    {
+      ssize_t n = pread( fd, buff, blen, offset );
+      return ( n < 0 ? -errno : n );
+    }
+    int Close( long long * = 0 )
+    {
+      if( fd >= 0 ) close( fd );
+      fd = -1;
+      return 0;
+    }
+    TestOssFile( XrdOss *ossP ) : oss( ossP ) { fd = -1; }
+    ~TestOssFile() { Close(); }
+  private:
+    XrdOss *oss;
+};
+
+class TestOss : public XrdOss
+{
+  public:
+    XrdOssDF *newDir( const char * ) { return 0; }
+    XrdOssDF *newFile( const char * ) { return new TestOssFile( this ); }
+    int Chmod( const char *, mode_t, XrdOucEnv * ) { return -ENOTSUP; }
+    int Create( const char *, const char *, mode_t, XrdOucEnv &, int )
+      { return -ENOTSUP; }
+    int Init( XrdSysLogger *, const char * ) { return 0; }
+    int Mkdir( const char *, mode_t, int, XrdOucEnv * ) { return -ENOTSUP; }
+    int Remdir( const char *, int, XrdOucEnv * ) { return -ENOTSUP; }
+    int Rename( const char *, const char *, XrdOucEnv *, XrdOucEnv * )
+      { return -ENOTSUP; }
+    int Stat( const char *path, struct stat *buf, int, XrdOucEnv * )
+    {
+      char pfn[1024];
+      int rc = Lfn2Pfn( path, pfn, sizeof(pfn) );
+      if( rc ) return rc;
+      return ( stat( pfn, buf ) ? -errno : 0 );
+    }
+    int Truncate( const char *, unsigned long long, XrdOucEnv * )
+      { return -ENOTSUP; }
+    int Unlink( const char *, int, XrdOucEnv * ) { return -ENOTSUP; }
+    int Lfn2Pfn( const char *path, char *buff, int blen )
+    {
+      if( snprintf( buff, blen, "%s%s", root.c_str(), path ) >= blen )
+        return -ENAMETOOLONG;
+      return 0;
+    }
+    TestOss( const std::string &dir ) : root( dir ) {}
+  private:
+    std::string root;
+};
+}
+
+//------------------------------------------------------------------------------
+// Set up and clean up the test files
+//------------------------------------------------------------------------------
+void CksManagerTest::setUp()
+{
+  char dir[] = "/tmp/ckstest.XXXXXX";
+  CPPUNIT_ASSERT( mkdtemp( dir ) != 0 );
+  pDir = dir;
+  for( int i = 0; i < numFiles; ++i ) MakeFile( pDir, i );
+}
+
+void CksManagerTest::tearDown()
+{
+  char name[32];
+  for( int i = 0; i < numFiles; ++i )
+  {
+    snprintf( name, sizeof(name), "/f%d", i );
+    unlink( (pDir + name).c_str() );
+  }
+  rmdir( pDir.c_str() );
+}
+
+//------------------------------------------------------------------------------
+// Several checksums of one file
+//------------------------------------------------------------------------------
+void CksManagerTest::CalcManyTest()
+{
+  XrdCksManager cksMan( &cksTestErr, 0, cksTestVer );
+  CPPUNIT_ASSERT( cksMan.Init( 0 ) );
+
+  XrdCksData cks[3];
+  CPPUNIT_ASSERT( cks[0].Set( "adler32" ) );
+  CPPUNIT_ASSERT( cks[1].Set( "crc32" ) );
+  CPPUNIT_ASSERT( cks[2].Set( "md5" ) );
+  std::string path = pDir + "/f1";
+  CPPUNIT_ASSERT( cksMan.CalcMany( path.c_str(), cks, 3, 0 ) == 0 );
+  CheckOne( cksMan, path.c_str(), cks, 3 );
+
+  XrdCksData bad;
+  CPPUNIT_ASSERT( bad.Set( "nosuchsum" ) );
+  CPPUNIT_ASSERT( cksMan.CalcMany( path.c_str(), &bad, 1, 0 ) == -ENOTSUP );
+  CPPUNIT_ASSERT( cksMan.CalcMany( path.c_str(), cks, 0, 0 ) == -EINVAL );
+  path = pDir + "/missing";
+  CPPUNIT_ASSERT( cksMan.CalcMany( path.c_str(), cks, 3, 0 ) == -ENOENT );
+}
+
+//------------------------------------------------------------------------------
+// Checksums of many files with several files being read at once
+//------------------------------------------------------------------------------
+void CksManagerTest::CalcBatchTest()
+{
+  XrdCksManager cksMan( &cksTestErr, 0, cksTestVer );
+  CPPUNIT_ASSERT( cksMan.Init( 0 ) );
+
+  std::string                   paths[numFiles+1];
+  XrdCksData                    cks[numFiles+1][2];
+  XrdCksManager::csBatch        batch[numFiles+1];
+  char                          name[32];
+
+  for( int i = 0; i <= numFiles; ++i )
+  {
+    snprintf( name, sizeof(name), "/f%d", i ); // the last one does not exist
+    paths[i] = pDir + name;
+    CPPUNIT_ASSERT( cks[i][0].Set( "adler32" ) );
+    CPPUNIT_ASSERT( cks[i][1].Set( "md5" ) );
+    batch[i].Pfn    = paths[i].c_str();
+    batch[i].Cks    = cks[i];
+    batch[i].csNum  = 2;
+    batch[i].Result = 1;
+  }
+
+  CPPUNIT_ASSERT( cksMan.CalcBatch( batch, numFiles+1, 3, 0 ) == 1 );
+  for( int i = 0; i < numFiles; ++i )
+  {
+    CPPUNIT_ASSERT( batch[i].Result == 0 );
+    CheckOne( cksMan, batch[i].Pfn, cks[i], 2 );
+  }
+  CPPUNIT_ASSERT( batch[numFiles].Result == -ENOENT );
+}
+
+//------------------------------------------------------------------------------
+// The oss based manager takes lfn's, also when batching
+//------------------------------------------------------------------------------
+void CksManagerTest::OssCalcManyTest()
+{
+  TestOss       oss( pDir );
+  XrdCksManOss  ossMan( &oss, &cksTestErr, 0, cksTestVer );
+  XrdCksManager cksMan( &cksTestErr, 0, cksTestVer );
+  CPPUNIT_ASSERT( ossMan.Init( 0 ) );
+  CPPUNIT_ASSERT( cksMan.Init( 0 ) );
+
+  XrdCksData cks[2];
+  CPPUNIT_ASSERT( cks[0].Set( "crc32" ) );
+  CPPUNIT_ASSERT( cks[1].Set( "adler32" ) );
+  CPPUNIT_ASSERT( ossMan.CalcMany( "/f2", cks, 2, 0 ) == 0 );
+  CheckOne( cksMan, (pDir + "/f2").c_str(), cks, 2 );
+
+  XrdCksData             bcks[2][1];
+  XrdCksManager::csBatch batch[2];
+  const char            *lfn[2] = { "/f3", "/f4" };
+  for( int i = 0; i < 2; ++i )
+  {
+    CPPUNIT_ASSERT( bcks[i][0].Set( "md5" ) );
+    batch[i].Pfn    = lfn[i];
+    batch[i].Cks    = bcks[i];
+    batch[i].csNum  = 1;
+    batch[i].Result = 1;
+  }
+  CPPUNIT_ASSERT( ossMan.CalcBatch( batch, 2, 2, 0 ) == 0 );
+  for( int i = 0; i < 2; ++i )
+  {
+    CPPUNIT_ASSERT( batch[i].Result == 0 );
+    CheckOne( cksMan, (pDir + lfn[i]).c_str(), bcks[i], 1 );
+  }
+}
@@ -34,6 +34,7 @@ TestEnv::TestEnv()
   PutString( "Manager1URL",      "localhost:1094" );
   PutString( "Manager2URL",      "localhost:1094" );
   PutString( "DiskServerURL",    "localhost:1094" );
+  PutString( "ProxyServerURL",   "localhost:1094" );
   PutString( "DataPath",         "/data"         );
   PutString( "RemoteFile",       "/data/cb4aacf1-6f28-42f2-b68a-90a73460f424.dat" );
   PutString( "LocalFile",        "/data/testFile.dat" );
@@ -41,6 +42,7 @@ TestEnv::TestEnv()
 
   ImportString( "MainServerURL",    "XRDTEST_MAINSERVERURL" );
   ImportString( "DiskServerURL",    "XRDTEST_DISKSERVERURL" );
+  ImportString( "ProxyServerURL",   "XRDTEST_PROXYSERVERURL" );
   ImportString( "Manager1URL",      "XRDTEST_MANAGER1URL" );
   ImportString( "Manager2URL",      "XRDTEST_MANAGER2URL" );
   ImportString( "DataPath",         "XRDTEST_DATAPATH" );